@@ -37,6 +37,7 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 		// create the physical storage
 		storage = make_shared<DataTable>(catalog->storage, schema->name, name, GetTypes(), move(info->data));
 		// create the unique indexes for the UNIQUE and PRIMARY KEY constraints
+		index_t index_count = 0;
 		for (index_t i = 0; i < bound_constraints.size(); i++) {
 			auto &constraint = bound_constraints[i];
 			if (constraint->type == ConstraintType::UNIQUE) {
@@ -65,7 +66,15 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 						bound_constraints.push_back(make_unique<BoundNotNullConstraint>(column_index));
 					}
 				}
-				storage->AddIndex(move(art), bound_expressions);
+				auto &data = storage->persistent_data;
+				if (data && index_count < data->indexes.size()) {
+					// the index was stored together with the data of the table
+					art->Load(data->indexes[index_count].root);
+					storage->indexes.push_back(move(art));
+				} else {
+					storage->AddIndex(move(art), bound_expressions);
+				}
+				index_count++;
 			}
 		}
 	}
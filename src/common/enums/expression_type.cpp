@@ -72,16 +72,8 @@ string ExpressionTypeToString(ExpressionType type) {
 		return "SCALAR";
 	case ExpressionType::AGGREGATE:
 		return "AGGREGATE";
-	case ExpressionType::WINDOW_SUM:
-		return "SUM";
-	case ExpressionType::WINDOW_COUNT_STAR:
-		return "COUNT_STAR";
-	case ExpressionType::WINDOW_MIN:
-		return "MIN";
-	case ExpressionType::WINDOW_MAX:
-		return "MAX";
-	case ExpressionType::WINDOW_AVG:
-		return "AVG";
+	case ExpressionType::WINDOW_AGGREGATE:
+		return "WINDOW_AGGREGATE";
 	case ExpressionType::WINDOW_RANK:
 		return "RANK";
 	case ExpressionType::WINDOW_RANK_DENSE:
@@ -115,6 +115,28 @@ void FileSystem::SetFilePointer(FileHandle &handle, index_t location) {
 	}
 }
 
+void FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) {
+	int fd = ((UnixFileHandle &)handle).fd;
+	int64_t bytes_read = pread(fd, buffer, nr_bytes, location);
+	if (bytes_read == -1) {
+		throw IOException("Could not read from file \"%s\": %s", handle.path.c_str(), strerror(errno));
+	}
+	if (bytes_read != nr_bytes) {
+		throw IOException("Could not read sufficient bytes from file \"%s\"", handle.path.c_str());
+	}
+}
+
+void FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) {
+	int fd = ((UnixFileHandle &)handle).fd;
+	int64_t bytes_written = pwrite(fd, buffer, nr_bytes, location);
+	if (bytes_written == -1) {
+		throw IOException("Could not write file \"%s\": %s", handle.path.c_str(), strerror(errno));
+	}
+	if (bytes_written != nr_bytes) {
+		throw IOException("Could not write sufficient bytes from file \"%s\"", handle.path.c_str());
+	}
+}
+
 int64_t FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
 	int fd = ((UnixFileHandle &)handle).fd;
 	int64_t bytes_read = read(fd, buffer, nr_bytes);
@@ -367,6 +389,39 @@ void FileSystem::SetFilePointer(FileHandle &handle, index_t location) {
 	}
 }
 
+void FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) {
+	HANDLE hFile = ((WindowsFileHandle &)handle).fd;
+	// the offset of the overlapped structure makes the read independent of the file pointer
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = (DWORD)(location & 0xFFFFFFFF);
+	overlapped.OffsetHigh = (DWORD)(location >> 32);
+	DWORD bytes_read;
+	auto rc = ReadFile(hFile, buffer, (DWORD)nr_bytes, &bytes_read, &overlapped);
+	if (rc == 0) {
+		auto error = GetLastErrorAsString();
+		throw IOException("Could not read from file \"%s\": %s", handle.path.c_str(), error.c_str());
+	}
+	if ((int64_t)bytes_read != nr_bytes) {
+		throw IOException("Could not read sufficient bytes from file \"%s\"", handle.path.c_str());
+	}
+}
+
+void FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) {
+	HANDLE hFile = ((WindowsFileHandle &)handle).fd;
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = (DWORD)(location & 0xFFFFFFFF);
+	overlapped.OffsetHigh = (DWORD)(location >> 32);
+	DWORD bytes_written;
+	auto rc = WriteFile(hFile, buffer, (DWORD)nr_bytes, &bytes_written, &overlapped);
+	if (rc == 0) {
+		auto error = GetLastErrorAsString();
+		throw IOException("Could not write file \"%s\": %s", handle.path.c_str(), error.c_str());
+	}
+	if ((int64_t)bytes_written != nr_bytes) {
+		throw IOException("Could not write sufficient bytes from file \"%s\"", handle.path.c_str());
+	}
+}
+
 int64_t FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
 	HANDLE hFile = ((WindowsFileHandle &)handle).fd;
 	DWORD bytes_read;
@@ -515,26 +570,6 @@ void FileSystem::MoveFile(const string &source, const string &target) {
 }
 #endif
 
-void FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) {
-	// seek to the location
-	SetFilePointer(handle, location);
-	// now read from the location
-	int64_t bytes_read = Read(handle, buffer, nr_bytes);
-	if (bytes_read != nr_bytes) {
-		throw IOException("Could not read sufficient bytes from file \"%s\"", handle.path.c_str());
-	}
-}
-
-void FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) {
-	// seek to the location
-	SetFilePointer(handle, location);
-	// now write to the location
-	int64_t bytes_written = Write(handle, buffer, nr_bytes);
-	if (bytes_written != nr_bytes) {
-		throw IOException("Could not write sufficient bytes from file \"%s\"", handle.path.c_str());
-	}
-}
-
 string FileSystem::JoinPath(const string &a, const string &b) {
 	// FIXME: sanitize paths
 	return a + PathSeparator() + b;
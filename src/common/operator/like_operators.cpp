@@ -1,5 +1,7 @@
 #include "common/operator/like_operators.hpp"
 
+#include <cstring>
+
 namespace duckdb {
 
 bool Like::Operation(const char *s, const char *pattern, const char *escape) {
@@ -44,4 +46,87 @@ bool Like::Operation(const char *s, const char *pattern, const char *escape) {
 	return *t == 0 && *p == 0;
 }
 
+LikeMatcher::LikeMatcher(const char *pattern) {
+	auto length = strlen(pattern);
+	has_start_percentage = length > 0 && pattern[0] == '%';
+	has_end_percentage = length > 0 && pattern[length - 1] == '%';
+	index_t segment_start = 0;
+	for (index_t i = 0; i <= length; i++) {
+		if (i == length || pattern[i] == '%') {
+			if (i > segment_start) {
+				segments.push_back(LikeSegment(string(pattern + segment_start, i - segment_start)));
+			}
+			segment_start = i + 1;
+		}
+	}
+}
+
+bool LikeMatcher::MatchSegment(LikeSegment &segment, const char *str) {
+	if (!segment.has_underscore) {
+		return memcmp(str, segment.pattern.c_str(), segment.pattern.size()) == 0;
+	}
+	for (index_t i = 0; i < segment.pattern.size(); i++) {
+		if (segment.pattern[i] != '_' && segment.pattern[i] != str[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+const char *LikeMatcher::FindSegment(LikeSegment &segment, const char *begin, const char *end) {
+	auto segment_length = segment.pattern.size();
+	if (!segment.has_underscore) {
+		// strstr finds the first occurrence; if that does not end before end no later occurrence does either
+		auto result = strstr(begin, segment.pattern.c_str());
+		return result && result + segment_length <= end ? result : nullptr;
+	}
+	for (auto str = begin; str + segment_length <= end; str++) {
+		if (MatchSegment(segment, str)) {
+			return str;
+		}
+	}
+	return nullptr;
+}
+
+bool LikeMatcher::Match(const char *str) {
+	if (segments.size() == 0) {
+		// the pattern is empty or consists of only % wildcards
+		return has_start_percentage || *str == '\0';
+	}
+	auto begin = str;
+	auto end = str + strlen(str);
+	index_t first = 0, last = segments.size();
+	if (!has_start_percentage) {
+		// the first segment has to match at the start of the string
+		auto &segment = segments[first++];
+		if ((index_t)(end - begin) < segment.pattern.size() || !MatchSegment(segment, begin)) {
+			return false;
+		}
+		begin += segment.pattern.size();
+		if (!has_end_percentage && last == 1) {
+			// there are no wildcards: the segment has to match the entire string
+			return begin == end;
+		}
+	}
+	if (!has_end_percentage) {
+		// the last segment has to match at the end of the string
+		auto &segment = segments[--last];
+		if ((index_t)(end - begin) < segment.pattern.size() ||
+		    !MatchSegment(segment, end - segment.pattern.size())) {
+			return false;
+		}
+		end -= segment.pattern.size();
+	}
+	// the segments in between can match anywhere in the remainder of the string: because every segment has a fixed
+	// length, matching each at its first occurrence leaves the most room for the segments after it
+	for (index_t i = first; i < last; i++) {
+		auto position = FindSegment(segments[i], begin, end);
+		if (!position) {
+			return false;
+		}
+		begin = position + segments[i].pattern.size();
+	}
+	return true;
+}
+
 } // namespace duckdb
@@ -0,0 +1,337 @@
+#include "common/radix_sort.hpp"
+
+#include "common/exception.hpp"
+#include "common/vector_operations/vector_operations.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace duckdb;
+using namespace std;
+
+constexpr index_t RadixSort::STRING_PREFIX_SIZE;
+
+//! Buckets with at most this amount of entries are sorted with an insertion sort instead of another radix pass
+#define RADIX_SORT_INSERTION_THRESHOLD 24
+
+//===--------------------------------------------------------------------===//
+// Key encoding
+//===--------------------------------------------------------------------===//
+template <class T> static void EncodeBigEndian(T value, data_ptr_t target) {
+	// the most significant byte is stored first, so memcmp compares it first
+	for (index_t i = 0; i < sizeof(T); i++) {
+		target[i] = (data_t)(value >> ((sizeof(T) - 1 - i) * 8));
+	}
+}
+
+// signed integers: flipping the sign bit moves the negative numbers before the positive numbers
+static void EncodeKey(int8_t value, data_ptr_t target) {
+	EncodeBigEndian<uint8_t>((uint8_t)value ^ 0x80, target);
+}
+
+static void EncodeKey(int16_t value, data_ptr_t target) {
+	EncodeBigEndian<uint16_t>((uint16_t)value ^ 0x8000, target);
+}
+
+static void EncodeKey(int32_t value, data_ptr_t target) {
+	EncodeBigEndian<uint32_t>((uint32_t)value ^ 0x80000000u, target);
+}
+
+static void EncodeKey(int64_t value, data_ptr_t target) {
+	EncodeBigEndian<uint64_t>((uint64_t)value ^ 0x8000000000000000ull, target);
+}
+
+static void EncodeKey(uint64_t value, data_ptr_t target) {
+	EncodeBigEndian<uint64_t>(value, target);
+}
+
+// floating point numbers: negative numbers sort in reverse order of their bits, so all their bits are flipped; positive
+// numbers only get their sign bit set
+static void EncodeKey(float value, data_ptr_t target) {
+	if (value == 0) {
+		// -0.0 and 0.0 are equal
+		value = 0;
+	}
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+	EncodeBigEndian<uint32_t>(bits, target);
+}
+
+static void EncodeKey(double value, data_ptr_t target) {
+	if (value == 0) {
+		value = 0;
+	}
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bits = (bits & 0x8000000000000000ull) ? ~bits : bits | 0x8000000000000000ull;
+	EncodeBigEndian<uint64_t>(bits, target);
+}
+
+struct EncodeFixedSize {
+	template <class T> static void Operation(T value, data_ptr_t target, index_t width) {
+		EncodeKey(value, target);
+	}
+};
+
+struct EncodeStringPrefix {
+	static void Operation(const char *value, data_ptr_t target, index_t width) {
+		// strings are padded with zeros, so a string sorts before every string it is a prefix of
+		index_t i = 0;
+		for (; i < width && value[i]; i++) {
+			target[i] = (data_t)value[i];
+		}
+		memset(target + i, 0, width - i);
+	}
+};
+
+template <class T, class OP>
+static void TemplatedEncodeColumn(Vector &source, sel_t *sel_vector, index_t count, data_ptr_t target,
+                                  index_t entry_size, index_t width, bool encode_nulls) {
+	auto data = (T *)source.data;
+	VectorOperations::Exec(sel_vector, count, [&](index_t i, index_t k) {
+		auto key = target + k * entry_size;
+		if (encode_nulls) {
+			// NULL values are smaller than all other values
+			if (source.nullmask[i]) {
+				memset(key, 0, 1 + width);
+				return;
+			}
+			*key++ = 1;
+		}
+		OP::Operation(data[i], key, width);
+	});
+}
+
+//! Writes the normalized keys of the selected values of the source vector to the entry at target + k * entry_size. If
+//! encode_nulls is true the key is preceded by a byte that marks whether or not the value is NULL.
+static void EncodeColumn(Vector &source, sel_t *sel_vector, index_t count, data_ptr_t target, index_t entry_size,
+                         index_t width, bool encode_nulls) {
+	switch (source.type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		TemplatedEncodeColumn<int8_t, EncodeFixedSize>(source, sel_vector, count, target, entry_size, width,
+		                                               encode_nulls);
+		break;
+	case TypeId::SMALLINT:
+		TemplatedEncodeColumn<int16_t, EncodeFixedSize>(source, sel_vector, count, target, entry_size, width,
+		                                                encode_nulls);
+		break;
+	case TypeId::INTEGER:
+		TemplatedEncodeColumn<int32_t, EncodeFixedSize>(source, sel_vector, count, target, entry_size, width,
+		                                                encode_nulls);
+		break;
+	case TypeId::BIGINT:
+		TemplatedEncodeColumn<int64_t, EncodeFixedSize>(source, sel_vector, count, target, entry_size, width,
+		                                                encode_nulls);
+		break;
+	case TypeId::POINTER:
+		TemplatedEncodeColumn<uint64_t, EncodeFixedSize>(source, sel_vector, count, target, entry_size, width,
+		                                                 encode_nulls);
+		break;
+	case TypeId::FLOAT:
+		TemplatedEncodeColumn<float, EncodeFixedSize>(source, sel_vector, count, target, entry_size, width,
+		                                              encode_nulls);
+		break;
+	case TypeId::DOUBLE:
+		TemplatedEncodeColumn<double, EncodeFixedSize>(source, sel_vector, count, target, entry_size, width,
+		                                               encode_nulls);
+		break;
+	case TypeId::VARCHAR:
+		TemplatedEncodeColumn<const char *, EncodeStringPrefix>(source, sel_vector, count, target, entry_size, width,
+		                                                        encode_nulls);
+		break;
+	default:
+		throw NotImplementedException("Unimplemented type for sort");
+	}
+}
+
+static index_t MaxStringLength(Vector &source, sel_t *sel_vector, index_t count) {
+	auto data = (const char **)source.data;
+	index_t max_length = 0;
+	VectorOperations::Exec(sel_vector, count, [&](index_t i, index_t k) {
+		if (!source.nullmask[i]) {
+			max_length = std::max(max_length, (index_t)strlen(data[i]));
+		}
+	});
+	return max_length;
+}
+
+//===--------------------------------------------------------------------===//
+// Sorting the keys
+//===--------------------------------------------------------------------===//
+static void InsertionSort(data_ptr_t entries, index_t count, index_t offset, index_t key_width, index_t entry_size,
+                          data_ptr_t swap) {
+	for (index_t i = 1; i < count; i++) {
+		memcpy(swap, entries + i * entry_size, entry_size);
+		index_t j = i;
+		while (j > 0 && memcmp(entries + (j - 1) * entry_size + offset, swap + offset, key_width - offset) > 0) {
+			memcpy(entries + j * entry_size, entries + (j - 1) * entry_size, entry_size);
+			j--;
+		}
+		memcpy(entries + j * entry_size, swap, entry_size);
+	}
+}
+
+//! Sorts the entries on the key bytes [offset, key_width) with a (stable) MSD radix sort. temp has to be able to hold
+//! count entries.
+static void RadixSortEntries(data_ptr_t entries, data_ptr_t temp, index_t count, index_t offset, index_t key_width,
+                             index_t entry_size) {
+	index_t counts[256];
+	while (offset < key_width) {
+		if (count <= RADIX_SORT_INSERTION_THRESHOLD) {
+			InsertionSort(entries, count, offset, key_width, entry_size, temp);
+			return;
+		}
+		memset(counts, 0, sizeof(counts));
+		for (index_t i = 0; i < count; i++) {
+			counts[entries[i * entry_size + offset]]++;
+		}
+		if (counts[entries[offset]] == count) {
+			// all entries have the same byte here: move on to the next byte without moving the entries
+			offset++;
+			continue;
+		}
+		index_t positions[256];
+		positions[0] = 0;
+		for (index_t i = 1; i < 256; i++) {
+			positions[i] = positions[i - 1] + counts[i - 1];
+		}
+		for (index_t i = 0; i < count; i++) {
+			auto entry = entries + i * entry_size;
+			memcpy(temp + positions[entry[offset]]++ * entry_size, entry, entry_size);
+		}
+		memcpy(entries, temp, count * entry_size);
+		if (offset + 1 == key_width) {
+			return;
+		}
+		// now sort every bucket on the next byte
+		index_t start = 0;
+		for (index_t i = 0; i < 256; i++) {
+			if (counts[i] > 1) {
+				RadixSortEntries(entries + start * entry_size, temp, counts[i], offset + 1, key_width, entry_size);
+			}
+			start += counts[i];
+		}
+		return;
+	}
+}
+
+//! Sorts the entries, which consist of a key of key_width bytes followed by the index of the tuple, and writes the
+//! sorted indices to result. If the keys are not unique for the tuples (needs_tiebreak) the tuples with equal keys
+//! are ordered with the comparison function.
+template <class T, class COMPARE>
+static void SortEntries(data_ptr_t entries, index_t count, index_t key_width, index_t entry_size, bool needs_tiebreak,
+                        T result[], COMPARE &&compare) {
+	auto temp = unique_ptr<data_t[]>(new data_t[count * entry_size]);
+	RadixSortEntries(entries, temp.get(), count, 0, key_width, entry_size);
+	for (index_t i = 0; i < count; i++) {
+		index_t index;
+		memcpy(&index, entries + i * entry_size + key_width, sizeof(index_t));
+		result[i] = (T)index;
+	}
+	if (!needs_tiebreak) {
+		return;
+	}
+	index_t start = 0;
+	for (index_t i = 1; i <= count; i++) {
+		if (i < count && memcmp(entries + start * entry_size, entries + i * entry_size, key_width) == 0) {
+			continue;
+		}
+		if (i - start > 1) {
+			std::sort(result + start, result + i, compare);
+		}
+		start = i;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Sort
+//===--------------------------------------------------------------------===//
+void RadixSort::Sort(ChunkCollection &collection, vector<OrderType> &desc, index_t result[]) {
+	assert(result);
+	if (collection.count == 0) {
+		return;
+	}
+	// determine the width of the key of every column
+	vector<index_t> widths;
+	index_t key_width = 0;
+	bool needs_tiebreak = false;
+	for (index_t col_idx = 0; col_idx < desc.size(); col_idx++) {
+		index_t width;
+		if (collection.types[col_idx] == TypeId::VARCHAR) {
+			index_t max_length = 0;
+			for (auto &chunk : collection.chunks) {
+				auto &vector = chunk->data[col_idx];
+				max_length = std::max(max_length, MaxStringLength(vector, vector.sel_vector, vector.count));
+			}
+			width = std::min(max_length, STRING_PREFIX_SIZE);
+			needs_tiebreak = max_length > STRING_PREFIX_SIZE;
+		} else {
+			width = GetTypeIdSize(collection.types[col_idx]);
+		}
+		widths.push_back(width);
+		key_width += 1 + width;
+		if (needs_tiebreak) {
+			// the key only holds a prefix of this column: the remaining columns are compared in the tie-break
+			break;
+		}
+	}
+	index_t entry_size = key_width + sizeof(index_t);
+	auto entries = unique_ptr<data_t[]>(new data_t[collection.count * entry_size]);
+	for (index_t chunk_idx = 0; chunk_idx < collection.chunks.size(); chunk_idx++) {
+		auto &chunk = *collection.chunks[chunk_idx];
+		auto chunk_entries = entries.get() + chunk_idx * STANDARD_VECTOR_SIZE * entry_size;
+		index_t key_offset = 0;
+		for (index_t col_idx = 0; col_idx < widths.size(); col_idx++) {
+			assert(!chunk.data[col_idx].sel_vector);
+			EncodeColumn(chunk.data[col_idx], nullptr, chunk.size(), chunk_entries + key_offset, entry_size,
+			             widths[col_idx], true);
+			if (desc[col_idx] == OrderType::DESCENDING) {
+				// inverting the key bytes reverses the order, this also moves the NULL values to the end
+				for (index_t i = 0; i < chunk.size(); i++) {
+					auto key = chunk_entries + i * entry_size + key_offset;
+					for (index_t j = 0; j < 1 + widths[col_idx]; j++) {
+						key[j] = ~key[j];
+					}
+				}
+			}
+			key_offset += 1 + widths[col_idx];
+		}
+		for (index_t i = 0; i < chunk.size(); i++) {
+			index_t index = chunk_idx * STANDARD_VECTOR_SIZE + i;
+			memcpy(chunk_entries + i * entry_size + key_width, &index, sizeof(index_t));
+		}
+	}
+	SortEntries(entries.get(), collection.count, key_width, entry_size, needs_tiebreak, result,
+	            [&](index_t left, index_t right) {
+		            return ChunkCollection::CompareTuple(*collection.chunks[left / STANDARD_VECTOR_SIZE],
+		                                                 left % STANDARD_VECTOR_SIZE,
+		                                                 *collection.chunks[right / STANDARD_VECTOR_SIZE],
+		                                                 right % STANDARD_VECTOR_SIZE, desc) < 0;
+	            });
+}
+
+void RadixSort::Sort(Vector &vector, sel_t *sel_vector, index_t count, sel_t result[]) {
+	if (count == 0) {
+		return;
+	}
+	index_t width;
+	bool needs_tiebreak = false;
+	if (vector.type == TypeId::VARCHAR) {
+		index_t max_length = MaxStringLength(vector, sel_vector, count);
+		width = std::min(max_length, STRING_PREFIX_SIZE);
+		needs_tiebreak = max_length > STRING_PREFIX_SIZE;
+	} else {
+		width = GetTypeIdSize(vector.type);
+	}
+	index_t entry_size = width + sizeof(index_t);
+	auto entries = unique_ptr<data_t[]>(new data_t[count * entry_size]);
+	EncodeColumn(vector, sel_vector, count, entries.get(), entry_size, width, false);
+	VectorOperations::Exec(sel_vector, count, [&](index_t i, index_t k) {
+		memcpy(entries.get() + k * entry_size + width, &i, sizeof(index_t));
+	});
+	auto strings = (const char **)vector.data;
+	SortEntries(entries.get(), count, width, entry_size, needs_tiebreak, result,
+	            [&](sel_t left, sel_t right) { return strcmp(strings[left], strings[right]) < 0; });
+}
@@ -2,6 +2,7 @@
 
 #include "common/exception.hpp"
 #include "common/printer.hpp"
+#include "common/radix_sort.hpp"
 #include "common/value_operations/value_operations.hpp"
 
 #include <algorithm>
@@ -10,6 +11,12 @@
 using namespace duckdb;
 using namespace std;
 
+void ChunkCollection::Append(ChunkCollection &other) {
+	for (auto &chunk : other.chunks) {
+		Append(*chunk);
+	}
+}
+
 void ChunkCollection::Append(DataChunk &new_chunk) {
 	if (new_chunk.size() == 0) {
 		return;
@@ -116,28 +123,19 @@ static int8_t compare_value(Vector &left_vec, Vector &right_vec, index_t vector_
 	return false;
 }
 
-static int compare_tuple(ChunkCollection *sort_by, vector<OrderType> &desc, index_t left, index_t right) {
-	assert(sort_by);
-
-	index_t chunk_idx_left = left / STANDARD_VECTOR_SIZE;
-	index_t chunk_idx_right = right / STANDARD_VECTOR_SIZE;
-	index_t vector_idx_left = left % STANDARD_VECTOR_SIZE;
-	index_t vector_idx_right = right % STANDARD_VECTOR_SIZE;
-
-	auto &left_chunk = sort_by->chunks[chunk_idx_left];
-	auto &right_chunk = sort_by->chunks[chunk_idx_right];
-
+int ChunkCollection::CompareTuple(DataChunk &left, index_t left_idx, DataChunk &right, index_t right_idx,
+                                  vector<OrderType> &desc, index_t column_offset) {
 	for (index_t col_idx = 0; col_idx < desc.size(); col_idx++) {
 		auto order_type = desc[col_idx];
 
-		Vector &left_vec = left_chunk->data[col_idx];
-		Vector &right_vec = right_chunk->data[col_idx];
+		Vector &left_vec = left.data[column_offset + col_idx];
+		Vector &right_vec = right.data[column_offset + col_idx];
 
 		assert(!left_vec.sel_vector);
 		assert(!right_vec.sel_vector);
 		assert(left_vec.type == right_vec.type);
 
-		auto comp_res = compare_value(left_vec, right_vec, vector_idx_left, vector_idx_right);
+		auto comp_res = compare_value(left_vec, right_vec, left_idx, right_idx);
 
 		if (comp_res == 0) {
 			continue;
@@ -148,99 +146,23 @@ static int compare_tuple(ChunkCollection *sort_by, vector<OrderType> &desc, inde
 	return 0;
 }
 
-static int64_t _quicksort_initial(ChunkCollection *sort_by, vector<OrderType> &desc, index_t *result) {
-	// select pivot
-	int64_t pivot = 0;
-	int64_t low = 0, high = sort_by->count - 1;
-	// now insert elements
-	for (index_t i = 1; i < sort_by->count; i++) {
-		if (compare_tuple(sort_by, desc, i, pivot) <= 0) {
-			result[low++] = i;
-		} else {
-			result[high--] = i;
-		}
-	}
-	assert(low == high);
-	result[low] = pivot;
-	return low;
-}
-
-static void _quicksort_inplace(ChunkCollection *sort_by, vector<OrderType> &desc, index_t *result, int64_t left,
-                               int64_t right) {
-	if (left >= right) {
-		return;
-	}
-
-	int64_t middle = left + (right - left) / 2;
-	int64_t pivot = result[middle];
-	// move the mid point value to the front.
-	int64_t i = left + 1;
-	int64_t j = right;
-
-	std::swap(result[middle], result[left]);
-	while (i <= j) {
-		while (i <= j && compare_tuple(sort_by, desc, result[i], pivot) <= 0) {
-			i++;
-		}
-
-		while (i <= j && compare_tuple(sort_by, desc, result[j], pivot) > 0) {
-			j--;
-		}
-
-		if (i < j) {
-			std::swap(result[i], result[j]);
-		}
-	}
-	std::swap(result[i - 1], result[left]);
-	int64_t part = i - 1;
-
-	_quicksort_inplace(sort_by, desc, result, left, part - 1);
-	_quicksort_inplace(sort_by, desc, result, part + 1, right);
-}
-
 void ChunkCollection::Sort(vector<OrderType> &desc, index_t result[]) {
-	assert(result);
-	if (count == 0)
-		return;
-	// quicksort
-	int64_t part = _quicksort_initial(this, desc, result);
-	_quicksort_inplace(this, desc, result, 0, part);
-	_quicksort_inplace(this, desc, result, part + 1, count - 1);
+	RadixSort::Sort(*this, desc, result);
 }
 
 // FIXME make this more efficient by not using the Value API
 // just use memcpy in the vectors
 // assert that there is no selection list
-void ChunkCollection::Reorder(index_t order_org[]) {
-	auto order = unique_ptr<index_t[]>(new index_t[count]);
-	memcpy(order.get(), order_org, sizeof(index_t) * count);
-
-	// adapted from https://stackoverflow.com/a/7366196/2652376
-
-	auto val_buf = vector<Value>();
-	val_buf.resize(column_count());
-
-	index_t j, k;
-	for (index_t i = 0; i < count; i++) {
-		for (index_t col_idx = 0; col_idx < column_count(); col_idx++) {
-			val_buf[col_idx] = GetValue(col_idx, i);
-		}
-		j = i;
-		while (true) {
-			k = order[j];
-			order[j] = j;
-			if (k == i) {
-				break;
-			}
-			for (index_t col_idx = 0; col_idx < column_count(); col_idx++) {
-				SetValue(col_idx, j, GetValue(col_idx, k));
-			}
-			j = k;
-		}
-		for (index_t col_idx = 0; col_idx < column_count(); col_idx++) {
-			SetValue(col_idx, j, val_buf[col_idx]);
-		}
+void ChunkCollection::Reorder(index_t order[]) {
+	// materialize the rows in the new order, and replace the chunks of the collection with them
+	ChunkCollection reordered;
+	for (index_t position = 0; position < count; position += STANDARD_VECTOR_SIZE) {
+		DataChunk chunk;
+		chunk.Initialize(types);
+		MaterializeSortedChunk(chunk, order, position);
+		reordered.Append(chunk);
 	}
+	chunks = move(reordered.chunks);
 }
 
 template <class TYPE>
@@ -263,7 +185,6 @@ static void templated_set_values(ChunkCollection *src_coll, Vector &tgt_vec, ind
 	}
 }
 
-// TODO: reorder functionality is similar, perhaps merge
 void ChunkCollection::MaterializeSortedChunk(DataChunk &target, index_t order[], index_t start_offset) {
 	index_t remaining_data = min((index_t)STANDARD_VECTOR_SIZE, count - start_offset);
 	assert(target.GetTypes() == types);
@@ -190,7 +190,7 @@ void DataChunk::Serialize(Serializer &serializer) {
 			// we use null-padding to store them
 			auto strings = (const char **)data[i].data;
 			for (index_t j = 0; j < size(); j++) {
-				auto source = strings[j] ? strings[j] : NullValue<const char *>();
+				auto source = !data[i].nullmask[j] && strings[j] ? strings[j] : NullValue<const char *>();
 				serializer.WriteString(source);
 			}
 		}
@@ -10,7 +10,21 @@
 using namespace duckdb;
 using namespace std;
 
-template <class OP> void templated_like(Vector &left, Vector &right, Vector &result) {
+static void like_constant_pattern(Vector &left, const char *pattern, Vector &result, bool invert) {
+	LikeMatcher matcher(pattern);
+	auto ldata = (const char **)left.data;
+	auto result_data = (bool *)result.data;
+	result.nullmask = left.nullmask;
+	VectorOperations::Exec(left, [&](index_t i, index_t k) {
+		if (!result.nullmask[i]) {
+			result_data[i] = matcher.Match(ldata[i]) != invert;
+		}
+	});
+	result.sel_vector = left.sel_vector;
+	result.count = left.count;
+}
+
+template <class OP> void templated_like(Vector &left, Vector &right, Vector &result, bool invert) {
 	if (left.type != TypeId::VARCHAR) {
 		throw InvalidTypeException(left.type, "Input of (NOT) LIKE must be VARCHAR");
 	}
@@ -20,13 +34,18 @@ template <class OP> void templated_like(Vector &left, Vector &right, Vector &res
 	if (result.type != TypeId::BOOLEAN) {
 		throw InvalidTypeException(result.type, "Result of (NOT) LIKE must be VARCHAR");
 	}
+	if (right.IsConstant() && !right.nullmask[0]) {
+		// constant pattern: analyze the pattern once for the entire vector
+		like_constant_pattern(left, ((const char **)right.data)[0], result, invert);
+		return;
+	}
 	templated_binary_loop<const char *, const char *, bool, OP, true>(left, right, result);
 }
 
 void VectorOperations::Like(Vector &left, Vector &right, Vector &result) {
-	templated_like<duckdb::Like>(left, right, result);
+	templated_like<duckdb::Like>(left, right, result, false);
 }
 
 void VectorOperations::NotLike(Vector &left, Vector &right, Vector &result) {
-	templated_like<duckdb::NotLike>(left, right, result);
+	templated_like<duckdb::NotLike>(left, right, result, true);
 }
@@ -230,6 +230,64 @@ void SuperLargeHashTable::AddChunk(DataChunk &groups, DataChunk &payload) {
 	}
 }
 
+void SuperLargeHashTable::Combine(SuperLargeHashTable &other) {
+	assert(other.group_types == group_types && other.tuple_size == tuple_size);
+	if (other.entries == 0) {
+		return;
+	}
+
+	DataChunk groups;
+	groups.Initialize(group_types, false);
+
+	Vector source_addresses(TypeId::POINTER, true, false);
+	auto data_pointers = (data_ptr_t *)source_addresses.data;
+
+	data_ptr_t ptr = other.data;
+	data_ptr_t end = other.data + other.capacity * tuple_size;
+	while (true) {
+		groups.Reset();
+
+		// scan the other table for full cells
+		index_t entry = 0;
+		for (; ptr < end && entry < STANDARD_VECTOR_SIZE; ptr += tuple_size) {
+			if (*ptr == FULL_CELL) {
+				data_pointers[entry++] = ptr + FLAG_SIZE;
+			}
+		}
+		if (entry == 0) {
+			break;
+		}
+		source_addresses.count = entry;
+		// fetch the group columns
+		for (index_t i = 0; i < groups.column_count; i++) {
+			auto &column = groups.data[i];
+			column.count = entry;
+			VectorOperations::Gather::Set(source_addresses, column);
+			VectorOperations::AddInPlace(source_addresses, GetTypeIdSize(column.type));
+		}
+		groups.Verify();
+
+		// find (or create) the matching groups in this table
+		StaticPointerVector target_addresses;
+		StaticVector<bool> new_group_dummy;
+		FindOrCreateGroups(groups, target_addresses, new_group_dummy);
+		assert(source_addresses.count == target_addresses.count);
+		assert(source_addresses.sel_vector == target_addresses.sel_vector);
+
+		// now merge the aggregate states of the other table into the states of this table
+		for (index_t aggr_idx = 0; aggr_idx < aggregates.size(); aggr_idx++) {
+			auto aggr = aggregates[aggr_idx];
+			assert(aggr->bound_aggregate->combine && !aggr->distinct);
+			aggr->bound_aggregate->combine(source_addresses, target_addresses, aggr->return_type);
+
+			auto state_size = aggr->bound_aggregate->state_size(aggr->return_type);
+			VectorOperations::AddInPlace(source_addresses, state_size);
+			VectorOperations::AddInPlace(target_addresses, state_size);
+		}
+	}
+	string_heap.MergeHeap(other.string_heap);
+}
+
 void SuperLargeHashTable::FetchAggregates(DataChunk &groups, DataChunk &result) {
 	groups.Verify();
 	assert(groups.column_count == group_types.size());
@@ -80,6 +80,46 @@ void ExpressionExecutor::MergeExpression(Expression &expr, Vector &result) {
 	and_result.Move(result);
 }
 
+void ExpressionExecutor::ExecuteSubset(Expression &expr, Vector &result, sel_t *sel_vector, index_t count) {
+	assert(chunk && count > 0 && count <= chunk->size());
+	if (count == chunk->size()) {
+		// all rows are selected
+		Execute(expr, result);
+		return;
+	}
+	// execute the expression on a chunk that only contains the selected rows
+	DataChunk subset;
+	auto types = chunk->GetTypes();
+	subset.InitializeEmpty(types);
+	for (index_t i = 0; i < subset.column_count; i++) {
+		subset.data[i].Reference(chunk->data[i]);
+		subset.data[i].sel_vector = sel_vector;
+		subset.data[i].count = count;
+	}
+	subset.sel_vector = sel_vector;
+
+	// the common subexpressions that were computed for the chunk can be used for the subset, but the ones that are
+	// computed for the subset cannot be used for the other rows of the chunk: they are dropped afterwards
+	auto chunk_cse = move(cached_cse);
+	cached_cse.clear();
+	for (auto &entry : chunk_cse) {
+		auto cse = make_unique<Vector>();
+		cse->Reference(*entry.second);
+		cached_cse[entry.first] = move(cse);
+	}
+	auto parent_chunk = chunk;
+	chunk = &subset;
+	try {
+		Execute(expr, result);
+	} catch (...) {
+		chunk = parent_chunk;
+		cached_cse = move(chunk_cse);
+		throw;
+	}
+	chunk = parent_chunk;
+	cached_cse = move(chunk_cse);
+}
+
 Value ExpressionExecutor::EvaluateScalar(Expression &expr) {
 	assert(expr.IsFoldable());
 	// use an ExpressionExecutor to execute the expression
@@ -2,16 +2,74 @@
 #include "execution/expression_executor.hpp"
 #include "planner/expression/bound_case_expression.hpp"
 
+#include <cstring>
+
 using namespace duckdb;
 using namespace std;
 
-void ExpressionExecutor::Execute(BoundCaseExpression &expr, Vector &result) {
-	Vector check, res_true, res_false;
+//! Copies the result of a branch of the CASE expression, which was computed for the rows in sel_vector, to the result
+static void CopyBranchResult(Vector &branch, sel_t *sel_vector, index_t count, Vector &result) {
+	if (branch.type != result.type) {
+		throw TypeMismatchException(result.type, branch.type, "Case types have to match!");
+	}
+	bool constant = branch.count == 1 && !branch.sel_vector;
+	auto width = GetTypeIdSize(result.type);
+	for (index_t k = 0; k < count; k++) {
+		auto i = sel_vector[k];
+		auto branch_idx = constant ? 0 : i;
+		result.nullmask[i] = branch.nullmask[branch_idx];
+		if (result.nullmask[i]) {
+			continue;
+		}
+		if (result.type == TypeId::VARCHAR) {
+			((const char **)result.data)[i] = result.string_heap.AddString(((const char **)branch.data)[branch_idx]);
+		} else {
+			memcpy(result.data + i * width, branch.data + branch_idx * width, width);
+		}
+	}
+}
 
+void ExpressionExecutor::Execute(BoundCaseExpression &expr, Vector &result) {
+	Vector check;
 	Execute(*expr.check, check);
-	Execute(*expr.result_if_true, res_true);
-	Execute(*expr.result_if_false, res_false);
+	if (check.type != TypeId::BOOLEAN) {
+		throw InvalidTypeException(check.type, "Case check has to be a boolean vector!");
+	}
+
+	if (!chunk || check.count != chunk->size() || check.sel_vector != chunk->sel_vector) {
+		// the check is a constant: evaluate both branches
+		Vector res_true, res_false;
+		Execute(*expr.result_if_true, res_true);
+		Execute(*expr.result_if_false, res_false);
+
+		result.Initialize(res_true.type);
+		VectorOperations::Case(check, res_true, res_false, result);
+		return;
+	}
+
+	// divide the rows over the branches, and only execute every branch for its own rows
+	auto cond = (bool *)check.data;
+	sel_t true_sel[STANDARD_VECTOR_SIZE], false_sel[STANDARD_VECTOR_SIZE];
+	index_t true_count = 0, false_count = 0;
+	VectorOperations::Exec(check, [&](index_t i, index_t k) {
+		if (cond[i] && !check.nullmask[i]) {
+			true_sel[true_count++] = i;
+		} else {
+			false_sel[false_count++] = i;
+		}
+	});
 
-	result.Initialize(res_true.type);
-	VectorOperations::Case(check, res_true, res_false, result);
+	result.Initialize(expr.return_type);
+	result.count = check.count;
+	result.sel_vector = check.sel_vector;
+	if (true_count > 0) {
+		Vector res_true;
+		ExecuteSubset(*expr.result_if_true, res_true, true_sel, true_count);
+		CopyBranchResult(res_true, true_sel, true_count, result);
+	}
+	if (false_count > 0) {
+		Vector res_false;
+		ExecuteSubset(*expr.result_if_false, res_false, false_sel, false_count);
+		CopyBranchResult(res_false, false_sel, false_count, result);
+	}
 }
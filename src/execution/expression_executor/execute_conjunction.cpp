@@ -6,19 +6,70 @@ using namespace duckdb;
 using namespace std;
 
 void ExpressionExecutor::Execute(BoundConjunctionExpression &expr, Vector &result) {
-	Vector left, right;
+	if (expr.type != ExpressionType::CONJUNCTION_AND && expr.type != ExpressionType::CONJUNCTION_OR) {
+		throw NotImplementedException("Unknown conjunction type!");
+	}
+	bool is_and = expr.type == ExpressionType::CONJUNCTION_AND;
+
+	Vector left;
 	Execute(*expr.left, left);
-	Execute(*expr.right, right);
+
+	// the right side only has to be executed for the rows where the left side does not determine the result, i.e. the
+	// rows where it is not FALSE (AND) or not TRUE (OR)
+	auto ldata = (bool *)left.data;
+	sel_t remaining[STANDARD_VECTOR_SIZE];
+	index_t remaining_count = 0;
+	bool short_circuit = chunk && left.count == chunk->size() && left.sel_vector == chunk->sel_vector;
+	if (short_circuit) {
+		VectorOperations::Exec(left, [&](index_t i, index_t k) {
+			if (left.nullmask[i] || ldata[i] == is_and) {
+				remaining[remaining_count++] = i;
+			}
+		});
+		short_circuit = remaining_count < left.count;
+	}
 
 	result.Initialize(TypeId::BOOLEAN);
-	switch (expr.type) {
-	case ExpressionType::CONJUNCTION_AND:
-		VectorOperations::And(left, right, result);
-		break;
-	case ExpressionType::CONJUNCTION_OR:
-		VectorOperations::Or(left, right, result);
-		break;
-	default:
-		throw NotImplementedException("Unknown conjunction type!");
+	if (!short_circuit) {
+		Vector right;
+		Execute(*expr.right, right);
+		if (is_and) {
+			VectorOperations::And(left, right, result);
+		} else {
+			VectorOperations::Or(left, right, result);
+		}
+		return;
+	}
+
+	// the result of the rows that are not remaining is the left side
+	auto result_data = (bool *)result.data;
+	result.count = left.count;
+	result.sel_vector = left.sel_vector;
+	VectorOperations::Exec(left, [&](index_t i, index_t k) {
+		result_data[i] = ldata[i];
+		result.nullmask[i] = left.nullmask[i];
+	});
+	if (remaining_count == 0) {
+		return;
+	}
+
+	Vector right;
+	ExecuteSubset(*expr.right, right, remaining, remaining_count);
+	auto rdata = (bool *)right.data;
+	bool right_constant = right.count == 1 && !right.sel_vector;
+	for (index_t k = 0; k < remaining_count; k++) {
+		auto i = remaining[k];
+		auto right_idx = right_constant ? 0 : i;
+		if (!left.nullmask[i]) {
+			// TRUE AND x = x, FALSE OR x = x
+			result_data[i] = rdata[right_idx];
+			result.nullmask[i] = right.nullmask[right_idx];
+		} else if (!right.nullmask[right_idx] && rdata[right_idx] != is_and) {
+			// NULL AND FALSE = FALSE, NULL OR TRUE = TRUE
+			result_data[i] = rdata[right_idx];
+			result.nullmask[i] = false;
+		} else {
+			result.nullmask[i] = true;
+		}
 	}
 }
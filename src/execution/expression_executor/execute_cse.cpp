@@ -11,6 +11,12 @@ void ExpressionExecutor::Execute(CommonSubExpression &expr, Vector &result) {
 	if (entry != cached_cse.end()) {
 		// already existed, just reference the stored vector!
 		result.Reference(*(entry->second));
+		if (chunk && (result.count != 1 || result.sel_vector)) {
+			// the CSE was computed for all rows of the chunk, but the expression might only be executed for a subset
+			// of them (see ExpressionExecutor::ExecuteSubset)
+			result.sel_vector = chunk->sel_vector;
+			result.count = chunk->size();
+		}
 	} else {
 		// else execute it
 		Execute(*expr.child, result);
@@ -1,18 +1,20 @@
 #include "execution/index/art/art.hpp"
 #include "execution/expression_executor.hpp"
 #include "common/vector_operations/vector_operations.hpp"
+#include "execution/task_scheduler.hpp"
 #include "main/client_context.hpp"
+#include "common/unordered_map.hpp"
 #include <algorithm>
 
 using namespace duckdb;
 using namespace std;
 
+constexpr index_t ART::BUILD_PARTITION_SIZE;
+
 ART::ART(DataTable &table, vector<column_t> column_ids, vector<unique_ptr<Expression>> unbound_expressions,
          bool is_unique)
-    : Index(IndexType::ART, table, column_ids, move(unbound_expressions)), is_unique(is_unique) {
-	if (this->unbound_expressions.size() > 1) {
-		throw NotImplementedException("Multiple columns in ART index not supported");
-	}
+    : Index(IndexType::ART, table, column_ids, move(unbound_expressions)), locked_exclusively(false),
+      is_unique(is_unique) {
 	tree = nullptr;
 	expression_result.Initialize(types);
 	int n = 1;
@@ -22,38 +24,51 @@ ART::ART(DataTable &table, vector<column_t> column_ids, vector<unique_ptr<Expres
 	} else {
 		is_little_endian = false;
 	}
-	switch (types[0]) {
-	case TypeId::TINYINT:
-		maxPrefix = sizeof(int8_t);
-		break;
-	case TypeId::SMALLINT:
-		maxPrefix = sizeof(int16_t);
-		break;
-	case TypeId::INTEGER:
-		maxPrefix = sizeof(int32_t);
-		break;
-	case TypeId::BIGINT:
-		maxPrefix = sizeof(int64_t);
-		break;
-	default:
-		throw InvalidTypeException(types[0], "Invalid type for index");
+	for (auto &type : types) {
+		switch (type) {
+		case TypeId::BOOLEAN:
+		case TypeId::TINYINT:
+		case TypeId::SMALLINT:
+		case TypeId::INTEGER:
+		case TypeId::BIGINT:
+		case TypeId::FLOAT:
+		case TypeId::DOUBLE:
+		case TypeId::VARCHAR:
+			break;
+		default:
+			throw InvalidTypeException(type, "Invalid type for index");
+		}
 	}
 }
 
 ART::~ART() {
 }
 
-bool ART::LeafMatches(Node *node, Key &key, unsigned depth) {
-	if (depth != maxPrefix) {
-		auto leaf = static_cast<Leaf *>(node);
-		Key &leaf_key = *leaf->value;
-		for (index_t i = depth; i < maxPrefix; i++) {
-			if (leaf_key[i] != key[i]) {
-				return false;
-			}
-		}
+//! Holds the exclusive lock of the index, during which nodes can be loaded from the database file
+class ExclusiveARTLock {
+public:
+	ExclusiveARTLock(ART &art) : art(art), key(art.lock.GetExclusiveLock()) {
+		art.locked_exclusively = true;
 	}
-	return true;
+	~ExclusiveARTLock() {
+		art.locked_exclusively = false;
+	}
+
+private:
+	ART &art;
+	unique_ptr<StorageLockKey> key;
+};
+
+void ART::ExecuteRead(const function<void()> &read, const function<void()> &restart) {
+	try {
+		auto shared_lock = lock.GetSharedLock();
+		read();
+		return;
+	} catch (ARTRestart &) {
+		restart();
+	}
+	ExclusiveARTLock exclusive_lock(*this);
+	read();
 }
 
 unique_ptr<IndexScanState> ART::InitializeScanSinglePredicate(Transaction &transaction, vector<column_t> column_ids,
@@ -75,45 +90,124 @@ unique_ptr<IndexScanState> ART::InitializeScanTwoPredicates(Transaction &transac
 	return move(result);
 }
 
+unique_ptr<IndexScanState> ART::InitializeScanEqualityPredicates(Transaction &transaction, vector<column_t> column_ids,
+                                                                 vector<Value> values) {
+	assert(values.size() == types.size());
+	auto result = make_unique<ARTIndexScanState>(column_ids);
+	result->equal_values = move(values);
+	return move(result);
+}
+
 //===--------------------------------------------------------------------===//
 // Insert
 //===--------------------------------------------------------------------===//
-template <class T> static void generate_keys(DataChunk &input, vector<unique_ptr<Key>> &keys, bool is_little_endian) {
-	auto input_data = (T *)input.data[0].data;
-	VectorOperations::Exec(input.data[0], [&](index_t i, index_t k) {
-		if (input.data[0].nullmask[i]) {
-			keys.push_back(nullptr);
-		} else {
-			keys.push_back(Key::CreateKey<T>(input_data[i], is_little_endian));
+template <class T> static void encode_keys(Vector &input, data_ptr_t key_data[], bool is_little_endian) {
+	auto input_data = (T *)input.data;
+	VectorOperations::Exec(input, [&](index_t i, index_t k) {
+		if (!key_data[k]) {
+			return;
+		}
+		Key::EncodeData<T>(key_data[k], input_data[i], is_little_endian);
+		key_data[k] += sizeof(T);
+	});
+}
+
+static void encode_string_keys(Vector &input, data_ptr_t key_data[]) {
+	auto input_data = (const char **)input.data;
+	VectorOperations::Exec(input, [&](index_t i, index_t k) {
+		if (!key_data[k]) {
+			return;
 		}
+		Key::EncodeString(key_data[k], input_data[i]);
+		key_data[k] += strlen(input_data[i]) + 1;
 	});
 }
 
+//! Computes the length of the key of every row of the input. Rows with a NULL value in any of the columns are not
+//! indexed: for them has_null is set.
+static void ComputeKeyLengths(DataChunk &input, index_t key_lengths[], bool has_null[]) {
+	index_t count = input.size();
+	for (index_t k = 0; k < count; k++) {
+		key_lengths[k] = 0;
+		has_null[k] = false;
+	}
+	for (index_t col_idx = 0; col_idx < input.column_count; col_idx++) {
+		auto &column = input.data[col_idx];
+		auto type_size = GetTypeIdSize(column.type);
+		auto strings = (const char **)column.data;
+		VectorOperations::Exec(column, [&](index_t i, index_t k) {
+			if (column.nullmask[i]) {
+				has_null[k] = true;
+			} else {
+				key_lengths[k] += column.type == TypeId::VARCHAR ? strlen(strings[i]) + 1 : type_size;
+			}
+		});
+	}
+}
+
+//! Encodes the columns of the input one after the other into the keys, key_data[k] is the key of the k-th row (or
+//! nullptr if the row is not indexed)
+static void EncodeKeys(DataChunk &input, data_ptr_t key_data[], bool is_little_endian) {
+	for (index_t col_idx = 0; col_idx < input.column_count; col_idx++) {
+		auto &column = input.data[col_idx];
+		switch (column.type) {
+		case TypeId::BOOLEAN:
+			encode_keys<bool>(column, key_data, is_little_endian);
+			break;
+		case TypeId::TINYINT:
+			encode_keys<int8_t>(column, key_data, is_little_endian);
+			break;
+		case TypeId::SMALLINT:
+			encode_keys<int16_t>(column, key_data, is_little_endian);
+			break;
+		case TypeId::INTEGER:
+			encode_keys<int32_t>(column, key_data, is_little_endian);
+			break;
+		case TypeId::BIGINT:
+			encode_keys<int64_t>(column, key_data, is_little_endian);
+			break;
+		case TypeId::FLOAT:
+			encode_keys<float>(column, key_data, is_little_endian);
+			break;
+		case TypeId::DOUBLE:
+			encode_keys<double>(column, key_data, is_little_endian);
+			break;
+		case TypeId::VARCHAR:
+			encode_string_keys(column, key_data);
+			break;
+		default:
+			throw InvalidTypeException(column.type, "Invalid type for index");
+		}
+	}
+}
+
 void ART::GenerateKeys(DataChunk &input, vector<unique_ptr<Key>> &keys) {
-	keys.reserve(STANDARD_VECTOR_SIZE);
-
-	switch (input.data[0].type) {
-	case TypeId::TINYINT:
-		generate_keys<int8_t>(input, keys, is_little_endian);
-		break;
-	case TypeId::SMALLINT:
-		generate_keys<int16_t>(input, keys, is_little_endian);
-		break;
-	case TypeId::INTEGER:
-		generate_keys<int32_t>(input, keys, is_little_endian);
-		break;
-	case TypeId::BIGINT:
-		generate_keys<int64_t>(input, keys, is_little_endian);
-		break;
-	default:
-		throw InvalidTypeException(input.data[0].type, "Invalid type for index");
+	index_t count = input.size();
+	keys.reserve(count);
+
+	index_t key_lengths[STANDARD_VECTOR_SIZE];
+	bool has_null[STANDARD_VECTOR_SIZE];
+	ComputeKeyLengths(input, key_lengths, has_null);
+
+	// allocate the keys, and encode the columns one after the other into them
+	data_ptr_t key_data[STANDARD_VECTOR_SIZE];
+	for (index_t k = 0; k < count; k++) {
+		if (has_null[k]) {
+			key_data[k] = nullptr;
+			keys.push_back(nullptr);
+		} else {
+			auto data = unique_ptr<data_t[]>(new data_t[key_lengths[k]]);
+			key_data[k] = data.get();
+			keys.push_back(make_unique<Key>(move(data), key_lengths[k]));
+		}
 	}
+	EncodeKeys(input, key_data, is_little_endian);
 }
 
 bool ART::Insert(DataChunk &input, Vector &row_ids) {
 	assert(row_ids.type == TypeId::BIGINT);
 	assert(input.size() == row_ids.count);
-	assert(types[0] == input.data[0].type);
+	assert(input.column_count == types.size());
 
 	// generate the keys for the given input
 	vector<unique_ptr<Key>> keys;
@@ -153,7 +247,7 @@ bool ART::Insert(DataChunk &input, Vector &row_ids) {
 }
 
 bool ART::Append(DataChunk &appended_data, Vector &row_identifiers) {
-	lock_guard<mutex> l(lock);
+	ExclusiveARTLock l(*this);
 
 	// first resolve the expressions for the index
 	ExecuteExpressions(appended_data, expression_result);
@@ -162,15 +256,120 @@ bool ART::Append(DataChunk &appended_data, Vector &row_identifiers) {
 	return Insert(expression_result, row_identifiers);
 }
 
-bool ART::InsertToLeaf(Leaf &leaf, row_t row_id) {
-	if (is_unique && leaf.num_elements != 0) {
+//! Extract the row ids of a vector, in the order of the keys generated for the entries
+static vector<row_t> GetRowIds(Vector &row_ids) {
+	assert(row_ids.type == TypeId::BIGINT);
+	auto row_identifiers = (row_t *)row_ids.data;
+	vector<row_t> result;
+	result.reserve(row_ids.count);
+	for (index_t i = 0; i < row_ids.count; i++) {
+		result.push_back(row_identifiers[row_ids.sel_vector ? row_ids.sel_vector[i] : i]);
+	}
+	return result;
+}
+
+//! Whether or not two (possibly NULL) keys are equal
+static bool KeysEqual(Key *left, Key *right) {
+	if (!left || !right) {
+		return !left && !right;
+	}
+	return *left == *right;
+}
+
+bool ART::Update(DataChunk &old_entries, DataChunk &new_entries, Vector &row_ids) {
+	assert(old_entries.size() == row_ids.count && new_entries.size() == row_ids.count);
+	ExclusiveARTLock l(*this);
+
+	vector<unique_ptr<Key>> old_keys, new_keys;
+	ExecuteExpressions(old_entries, expression_result);
+	GenerateKeys(expression_result, old_keys);
+	ExecuteExpressions(new_entries, expression_result);
+	GenerateKeys(expression_result, new_keys);
+
+	// the updated rows keep the entries of the keys that do not change: only the changed keys are inserted
+	auto row_identifiers = GetRowIds(row_ids);
+	vector<bool> insert;
+	for (index_t k = 0; k < new_keys.size(); k++) {
+		insert.push_back(new_keys[k] && !KeysEqual(old_keys[k].get(), new_keys[k].get()));
+	}
+	return InsertReplacingRows(new_keys, insert, row_identifiers, row_identifiers);
+}
+
+bool ART::Replace(DataChunk &entries, Vector &row_ids, Vector &replaced_row_ids) {
+	assert(entries.size() == row_ids.count && row_ids.count == replaced_row_ids.count);
+	ExclusiveARTLock l(*this);
+
+	vector<unique_ptr<Key>> keys;
+	ExecuteExpressions(entries, expression_result);
+	GenerateKeys(expression_result, keys);
+
+	auto row_identifiers = GetRowIds(row_ids);
+	auto replaced_identifiers = GetRowIds(replaced_row_ids);
+	vector<bool> insert;
+	for (index_t k = 0; k < keys.size(); k++) {
+		insert.push_back(keys[k] != nullptr);
+	}
+	return InsertReplacingRows(keys, insert, row_identifiers, replaced_identifiers);
+}
+
+bool ART::InsertReplacingRows(vector<unique_ptr<Key>> &keys, vector<bool> &insert, vector<row_t> &row_ids,
+                              vector<row_t> &replaced_ids) {
+	// first insert all the keys, so rows that swap their keys can see each other
+	for (index_t k = 0; k < keys.size(); k++) {
+		if (insert[k]) {
+			auto data = unique_ptr<data_t[]>(new data_t[keys[k]->len]);
+			memcpy(data.get(), keys[k]->data.get(), keys[k]->len);
+			Insert(tree, make_unique<Key>(move(data), keys[k]->len), 0, row_ids[k], false);
+		}
+	}
+	if (!is_unique) {
+		return true;
+	}
+	// then check that every row that holds an inserted key gives it up (or is the row that takes it)
+	unordered_map<row_t, index_t> replaced_map;
+	for (index_t k = 0; k < replaced_ids.size(); k++) {
+		replaced_map[replaced_ids[k]] = k;
+	}
+	for (index_t k = 0; k < keys.size(); k++) {
+		if (!insert[k]) {
+			continue;
+		}
+		auto leaf = static_cast<Leaf *>(Lookup(tree, *keys[k], 0));
+		assert(leaf);
+		for (index_t i = 0; i < leaf->num_elements; i++) {
+			row_t holder = leaf->GetRowId(i);
+			if (holder == row_ids[k]) {
+				continue;
+			}
+			auto entry = replaced_map.find(holder);
+			if (entry != replaced_map.end()) {
+				auto replacement = entry->second;
+				if (row_ids[replacement] == row_ids[k] || !KeysEqual(keys[replacement].get(), keys[k].get())) {
+					// the row is replaced by this row, or replaced by a row with a different key
+					continue;
+				}
+			}
+			// the key is held by another row: constraint violation, remove the inserted entries
+			for (index_t j = 0; j < keys.size(); j++) {
+				if (insert[j]) {
+					Erase(tree, *keys[j], 0, row_ids[j]);
+				}
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ART::InsertToLeaf(Leaf &leaf, row_t row_id, bool check_unique) {
+	if (check_unique && is_unique && leaf.num_elements != 0) {
 		return false;
 	}
 	leaf.Insert(row_id);
 	return true;
 }
 
-bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth, row_t row_id) {
+bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth, row_t row_id, bool check_unique) {
 	Key &key = *value;
 	if (!node) {
 		// node is currently empty, create a leaf here with the key
@@ -182,51 +381,39 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 		// Replace leaf with Node4 and store both leaves in it
 		auto leaf = static_cast<Leaf *>(node.get());
 
-		Key &existingKey = *leaf->value;
-		uint32_t newPrefixLength = 0;
-		// Leaf node is already there, update row_id vector
-		if (depth + newPrefixLength == maxPrefix) {
-			return InsertToLeaf(*leaf, row_id);
-		}
-		while (existingKey[depth + newPrefixLength] == key[depth + newPrefixLength]) {
-			newPrefixLength++;
+		Key &existing_key = *leaf->value;
+		if (existing_key == key) {
 			// Leaf node is already there, update row_id vector
-			if (depth + newPrefixLength == maxPrefix) {
-				return InsertToLeaf(*leaf, row_id);
-			}
+			return InsertToLeaf(*leaf, row_id, check_unique);
+		}
+		// no key is a prefix of another key: the keys differ before the end of either of them
+		uint32_t new_prefix_length = 0;
+		while (existing_key[depth + new_prefix_length] == key[depth + new_prefix_length]) {
+			new_prefix_length++;
 		}
-		unique_ptr<Node> newNode = make_unique<Node4>(*this);
-		newNode->prefix_length = newPrefixLength;
-		memcpy(newNode->prefix.get(), &key[depth], std::min(newPrefixLength, maxPrefix));
-		Node4::insert(*this, newNode, existingKey[depth + newPrefixLength], node);
+		unique_ptr<Node> new_node = make_unique<Node4>(*this);
+		new_node->SetPrefix(&key[depth], new_prefix_length);
+		Node4::insert(*this, new_node, existing_key[depth + new_prefix_length], node);
 		unique_ptr<Node> leaf_node = make_unique<Leaf>(*this, move(value), row_id);
-		Node4::insert(*this, newNode, key[depth + newPrefixLength], leaf_node);
-		node = move(newNode);
+		Node4::insert(*this, new_node, key[depth + new_prefix_length], leaf_node);
+		node = move(new_node);
 		return true;
 	}
 
 	// Handle prefix of inner node
 	if (node->prefix_length) {
-		uint32_t mismatchPos = Node::PrefixMismatch(*this, node.get(), key, depth);
-		if (mismatchPos != node->prefix_length) {
+		uint32_t mismatch_pos = Node::PrefixMismatch(*this, node.get(), key, depth);
+		if (mismatch_pos != node->prefix_length) {
 			// Prefix differs, create new node
-			unique_ptr<Node> newNode = make_unique<Node4>(*this);
-			newNode->prefix_length = mismatchPos;
-			memcpy(newNode->prefix.get(), node->prefix.get(), std::min(mismatchPos, maxPrefix));
+			unique_ptr<Node> new_node = make_unique<Node4>(*this);
+			new_node->SetPrefix(node->prefix.get(), mismatch_pos);
 			// Break up prefix
-			if (node->prefix_length < maxPrefix) {
-				auto node_ptr = node.get();
-				Node4::insert(*this, newNode, node->prefix[mismatchPos], node);
-				node_ptr->prefix_length -= (mismatchPos + 1);
-				memmove(node_ptr->prefix.get(), node_ptr->prefix.get() + mismatchPos + 1,
-				        std::min(node_ptr->prefix_length, maxPrefix));
-			} else {
-				throw NotImplementedException("PrefixLength > MaxPrefixLength");
-			}
+			auto node_ptr = node.get();
+			Node4::insert(*this, new_node, node->prefix[mismatch_pos], node);
+			node_ptr->SetPrefix(node_ptr->prefix.get() + mismatch_pos + 1, node_ptr->prefix_length - mismatch_pos - 1);
 			unique_ptr<Node> leaf_node = make_unique<Leaf>(*this, move(value), row_id);
-
-			Node4::insert(*this, newNode, key[depth + mismatchPos], leaf_node);
-			node = move(newNode);
+			Node4::insert(*this, new_node, key[depth + mismatch_pos], leaf_node);
+			node = move(new_node);
 			return true;
 		}
 		depth += node->prefix_length;
@@ -236,7 +423,7 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 	index_t pos = node->GetChildPos(key[depth]);
 	if (pos != INVALID_INDEX) {
 		auto child = node->GetChild(pos);
-		return Insert(*child, move(value), depth + 1, row_id);
+		return Insert(*child, move(value), depth + 1, row_id, check_unique);
 	}
 
 	unique_ptr<Node> newNode = make_unique<Leaf>(*this, move(value), row_id);
@@ -244,11 +431,202 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 	return true;
 }
 
+//===--------------------------------------------------------------------===//
+// Bulk Loading
+//===--------------------------------------------------------------------===//
+//! The size of the blocks that hold the keys of the build entries
+static constexpr index_t BUILD_KEY_BLOCK_SIZE = 262144;
+
+data_ptr_t ARTBuildState::AllocateKey(index_t length) {
+	if (length > key_remaining) {
+		// the key does not fit in the current block: start a new one (big keys get a block of their own)
+		auto block_size = std::max(length, BUILD_KEY_BLOCK_SIZE);
+		key_blocks.push_back(unique_ptr<data_t[]>(new data_t[block_size]));
+		key_position = key_blocks.back().get();
+		key_remaining = block_size;
+	}
+	auto result = key_position;
+	key_position += length;
+	key_remaining -= length;
+	return result;
+}
+
+void ART::BuildAppend(DataChunk &input, Vector &row_ids) {
+	assert(row_ids.type == ROW_TYPE);
+	assert(input.size() == row_ids.count);
+	assert(input.column_count == types.size());
+	assert(!tree);
+	if (!build_state) {
+		build_state = make_unique<ARTBuildState>();
+	}
+	index_t count = input.size();
+	index_t key_lengths[STANDARD_VECTOR_SIZE];
+	bool has_null[STANDARD_VECTOR_SIZE];
+	ComputeKeyLengths(input, key_lengths, has_null);
+
+	// the keys are encoded directly into the key blocks
+	auto row_identifiers = (row_t *)row_ids.data;
+	index_t first_entry = build_state->entries.size();
+	data_ptr_t key_data[STANDARD_VECTOR_SIZE];
+	for (index_t k = 0; k < count; k++) {
+		if (has_null[k]) {
+			key_data[k] = nullptr;
+			continue;
+		}
+		ARTBuildEntry entry;
+		entry.key = key_data[k] = build_state->AllocateKey(key_lengths[k]);
+		entry.length = key_lengths[k];
+		entry.row_id = row_identifiers[row_ids.sel_vector ? row_ids.sel_vector[k] : k];
+		build_state->entries.push_back(entry);
+	}
+	EncodeKeys(input, key_data, is_little_endian);
+
+	// now that the keys are encoded, fill in the prefixes of the new entries
+	auto &entries = build_state->entries;
+	for (index_t i = first_entry; i < entries.size(); i++) {
+		uint64_t prefix = 0;
+		for (index_t j = 0; j < sizeof(uint64_t); j++) {
+			prefix = (prefix << 8) | (j < entries[i].length ? entries[i].key[j] : 0);
+		}
+		entries[i].prefix = prefix;
+	}
+}
+
+static bool CompareBuildEntries(const ARTBuildEntry &a, const ARTBuildEntry &b) {
+	if (a.prefix != b.prefix) {
+		return a.prefix < b.prefix;
+	}
+	// no key is a prefix of another key: keys of at most 8 bytes with the same prefix are equal
+	if (a.length > sizeof(uint64_t) || b.length > sizeof(uint64_t)) {
+		auto min_length = std::min(a.length, b.length);
+		assert(min_length > sizeof(uint64_t));
+		auto cmp = memcmp(a.key + sizeof(uint64_t), b.key + sizeof(uint64_t), min_length - sizeof(uint64_t));
+		if (cmp != 0) {
+			return cmp < 0;
+		}
+		if (a.length != b.length) {
+			return a.length < b.length;
+		}
+	}
+	return a.row_id < b.row_id;
+}
+
+//! Sort the entries by their key. Partitions of the entries are sorted in parallel, after which the sorted partitions
+//! are merged pairwise (again in parallel).
+static void SortBuildEntries(vector<ARTBuildEntry> &entries, TaskScheduler &scheduler) {
+	index_t partition_count = std::min(scheduler.NumberOfThreads(), entries.size() / ART::BUILD_PARTITION_SIZE);
+	if (partition_count <= 1) {
+		sort(entries.begin(), entries.end(), CompareBuildEntries);
+		return;
+	}
+	vector<index_t> bounds;
+	for (index_t i = 0; i <= partition_count; i++) {
+		bounds.push_back(entries.size() * i / partition_count);
+	}
+	auto begin = entries.begin();
+	scheduler.ExecuteParallel(partition_count, [&](index_t partition) {
+		sort(begin + bounds[partition], begin + bounds[partition + 1], CompareBuildEntries);
+	});
+	// merge sequences of width sorted partitions, until all the entries are sorted
+	for (index_t width = 1; width < partition_count; width *= 2) {
+		index_t merge_count = (partition_count + 2 * width - 1) / (2 * width);
+		scheduler.ExecuteParallel(merge_count, [&](index_t merge) {
+			auto first = bounds[2 * merge * width];
+			auto middle = bounds[std::min((2 * merge + 1) * width, partition_count)];
+			auto last = bounds[std::min((2 * merge + 2) * width, partition_count)];
+			inplace_merge(begin + first, begin + middle, begin + last, CompareBuildEntries);
+		});
+	}
+}
+
+//! Construct the (sub)tree of the sorted entries, of which the keys share their first depth bytes
+static unique_ptr<Node> BuildNode(ART &art, ARTBuildEntry entries[], index_t count, index_t depth) {
+	auto &first = entries[0];
+	auto &last = entries[count - 1];
+	// since the entries are sorted, the common prefix of the first and the last key is shared by all the keys
+	index_t prefix_end = depth;
+	index_t min_length = std::min(first.length, last.length);
+	while (prefix_end < min_length && first.key[prefix_end] == last.key[prefix_end]) {
+		prefix_end++;
+	}
+	if (prefix_end == min_length) {
+		// no key is a prefix of another key: all the entries have the same key, and form a single leaf
+		assert(first.length == last.length);
+		auto key_data = unique_ptr<data_t[]>(new data_t[first.length]);
+		memcpy(key_data.get(), first.key, first.length);
+		auto row_ids = unique_ptr<row_t[]>(new row_t[count]);
+		for (index_t i = 0; i < count; i++) {
+			row_ids[i] = entries[i].row_id;
+		}
+		return make_unique<Leaf>(art, make_unique<Key>(move(key_data), first.length), move(row_ids), count);
+	}
+
+	// the entries are grouped by the byte that follows the prefix: every group becomes a child of the node
+	index_t child_count = 1;
+	for (index_t i = 1; i < count; i++) {
+		if (entries[i].key[prefix_end] != entries[i - 1].key[prefix_end]) {
+			child_count++;
+		}
+	}
+	unique_ptr<Node> node;
+	if (child_count <= 4) {
+		node = make_unique<Node4>(art);
+	} else if (child_count <= 16) {
+		node = make_unique<Node16>(art);
+	} else if (child_count <= 48) {
+		node = make_unique<Node48>(art);
+	} else {
+		node = make_unique<Node256>(art);
+	}
+	node->SetPrefix(first.key + depth, prefix_end - depth);
+	index_t group_start = 0;
+	for (index_t i = 1; i <= count; i++) {
+		if (i == count || entries[i].key[prefix_end] != entries[group_start].key[prefix_end]) {
+			auto child = BuildNode(art, entries + group_start, i - group_start, prefix_end + 1);
+			Node::AppendChild(*node, entries[group_start].key[prefix_end], move(child));
+			group_start = i;
+		}
+	}
+	return node;
+}
+
+void ART::FinalizeBuild(TaskScheduler &scheduler) {
+	assert(!tree);
+	if (!build_state) {
+		// the table is empty
+		return;
+	}
+	auto &entries = build_state->entries;
+	if (entries.size() > 0) {
+		SortBuildEntries(entries, scheduler);
+		tree = BuildNode(*this, entries.data(), entries.size(), 0);
+	}
+	build_state.reset();
+}
+
+//===--------------------------------------------------------------------===//
+// Serialization
+//===--------------------------------------------------------------------===//
+BlockPointer ART::Serialize(MetaBlockWriter &writer) {
+	ExclusiveARTLock l(*this);
+	if (!tree) {
+		return BlockPointer{INVALID_BLOCK, 0};
+	}
+	return Node::Serialize(*this, tree, writer);
+}
+
+void ART::Load(BlockPointer root) {
+	assert(!tree);
+	if (root.block_id != INVALID_BLOCK) {
+		tree = Node::Deserialize(*this, root);
+	}
+}
+
 //===--------------------------------------------------------------------===//
 // Delete
 //===--------------------------------------------------------------------===//
 void ART::Delete(DataChunk &input, Vector &row_ids) {
-	lock_guard<mutex> l(lock);
+	ExclusiveARTLock l(*this);
 
 	// first resolve the expressions
 	ExecuteExpressions(input, expression_result);
@@ -267,6 +645,26 @@ void ART::Delete(DataChunk &input, Vector &row_ids) {
 	});
 }
 
+void ART::Delete(DataChunk &input, DataChunk &remaining_input, Vector &row_ids) {
+	assert(input.size() == row_ids.count && remaining_input.size() == row_ids.count);
+	ExclusiveARTLock l(*this);
+
+	vector<unique_ptr<Key>> keys, remaining_keys;
+	ExecuteExpressions(input, expression_result);
+	GenerateKeys(expression_result, keys);
+	ExecuteExpressions(remaining_input, expression_result);
+	GenerateKeys(expression_result, remaining_keys);
+
+	// the remaining version shares the entry if its key is the same
+	auto row_identifiers = GetRowIds(row_ids);
+	for (index_t k = 0; k < keys.size(); k++) {
+		if (!keys[k] || KeysEqual(keys[k].get(), remaining_keys[k].get())) {
+			continue;
+		}
+		Erase(tree, *keys[k], 0, row_identifiers[k]);
+	}
+}
+
 void ART::Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id) {
 	if (!node) {
 		return;
@@ -274,8 +672,12 @@ void ART::Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id)
 	// Delete a leaf from a tree
 	if (node->type == NodeType::NLeaf) {
 		// Make sure we have the right leaf
-		if (ART::LeafMatches(node.get(), key, depth)) {
-			node.reset();
+		auto leaf = static_cast<Leaf *>(node.get());
+		if (*leaf->value == key) {
+			leaf->Remove(row_id);
+			if (leaf->num_elements == 0) {
+				node.reset();
+			}
 		}
 		return;
 	}
@@ -287,20 +689,24 @@ void ART::Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id)
 		}
 		depth += node->prefix_length;
 	}
+	if (depth >= key.len) {
+		return;
+	}
 	index_t pos = node->GetChildPos(key[depth]);
 	if (pos != INVALID_INDEX) {
 		auto child = node->GetChild(pos);
 		assert(child);
 
 		unique_ptr<Node> &child_ref = *child;
-		if (child_ref->type == NodeType::NLeaf && LeafMatches(child_ref.get(), key, depth)) {
+		if (child_ref->type == NodeType::NLeaf) {
 			// Leaf found, remove entry
 			auto leaf = static_cast<Leaf *>(child_ref.get());
-			if (leaf->num_elements > 1) {
-				// leaf has multiple rows: remove the row from the leaf
-				leaf->Remove(row_id);
-			} else {
-				// Leaf only has one element, delete leaf, decrement node counter and maybe shrink node
+			if (!(*leaf->value == key)) {
+				return;
+			}
+			leaf->Remove(row_id);
+			if (leaf->num_elements == 0) {
+				// Leaf has no rows left, delete leaf, decrement node counter and maybe shrink node
 				Node::Erase(*this, node, pos);
 			}
 		} else {
@@ -315,23 +721,11 @@ void ART::Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id)
 //===--------------------------------------------------------------------===//
 static unique_ptr<Key> CreateKey(ART &art, TypeId type, Value &value) {
 	assert(type == value.type);
-	switch (type) {
-	case TypeId::TINYINT:
-		return Key::CreateKey<int8_t>(value.value_.tinyint, art.is_little_endian);
-	case TypeId::SMALLINT:
-		return Key::CreateKey<int16_t>(value.value_.smallint, art.is_little_endian);
-	case TypeId::INTEGER:
-		return Key::CreateKey<int32_t>(value.value_.integer, art.is_little_endian);
-	case TypeId::BIGINT:
-		return Key::CreateKey<int64_t>(value.value_.bigint, art.is_little_endian);
-	default:
-		throw InvalidTypeException(type, "Invalid type for index");
-	}
-}
-
-void ART::SearchEqual(vector<row_t> &result_ids, ARTIndexScanState *state) {
-	unique_ptr<Key> key = CreateKey(*this, types[0], state->values[0]);
-	auto leaf = static_cast<Leaf *>(Lookup(tree, *key, 0));
+	return Key::CreateKey(vector<Value>{value}, art.is_little_endian);
+}
+
+void ART::SearchEqual(vector<row_t> &result_ids, Key &key) {
+	auto leaf = static_cast<Leaf *>(Lookup(tree, key, 0));
 	if (!leaf) {
 		return;
 	}
@@ -341,41 +735,45 @@ void ART::SearchEqual(vector<row_t> &result_ids, ARTIndexScanState *state) {
 	}
 }
 
+void ART::LookupKeys(DataChunk &input, vector<index_t> &result_rows, vector<row_t> &result_ids) {
+	assert(input.column_count == types.size());
+	vector<unique_ptr<Key>> keys;
+	GenerateKeys(input, keys);
+
+	auto result_count = result_ids.size();
+	auto lookup = [&]() {
+		for (index_t k = 0; k < keys.size(); k++) {
+			if (!keys[k]) {
+				continue;
+			}
+			auto leaf = static_cast<Leaf *>(Lookup(tree, *keys[k], 0));
+			if (!leaf) {
+				continue;
+			}
+			for (index_t i = 0; i < leaf->num_elements; i++) {
+				result_rows.push_back(k);
+				result_ids.push_back(leaf->GetRowId(i));
+			}
+		}
+	};
+	ExecuteRead(lookup, [&]() {
+		result_rows.resize(result_count);
+		result_ids.resize(result_count);
+	});
+}
+
 Node *ART::Lookup(unique_ptr<Node> &node, Key &key, unsigned depth) {
-	bool skippedPrefix = false; // Did we optimistically skip some prefix without checking it?
 	auto node_val = node.get();
 
 	while (node_val) {
 		if (node_val->type == NodeType::NLeaf) {
-			if (!skippedPrefix && depth == maxPrefix) {
-				// No check required
-				return node_val;
-			}
-
-			if (depth != maxPrefix) {
-				// Check leaf
-				auto leaf = static_cast<Leaf *>(node_val);
-				Key &leafKey = *leaf->value;
-				for (index_t i = (skippedPrefix ? 0 : depth); i < maxPrefix; i++) {
-					if (leafKey[i] != key[i]) {
-						return nullptr;
-					}
-				}
-			}
-			return node_val;
+			// the prefixes on the path to the leaf were skipped: compare the entire key
+			auto leaf = static_cast<Leaf *>(node_val);
+			return *leaf->value == key ? node_val : nullptr;
 		}
-
-		if (node_val->prefix_length) {
-			if (node_val->prefix_length < maxPrefix) {
-				for (index_t pos = 0; pos < node_val->prefix_length; pos++) {
-					if (key[depth + pos] != node_val->prefix[pos]) {
-						return nullptr;
-					}
-				}
-			} else {
-				skippedPrefix = true;
-			}
-			depth += node_val->prefix_length;
+		depth += node_val->prefix_length;
+		if (depth >= key.len) {
+			return nullptr;
 		}
 		index_t pos = node_val->GetChildPos(key[depth]);
 		if (pos == INVALID_INDEX) {
@@ -438,9 +836,7 @@ bool ART::IteratorNext(Iterator &it) {
 		top.pos = node->GetNextPos(top.pos);
 		if (top.pos != INVALID_INDEX) {
 			// next node found: go there
-			it.stack[it.depth].node = node->GetChild(top.pos)->get();
-			it.stack[it.depth].pos = INVALID_INDEX;
-			it.depth++;
+			it.Push(node->GetChild(top.pos)->get(), INVALID_INDEX);
 		} else {
 			// no node found: move up the tree
 			it.depth--;
@@ -452,6 +848,17 @@ bool ART::IteratorNext(Iterator &it) {
 //===--------------------------------------------------------------------===//
 // Greater Than
 //===--------------------------------------------------------------------===//
+static Leaf &FindMinimum(Iterator &it, Node &node) {
+	if (node.type == NodeType::NLeaf) {
+		it.node = (Leaf *)&node;
+		return (Leaf &)node;
+	}
+	// the first child of the node contains the minimum
+	auto pos = node.GetNextPos(INVALID_INDEX);
+	it.Push(&node, pos);
+	return FindMinimum(it, *node.GetChild(pos)->get());
+}
+
 bool ART::Bound(unique_ptr<Node> &n, Key &key, Iterator &it, bool inclusive) {
 	it.depth = 0;
 	if (!n) {
@@ -461,52 +868,51 @@ bool ART::Bound(unique_ptr<Node> &n, Key &key, Iterator &it, bool inclusive) {
 
 	index_t depth = 0;
 	while (true) {
-		auto &top = it.stack[it.depth];
-		top.node = node;
-		it.depth++;
+		auto &top = it.Push(node, 0);
 
 		if (node->type == NodeType::NLeaf) {
 			// found a leaf node: check if it is bigger than the current key
 			auto leaf = static_cast<Leaf *>(node);
 			it.node = leaf;
-			if (key > *leaf->value) {
-				// the key is bigger than the min_key
-				// in this case there are no keys in the set that are bigger than key
-				// thus we terminate
-				return false;
-			}
-			// if the search is not inclusive the leaf node could still be equal to the current value
-			// check if leaf is equal to the current key
-			if (!inclusive && *leaf->value == key) {
-				// leaf is equal: move to next node
-				if (!IteratorNext(it)) {
-					return false;
-				}
+			if (key > *leaf->value || (!inclusive && *leaf->value == key)) {
+				// the leaf does not satisfy the predicate, but the leaves following it do
+				return IteratorNext(it);
 			}
 			return true;
 		}
-		uint32_t mismatchPos = Node::PrefixMismatch(*this, node, key, depth);
-		if (mismatchPos != node->prefix_length) {
-			if (node->prefix[mismatchPos] < key[depth + mismatchPos]) {
-				// Less
+		uint32_t mismatch_pos = Node::PrefixMismatch(*this, node, key, depth);
+		if (mismatch_pos != node->prefix_length) {
+			if (depth + mismatch_pos < key.len && node->prefix[mismatch_pos] < key[depth + mismatch_pos]) {
+				// Less: all the keys in this node are smaller than the key
 				it.depth--;
 				return IteratorNext(it);
 			} else {
-				// Greater
+				// Greater: all the keys in this node are bigger than the key
 				top.pos = INVALID_INDEX;
 				return IteratorNext(it);
 			}
 		}
 		// prefix matches, search inside the child for the key
 		depth += node->prefix_length;
-
-		top.pos = node->GetChildGreaterEqual(key[depth]);
+		if (depth < key.len) {
+			top.pos = node->GetChildPos(key[depth]);
+			if (top.pos != INVALID_INDEX) {
+				node = node->GetChild(top.pos)->get();
+				depth++;
+				continue;
+			}
+			top.pos = node->GetChildGreaterEqual(key[depth]);
+		} else {
+			top.pos = node->GetNextPos(INVALID_INDEX);
+		}
 		if (top.pos == INVALID_INDEX) {
-			// no node that is >= to the current node: abort
-			return false;
+			// all the keys in this node are smaller than the key: move to the next node
+			it.depth--;
+			return IteratorNext(it);
 		}
-		node = node->GetChild(top.pos)->get();
-		depth++;
+		// all the keys in the child are bigger than the key: start at its minimum
+		FindMinimum(it, *node->GetChild(top.pos)->get());
+		return true;
 	}
 }
 
@@ -531,42 +937,6 @@ void ART::SearchGreater(vector<row_t> &result_ids, ARTIndexScanState *state, boo
 //===--------------------------------------------------------------------===//
 // Less Than
 //===--------------------------------------------------------------------===//
-static Leaf &FindMinimum(Iterator &it, Node &node) {
-	Node *next = nullptr;
-	index_t pos = 0;
-	switch (node.type) {
-	case NodeType::NLeaf:
-		it.node = (Leaf *)&node;
-		return (Leaf &)node;
-	case NodeType::N4:
-		next = ((Node4 &)node).child[0].get();
-		break;
-	case NodeType::N16:
-		next = ((Node16 &)node).child[0].get();
-		break;
-	case NodeType::N48: {
-		auto &n48 = (Node48 &)node;
-		while (n48.childIndex[pos] == Node::EMPTY_MARKER) {
-			pos++;
-		}
-		next = n48.child[n48.childIndex[pos]].get();
-		break;
-	}
-	case NodeType::N256: {
-		auto &n256 = (Node256 &)node;
-		while (!n256.child[pos]) {
-			pos++;
-		}
-		next = n256.child[pos].get();
-		break;
-	}
-	}
-	it.stack[it.depth].node = &node;
-	it.stack[it.depth].pos = pos;
-	it.depth++;
-	return FindMinimum(it, *next);
-}
-
 void ART::SearchLess(vector<row_t> &result_ids, ARTIndexScanState *state, bool inclusive) {
 	if (!tree) {
 		return;
@@ -616,44 +986,54 @@ void ART::SearchCloseRange(vector<row_t> &result_ids, ARTIndexScanState *state,
 	}
 }
 
+void ART::Search(ARTIndexScanState *state, vector<row_t> &result_ids) {
+	if (!state->equal_values.empty()) {
+		// equality predicate on all the expressions of the index
+		auto key = Key::CreateKey(state->equal_values, is_little_endian);
+		SearchEqual(result_ids, *key);
+	} else if (state->values[1].is_null) {
+		// single predicate
+		switch (state->expressions[0]) {
+		case ExpressionType::COMPARE_EQUAL: {
+			auto key = CreateKey(*this, types[0], state->values[0]);
+			SearchEqual(result_ids, *key);
+			break;
+		}
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			SearchGreater(result_ids, state, true);
+			break;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			SearchGreater(result_ids, state, false);
+			break;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			SearchLess(result_ids, state, true);
+			break;
+		case ExpressionType::COMPARE_LESSTHAN:
+			SearchLess(result_ids, state, false);
+			break;
+		default:
+			throw NotImplementedException("Operation not implemented");
+		}
+	} else {
+		// two predicates
+		assert(state->values[1].type == types[0]);
+		bool left_inclusive = state->expressions[0] == ExpressionType ::COMPARE_GREATERTHANOREQUALTO;
+		bool right_inclusive = state->expressions[1] == ExpressionType ::COMPARE_LESSTHANOREQUALTO;
+		SearchCloseRange(result_ids, state, left_inclusive, right_inclusive);
+	}
+}
+
 void ART::Scan(Transaction &transaction, IndexScanState *ss, DataChunk &result) {
 	auto state = (ARTIndexScanState *)ss;
 
 	// scan the index
 	if (!state->checked) {
 		vector<row_t> result_ids;
-		assert(state->values[0].type == types[0]);
-
-		if (state->values[1].is_null) {
-			lock_guard<mutex> l(lock);
-			// single predicate
-			switch (state->expressions[0]) {
-			case ExpressionType::COMPARE_EQUAL:
-				SearchEqual(result_ids, state);
-				break;
-			case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
-				SearchGreater(result_ids, state, true);
-				break;
-			case ExpressionType::COMPARE_GREATERTHAN:
-				SearchGreater(result_ids, state, false);
-				break;
-			case ExpressionType::COMPARE_LESSTHANOREQUALTO:
-				SearchLess(result_ids, state, true);
-				break;
-			case ExpressionType::COMPARE_LESSTHAN:
-				SearchLess(result_ids, state, false);
-				break;
-			default:
-				throw NotImplementedException("Operation not implemented");
-			}
-		} else {
-			lock_guard<mutex> l(lock);
-			// two predicates
-			assert(state->values[1].type == types[0]);
-			bool left_inclusive = state->expressions[0] == ExpressionType ::COMPARE_GREATERTHANOREQUALTO;
-			bool right_inclusive = state->expressions[1] == ExpressionType ::COMPARE_LESSTHANOREQUALTO;
-			SearchCloseRange(result_ids, state, left_inclusive, right_inclusive);
-		}
+		ExecuteRead([&]() { Search(state, result_ids); },
+		            [&]() {
+			            result_ids.clear();
+			            state->iterator = Iterator();
+		            });
 		state->checked = true;
 
 		if (result_ids.size() == 0) {
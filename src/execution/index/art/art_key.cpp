@@ -2,6 +2,7 @@
 #include "execution/index/art/art.hpp"
 
 using namespace duckdb;
+using namespace std;
 
 //! these are optimized and assume a particular byte order
 #define BSWAP16(x) ((uint16_t)((((uint16_t)(x)&0xff00) >> 8) | (((uint16_t)(x)&0x00ff) << 8)))
@@ -23,38 +24,108 @@ static uint8_t FlipSign(uint8_t key_byte) {
 Key::Key(unique_ptr<data_t[]> data, index_t len) : len(len), data(move(data)) {
 }
 
-template <> unique_ptr<data_t[]> Key::CreateData(int8_t value, bool is_little_endian) {
-	auto data = unique_ptr<data_t[]>(new data_t[sizeof(value)]);
-	reinterpret_cast<uint8_t *>(data.get())[0] = value;
+template <class T> static void Store(data_ptr_t data, T value) {
+	memcpy(data, &value, sizeof(T));
+}
+
+template <> void Key::EncodeData(data_ptr_t data, bool value, bool is_little_endian) {
+	data[0] = value ? 1 : 0;
+}
+
+template <> void Key::EncodeData(data_ptr_t data, int8_t value, bool is_little_endian) {
+	Store<uint8_t>(data, value);
 	data[0] = FlipSign(data[0]);
-	return data;
 }
 
-template <> unique_ptr<data_t[]> Key::CreateData(int16_t value, bool is_little_endian) {
-	auto data = unique_ptr<data_t[]>(new data_t[sizeof(value)]);
-	reinterpret_cast<uint16_t *>(data.get())[0] = is_little_endian ? BSWAP16(value) : value;
+template <> void Key::EncodeData(data_ptr_t data, int16_t value, bool is_little_endian) {
+	Store<uint16_t>(data, is_little_endian ? BSWAP16(value) : value);
 	data[0] = FlipSign(data[0]);
-	return data;
 }
 
-template <> unique_ptr<data_t[]> Key::CreateData(int32_t value, bool is_little_endian) {
-	auto data = unique_ptr<data_t[]>(new data_t[sizeof(value)]);
-	reinterpret_cast<uint32_t *>(data.get())[0] = is_little_endian ? BSWAP32(value) : value;
+template <> void Key::EncodeData(data_ptr_t data, int32_t value, bool is_little_endian) {
+	Store<uint32_t>(data, is_little_endian ? BSWAP32(value) : value);
 	data[0] = FlipSign(data[0]);
-	return data;
 }
 
-template <> unique_ptr<data_t[]> Key::CreateData(int64_t value, bool is_little_endian) {
-	auto data = unique_ptr<data_t[]>(new data_t[sizeof(value)]);
-	reinterpret_cast<uint64_t *>(data.get())[0] = is_little_endian ? BSWAP64(value) : value;
+template <> void Key::EncodeData(data_ptr_t data, int64_t value, bool is_little_endian) {
+	Store<uint64_t>(data, is_little_endian ? BSWAP64(value) : value);
 	data[0] = FlipSign(data[0]);
-	return data;
+}
+
+//! The bits of a positive floating point number are ordered like an unsigned integer. Flipping the sign bit of
+//! positive numbers and all bits of negative numbers gives an unsigned integer that is ordered like the number.
+template <class T, class BITS> static BITS EncodeFloatingPoint(T value) {
+	const BITS sign_bit = BITS(1) << (sizeof(BITS) * 8 - 1);
+	if (value == 0) {
+		// 0.0 and -0.0 are equal, and are encoded the same
+		return sign_bit;
+	}
+	BITS bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return (bits & sign_bit) ? ~bits : bits | sign_bit;
+}
+
+template <> void Key::EncodeData(data_ptr_t data, float value, bool is_little_endian) {
+	uint32_t bits = EncodeFloatingPoint<float, uint32_t>(value);
+	Store<uint32_t>(data, is_little_endian ? BSWAP32(bits) : bits);
+}
+
+template <> void Key::EncodeData(data_ptr_t data, double value, bool is_little_endian) {
+	uint64_t bits = EncodeFloatingPoint<double, uint64_t>(value);
+	Store<uint64_t>(data, is_little_endian ? BSWAP64(bits) : bits);
+}
+
+void Key::EncodeString(data_ptr_t data, const char *value) {
+	memcpy(data, value, strlen(value) + 1);
 }
 
 template <> unique_ptr<Key> Key::CreateKey(string value, bool is_little_endian) {
 	index_t len = value.size() + 1;
 	auto data = unique_ptr<data_t[]>(new data_t[len]);
-	memcpy(data.get(), value.c_str(), len);
+	EncodeString(data.get(), value.c_str());
+	return make_unique<Key>(move(data), len);
+}
+
+unique_ptr<Key> Key::CreateKey(const vector<Value> &values, bool is_little_endian) {
+	index_t len = 0;
+	for (auto &value : values) {
+		len += value.type == TypeId::VARCHAR ? value.str_value.size() + 1 : GetTypeIdSize(value.type);
+	}
+	auto data = unique_ptr<data_t[]>(new data_t[len]);
+	auto ptr = data.get();
+	for (auto &value : values) {
+		assert(!value.is_null);
+		switch (value.type) {
+		case TypeId::BOOLEAN:
+			EncodeData<bool>(ptr, value.value_.boolean, is_little_endian);
+			break;
+		case TypeId::TINYINT:
+			EncodeData<int8_t>(ptr, value.value_.tinyint, is_little_endian);
+			break;
+		case TypeId::SMALLINT:
+			EncodeData<int16_t>(ptr, value.value_.smallint, is_little_endian);
+			break;
+		case TypeId::INTEGER:
+			EncodeData<int32_t>(ptr, value.value_.integer, is_little_endian);
+			break;
+		case TypeId::BIGINT:
+			EncodeData<int64_t>(ptr, value.value_.bigint, is_little_endian);
+			break;
+		case TypeId::FLOAT:
+			EncodeData<float>(ptr, value.value_.float_, is_little_endian);
+			break;
+		case TypeId::DOUBLE:
+			EncodeData<double>(ptr, value.value_.double_, is_little_endian);
+			break;
+		case TypeId::VARCHAR:
+			EncodeString(ptr, value.str_value.c_str());
+			ptr += value.str_value.size() + 1;
+			continue;
+		default:
+			throw InvalidTypeException(value.type, "Invalid type for index");
+		}
+		ptr += GetTypeIdSize(value.type);
+	}
 	return make_unique<Key>(move(data), len);
 }
 
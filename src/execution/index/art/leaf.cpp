@@ -1,5 +1,6 @@
 #include "execution/index/art/node.hpp"
 #include "execution/index/art/leaf.hpp"
+#include "storage/meta_block_writer.hpp"
 
 Leaf::Leaf(ART &art, unique_ptr<Key> value, row_t row_id) : Node(art, NodeType::NLeaf) {
 	this->value = move(value);
@@ -9,6 +10,15 @@ Leaf::Leaf(ART &art, unique_ptr<Key> value, row_t row_id) : Node(art, NodeType::
 	this->num_elements = 1;
 }
 
+Leaf::Leaf(ART &art, unique_ptr<Key> value, unique_ptr<row_t[]> row_ids, index_t num_elements)
+    : Node(art, NodeType::NLeaf) {
+	assert(num_elements > 0);
+	this->value = move(value);
+	this->capacity = num_elements;
+	this->row_ids = move(row_ids);
+	this->num_elements = num_elements;
+}
+
 void Leaf::Insert(row_t row_id) {
 	// Grow array
 	if (num_elements == capacity) {
@@ -22,15 +32,38 @@ void Leaf::Insert(row_t row_id) {
 
 //! TODO: Maybe shrink array dynamically?
 void Leaf::Remove(row_t row_id) {
-	index_t entry_offset = -1;
+	index_t entry_offset = INVALID_INDEX;
 	for (index_t i = 0; i < num_elements; i++) {
 		if (row_ids[i] == row_id) {
 			entry_offset = i;
 			break;
 		}
 	}
+	if (entry_offset == INVALID_INDEX) {
+		return;
+	}
 	num_elements--;
 	for (index_t j = entry_offset; j < num_elements; j++) {
 		row_ids[j] = row_ids[j + 1];
 	}
 }
+
+BlockPointer Leaf::Serialize(MetaBlockWriter &writer) {
+	auto pointer = writer.GetBlockPointer();
+	writer.Write<uint8_t>((uint8_t)NodeType::NLeaf);
+	writer.Write<index_t>(value->len);
+	writer.WriteData(value->data.get(), value->len);
+	writer.Write<index_t>(num_elements);
+	writer.WriteData((const_data_ptr_t)row_ids.get(), num_elements * sizeof(row_t));
+	return pointer;
+}
+
+unique_ptr<Leaf> Leaf::Deserialize(ART &art, Deserializer &source) {
+	auto key_length = source.Read<index_t>();
+	auto key_data = unique_ptr<data_t[]>(new data_t[key_length]);
+	source.ReadData(key_data.get(), key_length);
+	auto num_elements = source.Read<index_t>();
+	auto row_ids = unique_ptr<row_t[]>(new row_t[num_elements]);
+	source.ReadData((data_ptr_t)row_ids.get(), num_elements * sizeof(row_t));
+	return make_unique<Leaf>(art, make_unique<Key>(move(key_data), key_length), move(row_ids), num_elements);
+}
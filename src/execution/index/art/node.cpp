@@ -1,16 +1,27 @@
 #include "execution/index/art/node.hpp"
 #include "execution/index/art/art.hpp"
 #include "common/exception.hpp"
+#include "storage/meta_block_reader.hpp"
+#include "storage/meta_block_writer.hpp"
+#include "storage/storage_manager.hpp"
 
 using namespace duckdb;
 
 Node::Node(ART &art, NodeType type) : prefix_length(0), count(0), type(type) {
-	this->prefix = unique_ptr<uint8_t[]>(new uint8_t[art.maxPrefix]);
+}
+
+void Node::SetPrefix(const uint8_t *data, uint32_t length) {
+	unique_ptr<uint8_t[]> new_prefix;
+	if (length > 0) {
+		new_prefix = unique_ptr<uint8_t[]>(new uint8_t[length]);
+		memcpy(new_prefix.get(), data, length);
+	}
+	prefix = move(new_prefix);
+	prefix_length = length;
 }
 
 void Node::CopyPrefix(ART &art, Node *src, Node *dst) {
-	dst->prefix_length = src->prefix_length;
-	memcpy(dst->prefix.get(), src->prefix.get(), std::min(src->prefix_length, art.maxPrefix));
+	dst->SetPrefix(src->prefix.get(), src->prefix_length);
 }
 
 unique_ptr<Node> *Node::GetChild(index_t pos) {
@@ -20,15 +31,10 @@ unique_ptr<Node> *Node::GetChild(index_t pos) {
 
 uint32_t Node::PrefixMismatch(ART &art, Node *node, Key &key, uint64_t depth) {
 	uint64_t pos;
-	// TODO: node->prefix_length > node->max_prefix_length
-	if (node->prefix_length <= art.maxPrefix) {
-		for (pos = 0; pos < node->prefix_length; pos++) {
-			if (key[depth + pos] != node->prefix[pos]) {
-				return pos;
-			}
+	for (pos = 0; pos < node->prefix_length; pos++) {
+		if (depth + pos >= key.len || key[depth + pos] != node->prefix[pos]) {
+			return pos;
 		}
-	} else {
-		throw NotImplementedException("Operation not implemented");
 	}
 	return pos;
 }
@@ -74,3 +80,130 @@ void Node::Erase(ART &art, unique_ptr<Node> &node, index_t pos) {
 		break;
 	}
 }
+
+void Node::AppendChild(Node &node, uint8_t key_byte, unique_ptr<Node> child) {
+	switch (node.type) {
+	case NodeType::N4: {
+		auto &n4 = (Node4 &)node;
+		assert(n4.count < 4 && (n4.count == 0 || n4.key[n4.count - 1] < key_byte));
+		n4.key[n4.count] = key_byte;
+		n4.child[n4.count] = move(child);
+		break;
+	}
+	case NodeType::N16: {
+		auto &n16 = (Node16 &)node;
+		assert(n16.count < 16 && (n16.count == 0 || n16.key[n16.count - 1] < key_byte));
+		n16.key[n16.count] = key_byte;
+		n16.child[n16.count] = move(child);
+		break;
+	}
+	case NodeType::N48: {
+		auto &n48 = (Node48 &)node;
+		assert(n48.count < 48 && n48.childIndex[key_byte] == Node::EMPTY_MARKER);
+		n48.childIndex[key_byte] = n48.count;
+		n48.child[n48.count] = move(child);
+		break;
+	}
+	default: {
+		assert(node.type == NodeType::N256);
+		auto &n256 = (Node256 &)node;
+		assert(!n256.child[key_byte]);
+		n256.child[key_byte] = move(child);
+		break;
+	}
+	}
+	node.count++;
+}
+
+unique_ptr<Node> *Node::LoadChild(unique_ptr<Node> &child) {
+	if (child && child->type == NodeType::NPersistent) {
+		auto &persistent = (PersistentNode &)*child;
+		if (!persistent.art.locked_exclusively) {
+			// the index is shared with other readers, which might access the same child
+			throw ARTRestart();
+		}
+		child = Deserialize(persistent.art, persistent.pointer);
+	}
+	return &child;
+}
+
+//! Returns the key byte of the child at the given position of an inner node
+static uint8_t GetKeyByte(Node &node, index_t pos) {
+	switch (node.type) {
+	case NodeType::N4:
+		return ((Node4 &)node).key[pos];
+	case NodeType::N16:
+		return ((Node16 &)node).key[pos];
+	default:
+		// the position of a child of a Node48 or Node256 is its key byte
+		return pos;
+	}
+}
+
+BlockPointer Node::Serialize(ART &art, unique_ptr<Node> &node, MetaBlockWriter &writer) {
+	if (node->type == NodeType::NLeaf) {
+		return ((Leaf &)*node).Serialize(writer);
+	}
+	// first write the children, so the node can refer to their positions
+	vector<uint8_t> child_keys;
+	vector<BlockPointer> child_pointers;
+	for (index_t pos = node->GetNextPos(INVALID_INDEX); pos != INVALID_INDEX; pos = node->GetNextPos(pos)) {
+		child_keys.push_back(GetKeyByte(*node, pos));
+		child_pointers.push_back(Serialize(art, *node->GetChild(pos), writer));
+	}
+	assert(child_keys.size() == node->count);
+
+	// write the node: its type, its prefix and the key bytes and positions of its children
+	auto pointer = writer.GetBlockPointer();
+	writer.Write<uint8_t>((uint8_t)node->type);
+	writer.Write<uint32_t>(node->prefix_length);
+	writer.WriteData(node->prefix.get(), node->prefix_length);
+	writer.Write<uint16_t>(node->count);
+	for (index_t i = 0; i < child_keys.size(); i++) {
+		writer.Write<uint8_t>(child_keys[i]);
+		writer.Write<block_id_t>(child_pointers[i].block_id);
+		writer.Write<uint32_t>(child_pointers[i].offset);
+	}
+	return pointer;
+}
+
+unique_ptr<Node> Node::Deserialize(ART &art, BlockPointer pointer) {
+	MetaBlockReader reader(*art.table.storage.buffer_manager, pointer);
+	auto type = (NodeType)reader.Read<uint8_t>();
+	unique_ptr<Node> node;
+	switch (type) {
+	case NodeType::NLeaf:
+		return Leaf::Deserialize(art, reader);
+	case NodeType::N4:
+		node = make_unique<Node4>(art);
+		break;
+	case NodeType::N16:
+		node = make_unique<Node16>(art);
+		break;
+	case NodeType::N48:
+		node = make_unique<Node48>(art);
+		break;
+	case NodeType::N256:
+		node = make_unique<Node256>(art);
+		break;
+	default:
+		throw IOException("Corrupt index node in the database file");
+	}
+	auto prefix_length = reader.Read<uint32_t>();
+	if (prefix_length > 0) {
+		auto prefix = unique_ptr<uint8_t[]>(new uint8_t[prefix_length]);
+		reader.ReadData(prefix.get(), prefix_length);
+		node->prefix = move(prefix);
+		node->prefix_length = prefix_length;
+	}
+	// the children are placeholders, which are replaced by the actual nodes when they are accessed
+	auto child_count = reader.Read<uint16_t>();
+	for (index_t i = 0; i < child_count; i++) {
+		auto key_byte = reader.Read<uint8_t>();
+		BlockPointer child_pointer;
+		child_pointer.block_id = reader.Read<block_id_t>();
+		child_pointer.offset = reader.Read<uint32_t>();
+		AppendChild(*node, key_byte, make_unique<PersistentNode>(art, child_pointer));
+	}
+	return node;
+}
@@ -2,28 +2,52 @@
 #include "execution/index/art/node16.hpp"
 #include "execution/index/art/node48.hpp"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using namespace duckdb;
 
 Node16::Node16(ART &art) : Node(art, NodeType::N16) {
 	memset(key, 16, sizeof(key));
 }
 
-// TODO : In the future this can be performed using SIMD (#include <emmintrin.h>  x86 SSE intrinsics)
 index_t Node16::GetChildPos(uint8_t k) {
+#if defined(__SSE2__)
+	// compare the byte with all the keys at once, the keys beyond the count are masked out
+	auto matches = _mm_cmpeq_epi8(_mm_set1_epi8((char)k), _mm_loadu_si128((__m128i *)key));
+	int mask = _mm_movemask_epi8(matches) & ((1 << count) - 1);
+	if (mask) {
+		return __builtin_ctz(mask);
+	}
+#else
 	for (index_t pos = 0; pos < count; pos++) {
 		if (key[pos] == k) {
 			return pos;
 		}
 	}
+#endif
 	return Node::GetChildPos(k);
 }
 
 index_t Node16::GetChildGreaterEqual(uint8_t k) {
+#if defined(__SSE2__)
+	// SSE2 only compares signed bytes: flipping the sign bit of both sides gives the unsigned order. The keys are
+	// sorted, so the first key that is not smaller than the byte is the result.
+	auto sign = _mm_set1_epi8((char)0x80);
+	auto keys = _mm_xor_si128(_mm_loadu_si128((__m128i *)key), sign);
+	auto smaller = _mm_cmplt_epi8(keys, _mm_xor_si128(_mm_set1_epi8((char)k), sign));
+	int mask = ~_mm_movemask_epi8(smaller) & ((1 << count) - 1);
+	if (mask) {
+		return __builtin_ctz(mask);
+	}
+#else
 	for (index_t pos = 0; pos < count; pos++) {
 		if (key[pos] >= k) {
 			return pos;
 		}
 	}
+#endif
 	return Node::GetChildGreaterEqual(k);
 }
 
@@ -37,7 +61,7 @@ index_t Node16::GetNextPos(index_t pos) {
 
 unique_ptr<Node> *Node16::GetChild(index_t pos) {
 	assert(pos < count);
-	return &child[pos];
+	return LoadChild(child[pos]);
 }
 
 void Node16::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_ptr<Node> &child) {
@@ -74,16 +98,15 @@ void Node16::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_pt
 
 void Node16::erase(ART &art, unique_ptr<Node> &node, int pos) {
 	Node16 *n = static_cast<Node16 *>(node.get());
-	if (node->count > 3) {
-		// erase the child and decrease the count
-		n->child[pos].reset();
-		n->count--;
-		// potentially move any children backwards
-		for (; pos < n->count; pos++) {
-			n->key[pos] = n->key[pos + 1];
-			n->child[pos] = move(n->child[pos + 1]);
-		}
-	} else {
+	// erase the child and decrease the count
+	n->child[pos].reset();
+	n->count--;
+	// potentially move any children backwards
+	for (; pos < n->count; pos++) {
+		n->key[pos] = n->key[pos + 1];
+		n->child[pos] = move(n->child[pos + 1]);
+	}
+	if (n->count < 3) {
 		// Shrink node
 		auto newNode = make_unique<Node4>(art);
 		for (unsigned i = 0; i < n->count; i++) {
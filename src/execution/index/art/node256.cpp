@@ -34,7 +34,7 @@ index_t Node256::GetNextPos(index_t pos) {
 
 unique_ptr<Node> *Node256::GetChild(index_t pos) {
 	assert(child[pos]);
-	return &child[pos];
+	return LoadChild(child[pos]);
 }
 
 void Node256::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_ptr<Node> &child) {
@@ -46,11 +46,10 @@ void Node256::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_p
 
 void Node256::erase(ART &art, unique_ptr<Node> &node, int pos) {
 	Node256 *n = static_cast<Node256 *>(node.get());
-
-	if (node->count > 37) {
-		n->child[pos].reset();
-		n->count--;
-	} else {
+	n->child[pos].reset();
+	n->count--;
+	if (n->count < 37) {
+		// Shrink node
 		auto newNode = make_unique<Node48>(art);
 		CopyPrefix(art, n, newNode.get());
 		for (index_t i = 0; i < 256; i++) {
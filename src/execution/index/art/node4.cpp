@@ -36,7 +36,7 @@ index_t Node4::GetNextPos(index_t pos) {
 
 unique_ptr<Node> *Node4::GetChild(index_t pos) {
 	assert(pos < count);
-	return &child[pos];
+	return LoadChild(child[pos]);
 }
 
 void Node4::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_ptr<Node> &child) {
@@ -84,26 +84,22 @@ void Node4::erase(ART &art, unique_ptr<Node> &node, int pos) {
 		n->child[pos] = move(n->child[pos + 1]);
 	}
 
-	// This is a one way node
+	// This is a one way node: replace it with its only child
 	if (n->count == 1) {
-		auto childref = n->child[0].get();
-		if (childref->type == NodeType::NLeaf) {
-			// Concantenate prefixes
-			uint32_t l1 = childref->prefix_length;
-			if (l1 < art.maxPrefix) {
-				n->prefix[l1] = n->key[0];
-				l1++;
+		auto childref = n->GetChild(0)->get();
+		if (childref->type != NodeType::NLeaf) {
+			// the path to the child is the prefix of this node, the key byte of the child and the prefix of the child
+			uint32_t new_length = n->prefix_length + 1 + childref->prefix_length;
+			auto new_prefix = unique_ptr<uint8_t[]>(new uint8_t[new_length]);
+			if (n->prefix_length > 0) {
+				memcpy(new_prefix.get(), n->prefix.get(), n->prefix_length);
 			}
-			if (l1 < art.maxPrefix) {
-				uint32_t l2 = std::min(childref->prefix_length, art.maxPrefix - l1);
-				for (index_t i = 0; i < l2; i++) {
-					n->prefix[l1 + i] = childref->prefix[l2];
-				}
-				l1 += l2;
-			}
-			for (index_t i = 0; i < l1; i++) {
-				childref->prefix[i] = n->prefix[i];
+			new_prefix[n->prefix_length] = n->key[0];
+			if (childref->prefix_length > 0) {
+				memcpy(new_prefix.get() + n->prefix_length + 1, childref->prefix.get(), childref->prefix_length);
 			}
+			childref->prefix = move(new_prefix);
+			childref->prefix_length = new_length;
 		}
 		node = move(n->child[0]);
 	}
@@ -4,6 +4,10 @@
 #include "common/types/null_value.hpp"
 #include "common/types/static_vector.hpp"
 #include "common/vector_operations/vector_operations.hpp"
+#include "execution/spill_file.hpp"
+#include "execution/task_scheduler.hpp"
+
+#include <atomic>
 
 using namespace duckdb;
 using namespace std;
@@ -22,21 +26,21 @@ static void SerializeChunk(DataChunk &source, data_ptr_t targets[]) {
 	}
 }
 
-static void DeserializeChunk(DataChunk &result, data_ptr_t source[], index_t count) {
+static void DeserializeChunk(DataChunk &result, data_ptr_t source[], index_t count, bool set_null = false) {
 	Vector source_vector(TypeId::POINTER, (data_ptr_t)source);
 	source_vector.count = count;
 
 	index_t offset = 0;
 	for (index_t i = 0; i < result.column_count; i++) {
-		VectorOperations::Gather::Set(source_vector, result.data[i], false, offset);
+		VectorOperations::Gather::Set(source_vector, result.data[i], set_null, offset);
 		offset += GetTypeIdSize(result.data[i].type);
 	}
 }
 
 JoinHashTable::JoinHashTable(vector<JoinCondition> &conditions, vector<TypeId> build_types, JoinType type,
-                             index_t initial_capacity, bool parallel)
+                             index_t initial_capacity)
     : build_types(build_types), equality_size(0), condition_size(0), build_size(0), entry_size(0), tuple_size(0),
-      join_type(type), has_null(false), capacity(0), count(0), parallel(parallel) {
+      join_type(type), has_null(false), capacity(0), count(0) {
 	for (auto &condition : conditions) {
 		assert(condition.left->return_type == condition.right->return_type);
 		auto type = condition.left->return_type;
@@ -80,7 +84,7 @@ void JoinHashTable::ApplyBitmask(Vector &hashes) {
 	VectorOperations::Exec(hashes, [&](index_t i, index_t k) { indices[i] = indices[i] & bitmask; });
 }
 
-void JoinHashTable::InsertHashes(Vector &hashes, data_ptr_t key_locations[]) {
+void JoinHashTable::InsertHashes(Vector &hashes, data_ptr_t key_locations[], bool parallel) {
 	assert(hashes.type == TypeId::HASH);
 
 	// use bitmask to get position in array
@@ -88,6 +92,21 @@ void JoinHashTable::InsertHashes(Vector &hashes, data_ptr_t key_locations[]) {
 
 	auto pointers = hashed_pointers.get();
 	auto indices = (index_t *)hashes.data;
+	if (parallel) {
+		// other threads insert into the same hash map: link the entries into the chains using compare-and-swap
+		static_assert(sizeof(atomic<data_ptr_t>) == sizeof(data_ptr_t), "atomic pointers must be lock-free");
+		auto atomic_pointers = (atomic<data_ptr_t> *)pointers;
+		VectorOperations::Exec(hashes, [&](index_t i, index_t k) {
+			auto &bucket = atomic_pointers[indices[i]];
+			auto prev_pointer = (data_ptr_t *)(key_locations[i] + tuple_size);
+			auto head = bucket.load(memory_order_relaxed);
+			do {
+				*prev_pointer = head;
+			} while (!bucket.compare_exchange_weak(head, key_locations[i], memory_order_release,
+			                                       memory_order_relaxed));
+		});
+		return;
+	}
 	// now fill in the entries
 	VectorOperations::Exec(hashes, [&](index_t i, index_t k) {
 		auto index = indices[i];
@@ -195,54 +214,15 @@ static index_t CreateNotNullSelVector(DataChunk &keys, sel_t *not_null_sel_vecto
 	return result_count;
 }
 
-void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
-	assert(keys.size() == payload.size());
-	if (keys.size() == 0) {
-		return;
-	}
-	// resize at 50% capacity, also need to fit the entire vector
-	if (parallel) {
-		parallel_lock.lock();
-	}
-	if (count + keys.size() > capacity / 2) {
-		Resize(capacity * 2);
-	}
-	count += keys.size();
-	// move strings to the string heap
-	keys.MoveStringsToHeap(string_heap);
-	payload.MoveStringsToHeap(string_heap);
-
-	if (parallel) {
-		parallel_lock.unlock();
-	}
-
-	// for any columns for which null values are equal, fill the NullMask
-	assert(keys.column_count == null_values_are_equal.size());
+unique_ptr<JoinHashTable::Node> JoinHashTable::SerializeNode(DataChunk &keys, DataChunk &payload,
+                                                              data_ptr_t key_locations[], sel_t not_null_sel_vector[],
+                                                              bool &has_null) {
 	bool null_values_equal_for_all = true;
 	for (index_t i = 0; i < keys.column_count; i++) {
-		if (null_values_are_equal[i]) {
-			VectorOperations::FillNullMask(keys.data[i]);
-		} else {
+		if (!null_values_are_equal[i]) {
 			null_values_equal_for_all = false;
 		}
 	}
-	// special case: correlated mark join
-	if (join_type == JoinType::MARK && correlated_mark_join_info.correlated_types.size() > 0) {
-		auto &info = correlated_mark_join_info;
-		// Correlated MARK join
-		// for the correlated mark join we need to keep track of COUNT(*) and COUNT(COLUMN) for each of the correlated
-		// columns push into the aggregate hash table
-		assert(info.correlated_counts);
-		for (index_t i = 0; i < info.correlated_types.size(); i++) {
-			info.group_chunk.data[i].Reference(keys.data[i]);
-		}
-		info.payload_chunk.data[0].Reference(keys.data[info.correlated_types.size()]);
-		info.payload_chunk.data[1].Reference(keys.data[info.correlated_types.size()]);
-		info.payload_chunk.data[0].type = info.payload_chunk.data[1].type = TypeId::BIGINT;
-		info.payload_chunk.sel_vector = info.group_chunk.sel_vector = info.group_chunk.data[0].sel_vector;
-		info.correlated_counts->AddChunk(info.group_chunk, info.payload_chunk);
-	}
-	sel_t not_null_sel_vector[STANDARD_VECTOR_SIZE];
 	if (!null_values_equal_for_all) {
 		// if any columns are <<not>> supposed to have NULL values are equal:
 		// first create a selection vector of the non-null values in the keys
@@ -263,12 +243,11 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 			payload.sel_vector = keys.data[0].sel_vector;
 		}
 		if (not_null_count == 0) {
-			return;
+			return nullptr;
 		}
 	}
 
 	// get the locations of where to serialize the keys and payload columns
-	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
 	data_ptr_t tuple_locations[STANDARD_VECTOR_SIZE];
 	auto node = make_unique<Node>(entry_size, keys.size());
 	auto dataptr = node->data.get();
@@ -287,23 +266,147 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 	if (build_size > 0) {
 		SerializeChunk(payload, tuple_locations);
 	}
+	return node;
+}
+
+void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
+	assert(keys.size() == payload.size());
+	if (keys.size() == 0) {
+		return;
+	}
+	// resize at 50% capacity, also need to fit the entire vector
+	if (count + keys.size() > capacity / 2) {
+		Resize(capacity * 2);
+	}
+	count += keys.size();
+	// move strings to the string heap
+	keys.MoveStringsToHeap(string_heap);
+	payload.MoveStringsToHeap(string_heap);
+
+	// for any columns for which null values are equal, fill the NullMask
+	assert(keys.column_count == null_values_are_equal.size());
+	for (index_t i = 0; i < keys.column_count; i++) {
+		if (null_values_are_equal[i]) {
+			VectorOperations::FillNullMask(keys.data[i]);
+		}
+	}
+	// special case: correlated mark join
+	if (join_type == JoinType::MARK && correlated_mark_join_info.correlated_types.size() > 0) {
+		auto &info = correlated_mark_join_info;
+		// Correlated MARK join
+		// for the correlated mark join we need to keep track of COUNT(*) and COUNT(COLUMN) for each of the correlated
+		// columns push into the aggregate hash table
+		assert(info.correlated_counts);
+		for (index_t i = 0; i < info.correlated_types.size(); i++) {
+			info.group_chunk.data[i].Reference(keys.data[i]);
+		}
+		info.payload_chunk.data[0].Reference(keys.data[info.correlated_types.size()]);
+		info.payload_chunk.data[1].Reference(keys.data[info.correlated_types.size()]);
+		info.payload_chunk.data[0].type = info.payload_chunk.data[1].type = TypeId::BIGINT;
+		info.payload_chunk.sel_vector = info.group_chunk.sel_vector = info.group_chunk.data[0].sel_vector;
+		info.correlated_counts->AddChunk(info.group_chunk, info.payload_chunk);
+	}
+
+	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+	sel_t not_null_sel_vector[STANDARD_VECTOR_SIZE];
+	auto node = SerializeNode(keys, payload, key_locations, not_null_sel_vector, has_null);
+	if (!node) {
+		return;
+	}
 
 	// hash the keys and obtain an entry in the list
 	// note that we only hash the keys used in the equality comparison
 	StaticVector<uint64_t> hashes;
 	Hash(keys, hashes);
 
-	if (parallel) {
-		// obtain lock
-		parallel_lock.lock();
-	}
 	InsertHashes(hashes, key_locations);
 	// store the new node as the head
 	node->prev = move(head);
 	head = move(node);
-	if (parallel) {
-		parallel_lock.unlock();
+}
+
+void JoinHashTable::Build(LocalBuildState &local_state, DataChunk &keys, DataChunk &payload) {
+	assert(keys.size() == payload.size());
+	assert(join_type != JoinType::MARK || correlated_mark_join_info.correlated_types.size() == 0);
+	if (keys.size() == 0) {
+		return;
 	}
+	local_state.count += keys.size();
+	// move strings to the thread-local string heap
+	keys.MoveStringsToHeap(local_state.string_heap);
+	payload.MoveStringsToHeap(local_state.string_heap);
+
+	// for any columns for which null values are equal, fill the NullMask
+	assert(keys.column_count == null_values_are_equal.size());
+	for (index_t i = 0; i < keys.column_count; i++) {
+		if (null_values_are_equal[i]) {
+			VectorOperations::FillNullMask(keys.data[i]);
+		}
+	}
+
+	// serialize the tuples into the thread-local chain, the hashes are computed in Finalize
+	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+	sel_t not_null_sel_vector[STANDARD_VECTOR_SIZE];
+	auto node = SerializeNode(keys, payload, key_locations, not_null_sel_vector, local_state.has_null);
+	if (!node) {
+		return;
+	}
+	node->prev = move(local_state.head);
+	local_state.head = move(node);
+}
+
+void JoinHashTable::Finalize(vector<unique_ptr<LocalBuildState>> &local_states, TaskScheduler &scheduler) {
+	// first size the hash map for all the tuples, this only rehashes the tuples that are already in the HT
+	index_t new_count = count;
+	for (auto &local_state : local_states) {
+		new_count += local_state->count;
+	}
+	index_t new_capacity = capacity;
+	while (new_count > new_capacity / 2) {
+		new_capacity *= 2;
+	}
+	if (new_capacity > capacity) {
+		Resize(new_capacity);
+	}
+
+	// now move the thread-local chains into the HT
+	vector<Node *> nodes;
+	for (auto &local_state : local_states) {
+		while (local_state->head) {
+			auto node = move(local_state->head);
+			local_state->head = move(node->prev);
+			nodes.push_back(node.get());
+			node->prev = move(head);
+			head = move(node);
+		}
+		has_null = has_null || local_state->has_null;
+		string_heap.MergeHeap(local_state->string_heap);
+	}
+	count = new_count;
+
+	// finally insert the tuples of the nodes into the hash map in parallel
+	atomic<index_t> next_node(0);
+	scheduler.ExecuteParallel(nodes.size(), [&](index_t thread_index) {
+		DataChunk keys;
+		keys.Initialize(equality_types);
+		data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+
+		index_t node_index;
+		while ((node_index = next_node++) < nodes.size()) {
+			auto node = nodes[node_index];
+			auto dataptr = node->data.get();
+			for (index_t i = 0; i < node->count; i++) {
+				key_locations[i] = dataptr;
+				dataptr += entry_size;
+			}
+			// reconstruct the keys that are used in the equality comparison to compute the hashes
+			DeserializeChunk(keys, key_locations, node->count);
+			StaticVector<uint64_t> hashes;
+			keys.Hash(hashes);
+
+			InsertHashes(hashes, key_locations, true);
+		}
+	});
 }
 
 unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
@@ -360,6 +463,187 @@ unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
 	return ss;
 }
 
+index_t JoinHashTable::MemoryUsage() {
+	return count * entry_size + capacity * sizeof(data_ptr_t);
+}
+
+index_t JoinHashTable::MemoryUsage(index_t tuple_count) {
+	// the hash map is resized at 50% capacity
+	return tuple_count * (entry_size + 2 * sizeof(data_ptr_t));
+}
+
+vector<TypeId> JoinHashTable::GetSpillTypes() {
+	auto types = condition_types;
+	if (build_size > 0) {
+		types.insert(types.end(), build_types.begin(), build_types.end());
+	}
+	return types;
+}
+
+static void SetChunkSelection(DataChunk &chunk, sel_t *sel_vector, index_t count) {
+	chunk.sel_vector = sel_vector;
+	for (index_t i = 0; i < chunk.column_count; i++) {
+		chunk.data[i].sel_vector = sel_vector;
+		chunk.data[i].count = count;
+	}
+}
+
+void JoinHashTable::PartitionChunk(DataChunk &keys, DataChunk &input, vector<unique_ptr<SpillFile>> &partitions,
+                                   index_t depth) {
+	assert(partitions.size() == SPILL_PARTITION_COUNT);
+	assert(depth <= SPILL_MAX_DEPTH);
+	if (keys.size() == 0) {
+		return;
+	}
+	// compute the hashes in the same way as the HT does, so tuples that can match end up in the same partition
+	for (index_t i = 0; i < keys.column_count; i++) {
+		if (null_values_are_equal[i]) {
+			VectorOperations::FillNullMask(keys.data[i]);
+		}
+	}
+	StaticVector<uint64_t> hashes;
+	Hash(keys, hashes);
+
+	sel_t partition_sel[SPILL_PARTITION_COUNT][STANDARD_VECTOR_SIZE];
+	index_t partition_size[SPILL_PARTITION_COUNT] = {0};
+	auto hash_data = (uint64_t *)hashes.data;
+	auto shift = SPILL_PARTITION_SHIFT - depth * SPILL_PARTITION_BITS;
+	VectorOperations::Exec(hashes, [&](index_t i, index_t k) {
+		auto partition = (hash_data[i] >> shift) & (SPILL_PARTITION_COUNT - 1);
+		partition_sel[partition][partition_size[partition]++] = i;
+	});
+
+	auto old_sel_vector = input.sel_vector;
+	auto old_count = input.size();
+	for (index_t partition = 0; partition < SPILL_PARTITION_COUNT; partition++) {
+		if (partition_size[partition] == 0) {
+			continue;
+		}
+		SetChunkSelection(input, partition_sel[partition], partition_size[partition]);
+		partitions[partition]->Append(input);
+	}
+	SetChunkSelection(input, old_sel_vector, old_count);
+}
+
+void JoinHashTable::Partition(vector<unique_ptr<SpillFile>> &partitions) {
+	assert(join_type != JoinType::MARK || correlated_mark_join_info.correlated_types.size() == 0);
+	PartitionNodes(head.get(), partitions);
+
+	// now clear the HT, only the has_null flag is kept as it is a property of the entire build side
+	head.reset();
+	string_heap.Destroy();
+	count = 0;
+	capacity = 0;
+	Resize(STANDARD_VECTOR_SIZE * 2);
+}
+
+void JoinHashTable::Partition(LocalBuildState &local_state, vector<unique_ptr<SpillFile>> &partitions) {
+	PartitionNodes(local_state.head.get(), partitions);
+	local_state.head.reset();
+	local_state.string_heap.Destroy();
+	local_state.count = 0;
+}
+
+void JoinHashTable::PartitionNodes(Node *node, vector<unique_ptr<SpillFile>> &partitions) {
+	auto spill_types = GetSpillTypes();
+	DataChunk spill_chunk, keys;
+	spill_chunk.Initialize(spill_types);
+	keys.InitializeEmpty(condition_types);
+
+	// reconstruct the tuples of every node and write them to the partitions
+	data_ptr_t tuple_locations[STANDARD_VECTOR_SIZE];
+	while (node) {
+		auto dataptr = node->data.get();
+		for (index_t i = 0; i < node->count; i++) {
+			tuple_locations[i] = dataptr;
+			dataptr += entry_size;
+		}
+		spill_chunk.Reset();
+		DeserializeChunk(spill_chunk, tuple_locations, node->count, true);
+		for (index_t i = 0; i < keys.column_count; i++) {
+			keys.data[i].Reference(spill_chunk.data[i]);
+		}
+		PartitionChunk(keys, spill_chunk, partitions);
+		node = node->prev.get();
+	}
+}
+
+void JoinHashTable::PartitionBuild(DataChunk &keys, DataChunk &payload, vector<unique_ptr<SpillFile>> &partitions) {
+	PartitionBuild(keys, payload, partitions, has_null);
+}
+
+void JoinHashTable::PartitionBuild(LocalBuildState &local_state, DataChunk &keys, DataChunk &payload,
+                                   vector<unique_ptr<SpillFile>> &partitions) {
+	PartitionBuild(keys, payload, partitions, local_state.has_null);
+}
+
+void JoinHashTable::PartitionBuild(DataChunk &keys, DataChunk &payload, vector<unique_ptr<SpillFile>> &partitions,
+                                   bool &found_null) {
+	assert(keys.size() == payload.size());
+	// keep track of NULL values in the keys here, the partitions are built separately
+	for (index_t i = 0; i < keys.column_count; i++) {
+		if (null_values_are_equal[i]) {
+			continue;
+		}
+		auto &nullmask = keys.data[i].nullmask;
+		VectorOperations::Exec(keys.data[i], [&](index_t j, index_t k) {
+			if (nullmask[j]) {
+				found_null = true;
+			}
+		});
+	}
+	// the spilled tuples consist of the keys followed by the payload that is stored in the HT
+	auto spill_types = GetSpillTypes();
+	DataChunk spill_chunk;
+	spill_chunk.InitializeEmpty(spill_types);
+	for (index_t i = 0; i < keys.column_count; i++) {
+		spill_chunk.data[i].Reference(keys.data[i]);
+	}
+	for (index_t i = keys.column_count; i < spill_chunk.column_count; i++) {
+		spill_chunk.data[i].Reference(payload.data[i - keys.column_count]);
+	}
+	spill_chunk.sel_vector = keys.sel_vector;
+	PartitionChunk(keys, spill_chunk, partitions);
+}
+
+void JoinHashTable::PartitionProbe(DataChunk &keys, DataChunk &input, vector<unique_ptr<SpillFile>> &partitions,
+                                   index_t depth) {
+	PartitionChunk(keys, input, partitions, depth);
+}
+
+void JoinHashTable::Repartition(SpillFile &partition, vector<unique_ptr<SpillFile>> &partitions, index_t depth) {
+	DataChunk spill_chunk, keys;
+	keys.InitializeEmpty(condition_types);
+	while (partition.Scan(spill_chunk)) {
+		// the spilled tuples start with the keys
+		for (index_t i = 0; i < keys.column_count; i++) {
+			keys.data[i].Reference(spill_chunk.data[i]);
+		}
+		PartitionChunk(keys, spill_chunk, partitions, depth);
+	}
+}
+
+void JoinHashTable::Build(SpillFile &partition) {
+	DataChunk spill_chunk;
+	while (partition.Scan(spill_chunk)) {
+		// Build moves the strings of the chunks to the heap, which leaves their vectors owning data: the chunks cannot
+		// be re-pointed to the next spill chunk
+		DataChunk keys, payload;
+		keys.InitializeEmpty(condition_types);
+		payload.InitializeEmpty(build_size > 0 ? build_types : condition_types);
+		assert(spill_chunk.column_count == keys.column_count + (build_size > 0 ? payload.column_count : 0));
+		for (index_t i = 0; i < keys.column_count; i++) {
+			keys.data[i].Reference(spill_chunk.data[i]);
+		}
+		// without a stored payload the keys are passed as the (unused) payload
+		auto payload_offset = build_size > 0 ? keys.column_count : 0;
+		for (index_t i = 0; i < payload.column_count; i++) {
+			payload.data[i].Reference(spill_chunk.data[payload_offset + i]);
+		}
+		Build(keys, payload);
+	}
+}
+
 ScanStructure::ScanStructure(JoinHashTable &ht) : ht(ht), finished(false) {
 	pointers.Initialize(TypeId::POINTER, false);
 	build_pointer_vector.Initialize(TypeId::POINTER, false);
@@ -653,8 +937,9 @@ void ScanStructure::NextMarkJoin(DataChunk &keys, DataChunk &left, DataChunk &re
 	assert(result.column_count == left.column_count + 1);
 	assert(result.data[left.column_count].type == TypeId::BOOLEAN);
 	assert(!left.sel_vector);
-	// this method should only be called for a non-empty HT
-	assert(ht.count > 0);
+	// this method should only be called for a non-empty HT, or for the partition of a spilled join (which is never
+	// correlated) that has no tuples while the rest of the build side does
+	assert(ht.count > 0 || ht.correlated_mark_join_info.correlated_types.size() == 0);
 
 	ScanKeyMatches(keys);
 	if (ht.correlated_mark_join_info.correlated_types.size() == 0) {
@@ -1,11 +1,18 @@
 #include "execution/operator/aggregate/physical_hash_aggregate.hpp"
 
+#include "common/types/static_vector.hpp"
 #include "common/vector_operations/vector_operations.hpp"
 #include "execution/expression_executor.hpp"
+#include "execution/parallel_pipeline.hpp"
+#include "execution/task_scheduler.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
 #include "planner/expression/bound_aggregate_expression.hpp"
 #include "planner/expression/bound_constant_expression.hpp"
 #include "catalog/catalog_entry/aggregate_function_catalog_entry.hpp"
 
+#include <atomic>
+
 using namespace duckdb;
 using namespace std;
 
@@ -33,53 +40,85 @@ PhysicalHashAggregate::PhysicalHashAggregate(vector<TypeId> types, vector<unique
 	}
 }
 
-void PhysicalHashAggregate::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalHashAggregateOperatorState *>(state_);
-	do {
-		if (children.size() > 0) {
-			// resolve the child chunk if there is one
-			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-			if (state->child_chunk.size() == 0) {
-				break;
-			}
-		}
-		index_t payload_idx = 0;
-		ExpressionExecutor executor(state->child_chunk);
-		// aggregation with groups
-		DataChunk &group_chunk = state->group_chunk;
-		DataChunk &payload_chunk = state->payload_chunk;
-		executor.Execute(groups, group_chunk);
-		for (index_t i = 0; i < aggregates.size(); i++) {
-			auto &aggr = (BoundAggregateExpression &)*aggregates[i];
-			if (aggr.children.size()) {
-				for (index_t j = 0; j < aggr.children.size(); ++j) {
-					executor.ExecuteExpression(*aggr.children[j], payload_chunk.data[payload_idx]);
-					payload_chunk.heap.MergeHeap(payload_chunk.data[payload_idx].string_heap);
-					++payload_idx;
-				}
-			} else {
-				payload_chunk.data[payload_idx].count = group_chunk.size();
-				payload_chunk.data[payload_idx].sel_vector = group_chunk.sel_vector;
+void PhysicalHashAggregate::ComputeGroupsAndPayload(DataChunk &input, DataChunk &group_chunk,
+                                                    DataChunk &payload_chunk) {
+	index_t payload_idx = 0;
+	ExpressionExecutor executor(input);
+	// aggregation with groups
+	executor.Execute(groups, group_chunk);
+	for (index_t i = 0; i < aggregates.size(); i++) {
+		auto &aggr = (BoundAggregateExpression &)*aggregates[i];
+		if (aggr.children.size()) {
+			for (index_t j = 0; j < aggr.children.size(); ++j) {
+				executor.ExecuteExpression(*aggr.children[j], payload_chunk.data[payload_idx]);
+				payload_chunk.heap.MergeHeap(payload_chunk.data[payload_idx].string_heap);
 				++payload_idx;
 			}
+		} else {
+			payload_chunk.data[payload_idx].count = group_chunk.size();
+			payload_chunk.data[payload_idx].sel_vector = group_chunk.sel_vector;
+			++payload_idx;
 		}
-		payload_chunk.sel_vector = group_chunk.sel_vector;
+	}
+	payload_chunk.sel_vector = group_chunk.sel_vector;
 
-		group_chunk.Verify();
-		payload_chunk.Verify();
-		assert(payload_chunk.column_count == 0 || group_chunk.size() == payload_chunk.size());
+	group_chunk.Verify();
+	payload_chunk.Verify();
+	assert(payload_chunk.column_count == 0 || group_chunk.size() == payload_chunk.size());
+}
 
-		// move the strings inside the groups to the string heap
-		group_chunk.MoveStringsToHeap(state->ht->string_heap);
-		payload_chunk.MoveStringsToHeap(state->ht->string_heap);
+void PhysicalHashAggregate::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashAggregateOperatorState *>(state_);
+	if (!state->parallel_checked) {
+		state->parallel_checked = true;
+		state->is_parallel = CanParallelize(context) && ExecuteParallel(context, *state);
+	}
+	if (!state->is_parallel) {
+		do {
+			if (children.size() > 0) {
+				// resolve the child chunk if there is one
+				children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+				if (state->child_chunk.size() == 0) {
+					break;
+				}
+			}
+			DataChunk &group_chunk = state->group_chunk;
+			DataChunk &payload_chunk = state->payload_chunk;
+			ComputeGroupsAndPayload(state->child_chunk, group_chunk, payload_chunk);
 
-		state->ht->AddChunk(group_chunk, payload_chunk);
-		state->tuples_scanned += state->child_chunk.size();
-	} while (state->child_chunk.size() > 0);
+			// move the strings inside the groups to the string heap
+			group_chunk.MoveStringsToHeap(state->ht->string_heap);
+			payload_chunk.MoveStringsToHeap(state->ht->string_heap);
+
+			state->ht->AddChunk(group_chunk, payload_chunk);
+			state->tuples_scanned += state->child_chunk.size();
+		} while (state->child_chunk.size() > 0);
+	}
 
 	state->group_chunk.Reset();
 	state->aggregate_chunk.Reset();
-	index_t elements_found = state->ht->Scan(state->ht_scan_position, state->group_chunk, state->aggregate_chunk);
+	index_t elements_found = 0;
+	if (state->is_parallel) {
+		// scan the finalized partitions in order
+		while (state->scan_partition < PARTITION_COUNT) {
+			auto &result = *state->partition_results[state->scan_partition];
+			if (state->scan_chunk < result.chunks.size()) {
+				auto &result_chunk = *result.chunks[state->scan_chunk++];
+				for (index_t i = 0; i < state->group_chunk.column_count; i++) {
+					state->group_chunk.data[i].Reference(result_chunk.data[i]);
+				}
+				for (index_t i = 0; i < state->aggregate_chunk.column_count; i++) {
+					state->aggregate_chunk.data[i].Reference(result_chunk.data[state->group_chunk.column_count + i]);
+				}
+				elements_found = result_chunk.size();
+				break;
+			}
+			state->scan_partition++;
+			state->scan_chunk = 0;
+		}
+	} else {
+		elements_found = state->ht->Scan(state->ht_scan_position, state->group_chunk, state->aggregate_chunk);
+	}
 
 	// special case hack to sort out aggregating from empty intermediates
 	// for aggregations without groups
@@ -115,19 +154,161 @@ void PhysicalHashAggregate::GetChunkInternal(ClientContext &context, DataChunk &
 	}
 }
 
-unique_ptr<PhysicalOperatorState> PhysicalHashAggregate::GetOperatorState() {
-	auto state =
-	    make_unique<PhysicalHashAggregateOperatorState>(this, children.size() == 0 ? nullptr : children[0].get());
-	state->tuples_scanned = 0;
-	vector<TypeId> group_types, payload_types;
-	vector<BoundAggregateExpression *> aggregate_kind;
+bool PhysicalHashAggregate::CanParallelize(ClientContext &context) {
+	if (children.size() == 0) {
+		return false;
+	}
+	for (auto &expr : aggregates) {
+		auto &aggr = (BoundAggregateExpression &)*expr;
+		if (aggr.distinct || !aggr.bound_aggregate->combine) {
+			// the states of distinct aggregates and aggregates without a combine function cannot be merged
+			return false;
+		}
+	}
+	if (ParallelPipeline::HasSideEffects(groups) || ParallelPipeline::HasSideEffects(aggregates)) {
+		return false;
+	}
+	return ParallelPipeline::CanParallelize(context, *children[0]);
+}
+
+//! Restrict all the vectors of the chunk to the given selection vector
+static void SetChunkSelection(DataChunk &chunk, sel_t *sel_vector, index_t count) {
+	chunk.sel_vector = sel_vector;
+	for (index_t i = 0; i < chunk.column_count; i++) {
+		chunk.data[i].sel_vector = sel_vector;
+		chunk.data[i].count = count;
+	}
+}
+
+//! The thread-local state of a parallel hash aggregate
+struct LocalAggregateState {
+	DataChunk group_chunk;
+	DataChunk payload_chunk;
+	//! The radix partitions of the thread-local pre-aggregation
+	vector<unique_ptr<SuperLargeHashTable>> partitions;
+	//! The strings referenced by the groups and aggregates of the partitions
+	StringHeap string_heap;
+	index_t tuples_scanned = 0;
+};
+
+bool PhysicalHashAggregate::ExecuteParallel(ClientContext &context, PhysicalHashAggregateOperatorState &state) {
+	ParallelPipeline pipeline(context, *children[0]);
+	if (pipeline.thread_count <= 1) {
+		return false;
+	}
+	vector<TypeId> group_types, aggregate_types, result_types;
 	for (auto &expr : groups) {
 		group_types.push_back(expr->return_type);
+		result_types.push_back(expr->return_type);
 	}
+	for (auto &expr : aggregates) {
+		aggregate_types.push_back(expr->return_type);
+		result_types.push_back(expr->return_type);
+	}
+	auto payload_types = GetPayloadTypes();
+
+	vector<unique_ptr<LocalAggregateState>> local_states;
+	for (index_t i = 0; i < pipeline.thread_count; i++) {
+		auto local_state = make_unique<LocalAggregateState>();
+		local_state->group_chunk.Initialize(group_types);
+		if (payload_types.size() > 0) {
+			local_state->payload_chunk.Initialize(payload_types);
+		}
+		for (index_t partition = 0; partition < PARTITION_COUNT; partition++) {
+			local_state->partitions.push_back(CreateHashTable());
+		}
+		local_states.push_back(move(local_state));
+	}
+
+	// first phase: every thread pre-aggregates its morsels into its own radix partitioned hash tables
+	pipeline.Execute([&](DataChunk &input, index_t morsel_index, index_t thread_index) {
+		auto &local_state = *local_states[thread_index];
+		auto &group_chunk = local_state.group_chunk;
+		auto &payload_chunk = local_state.payload_chunk;
+		ComputeGroupsAndPayload(input, group_chunk, payload_chunk);
+
+		group_chunk.MoveStringsToHeap(local_state.string_heap);
+		payload_chunk.MoveStringsToHeap(local_state.string_heap);
+
+		// divide the tuples over the partitions based on the hash of their groups
+		StaticVector<uint64_t> hashes;
+		group_chunk.Hash(hashes);
+		sel_t partition_sel[PARTITION_COUNT][STANDARD_VECTOR_SIZE];
+		index_t partition_size[PARTITION_COUNT] = {0};
+		VectorOperations::ExecType<uint64_t>(hashes, [&](uint64_t hash, index_t i, index_t k) {
+			auto partition = (hash >> PARTITION_SHIFT) & (PARTITION_COUNT - 1);
+			partition_sel[partition][partition_size[partition]++] = i;
+		});
+
+		auto old_sel_vector = group_chunk.sel_vector;
+		auto old_count = group_chunk.size();
+		for (index_t partition = 0; partition < PARTITION_COUNT; partition++) {
+			if (partition_size[partition] == 0) {
+				continue;
+			}
+			SetChunkSelection(group_chunk, partition_sel[partition], partition_size[partition]);
+			SetChunkSelection(payload_chunk, partition_sel[partition], partition_size[partition]);
+			local_state.partitions[partition]->AddChunk(group_chunk, payload_chunk);
+		}
+		SetChunkSelection(group_chunk, old_sel_vector, old_count);
+		SetChunkSelection(payload_chunk, old_sel_vector, old_count);
+		local_state.tuples_scanned += input.size();
+	});
+
+	// second phase: the partitions are independent, so they can be merged and finalized in parallel
+	state.partitions.resize(PARTITION_COUNT);
+	state.partition_results.resize(PARTITION_COUNT);
+	atomic<index_t> next_partition(0);
+	context.db.scheduler->ExecuteParallel(PARTITION_COUNT, [&](index_t thread_index) {
+		DataChunk group_chunk, aggregate_chunk;
+		group_chunk.Initialize(group_types);
+		if (aggregate_types.size() > 0) {
+			aggregate_chunk.Initialize(aggregate_types);
+		}
+		index_t partition;
+		while ((partition = next_partition++) < PARTITION_COUNT) {
+			// merge the partition of every thread into the partition of the first thread
+			auto ht = move(local_states[0]->partitions[partition]);
+			for (index_t i = 1; i < local_states.size(); i++) {
+				ht->Combine(*local_states[i]->partitions[partition]);
+				local_states[i]->partitions[partition].reset();
+			}
+			// now finalize the aggregates of the partition
+			auto result = make_unique<ChunkCollection>();
+			index_t scan_position = 0;
+			while (true) {
+				group_chunk.Reset();
+				aggregate_chunk.Reset();
+				if (ht->Scan(scan_position, group_chunk, aggregate_chunk) == 0) {
+					break;
+				}
+				DataChunk result_chunk;
+				result_chunk.InitializeEmpty(result_types);
+				for (index_t i = 0; i < group_chunk.column_count; i++) {
+					result_chunk.data[i].Reference(group_chunk.data[i]);
+				}
+				for (index_t i = 0; i < aggregate_chunk.column_count; i++) {
+					result_chunk.data[group_chunk.column_count + i].Reference(aggregate_chunk.data[i]);
+				}
+				result->Append(result_chunk);
+			}
+			state.partitions[partition] = move(ht);
+			state.partition_results[partition] = move(result);
+		}
+	});
+
+	for (auto &local_state : local_states) {
+		state.string_heap.MergeHeap(local_state->string_heap);
+		state.tuples_scanned += local_state->tuples_scanned;
+	}
+	return true;
+}
+
+vector<TypeId> PhysicalHashAggregate::GetPayloadTypes() {
+	vector<TypeId> payload_types;
 	for (auto &expr : aggregates) {
 		assert(expr->GetExpressionClass() == ExpressionClass::BOUND_AGGREGATE);
 		auto &aggr = (BoundAggregateExpression &)*expr;
-		aggregate_kind.push_back(&aggr);
 		if (aggr.children.size()) {
 			for (index_t i = 0; i < aggr.children.size(); ++i) {
 				payload_types.push_back(aggr.children[i]->return_type);
@@ -137,17 +318,38 @@ unique_ptr<PhysicalOperatorState> PhysicalHashAggregate::GetOperatorState() {
 			payload_types.push_back(TypeId::BIGINT);
 		}
 	}
+	return payload_types;
+}
+
+unique_ptr<SuperLargeHashTable> PhysicalHashAggregate::CreateHashTable() {
+	vector<TypeId> group_types;
+	vector<BoundAggregateExpression *> aggregate_kind;
+	for (auto &expr : groups) {
+		group_types.push_back(expr->return_type);
+	}
+	for (auto &expr : aggregates) {
+		aggregate_kind.push_back((BoundAggregateExpression *)expr.get());
+	}
+	return make_unique<SuperLargeHashTable>(1024, group_types, GetPayloadTypes(), aggregate_kind);
+}
+
+unique_ptr<PhysicalOperatorState> PhysicalHashAggregate::GetOperatorState() {
+	auto state =
+	    make_unique<PhysicalHashAggregateOperatorState>(this, children.size() == 0 ? nullptr : children[0].get());
+	state->tuples_scanned = 0;
+	auto payload_types = GetPayloadTypes();
 	if (payload_types.size() > 0) {
 		state->payload_chunk.Initialize(payload_types);
 	}
 
-	state->ht = make_unique<SuperLargeHashTable>(1024, group_types, payload_types, aggregate_kind);
+	state->ht = CreateHashTable();
 	return move(state);
 }
 
 PhysicalHashAggregateOperatorState::PhysicalHashAggregateOperatorState(PhysicalHashAggregate *parent,
                                                                        PhysicalOperator *child)
-    : PhysicalOperatorState(child), ht_scan_position(0), tuples_scanned(0) {
+    : PhysicalOperatorState(child), ht_scan_position(0), tuples_scanned(0), parallel_checked(false),
+      is_parallel(false), scan_partition(0), scan_chunk(0) {
 	vector<TypeId> group_types, aggregate_types;
 	for (auto &expr : parent->groups) {
 		group_types.push_back(expr->return_type);
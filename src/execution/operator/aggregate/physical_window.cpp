@@ -1,14 +1,20 @@
 #include "execution/operator/aggregate/physical_window.hpp"
 
+#include "catalog/catalog_entry/aggregate_function_catalog_entry.hpp"
 #include "common/types/chunk_collection.hpp"
-#include "common/types/constant_vector.hpp"
+#include "common/types/static_vector.hpp"
 #include "common/vector_operations/vector_operations.hpp"
 #include "execution/expression_executor.hpp"
+#include "execution/parallel_pipeline.hpp"
+#include "execution/task_scheduler.hpp"
 #include "execution/window_segment_tree.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
 #include "planner/expression/bound_reference_expression.hpp"
 #include "planner/expression/bound_window_expression.hpp"
 
-#include <cmath>
+#include <atomic>
+#include <cstring>
 
 using namespace duckdb;
 using namespace std;
@@ -19,48 +25,20 @@ PhysicalWindow::PhysicalWindow(LogicalOperator &op, vector<unique_ptr<Expression
     : PhysicalOperator(type, op.types), select_list(std::move(select_list)) {
 }
 
-static bool EqualsSubset(vector<Value> &a, vector<Value> &b, index_t start, index_t end) {
-	assert(start <= end);
-	for (index_t i = start; i < end; i++) {
-		if (a[i] != b[i]) {
-			return false;
-		}
+static void MaterializeExpressions(ClientContext &context, vector<Expression *> &exprs, ChunkCollection &input,
+                                   ChunkCollection &output, bool scalar = false) {
+	if (exprs.size() == 0) {
+		return;
 	}
-	return true;
-}
-
-static index_t BinarySearchRightmost(ChunkCollection &input, vector<Value> row, index_t l, index_t r,
-                                     index_t comp_cols) {
-	if (comp_cols == 0) {
-		return r - 1;
-	}
-	while (l < r) {
-		index_t m = floor((l + r) / 2);
-		bool less_than_equals = true;
-		for (index_t i = 0; i < comp_cols; i++) {
-			if (input.GetRow(m)[i] > row[i]) {
-				less_than_equals = false;
-				break;
-			}
-		}
-		if (less_than_equals) {
-			l = m + 1;
-		} else {
-			r = m;
-		}
+	vector<TypeId> types;
+	for (auto &expr : exprs) {
+		types.push_back(expr->return_type);
 	}
-	return l - 1;
-}
-
-static void MaterializeExpression(ClientContext &context, Expression *expr, ChunkCollection &input,
-                                  ChunkCollection &output, bool scalar = false) {
-	ChunkCollection boundary_start_collection;
-	vector<TypeId> types = {expr->return_type};
 	for (index_t i = 0; i < input.chunks.size(); i++) {
 		DataChunk chunk;
 		chunk.Initialize(types);
 		ExpressionExecutor executor(*input.chunks[i]);
-		executor.ExecuteExpression(*expr, chunk.data[0]);
+		executor.Execute(exprs, chunk);
 
 		chunk.Verify();
 		output.Append(chunk);
@@ -71,8 +49,16 @@ static void MaterializeExpression(ClientContext &context, Expression *expr, Chun
 	}
 }
 
+static void MaterializeExpression(ClientContext &context, Expression *expr, ChunkCollection &input,
+                                  ChunkCollection &output, bool scalar = false) {
+	vector<Expression *> exprs = {expr};
+	MaterializeExpressions(context, exprs, input, output, scalar);
+}
+
+//! Sorts the rows of the input by the partition and order expressions of the window. The sorted order of the rows is
+//! written to order, and the sort collection contains the sorted values of the expressions.
 static void SortCollectionForWindow(ClientContext &context, BoundWindowExpression *wexpr, ChunkCollection &input,
-                                    ChunkCollection &output, ChunkCollection &sort_collection) {
+                                    ChunkCollection &sort_collection, index_t order[]) {
 	vector<TypeId> sort_types;
 	vector<Expression *> exprs;
 	vector<OrderType> orders;
@@ -107,12 +93,92 @@ static void SortCollectionForWindow(ClientContext &context, BoundWindowExpressio
 
 	assert(input.count == sort_collection.count);
 
-	auto sorted_vector = unique_ptr<index_t[]>(new index_t[input.count]);
-	sort_collection.Sort(orders, sorted_vector.get());
+	sort_collection.Sort(orders, order);
+	sort_collection.Reorder(order);
+}
 
-	input.Reorder(sorted_vector.get());
-	output.Reorder(sorted_vector.get());
-	sort_collection.Reorder(sorted_vector.get());
+//! Marks the rows of the sorted collection that start a new partition (one of the first partition_count columns differs
+//! from the previous row) and the rows that start a new peer group (any of the columns differs)
+static void MarkBoundaries(ChunkCollection &sort_collection, index_t partition_count, index_t count,
+                           bool partition_mask[], bool peer_mask[]) {
+	memset(partition_mask, 0, sizeof(bool) * count);
+	memset(peer_mask, 0, sizeof(bool) * count);
+	partition_mask[0] = true;
+	for (index_t chunk_idx = 0; chunk_idx < sort_collection.chunks.size(); chunk_idx++) {
+		auto &chunk = *sort_collection.chunks[chunk_idx];
+		index_t chunk_start = chunk_idx * STANDARD_VECTOR_SIZE;
+		for (index_t col_idx = 0; col_idx < chunk.column_count; col_idx++) {
+			auto mask = col_idx < partition_count ? partition_mask : peer_mask;
+			auto &vector = chunk.data[col_idx];
+			assert(!vector.sel_vector);
+			if (chunk_idx > 0) {
+				// the first row of the chunk is compared with the last row of the previous chunk
+				auto &prev_vector = sort_collection.chunks[chunk_idx - 1]->data[col_idx];
+				if (vector.GetValue(0) != prev_vector.GetValue(prev_vector.count - 1)) {
+					mask[chunk_start] = true;
+				}
+			}
+			if (vector.count <= 1) {
+				continue;
+			}
+			// the other rows are compared with the row before them by comparing the vector with itself shifted by one
+			Vector current, previous;
+			current.Reference(vector);
+			current.data += GetTypeIdSize(vector.type);
+			current.nullmask >>= 1;
+			current.count = vector.count - 1;
+			previous.Reference(vector);
+			previous.count = vector.count - 1;
+			StaticVector<bool> not_equals;
+			VectorOperations::NotEquals(current, previous, not_equals);
+			auto differs = (bool *)not_equals.data;
+			for (index_t i = 0; i < current.count; i++) {
+				// NULL values are equal to each other
+				bool current_null = current.nullmask[i], previous_null = previous.nullmask[i];
+				if (current_null || previous_null ? current_null != previous_null : differs[i]) {
+					mask[chunk_start + i + 1] = true;
+				}
+			}
+		}
+	}
+	// a new partition also starts a new peer group
+	for (index_t i = 0; i < count; i++) {
+		peer_mask[i] = peer_mask[i] || partition_mask[i];
+	}
+}
+
+//! Returns the value of a materialized BIGINT expression (e.g. a frame offset) for the given row
+static int64_t GetOffset(ChunkCollection &collection, bool scalar, index_t row_idx) {
+	index_t index = scalar ? 0 : row_idx;
+	auto &vector = collection.GetChunk(index).data[0];
+	assert(vector.type == TypeId::BIGINT);
+	index %= STANDARD_VECTOR_SIZE;
+	if (vector.nullmask[index]) {
+		throw Exception("Window function offsets cannot be NULL");
+	}
+	return ((int64_t *)vector.data)[index];
+}
+
+//! Copies the value at the given row of the collection into the result vector
+static void CopyCell(ChunkCollection &collection, index_t column, index_t row_idx, Vector &result, index_t index) {
+	auto &source = collection.GetChunk(row_idx).data[column];
+	auto source_idx = row_idx % STANDARD_VECTOR_SIZE;
+	assert(source.type == result.type);
+	result.nullmask[index] = source.nullmask[source_idx];
+	if (result.nullmask[index]) {
+		return;
+	}
+	if (result.type == TypeId::VARCHAR) {
+		((const char **)result.data)[index] = result.string_heap.AddString(((const char **)source.data)[source_idx]);
+	} else {
+		auto width = GetTypeIdSize(result.type);
+		memcpy(result.data + index * width, source.data + source_idx * width, width);
+	}
+}
+
+template <class T> static void SetResult(Vector &result, index_t index, T value) {
+	((T *)result.data)[index] = value;
+	result.nullmask[index] = false;
 }
 
 struct WindowBoundariesState {
@@ -122,9 +188,6 @@ struct WindowBoundariesState {
 	index_t peer_end = 0;
 	int64_t window_start = -1;
 	int64_t window_end = -1;
-	bool is_same_partition = false;
-	bool is_peer = false;
-	vector<Value> row_prev;
 };
 
 static bool WindowNeedsRank(BoundWindowExpression *wexpr) {
@@ -132,42 +195,24 @@ static bool WindowNeedsRank(BoundWindowExpression *wexpr) {
 	       wexpr->type == ExpressionType::WINDOW_RANK_DENSE || wexpr->type == ExpressionType::WINDOW_CUME_DIST;
 }
 
-static void UpdateWindowBoundaries(BoundWindowExpression *wexpr, ChunkCollection &input, index_t input_size,
-                                   index_t row_idx, ChunkCollection &boundary_start_collection,
+static void UpdateWindowBoundaries(BoundWindowExpression *wexpr, index_t input_size, index_t row_idx,
+                                   bool partition_mask[], bool peer_mask[],
+                                   ChunkCollection &boundary_start_collection,
                                    ChunkCollection &boundary_end_collection, WindowBoundariesState &bounds) {
-
-	if (input.column_count() > 0) {
-		vector<Value> row_cur = input.GetRow(row_idx);
-		index_t sort_col_count = wexpr->partitions.size() + wexpr->orders.size();
-
-		// determine partition and peer group boundaries to ultimately figure out window size
-		bounds.is_same_partition = EqualsSubset(bounds.row_prev, row_cur, 0, wexpr->partitions.size());
-		bounds.is_peer = bounds.is_same_partition &&
-		                 EqualsSubset(bounds.row_prev, row_cur, wexpr->partitions.size(), sort_col_count);
-		bounds.row_prev = row_cur;
-
-		// when the partition changes, recompute the boundaries
-		if (!bounds.is_same_partition || row_idx == 0) { // special case for first row, need to init
-			bounds.partition_start = row_idx;
-			bounds.peer_start = row_idx;
-
-			// find end of partition
-			bounds.partition_end =
-			    BinarySearchRightmost(input, row_cur, bounds.partition_start, input.count, wexpr->partitions.size()) +
-			    1;
-
-		} else if (!bounds.is_peer) {
-			bounds.peer_start = row_idx;
+	// the partition and peer group boundaries are found by scanning the masks, which is linear over all rows
+	if (partition_mask[row_idx]) {
+		bounds.partition_start = row_idx;
+		bounds.partition_end = row_idx + 1;
+		while (bounds.partition_end < input_size && !partition_mask[bounds.partition_end]) {
+			bounds.partition_end++;
 		}
-
-		if (wexpr->end == WindowBoundary::CURRENT_ROW_RANGE || wexpr->type == ExpressionType::WINDOW_CUME_DIST) {
-			bounds.peer_end = BinarySearchRightmost(input, row_cur, row_idx, bounds.partition_end, sort_col_count) + 1;
+	}
+	if (peer_mask[row_idx]) {
+		bounds.peer_start = row_idx;
+		bounds.peer_end = row_idx + 1;
+		while (bounds.peer_end < bounds.partition_end && !peer_mask[bounds.peer_end]) {
+			bounds.peer_end++;
 		}
-	} else {
-		bounds.is_same_partition = 0;
-		bounds.is_peer = true;
-		bounds.partition_end = input_size;
-		bounds.peer_end = bounds.partition_end;
 	}
 
 	// determine window boundaries depending on the type of expression
@@ -187,21 +232,13 @@ static void UpdateWindowBoundaries(BoundWindowExpression *wexpr, ChunkCollection
 	case WindowBoundary::UNBOUNDED_FOLLOWING:
 		assert(0); // disallowed
 		break;
-	case WindowBoundary::EXPR_PRECEDING: {
-		assert(boundary_start_collection.column_count() > 0);
+	case WindowBoundary::EXPR_PRECEDING:
 		bounds.window_start =
-		    (int64_t)row_idx -
-		    boundary_start_collection.GetValue(0, wexpr->start_expr->IsScalar() ? 0 : row_idx).GetNumericValue();
+		    (int64_t)row_idx - GetOffset(boundary_start_collection, wexpr->start_expr->IsScalar(), row_idx);
 		break;
-	}
-	case WindowBoundary::EXPR_FOLLOWING: {
-		assert(boundary_start_collection.column_count() > 0);
-		bounds.window_start =
-		    row_idx +
-		    boundary_start_collection.GetValue(0, wexpr->start_expr->IsScalar() ? 0 : row_idx).GetNumericValue();
+	case WindowBoundary::EXPR_FOLLOWING:
+		bounds.window_start = row_idx + GetOffset(boundary_start_collection, wexpr->start_expr->IsScalar(), row_idx);
 		break;
-	}
-
 	default:
 		throw NotImplementedException("Unsupported boundary");
 	}
@@ -220,50 +257,64 @@ static void UpdateWindowBoundaries(BoundWindowExpression *wexpr, ChunkCollection
 		bounds.window_end = bounds.partition_end;
 		break;
 	case WindowBoundary::EXPR_PRECEDING:
-		assert(boundary_end_collection.column_count() > 0);
 		bounds.window_end =
-		    (int64_t)row_idx -
-		    boundary_end_collection.GetValue(0, wexpr->end_expr->IsScalar() ? 0 : row_idx).GetNumericValue() + 1;
+		    (int64_t)row_idx - GetOffset(boundary_end_collection, wexpr->end_expr->IsScalar(), row_idx) + 1;
 		break;
 	case WindowBoundary::EXPR_FOLLOWING:
-		assert(boundary_end_collection.column_count() > 0);
-		bounds.window_end =
-		    row_idx + boundary_end_collection.GetValue(0, wexpr->end_expr->IsScalar() ? 0 : row_idx).GetNumericValue() +
-		    1;
-
+		bounds.window_end = row_idx + GetOffset(boundary_end_collection, wexpr->end_expr->IsScalar(), row_idx) + 1;
 		break;
 	default:
 		throw NotImplementedException("Unsupported boundary");
 	}
 
-	// clamp windows to partitions if they should exceed
+	// clamp windows to partitions if they should exceed, frames that end before they start are empty
 	if (bounds.window_start < (int64_t)bounds.partition_start) {
 		bounds.window_start = bounds.partition_start;
 	}
-	if ((index_t)bounds.window_end > bounds.partition_end) {
+	if (bounds.window_end > (int64_t)bounds.partition_end) {
 		bounds.window_end = bounds.partition_end;
 	}
-
-	if (bounds.window_start < 0 || bounds.window_end < 0) {
-		throw Exception("Failed to compute window boundaries");
+	if (bounds.window_end < bounds.window_start) {
+		bounds.window_end = bounds.window_start;
 	}
 }
 
+//! Computes the window expression over the rows of the input. The results are appended to the result collection in the
+//! order in which they were computed: result k belongs to input row order[k].
 static void ComputeWindowExpression(ClientContext &context, BoundWindowExpression *wexpr, ChunkCollection &input,
-                                    ChunkCollection &output, index_t output_idx) {
+                                    ChunkCollection &results, index_t order[]) {
+	vector<TypeId> result_types = {wexpr->return_type};
+	for (index_t i = 0; i < input.chunks.size(); i++) {
+		DataChunk result_chunk;
+		result_chunk.Initialize(result_types);
+		result_chunk.data[0].count = input.chunks[i]->size();
+		VectorOperations::Set(result_chunk.data[0], Value());
+		results.Append(result_chunk);
+	}
 
 	ChunkCollection sort_collection;
 	bool needs_sorting = wexpr->partitions.size() + wexpr->orders.size() > 0;
 	if (needs_sorting) {
-		SortCollectionForWindow(context, wexpr, input, output, sort_collection);
+		SortCollectionForWindow(context, wexpr, input, sort_collection, order);
+	} else {
+		for (index_t i = 0; i < input.count; i++) {
+			order[i] = i;
+		}
 	}
 
+	// mark the rows where a new partition or peer group starts
+	auto partition_mask = unique_ptr<bool[]>(new bool[input.count]);
+	auto peer_mask = unique_ptr<bool[]>(new bool[input.count]);
+	MarkBoundaries(sort_collection, wexpr->partitions.size(), input.count, partition_mask.get(), peer_mask.get());
+
 	// evaluate inner expressions of window functions, could be more complex
 	ChunkCollection payload_collection;
-	if (wexpr->child) {
-		// TODO: child[0] may be a scalar, don't need to materialize the whole collection then
-		MaterializeExpression(context, wexpr->child.get(), input, payload_collection);
+	vector<Expression *> exprs;
+	for (auto &child : wexpr->children) {
+		exprs.push_back(child.get());
 	}
+	// TODO: child may be a scalar, don't need to materialize the whole collection then
+	MaterializeExpressions(context, exprs, input, payload_collection);
 
 	ChunkCollection leadlag_offset_collection;
 	ChunkCollection leadlag_default_collection;
@@ -292,156 +343,263 @@ static void ComputeWindowExpression(ClientContext &context, BoundWindowExpressio
 		                      wexpr->end_expr->IsScalar());
 	}
 
+	// the expressions were evaluated in the order of the input, bring them in the sorted order
+	if (needs_sorting) {
+		payload_collection.Reorder(order);
+		if (wexpr->offset_expr && !wexpr->offset_expr->IsScalar()) {
+			leadlag_offset_collection.Reorder(order);
+		}
+		if (wexpr->default_expr && !wexpr->default_expr->IsScalar()) {
+			leadlag_default_collection.Reorder(order);
+		}
+		if (wexpr->start_expr && !wexpr->start_expr->IsScalar()) {
+			boundary_start_collection.Reorder(order);
+		}
+		if (wexpr->end_expr && !wexpr->end_expr->IsScalar()) {
+			boundary_end_collection.Reorder(order);
+		}
+	}
+
 	// build a segment tree for frame-adhering aggregates
 	// see http://www.vldb.org/pvldb/vol8/p1058-leis.pdf
 	unique_ptr<WindowSegmentTree> segment_tree = nullptr;
-
-	switch (wexpr->type) {
-	case ExpressionType::WINDOW_SUM:
-	case ExpressionType::WINDOW_MIN:
-	case ExpressionType::WINDOW_MAX:
-	case ExpressionType::WINDOW_AVG:
-		segment_tree = make_unique<WindowSegmentTree>(wexpr->type, wexpr->return_type, &payload_collection);
-		break;
-	default:
-		break;
-		// nothing
+	if (wexpr->type == ExpressionType::WINDOW_AGGREGATE && wexpr->children.size() > 0) {
+		segment_tree = make_unique<WindowSegmentTree>(*wexpr->aggregate, wexpr->return_type, &payload_collection);
 	}
 
 	WindowBoundariesState bounds;
 	uint64_t dense_rank = 1, rank_equal = 0, rank = 1;
-
-	if (needs_sorting) {
-		bounds.row_prev = sort_collection.GetRow(0);
-	}
-
-	// this is the main loop, go through all sorted rows and compute window function result
-	for (index_t row_idx = 0; row_idx < input.count; row_idx++) {
-		// special case, OVER (), aggregate over everything
-		UpdateWindowBoundaries(wexpr, sort_collection, input.count, row_idx, boundary_start_collection,
-		                       boundary_end_collection, bounds);
-		if (WindowNeedsRank(wexpr)) {
-			if (!bounds.is_same_partition || row_idx == 0) { // special case for first row, need to init
-				dense_rank = 1;
-				rank = 1;
-				rank_equal = 0;
-			} else if (!bounds.is_peer) {
-				dense_rank++;
-				rank += rank_equal;
-				rank_equal = 0;
+	index_t window_begins[STANDARD_VECTOR_SIZE], window_ends[STANDARD_VECTOR_SIZE];
+
+	// this is the main loop, go through all sorted rows a vector at a time and compute window function result
+	for (index_t chunk_idx = 0; chunk_idx < results.chunks.size(); chunk_idx++) {
+		auto &result = results.chunks[chunk_idx]->data[0];
+		index_t chunk_start = chunk_idx * STANDARD_VECTOR_SIZE;
+		for (index_t i = 0; i < result.count; i++) {
+			index_t row_idx = chunk_start + i;
+			UpdateWindowBoundaries(wexpr, input.count, row_idx, partition_mask.get(), peer_mask.get(),
+			                       boundary_start_collection, boundary_end_collection, bounds);
+			if (WindowNeedsRank(wexpr)) {
+				if (partition_mask[row_idx]) {
+					dense_rank = 1;
+					rank = 1;
+					rank_equal = 0;
+				} else if (peer_mask[row_idx]) {
+					dense_rank++;
+					rank += rank_equal;
+					rank_equal = 0;
+				}
+				rank_equal++;
 			}
-			rank_equal++;
-		}
-
-		auto res = Value();
-
-		// if no values are read for window, result is NULL
-		if (bounds.window_start >= bounds.window_end) {
-			output.SetValue(output_idx, row_idx, res);
-			continue;
-		}
+			window_begins[i] = bounds.window_start;
+			window_ends[i] = bounds.window_end;
 
-		switch (wexpr->type) {
-		case ExpressionType::WINDOW_SUM:
-		case ExpressionType::WINDOW_MIN:
-		case ExpressionType::WINDOW_MAX:
-		case ExpressionType::WINDOW_AVG: {
-			assert(segment_tree);
-			res = segment_tree->Compute(bounds.window_start, bounds.window_end);
-			break;
-		}
-		case ExpressionType::WINDOW_COUNT_STAR: {
-			res = Value::Numeric(wexpr->return_type, bounds.window_end - bounds.window_start);
-			break;
-		}
-		case ExpressionType::WINDOW_ROW_NUMBER: {
-			res = Value::Numeric(wexpr->return_type, row_idx - bounds.partition_start + 1);
-			break;
-		}
-		case ExpressionType::WINDOW_RANK_DENSE: {
-			res = Value::Numeric(wexpr->return_type, dense_rank);
-			break;
-		}
-		case ExpressionType::WINDOW_RANK: {
-			res = Value::Numeric(wexpr->return_type, rank);
-			break;
-		}
-		case ExpressionType::WINDOW_PERCENT_RANK: {
-			int64_t denom = (int64_t)bounds.partition_end - bounds.partition_start - 1;
-			double percent_rank = denom > 0 ? ((double)rank - 1) / denom : 0;
-			res = Value(percent_rank);
-			break;
-		}
-		case ExpressionType::WINDOW_CUME_DIST: {
-			int64_t denom = (int64_t)bounds.partition_end - bounds.partition_start;
-			double cume_dist = denom > 0 ? ((double)(bounds.peer_end - bounds.partition_start)) / denom : 0;
-			res = Value(cume_dist);
-			break;
-		}
-		case ExpressionType::WINDOW_NTILE: {
-			if (payload_collection.column_count() != 1) {
-				throw Exception("NTILE needs a parameter");
+			switch (wexpr->type) {
+			case ExpressionType::WINDOW_AGGREGATE:
+				// aggregates are computed for the whole vector at once
+				break;
+			case ExpressionType::WINDOW_ROW_NUMBER:
+				SetResult<int64_t>(result, i, row_idx - bounds.partition_start + 1);
+				break;
+			case ExpressionType::WINDOW_RANK_DENSE:
+				SetResult<int64_t>(result, i, dense_rank);
+				break;
+			case ExpressionType::WINDOW_RANK:
+				SetResult<int64_t>(result, i, rank);
+				break;
+			case ExpressionType::WINDOW_PERCENT_RANK: {
+				int64_t denom = (int64_t)bounds.partition_end - bounds.partition_start - 1;
+				double percent_rank = denom > 0 ? ((double)rank - 1) / denom : 0;
+				SetResult<double>(result, i, percent_rank);
+				break;
+			}
+			case ExpressionType::WINDOW_CUME_DIST: {
+				int64_t denom = (int64_t)bounds.partition_end - bounds.partition_start;
+				double cume_dist = denom > 0 ? ((double)(bounds.peer_end - bounds.partition_start)) / denom : 0;
+				SetResult<double>(result, i, cume_dist);
+				break;
 			}
-			auto n_param = payload_collection.GetValue(0, row_idx).GetNumericValue();
-			// With thanks from SQLite's ntileValueFunc()
-			int64_t n_total = bounds.partition_end - bounds.partition_start;
-			int64_t n_size = (n_total / n_param);
-			if (n_size > 0) {
-				int64_t n_large = n_total - n_param * n_size;
-				int64_t i_small = n_large * (n_size + 1);
-
-				assert((n_large * (n_size + 1) + (n_param - n_large) * n_size) == n_total);
-
-				if (row_idx < (index_t)i_small) {
-					res = Value::Numeric(wexpr->return_type, 1 + row_idx / (n_size + 1));
+			case ExpressionType::WINDOW_NTILE: {
+				assert(payload_collection.column_count() == 1);
+				auto n_param = GetOffset(payload_collection, false, row_idx);
+				if (n_param <= 0) {
+					throw Exception("Argument for NTILE must be greater than zero");
+				}
+				// With thanks from SQLite's ntileValueFunc()
+				int64_t n_total = bounds.partition_end - bounds.partition_start;
+				int64_t n_size = (n_total / n_param);
+				int64_t adjusted_row_idx = row_idx - bounds.partition_start;
+				if (n_size > 0) {
+					int64_t n_large = n_total - n_param * n_size;
+					int64_t i_small = n_large * (n_size + 1);
+
+					assert((n_large * (n_size + 1) + (n_param - n_large) * n_size) == n_total);
+
+					if (adjusted_row_idx < i_small) {
+						SetResult<int64_t>(result, i, 1 + adjusted_row_idx / (n_size + 1));
+					} else {
+						SetResult<int64_t>(result, i, 1 + n_large + (adjusted_row_idx - i_small) / n_size);
+					}
 				} else {
-					res = Value::Numeric(wexpr->return_type, 1 + n_large + (row_idx - i_small) / n_size);
+					// more buckets than rows: every row is in its own bucket
+					SetResult<int64_t>(result, i, adjusted_row_idx + 1);
 				}
+				break;
 			}
-			break;
-		}
-		case ExpressionType::WINDOW_LEAD:
-		case ExpressionType::WINDOW_LAG: {
-			Value def_val = Value(wexpr->return_type);
-			index_t offset = 1;
-			if (wexpr->offset_expr) {
-				offset = leadlag_offset_collection.GetValue(0, wexpr->offset_expr->IsScalar() ? 0 : row_idx)
-				             .GetNumericValue();
-			}
-			if (wexpr->default_expr) {
-				def_val = leadlag_default_collection.GetValue(0, wexpr->default_expr->IsScalar() ? 0 : row_idx);
-			}
-			if (wexpr->type == ExpressionType::WINDOW_LEAD) {
-				auto lead_idx = row_idx + 1;
-				if (lead_idx < bounds.partition_end) {
-					res = payload_collection.GetValue(0, lead_idx);
+			case ExpressionType::WINDOW_LEAD:
+			case ExpressionType::WINDOW_LAG: {
+				int64_t offset = 1;
+				if (wexpr->offset_expr) {
+					offset = GetOffset(leadlag_offset_collection, wexpr->offset_expr->IsScalar(), row_idx);
+				}
+				int64_t source_idx =
+				    wexpr->type == ExpressionType::WINDOW_LEAD ? (int64_t)row_idx + offset : (int64_t)row_idx - offset;
+				if (source_idx >= (int64_t)bounds.partition_start && source_idx < (int64_t)bounds.partition_end) {
+					CopyCell(payload_collection, 0, source_idx, result, i);
+				} else if (wexpr->default_expr) {
+					CopyCell(leadlag_default_collection, 0, wexpr->default_expr->IsScalar() ? 0 : row_idx, result, i);
 				} else {
-					res = def_val;
+					result.nullmask[i] = true;
 				}
-			} else {
-				int64_t lag_idx = (int64_t)row_idx - offset;
-				if (lag_idx >= 0 && (index_t)lag_idx >= bounds.partition_start) {
-					res = payload_collection.GetValue(0, lag_idx);
+				break;
+			}
+			case ExpressionType::WINDOW_FIRST_VALUE:
+			case ExpressionType::WINDOW_LAST_VALUE:
+				// if no values are read for window, result is NULL
+				if (bounds.window_start >= bounds.window_end) {
+					result.nullmask[i] = true;
+				} else if (wexpr->type == ExpressionType::WINDOW_FIRST_VALUE) {
+					CopyCell(payload_collection, 0, bounds.window_start, result, i);
 				} else {
-					res = def_val;
+					CopyCell(payload_collection, 0, bounds.window_end - 1, result, i);
 				}
+				break;
+			default:
+				throw NotImplementedException("Window aggregate type %s", ExpressionTypeToString(wexpr->type).c_str());
 			}
-
-			break;
 		}
-		case ExpressionType::WINDOW_FIRST_VALUE: {
-			res = payload_collection.GetValue(0, bounds.window_start);
-			break;
+		if (wexpr->type != ExpressionType::WINDOW_AGGREGATE) {
+			continue;
 		}
-		case ExpressionType::WINDOW_LAST_VALUE: {
-			res = payload_collection.GetValue(0, bounds.window_end - 1);
-			break;
+		if (segment_tree) {
+			segment_tree->Compute(result, window_begins, window_ends, result.count);
+		} else {
+			// an aggregate without arguments (COUNT(*)) counts the rows of the frame
+			assert(result.type == TypeId::BIGINT);
+			for (index_t i = 0; i < result.count; i++) {
+				SetResult<int64_t>(result, i, window_ends[i] - window_begins[i]);
+			}
+		}
+	}
+}
+
+//! Copies the results of a window expression into the output column at the positions of their input rows: result k
+//! belongs to input row order[k], which is the row row_ids[order[k]] of the output if row_ids is set
+static void ScatterResults(ChunkCollection &results, index_t order[], index_t row_ids[], ChunkCollection &output,
+                           index_t output_idx) {
+	for (index_t k = 0; k < results.count; k++) {
+		index_t row_idx = row_ids ? row_ids[order[k]] : order[k];
+		auto &target = output.GetChunk(row_idx).data[output_idx];
+		CopyCell(results, 0, k, target, row_idx % STANDARD_VECTOR_SIZE);
+	}
+}
+
+static void SetPartitionSelection(DataChunk &chunk, sel_t *sel_vector, index_t count) {
+	chunk.sel_vector = sel_vector;
+	for (index_t i = 0; i < chunk.column_count; i++) {
+		chunk.data[i].sel_vector = sel_vector;
+		chunk.data[i].count = count;
+	}
+}
+
+//! The rows of the input that belong to one hash partition of a window expression
+struct WindowHashPartition {
+	//! The rows of the partition
+	ChunkCollection input;
+	//! The positions of the rows in the input
+	vector<index_t> row_ids;
+	//! The results of the window expression, and the rows of the partition they belong to
+	ChunkCollection results;
+	unique_ptr<index_t[]> order;
+};
+
+//! Returns true if the window expression can be computed by evaluating partitions of the input in parallel
+static bool CanParallelizeWindow(ClientContext &context, BoundWindowExpression *wexpr, ChunkCollection &input) {
+	if (wexpr->partitions.size() == 0 || input.count <= STANDARD_VECTOR_SIZE) {
+		return false;
+	}
+	if (context.db.scheduler->NumberOfThreads() <= 1 || context.profiler.IsEnabled()) {
+		return false;
+	}
+	return !ParallelPipeline::HasSideEffects(*wexpr);
+}
+
+//! Computes a window expression with a PARTITION BY clause: the window partitions are independent, so the rows are
+//! divided over hash partitions on their PARTITION BY keys which are then sorted and evaluated in parallel
+static void ComputePartitionedWindowExpression(ClientContext &context, BoundWindowExpression *wexpr,
+                                               ChunkCollection &input, ChunkCollection &output, index_t output_idx) {
+	vector<TypeId> partition_types;
+	vector<Expression *> exprs;
+	for (auto &pexpr : wexpr->partitions) {
+		partition_types.push_back(pexpr->return_type);
+		exprs.push_back(pexpr.get());
+	}
+
+	// divide the rows over the hash partitions
+	WindowHashPartition partitions[PhysicalWindow::PARTITION_COUNT];
+	DataChunk partition_chunk, selected_chunk;
+	partition_chunk.Initialize(partition_types);
+	selected_chunk.InitializeEmpty(input.types);
+	sel_t partition_sel[PhysicalWindow::PARTITION_COUNT][STANDARD_VECTOR_SIZE];
+	for (index_t chunk_idx = 0; chunk_idx < input.chunks.size(); chunk_idx++) {
+		auto &chunk = *input.chunks[chunk_idx];
+		index_t chunk_start = chunk_idx * STANDARD_VECTOR_SIZE;
+		partition_chunk.Reset();
+		ExpressionExecutor executor(chunk);
+		executor.Execute(exprs, partition_chunk);
+
+		StaticVector<uint64_t> hashes;
+		partition_chunk.Hash(hashes);
+		index_t partition_size[PhysicalWindow::PARTITION_COUNT] = {0};
+		VectorOperations::ExecType<uint64_t>(hashes, [&](uint64_t hash, index_t i, index_t k) {
+			auto partition = (hash >> PhysicalWindow::PARTITION_SHIFT) & (PhysicalWindow::PARTITION_COUNT - 1);
+			partition_sel[partition][partition_size[partition]++] = i;
+		});
+
+		for (index_t col_idx = 0; col_idx < chunk.column_count; col_idx++) {
+			selected_chunk.data[col_idx].Reference(chunk.data[col_idx]);
 		}
-		default:
-			throw NotImplementedException("Window aggregate type %s", ExpressionTypeToString(wexpr->type).c_str());
+		for (index_t partition = 0; partition < PhysicalWindow::PARTITION_COUNT; partition++) {
+			if (partition_size[partition] == 0) {
+				continue;
+			}
+			SetPartitionSelection(selected_chunk, partition_sel[partition], partition_size[partition]);
+			partitions[partition].input.Append(selected_chunk);
+			for (index_t i = 0; i < partition_size[partition]; i++) {
+				partitions[partition].row_ids.push_back(chunk_start + partition_sel[partition][i]);
+			}
 		}
+	}
 
-		output.SetValue(output_idx, row_idx, res);
+	// sort and evaluate the partitions in parallel
+	atomic<index_t> next_partition(0);
+	context.db.scheduler->ExecuteParallel(PhysicalWindow::PARTITION_COUNT, [&](index_t thread_index) {
+		index_t partition_idx;
+		while ((partition_idx = next_partition++) < PhysicalWindow::PARTITION_COUNT) {
+			auto &partition = partitions[partition_idx];
+			if (partition.input.count == 0) {
+				continue;
+			}
+			partition.order = unique_ptr<index_t[]>(new index_t[partition.input.count]);
+			ComputeWindowExpression(context, wexpr, partition.input, partition.results, partition.order.get());
+		}
+	});
+
+	// finally write the results back to the positions of the rows in the input
+	for (auto &partition : partitions) {
+		if (partition.input.count > 0) {
+			ScatterResults(partition.results, partition.order.get(), partition.row_ids.data(), output, output_idx);
+		}
 	}
 }
 
@@ -479,12 +637,19 @@ void PhysicalWindow::GetChunkInternal(ClientContext &context, DataChunk &chunk,
 
 		assert(window_results.column_count() == select_list.size());
 		index_t window_output_idx = 0;
-		// we can have multiple window functions
+		// we can have multiple window functions, the results of which are written in the order of the input rows
 		for (index_t expr_idx = 0; expr_idx < select_list.size(); expr_idx++) {
 			assert(select_list[expr_idx]->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
 			// sort by partition and order clause in window def
 			auto wexpr = reinterpret_cast<BoundWindowExpression *>(select_list[expr_idx].get());
-			ComputeWindowExpression(context, wexpr, big_data, window_results, window_output_idx++);
+			if (CanParallelizeWindow(context, wexpr, big_data)) {
+				ComputePartitionedWindowExpression(context, wexpr, big_data, window_results, window_output_idx++);
+				continue;
+			}
+			ChunkCollection results;
+			auto order = unique_ptr<index_t[]>(new index_t[big_data.count]);
+			ComputeWindowExpression(context, wexpr, big_data, results, order.get());
+			ScatterResults(results, order.get(), nullptr, window_results, window_output_idx++);
 		}
 	}
 
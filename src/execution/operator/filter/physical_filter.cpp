@@ -1,12 +1,40 @@
 #include "execution/operator/filter/physical_filter.hpp"
 
+#include "common/profiler.hpp"
 #include "execution/expression_executor.hpp"
 
+#include <algorithm>
+#include <limits>
+
 using namespace duckdb;
 using namespace std;
 
+//! Reorders the filter expressions on the statistics gathered since the last update. Expressions are ordered on their
+//! cost per tuple divided by the fraction of tuples they filter out, which minimizes the expected cost of evaluating
+//! them one after the other.
+static void UpdateFilterOrder(PhysicalFilterOperatorState &state) {
+	auto &statistics = state.statistics;
+	for (auto &stats : statistics) {
+		if (stats.tuples_in == 0) {
+			// not every expression was evaluated: keep the current order
+			return;
+		}
+	}
+	vector<double> rank(statistics.size());
+	for (index_t i = 0; i < statistics.size(); i++) {
+		auto &stats = statistics[i];
+		double cost = stats.time / stats.tuples_in;
+		double filtered = 1 - (double)stats.tuples_out / stats.tuples_in;
+		rank[i] = filtered > 0 ? cost / filtered : numeric_limits<double>::infinity();
+	}
+	stable_sort(state.order.begin(), state.order.end(), [&](index_t a, index_t b) { return rank[a] < rank[b]; });
+	for (auto &stats : statistics) {
+		stats = FilterExpressionStatistics();
+	}
+}
+
 void PhysicalFilter::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalOperatorState *>(state_);
+	auto state = reinterpret_cast<PhysicalFilterOperatorState *>(state_);
 	do {
 		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
 		if (state->child_chunk.size() == 0) {
@@ -15,20 +43,47 @@ void PhysicalFilter::GetChunkInternal(ClientContext &context, DataChunk &chunk,
 
 		assert(expressions.size() > 0);
 
-		Vector result(TypeId::BOOLEAN, true, false);
-		ExpressionExecutor executor(state->child_chunk);
-		executor.Merge(expressions, result);
-
-		// now generate the selection vector
 		chunk.sel_vector = state->child_chunk.sel_vector;
 		for (index_t i = 0; i < chunk.column_count; i++) {
 			// create a reference to the vector of the child chunk
 			chunk.data[i].Reference(state->child_chunk.data[i]);
 		}
-		chunk.SetSelectionVector(result);
+
+		// evaluate the expressions one by one, every expression only for the tuples that passed the previous ones
+		ExpressionExecutor executor(chunk);
+		bool gather_statistics = expressions.size() > 1;
+		Profiler profiler;
+		for (index_t i = 0; i < expressions.size() && chunk.size() > 0; i++) {
+			auto expr_idx = state->order[i];
+			auto tuples_in = chunk.size();
+			if (gather_statistics) {
+				profiler.Start();
+			}
+
+			Vector result(TypeId::BOOLEAN, true, false);
+			executor.ExecuteExpression(*expressions[expr_idx], result);
+			// now generate the selection vector
+			chunk.SetSelectionVector(result);
+
+			if (gather_statistics) {
+				profiler.End();
+				auto &stats = state->statistics[expr_idx];
+				stats.tuples_in += tuples_in;
+				stats.tuples_out += chunk.size();
+				stats.time += profiler.Elapsed();
+			}
+		}
+		if (gather_statistics && ++state->chunk_count == ADAPTIVE_INTERVAL) {
+			UpdateFilterOrder(*state);
+			state->chunk_count = 0;
+		}
 	} while (chunk.size() == 0);
 }
 
+unique_ptr<PhysicalOperatorState> PhysicalFilter::GetOperatorState() {
+	return make_unique<PhysicalFilterOperatorState>(children[0].get(), expressions.size());
+}
+
 string PhysicalFilter::ExtraRenderInformation() const {
 	string extra_info;
 	for (auto &expr : expressions) {
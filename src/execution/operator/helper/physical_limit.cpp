@@ -11,25 +11,31 @@ void PhysicalLimit::GetChunkInternal(ClientContext &context, DataChunk &chunk, P
 		return;
 	}
 
-	// get the next chunk from the child
-	children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-	if (state->child_chunk.size() == 0) {
-		return;
+	while (true) {
+		// get the next chunk from the child
+		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+		if (state->child_chunk.size() == 0) {
+			return;
+		}
+		if (state->current_offset + state->child_chunk.size() > offset) {
+			break;
+		}
+		// the entire chunk is before the offset point: skip it, as an empty chunk would end the result
+		state->current_offset += state->child_chunk.size();
 	}
 
 	if (state->current_offset < offset) {
-		// we are not yet at the offset point
-		if (state->current_offset + state->child_chunk.size() >= offset) {
-			// however we will reach it in this chunk
-			// we have to copy part of the chunk with an offset
-			index_t start_position = offset - state->current_offset;
-			index_t chunk_count = min(limit, state->child_chunk.size() - start_position);
-			for (index_t i = 0; i < chunk.column_count; i++) {
-				chunk.data[i].Reference(state->child_chunk.data[i]);
-				chunk.data[i].data = chunk.data[i].data + GetTypeIdSize(chunk.data[i].type) * start_position;
-				chunk.data[i].count = chunk_count;
-			}
-			chunk.sel_vector = move(state->child_chunk.sel_vector);
+		// we are not yet at the offset point, but we will reach it in this chunk
+		// we have to copy part of the chunk with an offset
+		index_t start_position = offset - state->current_offset;
+		index_t chunk_count = min(limit, state->child_chunk.size() - start_position);
+		// the offset is applied to the data, so the chunk cannot have a selection vector
+		state->child_chunk.Flatten();
+		for (index_t i = 0; i < chunk.column_count; i++) {
+			chunk.data[i].Reference(state->child_chunk.data[i]);
+			chunk.data[i].data = chunk.data[i].data + GetTypeIdSize(chunk.data[i].type) * start_position;
+			chunk.data[i].nullmask = state->child_chunk.data[i].nullmask >> start_position;
+			chunk.data[i].count = chunk_count;
 		}
 	} else {
 		// have to copy either the entire chunk or part of it
@@ -2,6 +2,11 @@
 
 #include "common/vector_operations/vector_operations.hpp"
 #include "execution/expression_executor.hpp"
+#include "execution/parallel_pipeline.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
+
+#include <atomic>
 
 using namespace duckdb;
 using namespace std;
@@ -15,41 +20,222 @@ PhysicalHashJoin::PhysicalHashJoin(LogicalOperator &op, unique_ptr<PhysicalOpera
 	children.push_back(move(right));
 }
 
-void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalHashJoinOperatorState *>(state_);
-	if (!state->initialized) {
-		// build the HT
-		auto right_state = children[1]->GetOperatorState();
-		auto types = children[1]->GetTypes();
-
-		DataChunk right_chunk;
-		right_chunk.Initialize(types);
-
-		state->join_keys.Initialize(hash_table->condition_types);
-		while (true) {
-			// get the child chunk
-			children[1]->GetChunk(context, right_chunk, right_state.get());
-			if (right_chunk.size() == 0) {
-				break;
+static bool ConditionsHaveSideEffects(vector<JoinCondition> &conditions) {
+	for (auto &condition : conditions) {
+		if (ParallelPipeline::HasSideEffects(*condition.left) || ParallelPipeline::HasSideEffects(*condition.right)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void PhysicalHashJoin::ResolveBuildKeys(DataChunk &input, DataChunk &keys) {
+	keys.Reset();
+	ExpressionExecutor executor(input);
+	for (index_t i = 0; i < conditions.size(); i++) {
+		executor.ExecuteExpression(*conditions[i].right, keys.data[i]);
+	}
+}
+
+void PhysicalHashJoin::ResolveProbeKeys(DataChunk &input, DataChunk &keys) {
+	keys.Reset();
+	ExpressionExecutor executor(input);
+	for (index_t i = 0; i < conditions.size(); i++) {
+		executor.ExecuteExpression(*conditions[i].left, keys.data[i]);
+	}
+}
+
+void PhysicalHashJoin::BuildHashTable(ClientContext &context, PhysicalHashJoinOperatorState &state) {
+	bool can_spill = CanSpill(context);
+	auto &build_partitions = state.build_partitions;
+	if (hash_table->correlated_mark_join_info.correlated_types.size() == 0 &&
+	    !ConditionsHaveSideEffects(conditions) && ParallelPipeline::CanParallelize(context, *children[1])) {
+		// the right side is a parallel pipeline: every thread builds its own chain of tuples, which are merged into
+		// the hash table afterwards
+		ParallelPipeline pipeline(context, *children[1]);
+		vector<unique_ptr<JoinHashTable::LocalBuildState>> local_states;
+		vector<unique_ptr<DataChunk>> local_keys;
+		for (index_t i = 0; i < pipeline.thread_count; i++) {
+			local_states.push_back(make_unique<JoinHashTable::LocalBuildState>());
+			local_keys.push_back(make_unique<DataChunk>());
+			local_keys.back()->Initialize(hash_table->condition_types);
+		}
+		// the total amount of tuples added by the threads, used to check whether the hash table exceeds the limit
+		atomic<index_t> build_count(0);
+		// set once the build side is spilled, after the build partitions have been created
+		atomic<bool> spilled(false);
+		mutex spill_lock;
+		pipeline.Execute([&](DataChunk &right_chunk, index_t morsel_index, index_t thread_index) {
+			auto &keys = *local_keys[thread_index];
+			auto &local_state = *local_states[thread_index];
+			ResolveBuildKeys(right_chunk, keys);
+			if (spilled) {
+				// the build side has been spilled: write the chunk to its partition files
+				hash_table->PartitionBuild(local_state, keys, right_chunk, build_partitions);
+				return;
+			}
+			hash_table->Build(local_state, keys, right_chunk);
+			if (!can_spill ||
+			    hash_table->MemoryUsage(build_count += right_chunk.size()) <= context.db.maximum_memory) {
+				return;
 			}
-			// resolve the join keys for the right chunk
-			state->join_keys.Reset();
-			ExpressionExecutor executor(right_chunk);
-			for (index_t i = 0; i < conditions.size(); i++) {
-				executor.ExecuteExpression(*conditions[i].right, state->join_keys.data[i]);
+			// the hash table exceeds the memory limit: move the tuples into radix partitions on disk
+			{
+				lock_guard<mutex> guard(spill_lock);
+				if (!spilled) {
+					CreateBuildPartitions(context, state);
+					spilled = true;
+				}
+			}
+			hash_table->Partition(local_state, build_partitions);
+		});
+		if (spilled) {
+			// the threads that did not add any tuples after the spill still hold their tuples in memory
+			for (auto &local_state : local_states) {
+				hash_table->Partition(*local_state, build_partitions);
+				hash_table->has_null = hash_table->has_null || local_state->has_null;
 			}
-			// build the HT
-			hash_table->Build(state->join_keys, right_chunk);
+			return;
 		}
+		hash_table->Finalize(local_states, *context.db.scheduler);
+		return;
+	}
+	auto right_state = children[1]->GetOperatorState();
+	auto types = children[1]->GetTypes();
 
-		if (hash_table->size() == 0 &&
-		    (hash_table->join_type == JoinType::INNER || hash_table->join_type == JoinType::SEMI)) {
-			// empty hash table with INNER or SEMI join means empty result set
-			return;
+	DataChunk right_chunk, keys;
+	right_chunk.Initialize(types);
+	keys.Initialize(hash_table->condition_types);
+	while (true) {
+		// get the child chunk
+		children[1]->GetChunk(context, right_chunk, right_state.get());
+		if (right_chunk.size() == 0) {
+			break;
+		}
+		// resolve the join keys for the right chunk
+		ResolveBuildKeys(right_chunk, keys);
+		if (build_partitions.size() > 0) {
+			// the build side has been spilled: write the chunk to its partition files
+			hash_table->PartitionBuild(keys, right_chunk, build_partitions);
+			continue;
+		}
+		// build the HT
+		hash_table->Build(keys, right_chunk);
+		if (can_spill && hash_table->MemoryUsage() > context.db.maximum_memory) {
+			// the hash table exceeds the memory limit: move it into radix partitions on disk
+			CreateBuildPartitions(context, state);
+			hash_table->Partition(build_partitions);
+		}
+	}
+}
+
+bool PhysicalHashJoin::CanProbeInParallel(ClientContext &context) {
+	// probing a correlated MARK join updates the correlated counts of the hash table
+	return hash_table->correlated_mark_join_info.correlated_types.size() == 0 && !ConditionsHaveSideEffects(conditions);
+}
+
+bool PhysicalHashJoin::CanSpill(ClientContext &context) {
+	return context.db.maximum_memory != (index_t)-1 && SpillFile::CanSpill(context) &&
+	       hash_table->correlated_mark_join_info.correlated_types.size() == 0;
+}
+
+void PhysicalHashJoin::CreateBuildPartitions(ClientContext &context, PhysicalHashJoinOperatorState &state) {
+	assert(state.build_partitions.size() == 0);
+	for (index_t i = 0; i < JoinHashTable::SPILL_PARTITION_COUNT; i++) {
+		state.build_partitions.push_back(SpillFile::Create(context));
+	}
+}
+
+void PhysicalHashJoin::PartitionProbeSide(ClientContext &context, PhysicalHashJoinOperatorState &state) {
+	vector<unique_ptr<SpillFile>> probe_partitions;
+	for (index_t i = 0; i < JoinHashTable::SPILL_PARTITION_COUNT; i++) {
+		probe_partitions.push_back(SpillFile::Create(context));
+	}
+	while (true) {
+		children[0]->GetChunk(context, state.child_chunk, state.child_state.get());
+		if (state.child_chunk.size() == 0) {
+			break;
+		}
+		ResolveProbeKeys(state.child_chunk, state.join_keys);
+		hash_table->PartitionProbe(state.join_keys, state.child_chunk, probe_partitions);
+	}
+	// the partitions are joined from the back of the list: add them in reverse order
+	for (index_t i = JoinHashTable::SPILL_PARTITION_COUNT; i > 0; i--) {
+		state.partitions.push_back(PhysicalHashJoinOperatorState::SpilledPartition(
+		    move(state.build_partitions[i - 1]), move(probe_partitions[i - 1]), 0));
+	}
+	state.build_partitions.clear();
+	state.probe_partitioned = true;
+}
+
+void PhysicalHashJoin::RepartitionSpilledPartition(ClientContext &context, PhysicalHashJoinOperatorState &state) {
+	auto &partition = state.current_partition;
+	auto depth = partition.depth + 1;
+	vector<unique_ptr<SpillFile>> build_splits, probe_splits;
+	for (index_t i = 0; i < JoinHashTable::SPILL_PARTITION_COUNT; i++) {
+		build_splits.push_back(SpillFile::Create(context));
+		probe_splits.push_back(SpillFile::Create(context));
+	}
+	hash_table->Repartition(*partition.build, build_splits, depth);
+	while (partition.probe->Scan(state.child_chunk)) {
+		ResolveProbeKeys(state.child_chunk, state.join_keys);
+		hash_table->PartitionProbe(state.join_keys, state.child_chunk, probe_splits, depth);
+	}
+	state.child_chunk.Reset();
+	state.current_partition = PhysicalHashJoinOperatorState::SpilledPartition();
+	for (index_t i = JoinHashTable::SPILL_PARTITION_COUNT; i > 0; i--) {
+		state.partitions.push_back(PhysicalHashJoinOperatorState::SpilledPartition(
+		    move(build_splits[i - 1]), move(probe_splits[i - 1]), depth));
+	}
+}
+
+bool PhysicalHashJoin::FetchProbeChunk(ClientContext &context, PhysicalHashJoinOperatorState &state) {
+	if (!state.probe_partitioned) {
+		if (state.build_partitions.size() == 0) {
+			children[0]->GetChunk(context, state.child_chunk, state.child_state.get());
+			return state.child_chunk.size() > 0;
 		}
+		PartitionProbeSide(context, state);
+	}
+	while (!state.partition_table || !state.current_partition.probe->Scan(state.child_chunk)) {
+		// finished probing the current partition (if any): release it and move on to the next one
+		state.scan_structure = nullptr;
+		state.partition_table.reset();
+		state.current_partition = PhysicalHashJoinOperatorState::SpilledPartition();
+		if (state.partitions.size() == 0) {
+			return false;
+		}
+		state.current_partition = move(state.partitions.back());
+		state.partitions.pop_back();
+		auto &partition = state.current_partition;
+		if (hash_table->MemoryUsage(partition.build->count) > context.db.maximum_memory &&
+		    partition.depth < JoinHashTable::SPILL_MAX_DEPTH) {
+			// the partition still exceeds the memory limit: split it using the next bits of the hash
+			RepartitionSpilledPartition(context, state);
+			continue;
+		}
+		// build the hash table of the partition. If all bits of the hash have been used, the partition is built in
+		// memory even if it exceeds the limit (e.g. because most tuples have the same key).
+		state.partition_table = make_unique<JoinHashTable>(conditions, children[1]->GetTypes(), hash_table->join_type);
+		state.partition_table->Build(*partition.build);
+		// NULL values in the keys are a property of the entire build side
+		state.partition_table->has_null = state.partition_table->has_null || hash_table->has_null;
+	}
+	return true;
+}
 
+void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashJoinOperatorState *>(state_);
+	if (!state->initialized) {
+		// build the HT
+		BuildHashTable(context, *state);
 		state->initialized = true;
 	}
+	if (!state->IsSpilled() && hash_table->size() == 0 &&
+	    (hash_table->join_type == JoinType::INNER || hash_table->join_type == JoinType::SEMI)) {
+		// empty hash table with INNER or SEMI join means empty result set
+		return;
+	}
 	if (state->child_chunk.size() > 0 && state->scan_structure) {
 		// still have elements remaining from the previous probe (i.e. we got
 		// >1024 elements in the previous probe)
@@ -63,15 +249,17 @@ void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk
 	// probe the HT
 	do {
 		// fetch the chunk from the left side
-		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-		if (state->child_chunk.size() == 0) {
+		if (!FetchProbeChunk(context, *state)) {
 			return;
 		}
 		// remove any selection vectors
 		state->child_chunk.Flatten();
-		if (hash_table->size() == 0) {
-			// empty hash table, special case
-			if (hash_table->join_type == JoinType::ANTI) {
+		// a spilled join probes the hash table of the current partition
+		auto &ht = state->partition_table ? *state->partition_table : *hash_table;
+		if (!state->partition_table && ht.size() == 0) {
+			// empty hash table, special case. This only applies if the entire build side is empty: the empty
+			// partition of a spilled join is probed to handle NULL values in the keys of either side
+			if (ht.join_type == JoinType::ANTI) {
 				// anti join with empty hash table, NOP join
 				// return the input
 				assert(chunk.column_count == state->child_chunk.column_count);
@@ -79,9 +267,9 @@ void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk
 					chunk.data[i].Reference(state->child_chunk.data[i]);
 				}
 				return;
-			} else if (hash_table->join_type == JoinType::MARK) {
+			} else if (ht.join_type == JoinType::MARK) {
 				// MARK join with empty hash table
-				assert(hash_table->join_type == JoinType::MARK);
+				assert(ht.join_type == JoinType::MARK);
 				assert(chunk.column_count == state->child_chunk.column_count + 1);
 				auto &result_vector = chunk.data[state->child_chunk.column_count];
 				assert(result_vector.type == TypeId::BOOLEAN);
@@ -94,7 +282,7 @@ void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk
 				// if the HT has no NULL values (i.e. empty result set), return a vector that has false for every input
 				// entry if the HT has NULL values (i.e. result set had values, but all were NULL), return a vector that
 				// has NULL for every input entry
-				if (!hash_table->has_null) {
+				if (!ht.has_null) {
 					auto bool_result = (bool *)result_vector.data;
 					for (index_t i = 0; i < result_vector.count; i++) {
 						bool_result[i] = false;
@@ -106,17 +294,15 @@ void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk
 			}
 		}
 		// resolve the join keys for the left chunk
-		state->join_keys.Reset();
-		ExpressionExecutor executor(state->child_chunk);
-		for (index_t i = 0; i < conditions.size(); i++) {
-			executor.ExecuteExpression(*conditions[i].left, state->join_keys.data[i]);
-		}
+		ResolveProbeKeys(state->child_chunk, state->join_keys);
 		// perform the actual probe
-		state->scan_structure = hash_table->Probe(state->join_keys);
+		state->scan_structure = ht.Probe(state->join_keys);
 		state->scan_structure->Next(state->join_keys, state->child_chunk, chunk);
 	} while (chunk.size() == 0);
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalHashJoin::GetOperatorState() {
-	return make_unique<PhysicalHashJoinOperatorState>(children[0].get(), children[1].get());
+	auto state = make_unique<PhysicalHashJoinOperatorState>(children[0].get(), children[1].get());
+	state->join_keys.Initialize(hash_table->condition_types);
+	return move(state);
 }
@@ -0,0 +1,211 @@
+#include "execution/operator/join/physical_index_join.hpp"
+
+#include "common/types/static_vector.hpp"
+#include "common/vector_operations/vector_operations.hpp"
+#include "execution/expression_executor.hpp"
+#include "main/client_context.hpp"
+#include "planner/expression/bound_comparison_expression.hpp"
+#include "planner/expression/bound_reference_expression.hpp"
+
+#include <cstring>
+
+using namespace duckdb;
+using namespace std;
+
+constexpr index_t PhysicalIndexJoin::CARDINALITY_RATIO;
+
+PhysicalIndexJoin::PhysicalIndexJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> probe,
+                                     TableCatalogEntry &tableref, Index &index, vector<column_t> column_ids,
+                                     vector<JoinCondition> cond, vector<index_t> key_columns, bool table_is_left)
+    : PhysicalComparisonJoin(op, PhysicalOperatorType::INDEX_JOIN, move(cond), JoinType::INNER), tableref(tableref),
+      index(index), fetch_ids(move(column_ids)), table_is_left(table_is_left) {
+	children.push_back(move(probe));
+	// the row ids are fetched as well, to find out which of the rows are visible to the transaction
+	fetch_ids.push_back(COLUMN_IDENTIFIER_ROW_ID);
+
+	// the keys of the index are formed by the left sides of the equality conditions on the key columns
+	for (auto column : key_columns) {
+		Expression *key_expression = nullptr;
+		for (auto &condition : conditions) {
+			if (condition.comparison != ExpressionType::COMPARE_EQUAL ||
+			    condition.right->type != ExpressionType::BOUND_REF) {
+				continue;
+			}
+			if (((BoundReferenceExpression &)*condition.right).index == column) {
+				key_expression = condition.left.get();
+				break;
+			}
+		}
+		assert(key_expression);
+		key_expressions.push_back(key_expression);
+	}
+	// all the conditions are verified on the fetched rows: the values of the conditions are placed in a chunk with
+	// the values of the probe side followed by the values of the table
+	for (index_t i = 0; i < conditions.size(); i++) {
+		auto &condition = conditions[i];
+		auto left = make_unique<BoundReferenceExpression>(condition.left->return_type, i);
+		auto right = make_unique<BoundReferenceExpression>(condition.right->return_type, conditions.size() + i);
+		match_expressions.push_back(
+		    make_unique<BoundComparisonExpression>(condition.comparison, move(left), move(right)));
+	}
+}
+
+//! Copies the rows rows[0], rows[1], ..., rows[count - 1] of the source vector into the target vector. Strings are
+//! not copied: the target refers to the strings of the source.
+static void GatherRows(Vector &source, sel_t rows[], index_t count, Vector &target) {
+	assert(source.type == target.type && !target.sel_vector);
+	auto width = GetTypeIdSize(source.type);
+	for (index_t i = 0; i < count; i++) {
+		target.nullmask[i] = source.nullmask[rows[i]];
+		memcpy(target.data + i * width, source.data + rows[i] * width, width);
+	}
+	target.count = count;
+}
+
+//! Fetch the next set of matches of the probe chunk, and write the rows that satisfy all the join conditions to the
+//! result
+static void FetchMatches(PhysicalIndexJoin &join, Transaction &transaction, PhysicalIndexJoinOperatorState &state,
+                         DataChunk &result) {
+	auto &probe = state.child_chunk;
+	index_t count = std::min((index_t)STANDARD_VECTOR_SIZE, state.row_ids.size() - state.position);
+	Vector row_identifiers(ROW_TYPE, (data_ptr_t)&state.row_ids[state.position]);
+	row_identifiers.count = count;
+
+	state.fetch_chunk.Reset();
+	join.index.table.Fetch(transaction, state.fetch_chunk, join.fetch_ids, row_identifiers);
+
+	// rows that are not visible to the transaction are skipped by the fetch: line up the fetched rows with the matches
+	auto fetched_ids = (row_t *)state.fetch_chunk.data[join.fetch_ids.size() - 1].data;
+	index_t fetch_count = state.fetch_chunk.size();
+	sel_t probe_rows[STANDARD_VECTOR_SIZE];
+	index_t fetched = 0;
+	for (index_t i = 0; i < count && fetched < fetch_count; i++) {
+		if (state.row_ids[state.position + i] == fetched_ids[fetched]) {
+			auto row = state.probe_rows[state.position + i];
+			probe_rows[fetched++] = probe.sel_vector ? probe.sel_vector[row] : row;
+		}
+	}
+	assert(fetched == fetch_count);
+	state.position += count;
+	if (fetch_count == 0) {
+		return;
+	}
+
+	// construct the joined rows: the rows of the probe side are replicated for each of their matches
+	index_t table_columns = join.fetch_ids.size() - 1;
+	index_t probe_offset = join.table_is_left ? table_columns : 0;
+	index_t table_offset = join.table_is_left ? 0 : probe.column_count;
+	DataChunk matched_probe;
+	auto probe_types = probe.GetTypes();
+	matched_probe.InitializeEmpty(probe_types);
+	for (index_t i = 0; i < probe.column_count; i++) {
+		GatherRows(probe.data[i], probe_rows, fetch_count, result.data[probe_offset + i]);
+		matched_probe.data[i].Reference(result.data[probe_offset + i]);
+	}
+	for (index_t i = 0; i < table_columns; i++) {
+		result.data[table_offset + i].Reference(state.fetch_chunk.data[i]);
+	}
+
+	// the index only finds candidate rows: the visible version of a row might have a different key, and not all
+	// the conditions are necessarily part of the index. Verify all the conditions on the joined rows.
+	auto &conditions = join.conditions;
+	vector<TypeId> condition_types;
+	for (auto &condition : conditions) {
+		condition_types.push_back(condition.left->return_type);
+	}
+	for (auto &condition : conditions) {
+		condition_types.push_back(condition.right->return_type);
+	}
+	DataChunk condition_chunk;
+	condition_chunk.InitializeEmpty(condition_types);
+	ExpressionExecutor probe_executor(matched_probe);
+	ExpressionExecutor table_executor(state.fetch_chunk);
+	for (index_t i = 0; i < conditions.size(); i++) {
+		probe_executor.ExecuteExpression(*conditions[i].left, condition_chunk.data[i]);
+		table_executor.ExecuteExpression(*conditions[i].right, condition_chunk.data[conditions.size() + i]);
+	}
+	StaticVector<bool> matches;
+	ExpressionExecutor condition_executor(condition_chunk);
+	condition_executor.Merge(join.match_expressions, matches);
+
+	auto match_data = (bool *)matches.data;
+	index_t result_count = 0;
+	VectorOperations::Exec(matches, [&](index_t i, index_t k) {
+		if (match_data[i] && !matches.nullmask[i]) {
+			result.owned_sel_vector[result_count++] = i;
+		}
+	});
+	if (result_count < fetch_count) {
+		result.sel_vector = result.owned_sel_vector;
+		for (index_t i = 0; i < result.column_count; i++) {
+			result.data[i].sel_vector = result.sel_vector;
+			result.data[i].count = result_count;
+		}
+	}
+}
+
+void PhysicalIndexJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalIndexJoinOperatorState *>(state_);
+	auto &transaction = context.ActiveTransaction();
+	if (state->row_end == INVALID_INDEX) {
+		// like a table scan, the join does not see the rows that are appended to the table after it started (e.g. by
+		// an INSERT that is fed by the join itself)
+		TableScanState scan_state;
+		index.table.InitializeScan(scan_state);
+		state->row_end = scan_state.last_chunk->start + scan_state.last_chunk_count;
+	}
+	while (true) {
+		if (state->position < state->row_ids.size()) {
+			// the probe chunk has matches left
+			FetchMatches(*this, transaction, *state, chunk);
+			if (chunk.size() > 0) {
+				return;
+			}
+			chunk.Reset();
+			continue;
+		}
+		// look up the keys of the next probe chunk in the index
+		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+		if (state->child_chunk.size() == 0) {
+			return;
+		}
+		state->join_keys.Reset();
+		ExpressionExecutor executor(state->child_chunk);
+		executor.Execute(key_expressions, state->join_keys);
+
+		state->probe_rows.clear();
+		state->row_ids.clear();
+		state->position = 0;
+		index.LookupKeys(state->join_keys, state->probe_rows, state->row_ids);
+		index_t match_count = 0;
+		for (index_t i = 0; i < state->row_ids.size(); i++) {
+			if ((index_t)state->row_ids[i] < state->row_end) {
+				state->probe_rows[match_count] = state->probe_rows[i];
+				state->row_ids[match_count] = state->row_ids[i];
+				match_count++;
+			}
+		}
+		state->probe_rows.resize(match_count);
+		state->row_ids.resize(match_count);
+	}
+}
+
+unique_ptr<PhysicalOperatorState> PhysicalIndexJoin::GetOperatorState() {
+	auto state = make_unique<PhysicalIndexJoinOperatorState>(children[0].get());
+	vector<TypeId> key_types;
+	for (auto &expr : key_expressions) {
+		key_types.push_back(expr->return_type);
+	}
+	state->join_keys.Initialize(key_types);
+	vector<TypeId> fetch_types;
+	auto &table_types = index.table.types;
+	for (auto column_id : fetch_ids) {
+		fetch_types.push_back(column_id == COLUMN_IDENTIFIER_ROW_ID ? ROW_TYPE : table_types[column_id]);
+	}
+	state->fetch_chunk.Initialize(fetch_types);
+	return move(state);
+}
+
+string PhysicalIndexJoin::ExtraRenderInformation() const {
+	return tableref.name + "\n" + PhysicalComparisonJoin::ExtraRenderInformation();
+}
@@ -4,48 +4,272 @@
 #include "common/value_operations/value_operations.hpp"
 #include "common/vector_operations/vector_operations.hpp"
 #include "execution/expression_executor.hpp"
+#include "execution/parallel_pipeline.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
 #include "storage/data_table.hpp"
 
+#include <algorithm>
+
 using namespace duckdb;
 using namespace std;
 
+void PhysicalOrder::SortData(ChunkCollection &data, ChunkCollection &keys, unique_ptr<index_t[]> &sorted_vector) {
+	// compute the sorting columns from the input data
+	vector<TypeId> sort_types;
+	vector<Expression *> order_expressions;
+	vector<OrderType> order_types;
+	for (index_t i = 0; i < orders.size(); i++) {
+		auto &expr = orders[i].expression;
+		sort_types.push_back(expr->return_type);
+		order_expressions.push_back(expr.get());
+		order_types.push_back(orders[i].type);
+	}
+
+	for (index_t i = 0; i < data.chunks.size(); i++) {
+		DataChunk sort_chunk;
+		sort_chunk.Initialize(sort_types);
+
+		ExpressionExecutor executor(*data.chunks[i]);
+		executor.Execute(order_expressions, sort_chunk);
+		keys.Append(sort_chunk);
+	}
+
+	assert(keys.count == data.count);
+
+	// now perform the actual sort
+	sorted_vector = unique_ptr<index_t[]>(new index_t[keys.count]);
+	keys.Sort(order_types, sorted_vector.get());
+}
+
+void PhysicalOrder::WriteRun(ClientContext &context, ChunkCollection &data, PhysicalOrderOperatorState &state) {
+	ChunkCollection keys;
+	unique_ptr<index_t[]> sorted_vector;
+	SortData(data, keys, sorted_vector);
+
+	// write the sorted data together with its sort keys, so the keys do not need to be recomputed while merging
+	auto run = make_unique<SortedRun>(SpillFile::Create(context));
+	DataChunk data_chunk, key_chunk, run_chunk;
+	data_chunk.Initialize(data.types);
+	key_chunk.Initialize(keys.types);
+	auto run_types = data.types;
+	run_types.insert(run_types.end(), keys.types.begin(), keys.types.end());
+	run_chunk.InitializeEmpty(run_types);
+	for (index_t position = 0; position < data.count; position += STANDARD_VECTOR_SIZE) {
+		data_chunk.Reset();
+		key_chunk.Reset();
+		data.MaterializeSortedChunk(data_chunk, sorted_vector.get(), position);
+		keys.MaterializeSortedChunk(key_chunk, sorted_vector.get(), position);
+		for (index_t i = 0; i < data_chunk.column_count; i++) {
+			run_chunk.data[i].Reference(data_chunk.data[i]);
+		}
+		for (index_t i = 0; i < key_chunk.column_count; i++) {
+			run_chunk.data[data_chunk.column_count + i].Reference(key_chunk.data[i]);
+		}
+		run->file->Append(run_chunk);
+	}
+	state.runs.push_back(move(run));
+}
+
+//! Heap comparator that places the run with the smallest next tuple at the top of the heap
+struct SortedRunComparator {
+	vector<unique_ptr<SortedRun>> &runs;
+	vector<OrderType> &order_types;
+	index_t key_offset;
+
+	bool operator()(index_t left, index_t right) {
+		auto &left_run = *runs[left];
+		auto &right_run = *runs[right];
+		auto comp_res = ChunkCollection::CompareTuple(left_run.chunk, left_run.position, right_run.chunk,
+		                                              right_run.position, order_types, key_offset);
+		// equal tuples are emitted in the order of the runs
+		return comp_res == 0 ? left > right : comp_res > 0;
+	}
+};
+
+void PhysicalOrder::CombineRuns(ClientContext &context, PhysicalOrderOperatorState &state, index_t merge_width) {
+	assert(merge_width >= 2);
+	auto run_types = types;
+	for (auto &order : orders) {
+		run_types.push_back(order.expression->return_type);
+	}
+	DataChunk merge_chunk;
+	merge_chunk.Initialize(run_types);
+	while (state.runs.size() > merge_width) {
+		// merge every group of consecutive runs into a single run, equal tuples keep the order of the runs
+		vector<unique_ptr<SortedRun>> combined_runs;
+		for (index_t start = 0; start < state.runs.size(); start += merge_width) {
+			vector<unique_ptr<SortedRun>> group;
+			for (index_t i = start; i < state.runs.size() && i < start + merge_width; i++) {
+				group.push_back(move(state.runs[i]));
+			}
+			if (group.size() == 1) {
+				combined_runs.push_back(move(group[0]));
+				continue;
+			}
+			auto run = make_unique<SortedRun>(SpillFile::Create(context));
+			vector<index_t> heap;
+			InitializeMerge(group, heap);
+			while (true) {
+				merge_chunk.Reset();
+				MergeRuns(group, heap, merge_chunk);
+				if (merge_chunk.size() == 0) {
+					break;
+				}
+				run->file->Append(merge_chunk);
+			}
+			combined_runs.push_back(move(run));
+		}
+		state.runs = move(combined_runs);
+	}
+}
+
+void PhysicalOrder::InitializeMerge(vector<unique_ptr<SortedRun>> &runs, vector<index_t> &heap) {
+	vector<OrderType> order_types;
+	for (auto &order : orders) {
+		order_types.push_back(order.type);
+	}
+	SortedRunComparator comparator{runs, order_types, types.size()};
+	for (index_t i = 0; i < runs.size(); i++) {
+		if (runs[i]->file->Scan(runs[i]->chunk)) {
+			heap.push_back(i);
+		}
+	}
+	make_heap(heap.begin(), heap.end(), comparator);
+}
+
+static void CopyTuple(DataChunk &source, index_t source_idx, DataChunk &target, index_t target_idx) {
+	for (index_t col_idx = 0; col_idx < target.column_count; col_idx++) {
+		auto &source_vector = source.data[col_idx];
+		auto &target_vector = target.data[col_idx];
+		if (source_vector.nullmask[source_idx]) {
+			target_vector.nullmask[target_idx] = true;
+			continue;
+		}
+		if (target_vector.type == TypeId::VARCHAR) {
+			// the strings of a run are freed when its next chunk is read, so they are copied into the target
+			auto source_string = ((const char **)source_vector.data)[source_idx];
+			((const char **)target_vector.data)[target_idx] = target_vector.string_heap.AddString(source_string);
+		} else {
+			auto type_size = GetTypeIdSize(target_vector.type);
+			memcpy(target_vector.data + target_idx * type_size, source_vector.data + source_idx * type_size,
+			       type_size);
+		}
+	}
+}
+
+void PhysicalOrder::MergeRuns(vector<unique_ptr<SortedRun>> &runs, vector<index_t> &heap, DataChunk &chunk) {
+	vector<OrderType> order_types;
+	for (auto &order : orders) {
+		order_types.push_back(order.type);
+	}
+	SortedRunComparator comparator{runs, order_types, types.size()};
+	index_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && heap.size() > 0) {
+		// move the run with the smallest tuple to the back of the heap and output its tuple
+		pop_heap(heap.begin(), heap.end(), comparator);
+		auto &run = *runs[heap.back()];
+		CopyTuple(run.chunk, run.position, chunk, count);
+		count++;
+		run.position++;
+		if (run.position >= run.chunk.size()) {
+			run.position = 0;
+			if (!run.file->Scan(run.chunk)) {
+				// the run is exhausted: remove it from the heap
+				run.file.reset();
+				heap.pop_back();
+				continue;
+			}
+		}
+		push_heap(heap.begin(), heap.end(), comparator);
+	}
+	for (index_t i = 0; i < chunk.column_count; i++) {
+		chunk.data[i].count = count;
+	}
+}
+
+//! Returns the size of the strings in the chunk, which are stored in the string heap of a ChunkCollection
+static index_t StringSize(DataChunk &chunk) {
+	index_t size = 0;
+	for (index_t col_idx = 0; col_idx < chunk.column_count; col_idx++) {
+		auto &vector = chunk.data[col_idx];
+		if (vector.type != TypeId::VARCHAR) {
+			continue;
+		}
+		auto strings = (const char **)vector.data;
+		VectorOperations::Exec(vector, [&](index_t i, index_t k) {
+			if (!vector.nullmask[i]) {
+				size += strlen(strings[i]) + 1;
+			}
+		});
+	}
+	return size;
+}
+
 void PhysicalOrder::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalOrderOperatorState *>(state_);
 	ChunkCollection &big_data = state->sorted_data;
 	if (state->position == 0) {
 		// first concatenate all the data of the child chunks
-		do {
-			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-			big_data.Append(state->child_chunk);
-		} while (state->child_chunk.size() != 0);
-
-		// now perform the actual ordering of the data
-		// compute the sorting columns from the input data
-		vector<TypeId> sort_types;
-		vector<Expression *> order_expressions;
-		vector<OrderType> order_types;
-		for (index_t i = 0; i < orders.size(); i++) {
-			auto &expr = orders[i].expression;
-			sort_types.push_back(expr->return_type);
-			order_expressions.push_back(expr.get());
-			order_types.push_back(orders[i].type);
-		}
-
-		ChunkCollection sort_collection;
-		for (index_t i = 0; i < big_data.chunks.size(); i++) {
-			DataChunk sort_chunk;
-			sort_chunk.Initialize(sort_types);
-
-			ExpressionExecutor executor(*big_data.chunks[i]);
-			executor.Execute(order_expressions, sort_chunk);
-			sort_collection.Append(sort_chunk);
-		}
-
-		assert(sort_collection.count == big_data.count);
-
-		// now perform the actual sort
-		state->sorted_vector = unique_ptr<index_t[]>(new index_t[sort_collection.count]);
-		sort_collection.Sort(order_types, state->sorted_vector.get());
+		if (context.db.maximum_memory != (index_t)-1 && SpillFile::CanSpill(context)) {
+			// the data might not fit in memory: write sorted runs to disk whenever the memory limit is exceeded
+			index_t tuple_size = 0;
+			for (auto &type : types) {
+				tuple_size += GetTypeIdSize(type);
+			}
+			for (auto &order : orders) {
+				tuple_size += GetTypeIdSize(order.expression->return_type);
+			}
+			// the size of the strings is tracked separately, for the data in memory and for the entire input
+			index_t string_size = 0, total_string_size = 0, total_count = 0;
+			do {
+				children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+				auto chunk_string_size = StringSize(state->child_chunk);
+				string_size += chunk_string_size;
+				total_string_size += chunk_string_size;
+				total_count += state->child_chunk.size();
+				big_data.Append(state->child_chunk);
+				if (big_data.count * tuple_size + string_size > context.db.maximum_memory) {
+					WriteRun(context, big_data, *state);
+					big_data.chunks.clear();
+					big_data.count = 0;
+					string_size = 0;
+				}
+			} while (state->child_chunk.size() != 0);
+			if (state->runs.size() > 0) {
+				if (big_data.count > 0) {
+					WriteRun(context, big_data, *state);
+					big_data.chunks.clear();
+					big_data.count = 0;
+				}
+				// every run that is merged holds one chunk in memory: merge as many runs at once as fit in the limit
+				auto chunk_size = STANDARD_VECTOR_SIZE * (tuple_size + total_string_size / total_count);
+				auto merge_width = std::max((index_t)2, context.db.maximum_memory / chunk_size);
+				CombineRuns(context, *state, merge_width);
+				InitializeMerge(state->runs, state->merge_heap);
+			}
+		} else if (ParallelPipeline::CanParallelize(context, *children[0])) {
+			ParallelPipeline pipeline(context, *children[0]);
+			pipeline.Materialize(big_data);
+		} else {
+			do {
+				children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+				big_data.Append(state->child_chunk);
+			} while (state->child_chunk.size() != 0);
+		}
+
+		if (state->runs.size() == 0) {
+			// the data fits in memory: sort it directly
+			ChunkCollection sort_collection;
+			SortData(big_data, sort_collection, state->sorted_vector);
+		}
+	}
+
+	if (state->runs.size() > 0) {
+		// external sort: merge the sorted runs
+		MergeRuns(state->runs, state->merge_heap, chunk);
+		state->position += chunk.size();
+		return;
 	}
 
 	if (state->position >= big_data.count) {
@@ -0,0 +1,224 @@
+#include "execution/operator/order/physical_top_n.hpp"
+
+#include "common/types/static_vector.hpp"
+#include "execution/expression_executor.hpp"
+#include "execution/parallel_pipeline.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace duckdb;
+using namespace std;
+
+//! Copies the rows rows[0], rows[1], ..., rows[count - 1] of the source collection into the columns of the target
+//! chunk. Strings are not copied: the target refers to the strings of the source.
+static void GatherRows(ChunkCollection &source, index_t rows[], index_t count, DataChunk &target) {
+	assert(count <= STANDARD_VECTOR_SIZE);
+	for (index_t col_idx = 0; col_idx < target.column_count; col_idx++) {
+		auto &target_vector = target.data[col_idx];
+		auto width = GetTypeIdSize(target_vector.type);
+		for (index_t i = 0; i < count; i++) {
+			auto &source_vector = source.GetChunk(rows[i]).data[col_idx];
+			auto source_idx = rows[i] % STANDARD_VECTOR_SIZE;
+			assert(source_vector.type == target_vector.type && !source_vector.sel_vector);
+			target_vector.nullmask[i] = source_vector.nullmask[source_idx];
+			memcpy(target_vector.data + i * width, source_vector.data + source_idx * width, width);
+		}
+		target_vector.count = count;
+	}
+}
+
+TopNHeap::TopNHeap(vector<TypeId> &types, vector<BoundOrderByNode> &orders, index_t heap_size)
+    : types(types), heap_size(heap_size), row_types(types) {
+	vector<TypeId> key_types;
+	for (auto &order : orders) {
+		key_types.push_back(order.expression->return_type);
+		order_expressions.push_back(order.expression.get());
+		order_types.push_back(order.type);
+	}
+	keys.Initialize(key_types);
+	row_types.insert(row_types.end(), key_types.begin(), key_types.end());
+	// rows with equal sort keys are ordered on their sequence number
+	row_types.push_back(TypeId::BIGINT);
+	order_types.push_back(OrderType::ASCENDING);
+}
+
+void TopNHeap::Sink(DataChunk &input, int64_t sequence_start) {
+	if (heap_size == 0 || input.size() == 0) {
+		return;
+	}
+	// compute the sort keys of the input
+	keys.Reset();
+	ExpressionExecutor executor(input);
+	executor.Execute(order_expressions, keys);
+
+	// the candidate rows consist of the input followed by the sort keys and the sequence number
+	DataChunk rows;
+	rows.InitializeEmpty(row_types);
+	for (index_t i = 0; i < input.column_count; i++) {
+		rows.data[i].Reference(input.data[i]);
+	}
+	for (index_t i = 0; i < keys.column_count; i++) {
+		rows.data[input.column_count + i].Reference(keys.data[i]);
+	}
+	for (index_t i = 0; i + 1 < rows.column_count; i++) {
+		rows.data[i].Flatten();
+	}
+	StaticVector<int64_t> sequence;
+	auto sequence_data = (int64_t *)sequence.data;
+	for (index_t i = 0; i < input.size(); i++) {
+		sequence_data[i] = sequence_start + i;
+	}
+	sequence.count = input.size();
+	rows.data[rows.column_count - 1].Reference(sequence);
+	AddRows(rows);
+}
+
+void TopNHeap::AddRows(DataChunk &rows) {
+	assert(!rows.sel_vector);
+	sel_t sel_vector[STANDARD_VECTOR_SIZE];
+	if (heap.size() == heap_size) {
+		// the heap is full: only the rows that sort before the boundary can be part of the top-n
+		auto &boundary = candidates.GetChunk(heap[0]);
+		auto boundary_idx = heap[0] % STANDARD_VECTOR_SIZE;
+		index_t count = 0;
+		for (index_t i = 0; i < rows.size(); i++) {
+			if (ChunkCollection::CompareTuple(rows, i, boundary, boundary_idx, order_types, types.size()) < 0) {
+				sel_vector[count++] = i;
+			}
+		}
+		if (count == 0) {
+			return;
+		}
+		if (count < rows.size()) {
+			rows.sel_vector = sel_vector;
+			for (index_t i = 0; i < rows.column_count; i++) {
+				rows.data[i].sel_vector = sel_vector;
+				rows.data[i].count = count;
+			}
+		}
+	}
+
+	// add the rows to the candidates, and replace the last row of the top-n with them if they sort before it
+	index_t start = candidates.count;
+	candidates.Append(rows);
+	auto comparator = [&](index_t left, index_t right) { return SortsBefore(left, right); };
+	for (index_t idx = start; idx < candidates.count; idx++) {
+		if (heap.size() < heap_size) {
+			heap.push_back(idx);
+			push_heap(heap.begin(), heap.end(), comparator);
+		} else if (SortsBefore(idx, heap[0])) {
+			pop_heap(heap.begin(), heap.end(), comparator);
+			heap.back() = idx;
+			push_heap(heap.begin(), heap.end(), comparator);
+		}
+	}
+	// remove the rejected candidates once they take up more space than the heap itself
+	if (candidates.count >= 2 * heap.size() + STANDARD_VECTOR_SIZE) {
+		Compact();
+	}
+}
+
+bool TopNHeap::SortsBefore(index_t left, index_t right) {
+	return ChunkCollection::CompareTuple(candidates.GetChunk(left), left % STANDARD_VECTOR_SIZE,
+	                                     candidates.GetChunk(right), right % STANDARD_VECTOR_SIZE, order_types,
+	                                     types.size()) < 0;
+}
+
+void TopNHeap::Compact() {
+	// gather the candidates of the heap in the order in which they were added
+	vector<index_t> members = heap;
+	sort(members.begin(), members.end());
+	ChunkCollection compacted;
+	DataChunk chunk;
+	chunk.Initialize(row_types);
+	for (index_t position = 0; position < members.size(); position += STANDARD_VECTOR_SIZE) {
+		chunk.Reset();
+		GatherRows(candidates, &members[position], min((index_t)STANDARD_VECTOR_SIZE, members.size() - position),
+		           chunk);
+		compacted.Append(chunk);
+	}
+	candidates = move(compacted);
+	// the candidates keep their relative order, so renumbering them does not change the order of the heap
+	for (auto &idx : heap) {
+		idx = lower_bound(members.begin(), members.end(), idx) - members.begin();
+	}
+}
+
+void TopNHeap::Combine(TopNHeap &other) {
+	other.Compact();
+	DataChunk rows;
+	rows.InitializeEmpty(row_types);
+	for (auto &chunk : other.candidates.chunks) {
+		rows.sel_vector = nullptr;
+		for (index_t i = 0; i < chunk->column_count; i++) {
+			rows.data[i].Reference(chunk->data[i]);
+		}
+		AddRows(rows);
+	}
+}
+
+void TopNHeap::Finalize() {
+	sort(heap.begin(), heap.end(), [&](index_t left, index_t right) { return SortsBefore(left, right); });
+}
+
+void TopNHeap::Scan(index_t &position, DataChunk &chunk) {
+	if (position >= heap.size()) {
+		return;
+	}
+	index_t count = min((index_t)STANDARD_VECTOR_SIZE, heap.size() - position);
+	GatherRows(candidates, &heap[position], count, chunk);
+	position += count;
+}
+
+void PhysicalTopN::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalTopNOperatorState *>(state_);
+	if (limit == 0) {
+		return;
+	}
+	if (!state->heap) {
+		// consume the input, keeping only the first limit + offset rows
+		state->heap = make_unique<TopNHeap>(types, orders, limit + offset);
+		if (ParallelPipeline::CanParallelize(context, *children[0])) {
+			// every thread fills its own heap, which are combined afterwards. The sequence number of a row consists of
+			// the index of its morsel and its position within the morsel, so ties are broken as in serial execution.
+			ParallelPipeline pipeline(context, *children[0]);
+			vector<unique_ptr<TopNHeap>> local_heaps;
+			vector<index_t> current_morsel(pipeline.thread_count, INVALID_INDEX);
+			vector<int64_t> morsel_position(pipeline.thread_count, 0);
+			for (index_t i = 0; i < pipeline.thread_count; i++) {
+				local_heaps.push_back(make_unique<TopNHeap>(types, orders, limit + offset));
+			}
+			pipeline.Execute([&](DataChunk &input, index_t morsel_index, index_t thread_index) {
+				if (current_morsel[thread_index] != morsel_index) {
+					current_morsel[thread_index] = morsel_index;
+					morsel_position[thread_index] = 0;
+				}
+				local_heaps[thread_index]->Sink(input, ((int64_t)morsel_index << 32) + morsel_position[thread_index]);
+				morsel_position[thread_index] += input.size();
+			});
+			for (auto &local_heap : local_heaps) {
+				state->heap->Combine(*local_heap);
+			}
+		} else {
+			int64_t sequence = 0;
+			while (true) {
+				children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+				if (state->child_chunk.size() == 0) {
+					break;
+				}
+				state->heap->Sink(state->child_chunk, sequence);
+				sequence += state->child_chunk.size();
+			}
+		}
+		state->heap->Finalize();
+		state->position = offset;
+	}
+	state->heap->Scan(state->position, chunk);
+}
+
+unique_ptr<PhysicalOperatorState> PhysicalTopN::GetOperatorState() {
+	return make_unique<PhysicalTopNOperatorState>(children[0].get());
+}
@@ -2,12 +2,14 @@
 #include "execution/operator/persistent/physical_copy_from_file.hpp"
 
 #include "catalog/catalog_entry/table_catalog_entry.hpp"
+#include "common/operator/cast_operators.hpp"
 #include "common/vector_operations/vector_operations.hpp"
 #include "main/database.hpp"
 #include "storage/data_table.hpp"
 #include "parser/column_definition.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 
 using namespace duckdb;
@@ -17,14 +19,41 @@ static char is_newline(char c) {
 	return c == '\n' || c == '\r';
 }
 
+//! Whether or not values of the type are parsed directly from the buffer into a vector of the type, instead of being
+//! added to the parse chunk as strings and cast afterwards
+static bool parse_directly(SQLType type) {
+	switch (type.id) {
+	case SQLTypeId::BOOLEAN:
+	case SQLTypeId::TINYINT:
+	case SQLTypeId::SMALLINT:
+	case SQLTypeId::INTEGER:
+	case SQLTypeId::BIGINT:
+	case SQLTypeId::FLOAT:
+	case SQLTypeId::DECIMAL:
+	case SQLTypeId::DOUBLE:
+	case SQLTypeId::DATE:
+	case SQLTypeId::TIMESTAMP:
+		return true;
+	default:
+		return false;
+	}
+}
+
 BufferedCSVReader::BufferedCSVReader(CopyInfo &info, vector<SQLType> sql_types, istream &source)
     : info(info), sql_types(sql_types), source(source), buffer_size(0), position(0), start(0) {
-	// initialize the parse_chunk with a set of VARCHAR types
-	vector<TypeId> varchar_types;
+	// initialize the parse_chunk: columns that are parsed directly get their final type, the other columns are
+	// gathered as VARCHAR and cast when the chunk is flushed
+	vector<TypeId> parse_types;
 	for (index_t i = 0; i < sql_types.size(); i++) {
-		varchar_types.push_back(TypeId::VARCHAR);
+		parse_types.push_back(parse_directly(sql_types[i]) ? GetInternalType(sql_types[i]) : TypeId::VARCHAR);
 	}
-	parse_chunk.Initialize(varchar_types);
+	parse_chunk.Initialize(parse_types);
+	// the characters that end a field outside of quotes; all other characters can be skipped without looking at them
+	memset(special_characters, 0, sizeof(special_characters));
+	special_characters[(uint8_t)info.delimiter] = true;
+	special_characters[(uint8_t)info.quote] = true;
+	special_characters[(uint8_t)'\n'] = true;
+	special_characters[(uint8_t)'\r'] = true;
 
 	if (info.header) {
 		// ignore the first line as a header line
@@ -54,12 +83,22 @@ void BufferedCSVReader::ParseCSV(DataChunk &insert_chunk) {
 			return;
 		}
 		if (in_quotes) {
+			// skip ahead to the next quote
+			auto quote = (char *)memchr(buffer.get() + position, info.quote, buffer_size - position);
+			position = quote ? quote - buffer.get() : buffer_size - 1;
 			if (buffer[position] == info.quote) {
 				// end quote
 				offset = 1;
 				in_quotes = false;
 			}
 		} else {
+			if (offset == 0) {
+				// skip the characters of the field that cannot end it, the last character of the buffer is always
+				// looked at as it can end the file
+				while (position + 1 < buffer_size && !special_characters[(uint8_t)buffer[position]]) {
+					position++;
+				}
+			}
 			if (buffer[position] == info.quote) {
 				// start quotes can only occur at the start of a field
 				if (position == start) {
@@ -166,11 +205,44 @@ void BufferedCSVReader::AddValue(char *str_val, index_t length, index_t &column)
 	if (length == 0) {
 		parse_chunk.data[column].nullmask[row_entry] = true;
 	} else {
-		auto data = (const char **)parse_chunk.data[column].data;
-		data[row_entry] = str_val;
 		str_val[length] = '\0';
-		if (!Value::IsUTF8String(str_val)) {
-			throw ParserException("Error on line %lld: file is not valid UTF8", linenr);
+		auto &vector = parse_chunk.data[column];
+		switch (sql_types[column].id) {
+		case SQLTypeId::BOOLEAN:
+			((bool *)vector.data)[row_entry] = Cast::Operation<const char *, bool>(str_val);
+			break;
+		case SQLTypeId::TINYINT:
+			((int8_t *)vector.data)[row_entry] = Cast::Operation<const char *, int8_t>(str_val);
+			break;
+		case SQLTypeId::SMALLINT:
+			((int16_t *)vector.data)[row_entry] = Cast::Operation<const char *, int16_t>(str_val);
+			break;
+		case SQLTypeId::INTEGER:
+			((int32_t *)vector.data)[row_entry] = Cast::Operation<const char *, int32_t>(str_val);
+			break;
+		case SQLTypeId::BIGINT:
+			((int64_t *)vector.data)[row_entry] = Cast::Operation<const char *, int64_t>(str_val);
+			break;
+		case SQLTypeId::FLOAT:
+			((float *)vector.data)[row_entry] = Cast::Operation<const char *, float>(str_val);
+			break;
+		case SQLTypeId::DECIMAL:
+		case SQLTypeId::DOUBLE:
+			((double *)vector.data)[row_entry] = Cast::Operation<const char *, double>(str_val);
+			break;
+		case SQLTypeId::DATE:
+			((date_t *)vector.data)[row_entry] = CastToDate::Operation<const char *, date_t>(str_val);
+			break;
+		case SQLTypeId::TIMESTAMP:
+			((timestamp_t *)vector.data)[row_entry] = CastToTimestamp::Operation<const char *, timestamp_t>(str_val);
+			break;
+		default:
+			// the string points into the buffer, it is only copied if it ends up in a VARCHAR column of the table
+			if (!Value::IsUTF8String(str_val)) {
+				throw ParserException("Error on line %lld: file is not valid UTF8", linenr);
+			}
+			((const char **)vector.data)[row_entry] = str_val;
+			break;
 		}
 	}
 	// move to the next column
@@ -197,11 +269,11 @@ void BufferedCSVReader::Flush(DataChunk &insert_chunk) {
 	}
 	// convert the columns in the parsed chunk to the types of the table
 	for (index_t col_idx = 0; col_idx < sql_types.size(); col_idx++) {
-		if (sql_types[col_idx].id == SQLTypeId::VARCHAR) {
-			// target type is varchar: just move the parsed chunk
+		if (sql_types[col_idx].id == SQLTypeId::VARCHAR || parse_directly(sql_types[col_idx])) {
+			// target type is varchar or the values have been parsed already: just move the parsed chunk
 			parse_chunk.data[col_idx].Move(insert_chunk.data[col_idx]);
 		} else {
-			// target type is not varchar: perform a cast
+			// the values are still strings: perform a cast
 			VectorOperations::Cast(parse_chunk.data[col_idx], insert_chunk.data[col_idx], SQLType(SQLTypeId::VARCHAR),
 			                       sql_types[col_idx]);
 		}
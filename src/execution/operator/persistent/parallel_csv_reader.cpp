@@ -0,0 +1,199 @@
+#include "execution/operator/persistent/parallel_csv_reader.hpp"
+
+#include "execution/operator/persistent/buffered_csv_reader.hpp"
+#include "execution/task_scheduler.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
+
+#include <atomic>
+#include <streambuf>
+
+using namespace duckdb;
+using namespace std;
+
+constexpr index_t ParallelCSVReader::RANGE_SIZE;
+constexpr index_t ParallelCSVReader::RANGES_PER_THREAD;
+
+//! A stream buffer that reads directly from a range of memory
+struct MemoryStreamBuffer : public std::streambuf {
+	MemoryStreamBuffer(char *data, index_t size) {
+		setg(data, data, data + size);
+	}
+};
+
+ParallelCSVReader::ParallelCSVReader(ClientContext &context, CopyInfo &info, vector<SQLType> sql_types,
+                                     istream &source)
+    : context(context), info(info), sql_types(sql_types), source(source) {
+	if (info.header) {
+		// ignore the first line as a header line
+		string read_line;
+		getline(source, read_line);
+		linenr++;
+		this->info.header = false;
+	}
+}
+
+void ParallelCSVReader::ParseCSV(DataChunk &insert_chunk) {
+	while (true) {
+		if (range_index < parsed_ranges.size()) {
+			auto &collection = *parsed_ranges[range_index];
+			if (chunk_index < collection.chunks.size()) {
+				// return the next chunk of the current range
+				auto &chunk = *collection.chunks[chunk_index++];
+				for (index_t col_idx = 0; col_idx < insert_chunk.column_count; col_idx++) {
+					insert_chunk.data[col_idx].Reference(chunk.data[col_idx]);
+				}
+				return;
+			}
+			// move to the next range
+			range_index++;
+			chunk_index = 0;
+			continue;
+		}
+		// all ranges of the current batch have been returned: parse the next batch
+		if (!ParseBatch()) {
+			return;
+		}
+	}
+}
+
+bool ParallelCSVReader::SplitRanges(bool eof, vector<index_t> &boundaries, vector<index_t> &line_numbers) {
+	auto data = buffer.data();
+	index_t size = buffer.size();
+	boundaries.push_back(0);
+	line_numbers.push_back(linenr);
+	// find the record boundaries, using the same state machine as BufferedCSVReader::ParseCSV so that the ranges
+	// split the file at exactly the records the serial reader would find
+	index_t start = 0, offset = 0, record_end = 0, record_count = 0;
+	bool in_quotes = false;
+	for (index_t position = 0; position < size; position++) {
+		char c = data[position];
+		if (in_quotes) {
+			if (c == info.quote) {
+				// end quote
+				offset = 1;
+				in_quotes = false;
+			}
+			continue;
+		}
+		if (c == info.quote) {
+			// start quotes can only occur at the start of a field
+			if (position == start) {
+				start++;
+				in_quotes = true;
+			}
+		} else if (c == info.delimiter) {
+			start = position + 1;
+			offset = 0;
+		}
+		if (c == '\n' || c == '\r') {
+			if (c == '\r') {
+				if (position + 1 == size && !eof) {
+					// we need the next character to know whether or not this is a \r\n newline
+					break;
+				}
+				if (position + 1 < size && data[position + 1] == '\n') {
+					position++;
+				}
+			}
+			record_end = position + 1;
+			record_count++;
+			start = record_end;
+			offset = 0;
+			if (record_end - boundaries.back() >= RANGE_SIZE) {
+				// the current range is big enough: start a new range
+				boundaries.push_back(record_end);
+				line_numbers.push_back(linenr + record_count);
+			}
+		}
+		if (offset != 0) {
+			// a character after the end quote of a field: the serial reader reads it as quoted again
+			in_quotes = true;
+		}
+	}
+	if (eof) {
+		// a final record does not need to end in a newline
+		record_end = size;
+	}
+	if (record_end == 0) {
+		return false;
+	}
+	if (boundaries.back() != record_end) {
+		boundaries.push_back(record_end);
+	} else {
+		line_numbers.pop_back();
+	}
+	linenr += record_count;
+	return true;
+}
+
+bool ParallelCSVReader::ParseBatch() {
+	parsed_ranges.clear();
+	range_index = 0;
+	chunk_index = 0;
+
+	auto &scheduler = *context.db.scheduler;
+	index_t thread_count = scheduler.NumberOfThreads();
+	// read the next batch of the file, until it contains at least one complete record
+	vector<index_t> boundaries, line_numbers;
+	index_t read_size = thread_count * RANGES_PER_THREAD * RANGE_SIZE;
+	while (true) {
+		bool eof = false;
+		if (source.good()) {
+			index_t old_size = buffer.size();
+			buffer.resize(old_size + read_size);
+			source.read(buffer.data() + old_size, read_size);
+			buffer.resize(old_size + source.gcount());
+			eof = !source.good();
+		} else {
+			eof = true;
+		}
+		if (buffer.size() == 0) {
+			return false;
+		}
+		boundaries.clear();
+		line_numbers.clear();
+		if (SplitRanges(eof, boundaries, line_numbers)) {
+			break;
+		}
+		assert(!eof);
+		// no complete record in the buffer: read more of the file
+		read_size = RANGE_SIZE;
+	}
+
+	// parse the ranges in parallel
+	index_t range_count = boundaries.size() - 1;
+	for (index_t i = 0; i < range_count; i++) {
+		parsed_ranges.push_back(make_unique<ChunkCollection>());
+	}
+	vector<TypeId> types;
+	for (auto &type : sql_types) {
+		types.push_back(GetInternalType(type));
+	}
+	atomic<index_t> next_range(0);
+	scheduler.ExecuteParallel(range_count, [&](index_t thread_index) {
+		DataChunk chunk;
+		chunk.Initialize(types);
+		while (true) {
+			index_t range = next_range++;
+			if (range >= range_count) {
+				break;
+			}
+			MemoryStreamBuffer range_buffer(buffer.data() + boundaries[range], boundaries[range + 1] - boundaries[range]);
+			istream range_stream(&range_buffer);
+			BufferedCSVReader reader(info, sql_types, range_stream);
+			reader.linenr = line_numbers[range];
+			while (true) {
+				chunk.Reset();
+				reader.ParseCSV(chunk);
+				if (chunk.size() == 0) {
+					break;
+				}
+				parsed_ranges[range]->Append(chunk);
+			}
+		}
+	});
+	// keep the incomplete record at the end of the buffer for the next batch
+	buffer.erase(buffer.begin(), buffer.begin() + boundaries.back());
+	return true;
+}
@@ -3,6 +3,9 @@
 #include "catalog/catalog_entry/table_catalog_entry.hpp"
 #include "common/file_system.hpp"
 #include "common/gzip_stream.hpp"
+#include "execution/operator/persistent/buffered_csv_reader.hpp"
+#include "execution/operator/persistent/parallel_csv_reader.hpp"
+#include "execution/task_scheduler.hpp"
 #include "main/client_context.hpp"
 #include "main/database.hpp"
 
@@ -25,7 +28,8 @@ void PhysicalCopyFromFile::GetChunkInternal(ClientContext &context, DataChunk &c
 		}
 
 		// decide based on the extension which stream to use
-		if (StringUtil::EndsWith(StringUtil::Lower(info.file_path), ".gz")) {
+		bool is_gzip = StringUtil::EndsWith(StringUtil::Lower(info.file_path), ".gz");
+		if (is_gzip) {
 			state.csv_stream = make_unique<GzipStream>(info.file_path);
 		} else {
 			auto csv_local = make_unique<ifstream>();
@@ -33,10 +37,19 @@ void PhysicalCopyFromFile::GetChunkInternal(ClientContext &context, DataChunk &c
 			state.csv_stream = move(csv_local);
 		}
 
-		state.csv_reader = make_unique<BufferedCSVReader>(info, sql_types, *state.csv_stream);
+		if (!is_gzip && context.db.scheduler->NumberOfThreads() > 1) {
+			// parse the file using multiple threads
+			state.parallel_reader = make_unique<ParallelCSVReader>(context, info, sql_types, *state.csv_stream);
+		} else {
+			state.csv_reader = make_unique<BufferedCSVReader>(info, sql_types, *state.csv_stream);
+		}
 	}
 	// read from the CSV reader
-	state.csv_reader->ParseCSV(chunk);
+	if (state.parallel_reader) {
+		state.parallel_reader->ParseCSV(chunk);
+	} else {
+		state.csv_reader->ParseCSV(chunk);
+	}
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalCopyFromFile::GetOperatorState() {
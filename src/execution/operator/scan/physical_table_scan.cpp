@@ -15,9 +15,14 @@ void PhysicalTableScan::GetChunkInternal(ClientContext &context, DataChunk &chun
 }
 
 string PhysicalTableScan::ExtraRenderInformation() const {
-	return tableref.name;
+	string extra_info = tableref.name;
+	for (auto &filter : table_filters) {
+		extra_info += "\n" + tableref.columns[filter.column_index].name +
+		              ExpressionTypeToOperator(filter.comparison_type) + filter.constant.ToString();
+	}
+	return extra_info;
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalTableScan::GetOperatorState() {
-	return make_unique<PhysicalTableScanOperatorState>(table);
+	return make_unique<PhysicalTableScanOperatorState>(table, table_filters);
 }
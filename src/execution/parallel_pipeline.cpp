@@ -0,0 +1,167 @@
+#include "execution/parallel_pipeline.hpp"
+
+#include "catalog/catalog_entry/scalar_function_catalog_entry.hpp"
+#include "execution/operator/filter/physical_filter.hpp"
+#include "execution/operator/join/physical_hash_join.hpp"
+#include "execution/operator/projection/physical_projection.hpp"
+#include "execution/operator/scan/physical_table_scan.hpp"
+#include "execution/task_scheduler.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
+#include "planner/expression/bound_function_expression.hpp"
+#include "planner/expression_iterator.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+bool ParallelPipeline::HasSideEffects(Expression &expr) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_FUNCTION) {
+		auto &function = (BoundFunctionExpression &)expr;
+		if (function.bound_function->has_side_effects) {
+			return true;
+		}
+	}
+	bool has_side_effects = false;
+	ExpressionIterator::EnumerateChildren(expr, [&](Expression &child) {
+		if (HasSideEffects(child)) {
+			has_side_effects = true;
+		}
+	});
+	return has_side_effects;
+}
+
+bool ParallelPipeline::HasSideEffects(vector<unique_ptr<Expression>> &expressions) {
+	for (auto &expr : expressions) {
+		if (HasSideEffects(*expr)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ParallelPipeline::CanParallelize(ClientContext &context, PhysicalOperator &op) {
+	if (context.db.scheduler->NumberOfThreads() <= 1) {
+		return false;
+	}
+	if (context.profiler.IsEnabled()) {
+		// the profiler tracks a single operator stack and cannot be used from multiple threads
+		return false;
+	}
+	auto current = &op;
+	while (true) {
+		switch (current->type) {
+		case PhysicalOperatorType::FILTER:
+			if (HasSideEffects(((PhysicalFilter *)current)->expressions)) {
+				return false;
+			}
+			break;
+		case PhysicalOperatorType::PROJECTION:
+			if (HasSideEffects(((PhysicalProjection *)current)->select_list)) {
+				return false;
+			}
+			break;
+		case PhysicalOperatorType::HASH_JOIN:
+			// the hash table is built before the pipeline starts, after which it can be probed concurrently
+			if (!((PhysicalHashJoin *)current)->CanProbeInParallel(context)) {
+				return false;
+			}
+			break;
+		case PhysicalOperatorType::SEQ_SCAN:
+			return ((PhysicalTableScan *)current)->column_ids.size() > 0;
+		default:
+			return false;
+		}
+		current = current->children[0].get();
+	}
+}
+
+ParallelPipeline::ParallelPipeline(ClientContext &context, PhysicalOperator &source)
+    : context(context), source(source) {
+	auto current = &source;
+	while (current->type != PhysicalOperatorType::SEQ_SCAN) {
+		assert(current->type == PhysicalOperatorType::FILTER || current->type == PhysicalOperatorType::PROJECTION ||
+		       current->type == PhysicalOperatorType::HASH_JOIN);
+		current = current->children[0].get();
+	}
+	scan = (PhysicalTableScan *)current;
+	scan->table.InitializeParallelScan(scan_state);
+	morsel_count = scan_state.morsel_count;
+	thread_count = std::min(context.db.scheduler->NumberOfThreads(), morsel_count);
+}
+
+void ParallelPipeline::Execute(function<void(DataChunk &chunk, index_t morsel_index, index_t thread_index)> sink) {
+	// build the hash tables of the joins in the pipeline first, the threads only probe them. The partitions of a
+	// spilled join are kept in the operator state it was built with, which is used if the pipeline runs serially.
+	auto serial_state = source.GetOperatorState();
+	bool spilled = false;
+	auto current_state = serial_state.get();
+	for (auto current = &source; current != scan; current = current->children[0].get()) {
+		if (current->type == PhysicalOperatorType::HASH_JOIN) {
+			auto &join_state = *((PhysicalHashJoinOperatorState *)current_state);
+			((PhysicalHashJoin *)current)->BuildHashTable(context, join_state);
+			join_state.initialized = true;
+			spilled = spilled || join_state.IsSpilled();
+		}
+		current_state = current_state->child_state.get();
+	}
+	if (spilled) {
+		// the partitions of a spilled join are joined one by one: execute the pipeline in a single thread
+		ExecuteSerial(*serial_state, sink);
+		return;
+	}
+	context.db.scheduler->ExecuteParallel(thread_count, [&](index_t thread_index) {
+		// every thread has its own copy of the operator states of the pipeline
+		auto state = source.GetOperatorState();
+		auto bottom_state = state.get();
+		for (auto current = &source; current != scan; current = current->children[0].get()) {
+			if (current->type == PhysicalOperatorType::HASH_JOIN) {
+				((PhysicalHashJoinOperatorState *)bottom_state)->initialized = true;
+			}
+			bottom_state = bottom_state->child_state.get();
+		}
+		auto &table_scan_state = ((PhysicalTableScanOperatorState *)bottom_state)->scan_offset;
+
+		DataChunk chunk;
+		source.InitializeChunk(chunk);
+		// now keep on fetching morsels and push their chunks through the pipeline
+		index_t morsel_index;
+		while (scan->table.NextParallelScanMorsel(scan_state, table_scan_state, morsel_index)) {
+			while (true) {
+				source.GetChunk(context, chunk, state.get());
+				if (chunk.size() == 0) {
+					break;
+				}
+				sink(chunk, morsel_index, thread_index);
+			}
+		}
+	});
+}
+
+void ParallelPipeline::ExecuteSerial(
+    PhysicalOperatorState &state, function<void(DataChunk &chunk, index_t morsel_index, index_t thread_index)> sink) {
+	// the hash tables have already been built with the state
+	DataChunk chunk;
+	source.InitializeChunk(chunk);
+	while (true) {
+		source.GetChunk(context, chunk, &state);
+		if (chunk.size() == 0) {
+			break;
+		}
+		// all output belongs to the first morsel
+		sink(chunk, 0, 0);
+	}
+}
+
+void ParallelPipeline::Materialize(ChunkCollection &result) {
+	// gather the output of every morsel separately, so we can concatenate them in order afterwards
+	vector<unique_ptr<ChunkCollection>> morsel_data;
+	for (index_t i = 0; i < morsel_count; i++) {
+		morsel_data.push_back(make_unique<ChunkCollection>());
+	}
+	Execute([&](DataChunk &chunk, index_t morsel_index, index_t thread_index) {
+		morsel_data[morsel_index]->Append(chunk);
+	});
+	for (auto &data : morsel_data) {
+		result.Append(*data);
+	}
+}
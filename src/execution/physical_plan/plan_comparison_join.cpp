@@ -1,23 +1,76 @@
 #include "execution/operator/join/physical_cross_product.hpp"
 #include "execution/operator/join/physical_hash_join.hpp"
+#include "execution/operator/join/physical_index_join.hpp"
 #include "execution/operator/join/physical_nested_loop_join.hpp"
 #include "execution/operator/join/physical_piecewise_merge_join.hpp"
 #include "execution/physical_plan_generator.hpp"
+#include "planner/expression/bound_columnref_expression.hpp"
+#include "planner/expression/bound_reference_expression.hpp"
 #include "planner/operator/logical_comparison_join.hpp"
+#include "planner/operator/logical_get.hpp"
+#include "storage/data_table.hpp"
 
 using namespace duckdb;
 using namespace std;
 
+//! Returns an index of the base table scanned by one of the children of the join that can be used to look up the
+//! values of the other child, or nullptr if there is none or if an index join is not expected to be faster than a hash
+//! join. For every expression of the index, key_columns is filled with the column of the scan it refers to.
+static Index *FindJoinIndex(LogicalComparisonJoin &op, bool table_is_left, vector<index_t> &key_columns) {
+	auto &table_child = *op.children[table_is_left ? 0 : 1];
+	auto &probe_child = *op.children[table_is_left ? 1 : 0];
+	if (table_child.type != LogicalOperatorType::GET) {
+		return nullptr;
+	}
+	auto &get = (LogicalGet &)table_child;
+	if (!get.table || get.table->storage->indexes.size() == 0) {
+		return nullptr;
+	}
+	// the probe side has to be considerably smaller than the table
+	if (probe_child.EstimateCardinality() * PhysicalIndexJoin::CARDINALITY_RATIO >= get.EstimateCardinality()) {
+		return nullptr;
+	}
+	for (auto &index : get.table->storage->indexes) {
+		// every expression of the index has to be a column that is compared for equality with the other side
+		key_columns.clear();
+		for (index_t i = 0; i < index->unbound_expressions.size(); i++) {
+			auto &expr = *index->unbound_expressions[i];
+			if (expr.type != ExpressionType::BOUND_COLUMN_REF) {
+				break;
+			}
+			auto column_id = index->column_ids[((BoundColumnRefExpression &)expr).binding.column_index];
+			for (auto &cond : op.conditions) {
+				auto &table_expr = table_is_left ? *cond.left : *cond.right;
+				auto &probe_expr = table_is_left ? *cond.right : *cond.left;
+				if (cond.comparison != ExpressionType::COMPARE_EQUAL || table_expr.type != ExpressionType::BOUND_REF ||
+				    table_expr.return_type != index->types[i] || probe_expr.return_type != index->types[i]) {
+					continue;
+				}
+				auto column_index = ((BoundReferenceExpression &)table_expr).index;
+				if (get.column_ids[column_index] == column_id) {
+					key_columns.push_back(column_index);
+					break;
+				}
+			}
+			if (key_columns.size() != i + 1) {
+				break;
+			}
+		}
+		if (key_columns.size() == index->unbound_expressions.size()) {
+			return index.get();
+		}
+	}
+	return nullptr;
+}
+
 unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparisonJoin &op) {
 	// now visit the children
 	assert(op.children.size() == 2);
 
-	auto left = CreatePlan(*op.children[0]);
-	auto right = CreatePlan(*op.children[1]);
-	assert(left && right);
-
 	if (op.conditions.size() == 0) {
 		// no conditions: insert a cross product
+		auto left = CreatePlan(*op.children[0]);
+		auto right = CreatePlan(*op.children[1]);
 		return make_unique<PhysicalCrossProduct>(op, move(left), move(right));
 	}
 
@@ -36,6 +89,34 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparison
 			assert(cond.comparison == ExpressionType::COMPARE_EQUAL);
 		}
 	}
+	if (has_equality && !has_null_equal_conditions && op.type == JoinType::INNER &&
+	    op.LogicalOperator::type == LogicalOperatorType::COMPARISON_JOIN) {
+		// if one side of the join is a scan of a large table with an index on the join keys, the keys of the other
+		// side can be looked up in the index instead of building a hash table over the entire table
+		for (auto table_is_left : {false, true}) {
+			vector<index_t> key_columns;
+			auto index = FindJoinIndex(op, table_is_left, key_columns);
+			if (!index) {
+				continue;
+			}
+			auto &get = (LogicalGet &)*op.children[table_is_left ? 0 : 1];
+			auto probe = CreatePlan(*op.children[table_is_left ? 1 : 0]);
+			if (table_is_left) {
+				// the index join expects the expressions of the probe side on the left side of the conditions
+				for (auto &cond : op.conditions) {
+					swap(cond.left, cond.right);
+					cond.comparison = FlipComparisionExpression(cond.comparison);
+				}
+			}
+			return make_unique<PhysicalIndexJoin>(op, move(probe), *get.table, *index, get.column_ids,
+			                                      move(op.conditions), move(key_columns), table_is_left);
+		}
+	}
+
+	auto left = CreatePlan(*op.children[0]);
+	auto right = CreatePlan(*op.children[1]);
+	assert(left && right);
+
 	unique_ptr<PhysicalOperator> plan;
 	if (has_equality) {
 		// equality join: use hash join
@@ -1,17 +1,61 @@
 #include "execution/operator/filter/physical_filter.hpp"
+#include "execution/operator/scan/physical_table_scan.hpp"
 #include "execution/physical_plan_generator.hpp"
 #include "optimizer/matcher/expression_matcher.hpp"
 #include "planner/expression/bound_comparison_expression.hpp"
 #include "planner/expression/bound_constant_expression.hpp"
+#include "planner/expression/bound_reference_expression.hpp"
 #include "planner/operator/logical_filter.hpp"
 #include "planner/operator/logical_get.hpp"
 
 using namespace duckdb;
 using namespace std;
 
+//! Moves comparisons between a column and a constant into the table filters of the scan, which evaluates them while
+//! scanning the table. The expressions that cannot be pushed into the scan remain in the list.
+static void PushdownTableFilters(PhysicalTableScan &scan, vector<unique_ptr<Expression>> &expressions) {
+	for (index_t expr_idx = 0; expr_idx < expressions.size(); expr_idx++) {
+		auto &expr = expressions[expr_idx];
+		switch (expr->type) {
+		case ExpressionType::COMPARE_EQUAL:
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			break;
+		default:
+			continue;
+		}
+		auto &comparison = (BoundComparisonExpression &)*expr;
+		auto comparison_type = comparison.type;
+		Expression *column = comparison.left.get(), *constant = comparison.right.get();
+		if (column->type == ExpressionType::VALUE_CONSTANT) {
+			// constant on the left side: flip the comparison
+			std::swap(column, constant);
+			comparison_type = FlipComparisionExpression(comparison_type);
+		}
+		if (column->type != ExpressionType::BOUND_REF || constant->type != ExpressionType::VALUE_CONSTANT) {
+			continue;
+		}
+		auto &ref = (BoundReferenceExpression &)*column;
+		auto &value = ((BoundConstantExpression &)*constant).value;
+		assert(ref.index < scan.column_ids.size());
+		auto column_index = scan.column_ids[ref.index];
+		if (column_index == COLUMN_IDENTIFIER_ROW_ID || value.is_null || value.type != ref.return_type) {
+			continue;
+		}
+		scan.table_filters.push_back(TableFilter(value, comparison_type, column_index));
+		expressions.erase(expressions.begin() + expr_idx);
+		expr_idx--;
+	}
+}
+
 unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalFilter &op) {
 	assert(op.children.size() == 1);
 	unique_ptr<PhysicalOperator> plan = CreatePlan(*op.children[0]);
+	if (plan->type == PhysicalOperatorType::SEQ_SCAN) {
+		PushdownTableFilters((PhysicalTableScan &)*plan, op.expressions);
+	}
 	if (op.expressions.size() > 0) {
 		// create a filter if there is anything to filter
 		auto filter = make_unique<PhysicalFilter>(op, move(op.expressions));
@@ -1,6 +1,8 @@
 #include "execution/operator/helper/physical_limit.hpp"
+#include "execution/operator/order/physical_top_n.hpp"
 #include "execution/physical_plan_generator.hpp"
 #include "planner/operator/logical_limit.hpp"
+#include "planner/operator/logical_order.hpp"
 
 using namespace duckdb;
 using namespace std;
@@ -8,6 +10,18 @@ using namespace std;
 unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalLimit &op) {
 	assert(op.children.size() == 1);
 
+	if (op.children[0]->type == LogicalOperatorType::ORDER_BY && (index_t)op.limit <= PhysicalTopN::MAXIMUM_HEAP_SIZE &&
+	    (index_t)op.offset <= PhysicalTopN::MAXIMUM_HEAP_SIZE - (index_t)op.limit) {
+		// a LIMIT on top of an ORDER BY only needs the first limit + offset rows of the sorted input: if these are few
+		// enough, compute them with a top-n instead of sorting the entire input
+		auto &order = (LogicalOrder &)*op.children[0];
+		auto plan = CreatePlan(*order.children[0]);
+
+		auto top_n = make_unique<PhysicalTopN>(op, move(order.orders), op.limit, op.offset);
+		top_n->children.push_back(move(plan));
+		return move(top_n);
+	}
+
 	auto plan = CreatePlan(*op.children[0]);
 
 	auto limit = make_unique<PhysicalLimit>(op, op.limit, op.offset);
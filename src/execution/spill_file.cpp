@@ -0,0 +1,105 @@
+#include "execution/spill_file.hpp"
+
+#include "common/exception.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
+
+#include <atomic>
+#include <random>
+
+using namespace duckdb;
+using namespace std;
+
+static atomic<index_t> spill_file_index(0);
+
+//! Returns a random identifier of this process, so that processes that share a temporary directory do not use the
+//! same file names
+static const string &GetProcessIdentifier() {
+	static const string identifier = [] {
+		random_device device;
+		uint64_t value = ((uint64_t)device() << 32) | device();
+		return to_string(value);
+	}();
+	return identifier;
+}
+//! The lock held while creating the temporary directory
+static mutex directory_lock;
+
+SpillFile::SpillFile(FileSystem &fs, string path_p)
+    : count(0), fs(fs), path(path_p), chunk_count(0), chunks_scanned(0) {
+	writer = make_unique<BufferedFileWriter>(fs, path.c_str());
+}
+
+SpillFile::~SpillFile() {
+	writer.reset();
+	reader.reset();
+	if (fs.FileExists(path)) {
+		fs.RemoveFile(path);
+	}
+}
+
+bool SpillFile::CanSpill(ClientContext &context) {
+	return !context.db.GetTemporaryDirectory().empty();
+}
+
+unique_ptr<SpillFile> SpillFile::Create(ClientContext &context) {
+	auto &fs = *context.db.file_system;
+	// the directory can be changed by another connection while the file is created: use the current one
+	auto directory = context.db.GetTemporaryDirectory();
+	if (directory.empty()) {
+		throw IOException("Cannot spill to disk: the temporary directory was unset");
+	}
+	{
+		lock_guard<mutex> guard(directory_lock);
+		if (!fs.DirectoryExists(directory)) {
+			fs.CreateDirectory(directory);
+			// we created the directory: remove it again when the database is closed
+			context.db.created_temporary_directories.push_back(directory);
+		}
+	}
+	string path;
+	do {
+		// skip the files that already exist, e.g. the files left behind by a process that crashed
+		auto file_name = "duckdb_spill_" + GetProcessIdentifier() + "_" + to_string(spill_file_index++) + ".tmp";
+		path = fs.JoinPath(directory, file_name);
+	} while (fs.FileExists(path));
+	return make_unique<SpillFile>(fs, path);
+}
+
+void SpillFile::Append(DataChunk &chunk) {
+	assert(writer);
+	if (chunk.size() == 0) {
+		return;
+	}
+	lock_guard<mutex> guard(append_lock);
+	if (chunk.sel_vector) {
+		// serialization ignores the selection vector of strings: copy the selected tuples first
+		if (flat_chunk.column_count == 0) {
+			auto types = chunk.GetTypes();
+			flat_chunk.Initialize(types);
+		}
+		flat_chunk.Reset();
+		chunk.Copy(flat_chunk);
+		flat_chunk.Serialize(*writer);
+	} else {
+		chunk.Serialize(*writer);
+	}
+	count += chunk.size();
+	chunk_count++;
+}
+
+bool SpillFile::Scan(DataChunk &result) {
+	if (writer) {
+		// finished appending: flush the remaining data and switch to reading
+		writer->Flush();
+		writer.reset();
+		flat_chunk.Destroy();
+		reader = make_unique<BufferedFileReader>(fs, path.c_str());
+	}
+	if (chunks_scanned >= chunk_count) {
+		return false;
+	}
+	result.Deserialize(*reader);
+	chunks_scanned++;
+	return true;
+}
@@ -0,0 +1,145 @@
+#include "execution/task_scheduler.hpp"
+#include "common/exception.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TaskScheduler::TaskScheduler(index_t thread_count)
+    : shutdown(false), active_calls(0), resizing(false), thread_count(1) {
+	LaunchWorkers(thread_count > 1 ? thread_count - 1 : 0);
+}
+
+TaskScheduler::~TaskScheduler() {
+	StopWorkers();
+}
+
+void TaskScheduler::LaunchWorkers(index_t worker_count) {
+	{
+		lock_guard<mutex> guard(queue_lock);
+		shutdown = false;
+	}
+	for (index_t i = 0; i < worker_count; i++) {
+		workers.push_back(thread(&TaskScheduler::WorkerThread, this));
+	}
+	thread_count = worker_count + 1;
+}
+
+void TaskScheduler::StopWorkers() {
+	{
+		lock_guard<mutex> guard(queue_lock);
+		shutdown = true;
+	}
+	queue_signal.notify_all();
+	for (auto &worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+void TaskScheduler::SetThreads(index_t thread_count) {
+	if (thread_count == 0) {
+		throw Exception("Number of threads must be at least 1");
+	}
+	lock_guard<mutex> resize_guard(resize_lock);
+	{
+		// wait until the running calls to ExecuteParallel have finished, and block new calls while resizing: the
+		// workers that the tasks of a call were scheduled for have to stay around until the call has finished
+		unique_lock<mutex> guard(queue_lock);
+		resize_signal.wait(guard, [&] { return active_calls == 0; });
+		resizing = true;
+	}
+	StopWorkers();
+	LaunchWorkers(thread_count - 1);
+	{
+		lock_guard<mutex> guard(queue_lock);
+		resizing = false;
+	}
+	resize_signal.notify_all();
+}
+
+void TaskScheduler::WorkerThread() {
+	while (true) {
+		function<void()> task;
+		{
+			unique_lock<mutex> guard(queue_lock);
+			queue_signal.wait(guard, [&] { return shutdown || !tasks.empty(); });
+			if (tasks.empty()) {
+				// shutdown requested and no tasks left
+				return;
+			}
+			task = move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
+
+//! The shared state of a single call to ExecuteParallel
+struct ParallelExecutionState {
+	ParallelExecutionState(index_t remaining) : remaining(remaining) {
+	}
+
+	//! The amount of task invocations that have not finished yet
+	index_t remaining;
+	//! The first exception thrown by any of the invocations (if any)
+	exception_ptr error;
+	mutex lock;
+	condition_variable finished;
+
+	void Run(function<void(index_t)> &task, index_t thread_index) {
+		try {
+			task(thread_index);
+		} catch (...) {
+			lock_guard<mutex> guard(lock);
+			if (!error) {
+				error = current_exception();
+			}
+		}
+		lock_guard<mutex> guard(lock);
+		remaining--;
+		if (remaining == 0) {
+			finished.notify_all();
+		}
+	}
+};
+
+void TaskScheduler::ExecuteParallel(index_t task_count, function<void(index_t)> task) {
+	{
+		unique_lock<mutex> guard(queue_lock);
+		// wait for a concurrent SetThreads to finish replacing the workers
+		resize_signal.wait(guard, [&] { return !resizing; });
+		task_count = std::min(task_count, workers.size() + 1);
+		if (task_count > 1) {
+			active_calls++;
+		}
+	}
+	if (task_count <= 1) {
+		// no parallelism: execute the task in the calling thread
+		task(0);
+		return;
+	}
+	ParallelExecutionState state(task_count);
+	{
+		// schedule the invocations for the worker threads
+		lock_guard<mutex> guard(queue_lock);
+		for (index_t i = 1; i < task_count; i++) {
+			tasks.push([&state, &task, i]() { state.Run(task, i); });
+		}
+	}
+	queue_signal.notify_all();
+	// the calling thread executes the first invocation
+	state.Run(task, 0);
+	{
+		// wait for the workers to finish
+		unique_lock<mutex> guard(state.lock);
+		state.finished.wait(guard, [&] { return state.remaining == 0; });
+	}
+	{
+		lock_guard<mutex> guard(queue_lock);
+		active_calls--;
+	}
+	resize_signal.notify_all();
+	if (state.error) {
+		rethrow_exception(state.error);
+	}
+}
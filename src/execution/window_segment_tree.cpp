@@ -1,153 +1,216 @@
 #include "execution/window_segment_tree.hpp"
 
-#include "common/types/constant_vector.hpp"
-#include "common/vector_operations/vector_operations.hpp"
+#include "catalog/catalog_entry/aggregate_function_catalog_entry.hpp"
 
-#include <cmath>
+#include <cstring>
 
 using namespace duckdb;
 using namespace std;
 
-void WindowSegmentTree::AggregateInit() {
-	switch (window_type) {
-	case ExpressionType::WINDOW_SUM:
-	case ExpressionType::WINDOW_AVG:
-		aggregate = Value::Numeric(payload_type, 0);
-		break;
-	case ExpressionType::WINDOW_MIN:
-		aggregate = Value::MaximumValue(payload_type);
-		break;
-	case ExpressionType::WINDOW_MAX:
-		aggregate = Value::MinimumValue(payload_type);
-		break;
-	default:
-		throw NotImplementedException("Window Type");
-	}
-	assert(aggregate.type == payload_type);
-	n_aggregated = 0;
-}
-
-Value WindowSegmentTree::AggegateFinal() {
-	if (n_aggregated == 0) {
-		return Value(payload_type);
-	}
-	switch (window_type) {
-	case ExpressionType::WINDOW_AVG:
-		return aggregate / Value::Numeric(payload_type, n_aggregated);
-	default:
-		return aggregate;
-	}
-
-	return aggregate;
+WindowSegmentTree::WindowSegmentTree(AggregateFunctionCatalogEntry &aggregate, TypeId result_type,
+                                     ChunkCollection *input)
+    : aggregate(aggregate), result_type(result_type), state_size(aggregate.state_size(result_type)), input_ref(input),
+      leaf_count(0), node_count(0) {
+	assert(input_ref && input_ref->column_count() > 0);
+	row_states = unique_ptr<data_t[]>(new data_t[STANDARD_VECTOR_SIZE * state_size]);
+	leaves.Initialize(input_ref->types);
+	ConstructTree();
 }
 
-void WindowSegmentTree::WindowSegmentValue(index_t l_idx, index_t begin, index_t end) {
-	assert(begin <= end);
-	if (begin == end) {
+void WindowSegmentTree::ConstructTree() {
+	levels_flat_start.push_back(0);
+	if (!aggregate.combine || input_ref->count <= 1) {
+		// without a combine function the states of the nodes cannot be merged: every frame is aggregated from the
+		// input rows directly
 		return;
 	}
-	Vector v;
-	if (l_idx == 0) {
-		auto &vec = input_ref->GetChunk(begin).data[0];
-		v.Reference(vec);
-		index_t start_in_vector = begin % STANDARD_VECTOR_SIZE;
-		v.data = v.data + GetTypeIdSize(v.type) * start_in_vector;
-		v.count = end - begin;
-		v.nullmask <<= start_in_vector;
-		assert(v.count + start_in_vector <=
-		       vec.count); // if STANDARD_VECTOR_SIZE is not divisible by fanout this will trip
-	} else {
-		assert(end - begin < STANDARD_VECTOR_SIZE);
-		v.data = levels_flat_native.get() + GetTypeIdSize(payload_type) * (begin + levels_flat_start[l_idx - 1]);
-		v.count = end - begin;
-		v.type = payload_type;
-	}
-
-	assert(!v.sel_vector);
-	v.Verify();
-
-	switch (window_type) {
-	case ExpressionType::WINDOW_SUM:
-	case ExpressionType::WINDOW_AVG:
-		aggregate = aggregate + VectorOperations::Sum(v);
-		break;
-	case ExpressionType::WINDOW_MIN: {
-		auto val = VectorOperations::Min(v);
-		aggregate = aggregate > val ? val : aggregate;
-		break;
-	}
-	case ExpressionType::WINDOW_MAX: {
-		auto val = VectorOperations::Max(v);
-		aggregate = aggregate < val ? val : aggregate;
-		break;
-	}
-	default:
-		throw NotImplementedException("Window Type");
-	}
-
-	n_aggregated += end - begin;
-}
-
-void WindowSegmentTree::ConstructTree() {
-	assert(input_ref);
-	assert(input_ref->column_count() == 1);
 
 	// compute space required to store internal nodes of segment tree
 	index_t internal_nodes = 0;
 	index_t level_nodes = input_ref->count;
 	do {
-		level_nodes = (index_t)ceil((double)level_nodes / TREE_FANOUT);
+		level_nodes = (level_nodes + TREE_FANOUT - 1) / TREE_FANOUT;
 		internal_nodes += level_nodes;
 	} while (level_nodes > 1);
-	levels_flat_native = unique_ptr<data_t[]>(new data_t[internal_nodes * GetTypeIdSize(payload_type)]);
-	levels_flat_start.push_back(0);
+	levels_flat_native = unique_ptr<data_t[]>(new data_t[internal_nodes * state_size]);
+	for (index_t i = 0; i < internal_nodes; i++) {
+		aggregate.initialize(levels_flat_native.get() + i * state_size, result_type);
+	}
 
-	index_t levels_flat_offset = 0;
-	index_t level_current = 0;
-	// level 0 is data itself
-	index_t level_size;
-	while ((level_size = (level_current == 0 ? input_ref->count
-	                                         : levels_flat_offset - levels_flat_start[level_current - 1])) > 1) {
-		for (index_t pos = 0; pos < level_size; pos += TREE_FANOUT) {
-			AggregateInit();
-			WindowSegmentValue(level_current, pos, min(level_size, pos + TREE_FANOUT));
+	// the first level aggregates the input rows: row i is aggregated into node (i / TREE_FANOUT)
+	Vector addresses(TypeId::POINTER, true, false);
+	auto address_data = (data_ptr_t *)addresses.data;
+	for (index_t chunk_idx = 0; chunk_idx < input_ref->chunks.size(); chunk_idx++) {
+		auto &chunk = *input_ref->chunks[chunk_idx];
+		index_t chunk_start = chunk_idx * STANDARD_VECTOR_SIZE;
+		for (index_t i = 0; i < chunk.size(); i++) {
+			address_data[i] = levels_flat_native.get() + ((chunk_start + i) / TREE_FANOUT) * state_size;
+		}
+		addresses.count = chunk.size();
+		aggregate.update(chunk.data.get(), chunk.column_count, addresses);
+	}
+	index_t level_size = (input_ref->count + TREE_FANOUT - 1) / TREE_FANOUT;
+	index_t levels_flat_offset = level_size;
+	levels_flat_start.push_back(levels_flat_offset);
+
+	// the higher levels combine the states of the level below them
+	while (level_size > 1) {
+		auto source_start = levels_flat_start[levels_flat_start.size() - 2];
+		for (index_t pos = 0; pos < level_size; pos++) {
+			node_sources[node_count] = levels_flat_native.get() + (source_start + pos) * state_size;
+			node_targets[node_count] = levels_flat_native.get() + (levels_flat_offset + pos / TREE_FANOUT) * state_size;
+			if (++node_count == STANDARD_VECTOR_SIZE) {
+				FlushNodes();
+			}
+		}
+		FlushNodes();
+		level_size = (level_size + TREE_FANOUT - 1) / TREE_FANOUT;
+		levels_flat_offset += level_size;
+		levels_flat_start.push_back(levels_flat_offset);
+	}
+}
 
-			ConstantVector res_vec(AggegateFinal());
-			assert(res_vec.type == payload_type);
-			ConstantVector ptr_vec(Value::POINTER(
-			    (index_t)(levels_flat_native.get() + (levels_flat_offset * GetTypeIdSize(payload_type)))));
-			VectorOperations::Scatter::Set(res_vec, ptr_vec);
+void WindowSegmentTree::AddLeaves(index_t row_idx, index_t begin, index_t end) {
+	auto state = row_states.get() + row_idx * state_size;
+	while (begin < end) {
+		// copy the input rows into the leaves, a chunk of the input at a time
+		auto &chunk = input_ref->GetChunk(begin);
+		index_t offset = begin % STANDARD_VECTOR_SIZE;
+		index_t copy_count = min(end - begin, min(chunk.size() - offset, STANDARD_VECTOR_SIZE - leaf_count));
+		for (index_t col_idx = 0; col_idx < chunk.column_count; col_idx++) {
+			auto &source = chunk.data[col_idx];
+			auto &target = leaves.data[col_idx];
+			assert(!source.sel_vector);
+			auto width = GetTypeIdSize(source.type);
+			memcpy(target.data + leaf_count * width, source.data + offset * width, copy_count * width);
+			for (index_t i = 0; i < copy_count; i++) {
+				target.nullmask[leaf_count + i] = source.nullmask[offset + i];
+			}
+		}
+		for (index_t i = 0; i < copy_count; i++) {
+			leaf_states[leaf_count + i] = state;
+		}
+		leaf_count += copy_count;
+		begin += copy_count;
+		if (leaf_count == STANDARD_VECTOR_SIZE) {
+			FlushLeaves();
+		}
+	}
+}
 
-			levels_flat_offset++;
+void WindowSegmentTree::AddNodes(index_t row_idx, index_t level, index_t begin, index_t end) {
+	assert(level > 0);
+	auto state = row_states.get() + row_idx * state_size;
+	auto level_start = levels_flat_start[level - 1];
+	for (index_t pos = begin; pos < end; pos++) {
+		node_sources[node_count] = levels_flat_native.get() + (level_start + pos) * state_size;
+		node_targets[node_count] = state;
+		if (++node_count == STANDARD_VECTOR_SIZE) {
+			FlushNodes();
 		}
+	}
+}
 
-		levels_flat_start.push_back(levels_flat_offset);
-		level_current++;
+void WindowSegmentTree::FlushLeaves() {
+	if (leaf_count == 0) {
+		return;
+	}
+	for (index_t col_idx = 0; col_idx < leaves.column_count; col_idx++) {
+		leaves.data[col_idx].count = leaf_count;
 	}
+	Vector addresses(TypeId::POINTER, (data_ptr_t)leaf_states);
+	addresses.count = leaf_count;
+	aggregate.update(leaves.data.get(), leaves.column_count, addresses);
+	leaf_count = 0;
 }
 
-Value WindowSegmentTree::Compute(index_t begin, index_t end) {
-	assert(input_ref);
-	AggregateInit();
-	for (index_t l_idx = 0; l_idx < levels_flat_start.size() + 1; l_idx++) {
-		index_t parent_begin = begin / TREE_FANOUT;
-		index_t parent_end = end / TREE_FANOUT;
-		if (parent_begin == parent_end) {
-			WindowSegmentValue(l_idx, begin, end);
-			return AggegateFinal();
+void WindowSegmentTree::FlushNodes() {
+	if (node_count == 0) {
+		return;
+	}
+	Vector sources(TypeId::POINTER, (data_ptr_t)node_sources);
+	Vector targets(TypeId::POINTER, (data_ptr_t)node_targets);
+	sources.count = targets.count = node_count;
+	aggregate.combine(sources, targets, result_type);
+	node_count = 0;
+}
+
+void WindowSegmentTree::Compute(Vector &result, index_t begins[], index_t ends[], index_t count) {
+	assert(count <= STANDARD_VECTOR_SIZE);
+	for (index_t i = 0; i < count; i++) {
+		aggregate.initialize(row_states.get() + i * state_size, result_type);
+	}
+	for (index_t i = 0; i < count; i++) {
+		index_t begin = begins[i];
+		index_t end = ends[i];
+		if (begin >= end) {
+			// empty frame: the aggregate of the empty set
+			continue;
+		}
+		if (i > 0 && begin == begins[i - 1] && end == ends[i - 1]) {
+			// same frame as the previous row: its state is copied once it is complete
+			continue;
 		}
-		index_t group_begin = parent_begin * TREE_FANOUT;
-		if (begin != group_begin) {
-			WindowSegmentValue(l_idx, begin, group_begin + TREE_FANOUT);
-			parent_begin++;
+		if (!aggregate.combine) {
+			AddLeaves(i, begin, end);
+			continue;
 		}
-		index_t group_end = parent_end * TREE_FANOUT;
-		if (end != group_end) {
-			WindowSegmentValue(l_idx, group_end, end);
+		// go up the tree, adding the nodes at the edges of the frame until the remainder is covered by one node
+		for (index_t l_idx = 0; l_idx < levels_flat_start.size(); l_idx++) {
+			index_t parent_begin = begin / TREE_FANOUT;
+			index_t parent_end = end / TREE_FANOUT;
+			if (parent_begin == parent_end) {
+				if (l_idx == 0) {
+					AddLeaves(i, begin, end);
+				} else {
+					AddNodes(i, l_idx, begin, end);
+				}
+				break;
+			}
+			index_t group_begin = parent_begin * TREE_FANOUT;
+			if (begin != group_begin) {
+				if (l_idx == 0) {
+					AddLeaves(i, begin, group_begin + TREE_FANOUT);
+				} else {
+					AddNodes(i, l_idx, begin, group_begin + TREE_FANOUT);
+				}
+				parent_begin++;
+			}
+			index_t group_end = parent_end * TREE_FANOUT;
+			if (end != group_end) {
+				if (l_idx == 0) {
+					AddLeaves(i, group_end, end);
+				} else {
+					AddNodes(i, l_idx, group_end, end);
+				}
+			}
+			begin = parent_begin;
+			end = parent_end;
+		}
+	}
+	FlushLeaves();
+	FlushNodes();
+
+	data_ptr_t state_pointers[STANDARD_VECTOR_SIZE];
+	for (index_t i = 0; i < count; i++) {
+		state_pointers[i] = row_states.get() + i * state_size;
+		if (i > 0 && begins[i] < ends[i] && begins[i] == begins[i - 1] && ends[i] == ends[i - 1]) {
+			memcpy(state_pointers[i], state_pointers[i - 1], state_size);
+		}
+	}
+	// finalize the states into the result
+	Vector states(TypeId::POINTER, (data_ptr_t)state_pointers);
+	states.count = count;
+	result.count = count;
+	result.nullmask.reset();
+	aggregate.finalize(states, result);
+	if (result.type == TypeId::VARCHAR) {
+		// the result strings can point into the input: copy them into the result vector
+		auto strings = (const char **)result.data;
+		for (index_t i = 0; i < count; i++) {
+			if (!result.nullmask[i]) {
+				strings[i] = result.string_heap.AddString(strings[i]);
+			}
 		}
-		begin = parent_begin;
-		end = parent_end;
 	}
-
-	return AggegateFinal();
 }
@@ -51,6 +51,16 @@ void avg_update(Vector inputs[], index_t input_count, Vector &state) {
 	});
 }
 
+void avg_combine(Vector &state, Vector &combined, TypeId return_type) {
+	VectorOperations::Exec(state, [&](index_t i, index_t k) {
+		auto state_ptr = (avg_state_t *)((data_ptr_t *)state.data)[i];
+		auto combined_ptr = (avg_state_t *)((data_ptr_t *)combined.data)[i];
+
+		combined_ptr->count += state_ptr->count;
+		combined_ptr->sum += state_ptr->sum;
+	});
+}
+
 void avg_finalize(Vector &state, Vector &result) {
 	// compute finalization of streaming avg
 	VectorOperations::Exec(state, [&](uint64_t i, uint64_t k) {
@@ -83,6 +83,33 @@ void covar_update(Vector inputs[], index_t input_count, Vector &state) {
 	});
 }
 
+void covar_combine(Vector &state, Vector &combined, TypeId return_type) {
+	VectorOperations::Exec(state, [&](index_t i, index_t k) {
+		auto source_ptr = ((data_ptr_t *)state.data)[i];
+		auto target_ptr = ((data_ptr_t *)combined.data)[i];
+		auto source_count = *((uint64_t *)source_ptr);
+		if (source_count == 0) {
+			return;
+		}
+		auto target_count = *((uint64_t *)target_ptr);
+		// meanx, meany and co-moment
+		auto source_values = (double *)(source_ptr + sizeof(uint64_t));
+		auto target_values = (double *)(target_ptr + sizeof(uint64_t));
+		if (target_count == 0) {
+			memcpy(target_ptr, source_ptr, covar_state_size(return_type));
+			return;
+		}
+		// merge the co-moments of both partial states
+		const double count = (double)(source_count + target_count);
+		const double dx = source_values[0] - target_values[0];
+		const double dy = source_values[1] - target_values[1];
+		target_values[2] += source_values[2] + dx * dy * source_count * target_count / count;
+		target_values[0] += dx * source_count / count;
+		target_values[1] += dy * source_count / count;
+		*((uint64_t *)target_ptr) = source_count + target_count;
+	});
+}
+
 void covarpop_finalize(Vector &state, Vector &result) {
 	// compute finalization of streaming population covariance
 	VectorOperations::Exec(result, [&](uint64_t i, uint64_t k) {
@@ -11,6 +11,44 @@ void gather_finalize(Vector &payloads, Vector &result) {
 	VectorOperations::Gather::Set(payloads, result);
 }
 
+//! Gathers the in-place states of the source and applies OP to scatter them into the combined states
+template <class OP> static void gather_combine(Vector &state, Vector &combined, TypeId return_type) {
+	Vector gathered(return_type, true, false);
+	VectorOperations::Gather::Set(state, gathered);
+	gathered.sel_vector = state.sel_vector;
+	OP::Operation(gathered, combined);
+}
+
+struct ScatterAdd {
+	static void Operation(Vector &source, Vector &dest) {
+		VectorOperations::Scatter::Add(source, dest);
+	}
+};
+
+struct ScatterMin {
+	static void Operation(Vector &source, Vector &dest) {
+		VectorOperations::Scatter::Min(source, dest);
+	}
+};
+
+struct ScatterMax {
+	static void Operation(Vector &source, Vector &dest) {
+		VectorOperations::Scatter::Max(source, dest);
+	}
+};
+
+void add_combine(Vector &state, Vector &combined, TypeId return_type) {
+	gather_combine<ScatterAdd>(state, combined, return_type);
+}
+
+void min_combine(Vector &state, Vector &combined, TypeId return_type) {
+	gather_combine<ScatterMin>(state, combined, return_type);
+}
+
+void max_combine(Vector &state, Vector &combined, TypeId return_type) {
+	gather_combine<ScatterMax>(state, combined, return_type);
+}
+
 void null_payload_initialize(data_ptr_t payload, TypeId return_type) {
 	SetNullValue(payload, return_type);
 }
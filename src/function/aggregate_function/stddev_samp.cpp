@@ -62,6 +62,26 @@ void stddevsamp_update(Vector inputs[], index_t input_count, Vector &state) {
 	});
 }
 
+void stddevsamp_combine(Vector &state, Vector &combined, TypeId return_type) {
+	// merge the partial states using the parallel variant of Welford's method (Chan et al.)
+	VectorOperations::Exec(state, [&](index_t i, index_t k) {
+		auto state_ptr = (stddev_state_t *)((data_ptr_t *)state.data)[i];
+		auto combined_ptr = (stddev_state_t *)((data_ptr_t *)combined.data)[i];
+		if (state_ptr->count == 0) {
+			return;
+		}
+		if (combined_ptr->count == 0) {
+			*combined_ptr = *state_ptr;
+			return;
+		}
+		const double count = (double)(combined_ptr->count + state_ptr->count);
+		const double delta = state_ptr->mean - combined_ptr->mean;
+		combined_ptr->dsquared += state_ptr->dsquared + delta * delta * combined_ptr->count * state_ptr->count / count;
+		combined_ptr->mean += delta * state_ptr->count / count;
+		combined_ptr->count += state_ptr->count;
+	});
+}
+
 void varsamp_finalize(Vector &state, Vector &result) {
 	// compute finalization of streaming stddev of sample
 	VectorOperations::Exec(state, [&](uint64_t i, uint64_t k) {
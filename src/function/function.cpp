@@ -34,6 +34,7 @@ template <class T> static void AddAggregateFunction(Transaction &transaction, Ca
 	info.state_size = T::GetStateSizeFunction();
 	info.initialize = T::GetInitalizeFunction();
 	info.update = T::GetUpdateFunction();
+	info.combine = T::GetCombineFunction();
 	info.finalize = T::GetFinalizeFunction();
 
 	info.simple_initialize = T::GetSimpleInitializeFunction();
@@ -118,6 +119,9 @@ void BuiltinFunctions::Initialize(Transaction &transaction, Catalog &catalog) {
 	AddScalarFunction<SubstringFunction>(transaction, catalog);
 	AddScalarFunction<UpperFunction>(transaction, catalog);
 	AddScalarFunction<LowerFunction>(transaction, catalog);
+	AddScalarFunction<PrefixFunction>(transaction, catalog);
+	AddScalarFunction<SuffixFunction>(transaction, catalog);
+	AddScalarFunction<ContainsFunction>(transaction, catalog);
 
 	// regex
 	AddScalarFunction<RegexpMatchesFunction>(transaction, catalog);
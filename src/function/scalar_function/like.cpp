@@ -0,0 +1,84 @@
+#include "function/scalar_function/like.hpp"
+
+#include "common/exception.hpp"
+#include "common/vector_operations/vector_operations.hpp"
+
+#include <cstring>
+
+using namespace std;
+
+namespace duckdb {
+
+struct PrefixOperator {
+	static inline bool Operation(const char *str, const char *pattern, index_t pattern_length) {
+		// strncmp stops at the end of the string, so strings that are shorter than the pattern do not match
+		return strncmp(str, pattern, pattern_length) == 0;
+	}
+};
+
+struct SuffixOperator {
+	static inline bool Operation(const char *str, const char *pattern, index_t pattern_length) {
+		auto length = strlen(str);
+		return length >= pattern_length && memcmp(str + length - pattern_length, pattern, pattern_length) == 0;
+	}
+};
+
+struct ContainsOperator {
+	static inline bool Operation(const char *str, const char *pattern, index_t pattern_length) {
+		return strstr(str, pattern) != nullptr;
+	}
+};
+
+template <class OP> static void string_match_function(Vector inputs[], index_t input_count, Vector &result) {
+	assert(input_count == 2);
+	auto &strings = inputs[0];
+	auto &patterns = inputs[1];
+	assert(strings.type == TypeId::VARCHAR);
+	assert(patterns.type == TypeId::VARCHAR);
+
+	result.Initialize(TypeId::BOOLEAN);
+	result.nullmask.reset();
+	auto strings_data = (const char **)strings.data;
+	auto patterns_data = (const char **)patterns.data;
+	auto result_data = (bool *)result.data;
+
+	// the length of a constant pattern is only computed once
+	bool constant_pattern = patterns.IsConstant();
+	index_t constant_length = constant_pattern && !patterns.nullmask[0] ? strlen(patterns_data[0]) : 0;
+	VectorOperations::BinaryExec(strings, patterns, result,
+	                             [&](index_t strings_index, index_t patterns_index, index_t result_index) {
+		                             if (strings.nullmask[strings_index] || patterns.nullmask[patterns_index]) {
+			                             result.nullmask[result_index] = true;
+			                             return;
+		                             }
+		                             auto pattern = patterns_data[patterns_index];
+		                             auto pattern_length = constant_pattern ? constant_length : strlen(pattern);
+		                             result_data[result_index] =
+		                                 OP::Operation(strings_data[strings_index], pattern, pattern_length);
+	                             });
+}
+
+void prefix_function(ExpressionExecutor &exec, Vector inputs[], index_t input_count, BoundFunctionExpression &expr,
+                     Vector &result) {
+	string_match_function<PrefixOperator>(inputs, input_count, result);
+}
+
+void suffix_function(ExpressionExecutor &exec, Vector inputs[], index_t input_count, BoundFunctionExpression &expr,
+                     Vector &result) {
+	string_match_function<SuffixOperator>(inputs, input_count, result);
+}
+
+void contains_function(ExpressionExecutor &exec, Vector inputs[], index_t input_count, BoundFunctionExpression &expr,
+                       Vector &result) {
+	string_match_function<ContainsOperator>(inputs, input_count, result);
+}
+
+bool string_match_matches_arguments(vector<SQLType> &arguments) {
+	return arguments.size() == 2 && arguments[0].id == SQLTypeId::VARCHAR && arguments[1].id == SQLTypeId::VARCHAR;
+}
+
+SQLType string_match_get_return_type(vector<SQLType> &arguments) {
+	return SQLType(SQLTypeId::BOOLEAN);
+}
+
+} // namespace duckdb
@@ -23,8 +23,8 @@ class AggregateFunctionCatalogEntry : public CatalogEntry {
 public:
 	AggregateFunctionCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schema, CreateAggregateFunctionInfo *info)
 	    : CatalogEntry(CatalogType::AGGREGATE_FUNCTION, catalog, info->name), schema(schema),
-	      state_size(info->state_size), initialize(info->initialize), update(info->update), finalize(info->finalize),
-	      simple_initialize(info->simple_initialize), simple_update(info->simple_update),
+	      state_size(info->state_size), initialize(info->initialize), update(info->update), combine(info->combine),
+	      finalize(info->finalize), simple_initialize(info->simple_initialize), simple_update(info->simple_update),
 	      return_type(info->return_type), cast_arguments(info->cast_arguments) {
 	}
 
@@ -37,6 +37,8 @@ public:
 	aggregate_initialize_t initialize;
 	//! The hashed aggregate update function
 	aggregate_update_t update;
+	//! The hashed aggregate combine function (may be null)
+	aggregate_combine_t combine;
 	//! The hashed aggregate finalization function
 	aggregate_finalize_t finalize;
 
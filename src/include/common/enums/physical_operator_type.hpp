@@ -20,6 +20,7 @@ enum class PhysicalOperatorType : uint8_t {
 	LEAF,
 	ORDER_BY,
 	LIMIT,
+	TOP_N,
 	AGGREGATE,
 	WINDOW,
 	DISTINCT,
@@ -48,6 +49,7 @@ enum class PhysicalOperatorType : uint8_t {
 	BLOCKWISE_NL_JOIN,
 	NESTED_LOOP_JOIN,
 	HASH_JOIN,
+	INDEX_JOIN,
 	CROSS_PRODUCT,
 	PIECEWISE_MERGE_JOIN,
 	DELIM_JOIN,
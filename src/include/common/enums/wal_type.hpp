@@ -41,6 +41,10 @@ enum class WALType : uint8_t {
 	// -----------------------------
 	QUERY = 50,
 	// -----------------------------
+	// Checkpoint
+	// -----------------------------
+	CHECKPOINT = 99,
+	// -----------------------------
 	// Flush
 	// -----------------------------
 	WAL_FLUSH = 100
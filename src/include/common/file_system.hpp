@@ -62,11 +62,11 @@ public:
 	unique_ptr<FileHandle> OpenFile(string &path, uint8_t flags, FileLockType lock = FileLockType::NO_LOCK) {
 		return OpenFile(path.c_str(), flags, lock);
 	}
-	//! Read exactly nr_bytes from the specified location in the file. Fails if nr_bytes could not be read. This is
-	//! equivalent to calling SetFilePointer(location) followed by calling Read().
+	//! Read exactly nr_bytes from the specified location in the file. Fails if nr_bytes could not be read. Does not
+	//! use or move the file pointer, so concurrent positional reads and writes of a handle do not interfere.
 	virtual void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location);
-	//! Write exactly nr_bytes to the specified location in the file. Fails if nr_bytes could not be read. This is
-	//! equivalent to calling SetFilePointer(location) followed by calling Write().
+	//! Write exactly nr_bytes to the specified location in the file. Fails if nr_bytes could not be written. Does not
+	//! use or move the file pointer, so concurrent positional reads and writes of a handle do not interfere.
 	virtual void Write(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location);
 	//! Read nr_bytes from the specified file into the buffer, moving the file pointer forward by nr_bytes. Returns the
 	//! amount of bytes read.
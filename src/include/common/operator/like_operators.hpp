@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "common/common.hpp"
+
 namespace duckdb {
 
 struct Like {
@@ -20,4 +22,38 @@ struct NotLike {
 	}
 };
 
+//! A LikeMatcher matches strings against a constant LIKE pattern. The pattern is split on its % wildcards into
+//! segments once, after which a string is matched by searching for the segments from left to right instead of
+//! interpreting the pattern for every string.
+class LikeMatcher {
+public:
+	LikeMatcher(const char *pattern);
+
+	//! Returns true if the string matches the pattern
+	bool Match(const char *str);
+
+private:
+	struct LikeSegment {
+		LikeSegment(string pattern) : pattern(pattern), has_underscore(pattern.find('_') != string::npos) {
+		}
+
+		//! The characters of the segment, in which _ matches any character
+		string pattern;
+		//! Whether or not the segment contains a _ wildcard
+		bool has_underscore;
+	};
+
+	//! Returns true if the segment matches the characters starting at str
+	static bool MatchSegment(LikeSegment &segment, const char *str);
+	//! Returns the first position in [begin, end) where the segment matches, or nullptr if there is none
+	static const char *FindSegment(LikeSegment &segment, const char *begin, const char *end);
+
+	//! The segments of the pattern, without the % wildcards that separate them
+	vector<LikeSegment> segments;
+	//! Whether or not the pattern starts with a % wildcard
+	bool has_start_percentage;
+	//! Whether or not the pattern ends with a % wildcard
+	bool has_end_percentage;
+};
+
 } // namespace duckdb
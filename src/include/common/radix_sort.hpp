@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// common/radix_sort.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/enums/order_type.hpp"
+#include "common/types/chunk_collection.hpp"
+
+namespace duckdb {
+
+//! RadixSort sorts tuples on normalized keys: the sort columns of every tuple are encoded into a fixed-width byte
+//! string that compares (with memcmp) in the same order as the tuples, after which the keys are sorted with an MSD
+//! radix sort. Strings only store a prefix in the key, tuples with equal keys are then ordered with a comparison sort.
+class RadixSort {
+public:
+	//! The maximum amount of bytes of a string that is stored in a normalized key
+	static constexpr index_t STRING_PREFIX_SIZE = 16;
+
+	//! Sorts the tuples of the collection on its first desc.size() columns, NULL values are smaller than any other
+	//! value. Writes the sorted tuple indices to result.
+	static void Sort(ChunkCollection &collection, vector<OrderType> &desc, index_t result[]);
+	//! Sorts the (non-NULL) values of the vector selected by the selection vector in ascending order, writing the
+	//! sorted selection vector to result
+	static void Sort(Vector &vector, sel_t *sel_vector, index_t count, sel_t result[]);
+};
+
+} // namespace duckdb
@@ -40,6 +40,8 @@ public:
 
 	//! Append a new DataChunk directly to this ChunkCollection
 	void Append(DataChunk &new_chunk);
+	//! Append all the chunks of another ChunkCollection to this ChunkCollection
+	void Append(ChunkCollection &other);
 
 	//! Gets the value of the column at the specified index
 	Value GetValue(index_t column, index_t index);
@@ -60,9 +62,16 @@ public:
 	}
 
 	void Sort(vector<OrderType> &desc, index_t result[]);
-	//! Reorders the rows in the collection according to the given indices. NB: order is changed!
+	//! Compares the tuple at left_idx in the left chunk with the tuple at right_idx in the right chunk on the columns
+	//! starting at column_offset, with the given order types. Returns a negative number, zero or a positive number if
+	//! the left tuple sorts before, equal to or after the right tuple.
+	static int CompareTuple(DataChunk &left, index_t left_idx, DataChunk &right, index_t right_idx,
+	                        vector<OrderType> &desc, index_t column_offset = 0);
+	//! Reorders the rows in the collection according to the given indices, such that row i is the old row order[i]
 	void Reorder(index_t order[]);
 
+	//! Materializes the (at most STANDARD_VECTOR_SIZE) rows order[start_offset], order[start_offset + 1], ... in the
+	//! target chunk
 	void MaterializeSortedChunk(DataChunk &target, index_t order[], index_t start_offset);
 
 	//! Returns true if the ChunkCollections are equivalent
@@ -90,6 +90,7 @@ typedef struct {
 typedef void *duckdb_database;
 typedef void *duckdb_connection;
 typedef void *duckdb_prepared_statement;
+typedef void *duckdb_appender;
 
 typedef enum { DuckDBSuccess = 0, DuckDBError = 1 } duckdb_state;
 
@@ -154,6 +155,22 @@ duckdb_state duckdb_execute_prepared(duckdb_prepared_statement prepared_statemen
 //! Destroys the specified prepared statement descriptor
 void duckdb_destroy_prepare(duckdb_prepared_statement *prepared_statement);
 
+// Appender
+
+//! Creates an appender that appends rows in bulk to the table [schema].[table] (schema can be nullptr for the default
+//! schema). The appended rows are only visible to other connections after duckdb_appender_commit. [OUT: appender]
+duckdb_state duckdb_appender_create(duckdb_connection connection, const char *schema, const char *table,
+                                    duckdb_appender *out_appender);
+//! Appends count rows to the table. columns holds one array of count values for every column of the table, in the
+//! representation of a duckdb_column of that type (e.g. duckdb_date for DATE columns, const char* for VARCHAR columns).
+//! nullmasks is either NULL (no NULL values), or holds per column either NULL or an array of count entries that are
+//! true for NULL values.
+duckdb_state duckdb_append_columns(duckdb_appender appender, index_t count, void **columns, bool **nullmasks);
+//! Commits the rows appended so far. The appender cannot be used for appending after this point.
+duckdb_state duckdb_appender_commit(duckdb_appender appender);
+//! Destroys the appender, rolling back the appended rows if they have not been committed
+void duckdb_appender_destroy(duckdb_appender *appender);
+
 #ifdef __cplusplus
 };
 #endif
@@ -37,6 +37,9 @@ public:
 	//! data in the group chunk. When resize = true, aggregates will not be
 	//! computed but instead just assigned.
 	void AddChunk(DataChunk &groups, DataChunk &payload);
+	//! Merge the groups and aggregate states of another HT with the same layout into this HT. The strings of the other
+	//! HT are moved into the string heap of this HT. Requires all aggregates to have a combine function.
+	void Combine(SuperLargeHashTable &other);
 	//! Scan the HT starting from the scan_position until the result and group
 	//! chunks are filled. scan_position will be updated by this function.
 	//! Returns the amount of elements found.
@@ -56,6 +56,9 @@ protected:
 	//! Execute the abstract expression, and "logical AND" the result together
 	//! with result
 	void MergeExpression(Expression &expr, Vector &result);
+	//! Execute the expression only for the count rows of the chunk in the selection vector, which is a subset of the
+	//! rows of the chunk. The result has the given selection vector (or is a constant).
+	void ExecuteSubset(Expression &expr, Vector &result, sel_t *sel_vector, index_t count);
 
 	//! Verify that the output of a step in the ExpressionExecutor is correct
 	void Verify(Expression &expr, Vector &result);
@@ -14,6 +14,7 @@
 #include "parser/parsed_expression.hpp"
 #include "storage/data_table.hpp"
 #include "storage/index.hpp"
+#include "storage/storage_lock.hpp"
 #include "common/types/static_vector.hpp"
 #include "art_key.hpp"
 #include "leaf.hpp"
@@ -23,6 +24,8 @@
 #include "node48.hpp"
 #include "node256.hpp"
 
+#include <functional>
+
 namespace duckdb {
 struct IteratorEntry {
 	Node *node = nullptr;
@@ -34,10 +37,21 @@ struct Iterator {
 	Leaf *node = nullptr;
 	//! The current depth
 	int32_t depth = 0;
-	//! Stack, actually the size is determined at runtime
-	IteratorEntry stack[9];
+	//! Stack of the nodes on the path to the current leaf, grows with the depth of the tree
+	vector<IteratorEntry> stack;
 
 	bool start = false;
+
+	//! Push a node onto the stack, and return its entry
+	IteratorEntry &Push(Node *node, index_t pos) {
+		if ((index_t)depth == stack.size()) {
+			stack.resize(depth + 1);
+		}
+		auto &entry = stack[depth++];
+		entry.node = node;
+		entry.pos = pos;
+		return entry;
+	}
 };
 
 struct ARTIndexScanState : public IndexScanState {
@@ -46,27 +60,60 @@ struct ARTIndexScanState : public IndexScanState {
 
 	Value values[2];
 	ExpressionType expressions[2];
+	//! The values of an equality predicate on every expression of the index
+	vector<Value> equal_values;
 	bool checked;
 	index_t result_index = 0;
 	vector<row_t> result_ids;
 	Iterator iterator;
 };
 
+//! An entry of the table that is collected while the index is created
+struct ARTBuildEntry {
+	//! The first (up to) 8 bytes of the key as an integer, which orders most entries without accessing their key
+	uint64_t prefix;
+	//! The key of the entry, which is stored in the key blocks of the build state
+	data_ptr_t key;
+	index_t length;
+	row_t row_id;
+};
+
+//! The entries that are collected while the index is created. Instead of inserting them one by one, they are sorted
+//! by their key after which the tree is constructed bottom-up, with nodes of the right size.
+struct ARTBuildState {
+	ARTBuildState() : key_position(nullptr), key_remaining(0) {
+	}
+
+	vector<ARTBuildEntry> entries;
+	//! The blocks that hold the keys of the entries
+	vector<unique_ptr<data_t[]>> key_blocks;
+	//! The unused part of the last key block
+	data_ptr_t key_position;
+	index_t key_remaining;
+
+	//! Allocate room for a key of the given length in the key blocks
+	data_ptr_t AllocateKey(index_t length);
+};
+
+//! Thrown when a reader that shares the index with other readers reaches a node that has not been loaded from the
+//! database file yet. Nodes can only be loaded while the index is locked exclusively, so the reader restarts with an
+//! exclusive lock.
+struct ARTRestart {};
+
 class ART : public Index {
 public:
 	ART(DataTable &table, vector<column_t> column_ids, vector<unique_ptr<Expression>> unbound_expressions,
 	    bool is_unique = false);
 	~ART();
 
-	//! Lock used for updating the index
-	std::mutex lock;
+	//! Lock of the index: lookups and scans share the index, modifications lock it exclusively
+	StorageLock lock;
+	//! Whether the index is locked exclusively, which is required to load nodes from the database file
+	bool locked_exclusively;
 	//! Root of the tree
 	unique_ptr<Node> tree;
 	//! True if machine is little endian
 	bool is_little_endian;
-	//! The maximum prefix length for compressed paths stored in the
-	//! header, if the path is longer it is loaded from the database on demand
-	uint32_t maxPrefix;
 	//! Whether or not the ART is an index built to enforce a UNIQUE constraint
 	bool is_unique;
 
@@ -83,32 +130,65 @@ public:
 	                                                       Value high_value,
 	                                                       ExpressionType high_expression_type) override;
 
+	//! Initialize a scan on the index with the given column ids to fetch from the base table, for an equality
+	//! predicate on every expression of the index
+	unique_ptr<IndexScanState> InitializeScanEqualityPredicates(Transaction &transaction, vector<column_t> column_ids,
+	                                                            vector<Value> values) override;
+
 	//! Perform a lookup on the index
 	void Scan(Transaction &transaction, IndexScanState *ss, DataChunk &result) override;
+	//! Look up the keys formed by the rows of the input chunk
+	void LookupKeys(DataChunk &input, vector<index_t> &result_rows, vector<row_t> &result_ids) override;
 	//! Append entries to the index
 	bool Append(DataChunk &entries, Vector &row_identifiers) override;
 	//! Delete entries in the index
 	void Delete(DataChunk &entries, Vector &row_identifiers) override;
+	//! Delete the entries of which the key differs from the key of the remaining version of the row
+	void Delete(DataChunk &entries, DataChunk &remaining_entries, Vector &row_identifiers) override;
+	//! Add the changed keys of rows that are updated in place
+	bool Update(DataChunk &old_entries, DataChunk &new_entries, Vector &row_identifiers) override;
+	//! Add the entries of appended rows that replace other rows
+	bool Replace(DataChunk &entries, Vector &row_identifiers, Vector &replaced_row_identifiers) override;
 
 	//! Insert data into the index. Does not lock the index.
 	bool Insert(DataChunk &data, Vector &row_ids) override;
 
+	//! Collect the entries of the existing rows of the table, the tree is constructed by FinalizeBuild
+	void BuildAppend(DataChunk &input, Vector &row_ids) override;
+	//! Sort the collected entries, and construct the tree from them
+	void FinalizeBuild(TaskScheduler &scheduler) override;
+
+	//! Write the nodes of the index to the writer, the children of a node before the node itself
+	BlockPointer Serialize(MetaBlockWriter &writer) override;
+	//! Use the index that is stored at the given position in the database file. Only its root is read: the other nodes
+	//! are loaded when they are first accessed.
+	void Load(BlockPointer root);
+
+	//! The minimum amount of entries that the sort of FinalizeBuild assigns to a thread
+	static constexpr index_t BUILD_PARTITION_SIZE = 16384;
+
 private:
 	DataChunk expression_result;
+	//! The entries collected while the index is created
+	unique_ptr<ARTBuildState> build_state;
 
 private:
 	//! Insert a row id into a leaf node
-	bool InsertToLeaf(Leaf &leaf, row_t row_id);
-	//! Insert the leaf value into the tree
-	bool Insert(unique_ptr<Node> &node, unique_ptr<Key> key, unsigned depth, row_t row_id);
+	bool InsertToLeaf(Leaf &leaf, row_t row_id, bool check_unique);
+	//! Insert the leaf value into the tree. If check_unique is false, the UNIQUE constraint is not checked.
+	bool Insert(unique_ptr<Node> &node, unique_ptr<Key> key, unsigned depth, row_t row_id, bool check_unique = true);
+	//! Insert the keys of rows that replace other rows: keys[k] is the key of row_ids[k], which replaces row
+	//! replaced_ids[k] (possibly the same row). Keys for which insert[k] is false are not inserted. A UNIQUE index
+	//! allows a key that is held by a replaced row, unless another row that replaces a row takes the key as well.
+	//! Returns false on a violation, in which case no keys are inserted.
+	bool InsertReplacingRows(vector<unique_ptr<Key>> &keys, vector<bool> &insert, vector<row_t> &row_ids,
+	                         vector<row_t> &replaced_ids);
 
 	//! Erase element from leaf (if leaf has more than one value) or eliminate the leaf itself
 	void Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id);
 
-	//! Check if the key of the leaf is equal to the searched key
-	bool LeafMatches(Node *node, Key &key, unsigned depth);
-
-	//! Find the node with a matching key, optimistic version
+	//! Find the leaf with a matching key. The prefixes of the inner nodes are skipped without comparing them, instead
+	//! the key of the leaf is compared with the entire key.
 	Node *Lookup(unique_ptr<Node> &node, Key &key, unsigned depth);
 
 	//! Find the first node that is bigger (or equal to) a specific key
@@ -117,7 +197,7 @@ private:
 	//! Gets next node for range queries
 	bool IteratorNext(Iterator &iter);
 
-	void SearchEqual(vector<row_t> &result_ids, ARTIndexScanState *state);
+	void SearchEqual(vector<row_t> &result_ids, Key &key);
 	void SearchGreater(vector<row_t> &result_ids, ARTIndexScanState *state, bool inclusive);
 	void SearchLess(vector<row_t> &result_ids, ARTIndexScanState *state, bool inclusive);
 	void SearchCloseRange(vector<row_t> &result_ids, ARTIndexScanState *state, bool left_inclusive,
@@ -127,6 +207,12 @@ private:
 	template <bool HAS_BOUND, bool INCLUSIVE>
 	void IteratorScan(ARTIndexScanState *state, Iterator *it, vector<row_t> &result_ids, Key *upper_bound);
 
+	//! Execute a read of the index with a shared lock. If the read has to load nodes from the database file, restart is
+	//! called to undo its effects after which it is executed again with an exclusive lock.
+	void ExecuteRead(const std::function<void()> &read, const std::function<void()> &restart);
+	//! Search the index for the predicates of the scan state
+	void Search(ARTIndexScanState *state, vector<row_t> &result_ids);
+
 	void GenerateKeys(DataChunk &input, vector<unique_ptr<Key>> &keys);
 };
 
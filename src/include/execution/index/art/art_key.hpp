@@ -10,9 +10,14 @@
 
 #include "common/common.hpp"
 #include "common/exception.hpp"
+#include "common/types/value.hpp"
 
 namespace duckdb {
 
+//! A Key is the binary-comparable encoding of the values of the indexed expressions of a row: comparing two keys
+//! byte-by-byte gives the order of the rows. The keys of multiple columns are the concatenation of the encodings of
+//! the columns. No key is a prefix of another key, since every value has a fixed length encoding apart from strings,
+//! which are terminated by a zero byte.
 class Key {
 public:
 	Key(unique_ptr<data_t[]> data, index_t len);
@@ -22,9 +27,19 @@ public:
 
 public:
 	template <class T> static unique_ptr<Key> CreateKey(T element, bool is_little_endian) {
-		auto data = Key::CreateData<T>(element, is_little_endian);
+		auto data = unique_ptr<data_t[]>(new data_t[sizeof(element)]);
+		Key::EncodeData<T>(data.get(), element, is_little_endian);
 		return make_unique<Key>(move(data), sizeof(element));
 	}
+	//! Creates the key of a set of values, one for each of the indexed expressions
+	static unique_ptr<Key> CreateKey(const vector<Value> &values, bool is_little_endian);
+
+	//! Writes the encoding of the value to data, which has to hold sizeof(T) bytes
+	template <class T> static void EncodeData(data_ptr_t data, T value, bool is_little_endian) {
+		throw NotImplementedException("Cannot create data from this type");
+	}
+	//! Writes the encoding of the string to data, which has to hold strlen(value) + 1 bytes
+	static void EncodeString(data_ptr_t data, const char *value);
 
 public:
 	data_t &operator[](std::size_t i);
@@ -34,17 +49,15 @@ public:
 	bool operator==(const Key &k) const;
 
 	string ToString(bool is_little_endian, TypeId type);
-
-private:
-	template <class T> static unique_ptr<data_t[]> CreateData(T value, bool is_little_endian) {
-		throw NotImplementedException("Cannot create data from this type");
-	}
 };
 
-template <> unique_ptr<data_t[]> Key::CreateData(int8_t value, bool is_little_endian);
-template <> unique_ptr<data_t[]> Key::CreateData(int16_t value, bool is_little_endian);
-template <> unique_ptr<data_t[]> Key::CreateData(int32_t value, bool is_little_endian);
-template <> unique_ptr<data_t[]> Key::CreateData(int64_t value, bool is_little_endian);
+template <> void Key::EncodeData(data_ptr_t data, bool value, bool is_little_endian);
+template <> void Key::EncodeData(data_ptr_t data, int8_t value, bool is_little_endian);
+template <> void Key::EncodeData(data_ptr_t data, int16_t value, bool is_little_endian);
+template <> void Key::EncodeData(data_ptr_t data, int32_t value, bool is_little_endian);
+template <> void Key::EncodeData(data_ptr_t data, int64_t value, bool is_little_endian);
+template <> void Key::EncodeData(data_ptr_t data, float value, bool is_little_endian);
+template <> void Key::EncodeData(data_ptr_t data, double value, bool is_little_endian);
 
 template <> unique_ptr<Key> Key::CreateKey(string element, bool is_little_endian);
 
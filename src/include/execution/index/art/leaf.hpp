@@ -11,10 +11,12 @@
 #include "node.hpp"
 
 namespace duckdb {
+class Deserializer;
 
 class Leaf : public Node {
 public:
 	Leaf(ART &art, unique_ptr<Key> value, row_t row_id);
+	Leaf(ART &art, unique_ptr<Key> value, unique_ptr<row_t[]> row_ids, index_t num_elements);
 
 	unique_ptr<Key> value;
 	index_t capacity;
@@ -28,6 +30,11 @@ public:
 	void Insert(row_t row_id);
 	void Remove(row_t row_id);
 
+	//! Write the leaf to the writer, returns its position
+	BlockPointer Serialize(MetaBlockWriter &writer);
+	//! Read a leaf, of which the node type was already read
+	static unique_ptr<Leaf> Deserialize(ART &art, Deserializer &source);
+
 private:
 	unique_ptr<row_t[]> row_ids;
 };
@@ -10,11 +10,13 @@
 
 #include "art_key.hpp"
 #include "common/common.hpp"
+#include "storage/storage_info.hpp"
 
 namespace duckdb {
-enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, NLeaf = 4 };
+enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, NLeaf = 4, NPersistent = 5 };
 
 class ART;
+class MetaBlockWriter;
 
 class Node {
 public:
@@ -31,7 +33,7 @@ public:
 	uint16_t count;
 	//! node type
 	NodeType type;
-	//! compressed path (prefix)
+	//! compressed path (prefix), prefix_length bytes
 	unique_ptr<uint8_t[]> prefix;
 
 public:
@@ -53,16 +55,44 @@ public:
 	//! the element is not found.
 	virtual unique_ptr<Node> *GetChild(index_t pos);
 
+	//! Set the prefix of the node to the given bytes
+	void SetPrefix(const uint8_t *data, uint32_t length);
+
 	//! Compare the key with the prefix of the node, return the number matching bytes
 	static uint32_t PrefixMismatch(ART &art, Node *node, Key &key, uint64_t depth);
 	//! Insert leaf into inner node
 	static void InsertLeaf(ART &art, unique_ptr<Node> &node, uint8_t key, unique_ptr<Node> &newNode);
 	//! Erase entry from node
 	static void Erase(ART &art, unique_ptr<Node> &node, index_t pos);
+	//! Add a child to an inner node that has room for it. Its key byte has to be greater than the key bytes of the
+	//! existing children of the node.
+	static void AppendChild(Node &node, uint8_t key_byte, unique_ptr<Node> child);
+
+	//! Write the node and its children to the writer, the children before their parent. Returns the position of the
+	//! node.
+	static BlockPointer Serialize(ART &art, unique_ptr<Node> &node, MetaBlockWriter &writer);
+	//! Read the node at the given position. Its children are not read: they are loaded when they are first accessed.
+	static unique_ptr<Node> Deserialize(ART &art, BlockPointer pointer);
 
 protected:
 	//! Copies the prefix from the source to the destination node
 	static void CopyPrefix(ART &art, Node *src, Node *dst);
+	//! Returns the child, after loading it from the database file if it has not been loaded yet. Every access to a
+	//! child has to go through this function. Throws ARTRestart if the child has to be loaded while the index is not
+	//! locked exclusively.
+	static unique_ptr<Node> *LoadChild(unique_ptr<Node> &child);
+};
+
+//! PersistentNode is a placeholder for a node of a stored index that has not been loaded yet
+class PersistentNode : public Node {
+public:
+	PersistentNode(ART &art, BlockPointer pointer) : Node(art, NodeType::NPersistent), art(art), pointer(pointer) {
+	}
+
+	//! The index the node belongs to
+	ART &art;
+	//! The position of the node in the database file
+	BlockPointer pointer;
 };
 
 } // namespace duckdb
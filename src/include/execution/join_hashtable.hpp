@@ -14,9 +14,9 @@
 #include "execution/aggregate_hashtable.hpp"
 #include "planner/operator/logical_comparison_join.hpp"
 
-#include <mutex>
-
 namespace duckdb {
+class SpillFile;
+class TaskScheduler;
 
 //! JoinHashTable is a linear probing HT that is used for computing joins
 /*!
@@ -99,16 +99,73 @@ private:
 	void Hash(DataChunk &keys, Vector &hashes);
 
 public:
+	//! The thread-local state of a parallel build. Every thread serializes its input into its own chain of nodes; the
+	//! chains are only merged into the HT and inserted into the hash map once all input has been consumed.
+	struct LocalBuildState {
+		LocalBuildState() : count(0), has_null(false) {
+		}
+
+		//! The chain of nodes holding the tuples added by this thread
+		unique_ptr<Node> head;
+		//! The amount of tuples added by this thread
+		index_t count;
+		//! Whether or not any of the keys added by this thread contain NULL
+		bool has_null;
+		//! The strings referenced by the tuples added by this thread
+		StringHeap string_heap;
+	};
+
 	JoinHashTable(vector<JoinCondition> &conditions, vector<TypeId> build_types, JoinType type,
-	              index_t initial_capacity = 32768, bool parallel = false);
+	              index_t initial_capacity = 32768);
 	//! Resize the HT to the specified size. Must be larger than the current
 	//! size.
 	void Resize(index_t size);
 	//! Add the given data to the HT
 	void Build(DataChunk &keys, DataChunk &input);
+	//! Add the given data to a thread-local build state. Can be called concurrently for different build states. Not
+	//! supported for correlated MARK joins.
+	void Build(LocalBuildState &local_state, DataChunk &keys, DataChunk &input);
+	//! Merge the thread-local build states into the HT and insert their tuples into the hash map, using the threads of
+	//! the scheduler
+	void Finalize(vector<unique_ptr<LocalBuildState>> &local_states, TaskScheduler &scheduler);
 	//! Probe the HT with the given input chunk, resulting in the given result
 	unique_ptr<ScanStructure> Probe(DataChunk &keys);
 
+	//! Returns the (approximate) amount of memory used by the tuples and the hash map of the HT
+	index_t MemoryUsage();
+	//! Returns the (approximate) amount of memory a HT needs to hold tuple_count tuples
+	index_t MemoryUsage(index_t tuple_count);
+	//! Move all tuples of the HT into the radix partitions of a spilled build side, leaving an empty HT
+	void Partition(vector<unique_ptr<SpillFile>> &partitions);
+	//! Move all tuples of a thread-local build state into the radix partitions of a spilled build side. Can be called
+	//! concurrently for different build states.
+	void Partition(LocalBuildState &local_state, vector<unique_ptr<SpillFile>> &partitions);
+	//! Write the given build side data into the radix partitions of a spilled build side
+	void PartitionBuild(DataChunk &keys, DataChunk &payload, vector<unique_ptr<SpillFile>> &partitions);
+	//! Write the given build side data into the radix partitions of a spilled build side, keeping track of NULL values
+	//! in the thread-local build state. Can be called concurrently for different build states.
+	void PartitionBuild(LocalBuildState &local_state, DataChunk &keys, DataChunk &payload,
+	                    vector<unique_ptr<SpillFile>> &partitions);
+	//! Write the given probe side data into the radix partitions of a spilled probe side. The depth is the amount of
+	//! times the data has been radix partitioned before.
+	void PartitionProbe(DataChunk &keys, DataChunk &input, vector<unique_ptr<SpillFile>> &partitions,
+	                    index_t depth = 0);
+	//! Split a radix partition of a spilled build side that was created at the given depth into the partitions of the
+	//! next depth
+	void Repartition(SpillFile &partition, vector<unique_ptr<SpillFile>> &partitions, index_t depth);
+	//! Add the tuples of a radix partition of a spilled build side to the HT
+	void Build(SpillFile &partition);
+
+	//! The amount of bits of the hash that are used to radix partition a spilled join
+	static constexpr index_t SPILL_PARTITION_BITS = 4;
+	//! The amount of radix partitions of a spilled join
+	static constexpr index_t SPILL_PARTITION_COUNT = (index_t)1 << SPILL_PARTITION_BITS;
+	//! The hash bits that determine the partition. Hashes are 32-bit values, the lower bits are used for the hash map.
+	static constexpr index_t SPILL_PARTITION_SHIFT = 32 - SPILL_PARTITION_BITS;
+	//! The maximum depth of a radix partition: a partition that exceeds the memory limit is split using the next bits
+	//! of the hash, until all bits of the hash have been used
+	static constexpr index_t SPILL_MAX_DEPTH = SPILL_PARTITION_SHIFT / SPILL_PARTITION_BITS;
+
 	//! The stringheap of the JoinHashTable
 	StringHeap string_heap;
 
@@ -161,8 +218,25 @@ private:
 	//! Apply a bitmask to the hashes
 	void ApplyBitmask(Vector &hashes);
 	//! Insert the given set of locations into the HT with the given set of
-	//! hashes. Caller should hold lock in parallel HT.
-	void InsertHashes(Vector &hashes, data_ptr_t key_locations[]);
+	//! hashes. If parallel is true, the insertion can happen concurrently with other insertions.
+	void InsertHashes(Vector &hashes, data_ptr_t key_locations[], bool parallel = false);
+	//! Serialize the keys with a non-NULL value (or a value for which NULL values are equal) and their payload into a
+	//! new node, filling the key_locations with the position of every tuple. Returns nullptr if no tuple is left. The
+	//! keys and payload can be left referencing not_null_sel_vector, which must outlive their use by the caller.
+	unique_ptr<Node> SerializeNode(DataChunk &keys, DataChunk &payload, data_ptr_t key_locations[],
+	                               sel_t not_null_sel_vector[], bool &has_null);
+	//! Write the tuples of the input to the radix partitions determined by the hash of the keys, using the hash bits
+	//! of the given depth
+	void PartitionChunk(DataChunk &keys, DataChunk &input, vector<unique_ptr<SpillFile>> &partitions,
+	                    index_t depth = 0);
+	//! Write the tuples of a chain of nodes to the radix partitions of a spilled build side
+	void PartitionNodes(Node *node, vector<unique_ptr<SpillFile>> &partitions);
+	//! Write the given build side data into the radix partitions of a spilled build side, setting found_null if any
+	//! of the keys contains a NULL value
+	void PartitionBuild(DataChunk &keys, DataChunk &payload, vector<unique_ptr<SpillFile>> &partitions,
+	                    bool &found_null);
+	//! The types of the chunks in a spilled build side: the keys followed by the stored payload
+	vector<TypeId> GetSpillTypes();
 	//! The capacity of the HT. This can be increased using
 	//! JoinHashTable::Resize
 	index_t capacity;
@@ -172,10 +246,6 @@ private:
 	unique_ptr<Node> head;
 	//! The hash map of the HT
 	unique_ptr<data_ptr_t[]> hashed_pointers;
-	//! Whether or not the HT has to support parallel build
-	bool parallel = false;
-	//! Mutex used for parallelism
-	std::mutex parallel_lock;
 	//! Whether or not NULL values are considered equal in each of the comparisons
 	vector<bool> null_values_are_equal;
 
@@ -8,11 +8,13 @@
 
 #pragma once
 
+#include "common/types/chunk_collection.hpp"
 #include "execution/aggregate_hashtable.hpp"
 #include "execution/physical_operator.hpp"
 #include "storage/data_table.hpp"
 
 namespace duckdb {
+class PhysicalHashAggregateOperatorState;
 
 //! PhysicalHashAggregate is an group-by and aggregate implementation that uses
 //! a hash table to perform the grouping
@@ -30,10 +32,31 @@ public:
 	vector<unique_ptr<Expression>> aggregates;
 	bool is_implicit_aggr;
 
+	//! The amount of bits of the group hash used to radix partition the groups in a parallel aggregation
+	static constexpr index_t PARTITION_BITS = 4;
+	static constexpr index_t PARTITION_COUNT = (index_t)1 << PARTITION_BITS;
+	//! The position of the partition bits within the group hash. The hashes of fixed-size types only use the lower 32
+	//! bits, and the hash tables themselves use the lowest bits to find the position of a group.
+	static constexpr index_t PARTITION_SHIFT = 32 - PARTITION_BITS;
+
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+private:
+	//! Compute the groups and the aggregate inputs of the input chunk
+	void ComputeGroupsAndPayload(DataChunk &input, DataChunk &group_chunk, DataChunk &payload_chunk);
+	//! Returns true if the input of the aggregate can be consumed by a parallel pipeline
+	bool CanParallelize(ClientContext &context);
+	//! Consume the entire input in parallel: every thread pre-aggregates its input in radix partitioned hash tables,
+	//! the partitions of the threads are then merged and finalized in parallel. Returns false if the input is too small
+	//! to benefit from parallelism, in which case nothing has been consumed.
+	bool ExecuteParallel(ClientContext &context, PhysicalHashAggregateOperatorState &state);
+	//! Create an empty hash table for the groups and aggregates
+	unique_ptr<SuperLargeHashTable> CreateHashTable();
+	//! Returns the types of the aggregate inputs
+	vector<TypeId> GetPayloadTypes();
 };
 
 class PhysicalHashAggregateOperatorState : public PhysicalOperatorState {
@@ -51,5 +74,19 @@ public:
 	unique_ptr<SuperLargeHashTable> ht;
 	//! The payload chunk, only used while filling the HT
 	DataChunk payload_chunk;
+
+	//! Whether or not we have checked if the input can be aggregated in parallel
+	bool parallel_checked;
+	//! Whether or not the input has been aggregated in parallel
+	bool is_parallel;
+	//! The merged partitions of a parallel aggregation
+	vector<unique_ptr<SuperLargeHashTable>> partitions;
+	//! The finalized groups and aggregates of every partition of a parallel aggregation
+	vector<unique_ptr<ChunkCollection>> partition_results;
+	//! The strings referenced by the partitions of a parallel aggregation
+	StringHeap string_heap;
+	//! The current partition and chunk to scan the result of a parallel aggregation
+	index_t scan_partition;
+	index_t scan_chunk;
 };
 } // namespace duckdb
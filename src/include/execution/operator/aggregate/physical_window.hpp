@@ -24,6 +24,13 @@ public:
 	//! The projection list of the SELECT statement (that contains aggregates)
 	vector<unique_ptr<Expression>> select_list;
 
+	//! The amount of bits of the hash of the PARTITION BY keys used to divide the rows over independent partitions,
+	//! which are evaluated in parallel. There are more partitions than threads to balance partitions of different size.
+	static constexpr index_t PARTITION_BITS = 5;
+	static constexpr index_t PARTITION_COUNT = (index_t)1 << PARTITION_BITS;
+	//! The position of the partition bits within the hash (see PhysicalHashAggregate::PARTITION_SHIFT)
+	static constexpr index_t PARTITION_SHIFT = 32 - PARTITION_BITS;
+
 public:
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
 };
@@ -14,7 +14,8 @@ namespace duckdb {
 
 //! PhysicalFilter represents a filter operator. It removes non-matching tupels
 //! from the result. Note that it does not physically change the data, it only
-//! adds a selection vector to the chunk.
+//! adds a selection vector to the chunk. Every filter expression is only evaluated for the tuples that passed the
+//! previous ones, and the expressions are reordered so that cheap and selective expressions are evaluated first.
 class PhysicalFilter : public PhysicalOperator {
 public:
 	PhysicalFilter(LogicalOperator &op, vector<unique_ptr<Expression>> select_list)
@@ -23,9 +24,40 @@ public:
 
 	vector<unique_ptr<Expression>> expressions;
 
+	//! The amount of chunks after which the order of the filter expressions is reconsidered
+	static constexpr index_t ADAPTIVE_INTERVAL = 64;
+
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
 
 	string ExtraRenderInformation() const override;
 };
+
+//! The statistics of a filter expression that are used to determine the order in which they are evaluated
+struct FilterExpressionStatistics {
+	//! The amount of tuples the expression was evaluated for
+	index_t tuples_in = 0;
+	//! The amount of tuples that passed the expression
+	index_t tuples_out = 0;
+	//! The time spent evaluating the expression, in seconds
+	double time = 0;
+};
+
+class PhysicalFilterOperatorState : public PhysicalOperatorState {
+public:
+	PhysicalFilterOperatorState(PhysicalOperator *child, index_t expression_count)
+	    : PhysicalOperatorState(child), chunk_count(0), statistics(expression_count) {
+		for (index_t i = 0; i < expression_count; i++) {
+			order.push_back(i);
+		}
+	}
+
+	//! The order in which the filter expressions are evaluated
+	vector<index_t> order;
+	//! The amount of chunks filtered since the order was last updated
+	index_t chunk_count;
+	//! The statistics of the filter expressions since the order was last updated
+	vector<FilterExpressionStatistics> statistics;
+};
 } // namespace duckdb
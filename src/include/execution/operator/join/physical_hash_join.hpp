@@ -12,9 +12,11 @@
 #include "execution/join_hashtable.hpp"
 #include "execution/operator/join/physical_comparison_join.hpp"
 #include "execution/physical_operator.hpp"
+#include "execution/spill_file.hpp"
 #include "planner/operator/logical_join.hpp"
 
 namespace duckdb {
+class PhysicalHashJoinOperatorState;
 
 //! PhysicalHashJoin represents a hash loop join between two tables
 class PhysicalHashJoin : public PhysicalComparisonJoin {
@@ -27,17 +29,75 @@ public:
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+	//! Build the hash table from the right child. The build is executed in parallel if the right child is a parallel
+	//! pipeline. If the hash table exceeds the memory limit, the build side is radix partitioned to disk instead
+	//! (grace hash join), and the partitions are kept in the state.
+	void BuildHashTable(ClientContext &context, PhysicalHashJoinOperatorState &state);
+	//! Returns true if the hash table can be probed by multiple threads at the same time, unless it has been spilled
+	bool CanProbeInParallel(ClientContext &context);
+
+private:
+	//! Returns true if the hash table can be spilled to disk when it exceeds the memory limit
+	bool CanSpill(ClientContext &context);
+	//! Create the spill files of the radix partitions of the build side
+	void CreateBuildPartitions(ClientContext &context, PhysicalHashJoinOperatorState &state);
+	//! Radix partition the entire left side of a spilled join to disk
+	void PartitionProbeSide(ClientContext &context, PhysicalHashJoinOperatorState &state);
+	//! Split the current partition of a spilled join, which exceeds the memory limit, into smaller partitions using
+	//! the next bits of the hash
+	void RepartitionSpilledPartition(ClientContext &context, PhysicalHashJoinOperatorState &state);
+	//! Fetch the next chunk of the left side into the child_chunk of the state. For a spilled join the partitions are
+	//! joined one by one, building the hash table of a partition before its probe side is read. Returns false if the
+	//! left side is exhausted.
+	bool FetchProbeChunk(ClientContext &context, PhysicalHashJoinOperatorState &state);
+	//! Resolve the join keys of the right side of the join
+	void ResolveBuildKeys(DataChunk &input, DataChunk &keys);
+	//! Resolve the join keys of the left side of the join
+	void ResolveProbeKeys(DataChunk &input, DataChunk &keys);
 };
 
 class PhysicalHashJoinOperatorState : public PhysicalOperatorState {
 public:
+	//! A radix partition of a spilled join: the tuples of both sides of the join with the same bits of the hash
+	struct SpilledPartition {
+		SpilledPartition() : depth(0) {
+		}
+		SpilledPartition(unique_ptr<SpillFile> build, unique_ptr<SpillFile> probe, index_t depth)
+		    : build(move(build)), probe(move(probe)), depth(depth) {
+		}
+
+		//! The tuples of the build side
+		unique_ptr<SpillFile> build;
+		//! The tuples of the probe side
+		unique_ptr<SpillFile> probe;
+		//! The amount of times the tuples were radix partitioned before ending up in this partition
+		index_t depth;
+	};
+
 	PhysicalHashJoinOperatorState(PhysicalOperator *left, PhysicalOperator *right)
-	    : PhysicalOperatorState(left), initialized(false) {
+	    : PhysicalOperatorState(left), initialized(false), probe_partitioned(false) {
 		assert(left && right);
 	}
 
+	//! Returns true if the build side has been spilled to disk, in which case the partitions are joined one by one by
+	//! a single thread
+	bool IsSpilled() {
+		return build_partitions.size() > 0 || probe_partitioned;
+	}
+
 	bool initialized;
 	DataChunk join_keys;
 	unique_ptr<JoinHashTable::ScanStructure> scan_structure;
+	//! The radix partitions of the build side, if the hash table has been spilled to disk
+	vector<unique_ptr<SpillFile>> build_partitions;
+	//! Whether or not the probe side of a spilled join has been radix partitioned to disk
+	bool probe_partitioned;
+	//! The partitions of a spilled join that have not been joined yet, the next partition is at the back
+	vector<SpilledPartition> partitions;
+	//! The partition of a spilled join that is currently being probed
+	SpilledPartition current_partition;
+	//! The hash table of the partition that is currently being probed
+	unique_ptr<JoinHashTable> partition_table;
 };
 } // namespace duckdb
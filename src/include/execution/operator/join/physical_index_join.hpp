@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/operator/join/physical_index_join.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "catalog/catalog_entry/table_catalog_entry.hpp"
+#include "execution/operator/join/physical_comparison_join.hpp"
+#include "storage/data_table.hpp"
+#include "storage/index.hpp"
+
+namespace duckdb {
+
+//! PhysicalIndexJoin is an inner join of its child (the probe side) with a base table that has an index on the join
+//! keys. Instead of building a hash table over the entire table, the keys of every probe chunk are looked up in the
+//! index and only the matching rows are fetched from the table.
+class PhysicalIndexJoin : public PhysicalComparisonJoin {
+public:
+	//! The conditions have the expressions of the probe side on the left, and the expressions of the table on the
+	//! right. For every expression of the index, key_columns holds the column of the table (an index into column_ids)
+	//! it refers to. If table_is_left is true the columns of the table precede the columns of the probe side in the
+	//! result.
+	PhysicalIndexJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> probe, TableCatalogEntry &tableref,
+	                  Index &index, vector<column_t> column_ids, vector<JoinCondition> cond,
+	                  vector<index_t> key_columns, bool table_is_left);
+
+	//! The index join is only used if the probe side is expected to be at least this many times smaller than the
+	//! table: a lookup in the index and a fetch of the row cost considerably more than a hash table insert
+	static constexpr index_t CARDINALITY_RATIO = 32;
+
+	//! The table that is joined with the probe side
+	TableCatalogEntry &tableref;
+	//! The index on the join keys of the table
+	Index &index;
+	//! The column ids of the table to fetch, followed by the row id
+	vector<column_t> fetch_ids;
+	//! The expressions of the probe side that form the keys of the index, in the order of the index expressions
+	vector<Expression *> key_expressions;
+	//! The comparisons of the conditions, which are evaluated on the fetched rows
+	vector<unique_ptr<Expression>> match_expressions;
+	//! Whether the columns of the table precede the columns of the probe side in the result
+	bool table_is_left;
+
+public:
+	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+	string ExtraRenderInformation() const override;
+};
+
+class PhysicalIndexJoinOperatorState : public PhysicalOperatorState {
+public:
+	PhysicalIndexJoinOperatorState(PhysicalOperator *child)
+	    : PhysicalOperatorState(child), row_end(INVALID_INDEX), position(0) {
+	}
+
+	//! The rows with a row id of at least row_end were appended after the join started, and are not part of the join
+	index_t row_end;
+
+	//! The keys of the probe chunk
+	DataChunk join_keys;
+	//! For every match of the probe chunk in the index the position of the probe row
+	vector<index_t> probe_rows;
+	//! For every match of the probe chunk in the index the row id of the matching row
+	vector<row_t> row_ids;
+	//! The next match to fetch
+	index_t position;
+	//! The rows fetched from the table
+	DataChunk fetch_chunk;
+};
+} // namespace duckdb
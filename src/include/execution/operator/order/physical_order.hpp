@@ -10,12 +10,16 @@
 
 #include "common/types/chunk_collection.hpp"
 #include "execution/physical_operator.hpp"
+#include "execution/spill_file.hpp"
 #include "planner/bound_query_node.hpp"
 
 namespace duckdb {
+class PhysicalOrderOperatorState;
+struct SortedRun;
 
 //! Represents a physical ordering of the data. Note that this will not change
-//! the data but only add a selection vector.
+//! the data but only add a selection vector. If the data does not fit in the memory limit, sorted runs are written to
+//! disk and merged afterwards (external merge sort).
 class PhysicalOrder : public PhysicalOperator {
 public:
 	PhysicalOrder(LogicalOperator &op, vector<BoundOrderByNode> orders)
@@ -27,6 +31,31 @@ public:
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+private:
+	//! Compute the sort keys of the data and the permutation that sorts the data
+	void SortData(ChunkCollection &data, ChunkCollection &keys, unique_ptr<index_t[]> &sorted_vector);
+	//! Sort the data and write it to disk as a sorted run
+	void WriteRun(ClientContext &context, ChunkCollection &data, PhysicalOrderOperatorState &state);
+	//! Merge groups of at most merge_width sorted runs into longer runs on disk, until all runs can be merged at once
+	void CombineRuns(ClientContext &context, PhysicalOrderOperatorState &state, index_t merge_width);
+	//! Load the first chunk of every sorted run, after which the runs can be merged
+	void InitializeMerge(vector<unique_ptr<SortedRun>> &runs, vector<index_t> &heap);
+	//! Merge the next tuples of the sorted runs into the chunk. If the chunk has more columns than the output of the
+	//! operator, the sort keys are copied into them as well.
+	void MergeRuns(vector<unique_ptr<SortedRun>> &runs, vector<index_t> &heap, DataChunk &chunk);
+};
+
+//! A sorted run of an external sort. The chunks of the run hold the sorted data followed by its sort keys.
+struct SortedRun {
+	SortedRun(unique_ptr<SpillFile> file) : file(move(file)), position(0) {
+	}
+
+	unique_ptr<SpillFile> file;
+	//! The chunk of the run that is currently being merged
+	DataChunk chunk;
+	//! The position of the next tuple in the current chunk
+	index_t position;
 };
 
 class PhysicalOrderOperatorState : public PhysicalOperatorState {
@@ -37,5 +66,9 @@ public:
 	index_t position;
 	ChunkCollection sorted_data;
 	unique_ptr<index_t[]> sorted_vector;
+	//! The sorted runs that have been written to disk, if the input does not fit in memory
+	vector<unique_ptr<SortedRun>> runs;
+	//! Heap of the runs that have tuples remaining, ordered on their next tuple
+	vector<index_t> merge_heap;
 };
 } // namespace duckdb
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/operator/order/physical_top_n.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/types/chunk_collection.hpp"
+#include "execution/physical_operator.hpp"
+#include "planner/bound_query_node.hpp"
+
+namespace duckdb {
+
+//! A TopNHeap keeps the first heap_size rows of its input in the order of the ORDER BY clause. Rows are only kept if
+//! they sort before the last row of the current top-n (the boundary), so most rows of a large input are rejected
+//! without being copied.
+class TopNHeap {
+public:
+	TopNHeap(vector<TypeId> &types, vector<BoundOrderByNode> &orders, index_t heap_size);
+
+	//! Add the rows of the input chunk to the heap. The sequence number of the first row of the chunk determines the
+	//! order of rows with equal sort keys: rows with a lower sequence number come first.
+	void Sink(DataChunk &input, int64_t sequence_start);
+	//! Add the rows of the other heap to this heap
+	void Combine(TopNHeap &other);
+	//! Sort the rows of the heap, after which they can be scanned
+	void Finalize();
+	//! Scan the next rows of the sorted heap, starting at the given position
+	void Scan(index_t &position, DataChunk &chunk);
+
+private:
+	//! Add candidate rows (the data, sort keys and sequence number of the rows) to the heap
+	void AddRows(DataChunk &rows);
+	//! Returns true if candidate left sorts before candidate right
+	bool SortsBefore(index_t left, index_t right);
+	//! Remove the candidates that are no longer part of the heap
+	void Compact();
+
+	//! The types of the rows
+	vector<TypeId> &types;
+	//! The maximum amount of rows in the heap
+	index_t heap_size;
+	//! The expressions that compute the sort keys
+	vector<Expression *> order_expressions;
+	//! The order types of the sort keys, including the sequence number
+	vector<OrderType> order_types;
+	//! The types of the candidate rows
+	vector<TypeId> row_types;
+	//! The candidate rows: the data followed by the sort keys and the sequence number of every row
+	ChunkCollection candidates;
+	//! The candidates that are part of the heap, with the last row of the top-n at the top of the heap
+	vector<index_t> heap;
+	//! The chunk the sort keys of the input are computed in
+	DataChunk keys;
+};
+
+//! PhysicalTopN computes the first limit rows after offset rows of the input in the order of the ORDER BY clause. It
+//! replaces a LIMIT on top of an ORDER BY, and only keeps the rows that can be part of the result instead of sorting
+//! the entire input.
+class PhysicalTopN : public PhysicalOperator {
+public:
+	PhysicalTopN(LogicalOperator &op, vector<BoundOrderByNode> orders, index_t limit, index_t offset)
+	    : PhysicalOperator(PhysicalOperatorType::TOP_N, op.types), orders(move(orders)), limit(limit), offset(offset) {
+	}
+
+	//! The maximum amount of rows (limit + offset) that are computed with a top-n. The heap is kept in memory, so
+	//! larger limits use a full sort instead, which can spill to disk.
+	static constexpr index_t MAXIMUM_HEAP_SIZE = 100 * STANDARD_VECTOR_SIZE;
+
+	vector<BoundOrderByNode> orders;
+	index_t limit;
+	index_t offset;
+
+public:
+	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+};
+
+class PhysicalTopNOperatorState : public PhysicalOperatorState {
+public:
+	PhysicalTopNOperatorState(PhysicalOperator *child) : PhysicalOperatorState(child), position(0) {
+	}
+
+	//! The position of the next row of the heap to output
+	index_t position;
+	//! The heap, which is created when the input is consumed
+	unique_ptr<TopNHeap> heap;
+};
+} // namespace duckdb
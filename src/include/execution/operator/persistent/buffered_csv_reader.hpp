@@ -36,7 +36,11 @@ public:
 
 	vector<unique_ptr<char[]>> cached_buffers;
 
+	//! The chunk the values of the current rows are parsed into; it has the types of the table for the types that can
+	//! be parsed directly, and VARCHAR for the other columns
 	DataChunk parse_chunk;
+	//! Lookup table of the characters that have a special meaning outside of quotes (delimiter, quote and newlines)
+	bool special_characters[256];
 
 public:
 	//! Extract a single DataChunk from the CSV file and stores it in insert_chunk
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/operator/persistent/parallel_csv_reader.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/types/chunk_collection.hpp"
+#include "parser/parsed_data/copy_info.hpp"
+
+namespace duckdb {
+class ClientContext;
+
+//! The ParallelCSVReader parses a CSV file using the threads of the task scheduler. The file is read in batches that
+//! are split into byte ranges on record boundaries. Every range is parsed and cast by its own BufferedCSVReader, after
+//! which the chunks of the ranges are returned in the order of the file.
+class ParallelCSVReader {
+public:
+	//! The (minimum) size of a range that is parsed by a single thread
+	static constexpr index_t RANGE_SIZE = 1048576;
+	//! The amount of ranges per thread in a batch
+	static constexpr index_t RANGES_PER_THREAD = 4;
+
+	ParallelCSVReader(ClientContext &context, CopyInfo &info, vector<SQLType> sql_types, std::istream &source);
+
+	ClientContext &context;
+	//! The settings of the COPY statement; the header (if any) is skipped before the file is split into ranges
+	CopyInfo info;
+	vector<SQLType> sql_types;
+	std::istream &source;
+
+public:
+	//! Extract a single DataChunk from the CSV file and stores it in insert_chunk
+	void ParseCSV(DataChunk &insert_chunk);
+
+private:
+	//! The part of the file that has been read but not parsed yet
+	vector<char> buffer;
+	//! The amount of lines before the start of the buffer
+	index_t linenr = 0;
+	//! The parsed chunks of every range of the current batch
+	vector<unique_ptr<ChunkCollection>> parsed_ranges;
+	//! The range and chunk within that range that is returned next
+	index_t range_index = 0;
+	index_t chunk_index = 0;
+
+	//! Reads and parses the next batch of the file. Returns false if the file is exhausted.
+	bool ParseBatch();
+	//! Splits the buffer into ranges of complete records. The ranges are [boundaries[i], boundaries[i + 1]), and
+	//! line_numbers[i] is the amount of records before range i. Returns false if the buffer does not contain a
+	//! complete record.
+	bool SplitRanges(bool eof, vector<index_t> &boundaries, vector<index_t> &line_numbers);
+};
+
+} // namespace duckdb
@@ -13,6 +13,7 @@
 
 namespace duckdb {
 class BufferedCSVReader;
+class ParallelCSVReader;
 
 //! Parse a CSV file and return the set of chunks retrieved from the file
 class PhysicalCopyFromFile : public PhysicalOperator {
@@ -40,6 +41,8 @@ public:
 	unique_ptr<std::istream> csv_stream;
 	//! The CSV reader
 	unique_ptr<BufferedCSVReader> csv_reader;
+	//! The parallel CSV reader, used instead of the CSV reader when multiple threads are available
+	unique_ptr<ParallelCSVReader> parallel_reader;
 };
 
 } // namespace duckdb
@@ -27,6 +27,8 @@ public:
 	DataTable &table;
 	//! The column ids to project
 	vector<column_t> column_ids;
+	//! Comparisons between a scanned column and a constant that are evaluated during the scan
+	vector<TableFilter> table_filters;
 
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
@@ -36,8 +38,12 @@ public:
 
 class PhysicalTableScanOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalTableScanOperatorState(DataTable &table) : PhysicalOperatorState(nullptr) {
+	PhysicalTableScanOperatorState(DataTable &table, vector<TableFilter> &table_filters)
+	    : PhysicalOperatorState(nullptr) {
 		table.InitializeScan(scan_offset);
+		if (table_filters.size() > 0) {
+			scan_offset.table_filters = &table_filters;
+		}
 	}
 
 	//! The current position in the scan
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/parallel_pipeline.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/types/chunk_collection.hpp"
+#include "execution/physical_operator.hpp"
+#include "storage/data_table.hpp"
+
+#include <functional>
+
+namespace duckdb {
+class PhysicalTableScan;
+
+//! A ParallelPipeline executes a chain of streaming operators (projections, filters and hash join probes) on top of a
+//! sequential table scan using multiple threads. The table is split into morsels (one per VersionChunk) that are handed
+//! out to the threads on demand; every thread pulls the chunks of its morsels through its own copy of the operator
+//! states. The hash tables of the joins in the pipeline are built before the threads start and are shared by them.
+class ParallelPipeline {
+public:
+	ParallelPipeline(ClientContext &context, PhysicalOperator &source);
+
+	//! Returns true if the operator chain starting at op can be executed as a parallel pipeline
+	static bool CanParallelize(ClientContext &context, PhysicalOperator &op);
+	//! Returns true if the expression has side effects, in which case it cannot be evaluated in parallel
+	static bool HasSideEffects(Expression &expr);
+	//! Returns true if any of the expressions has side effects
+	static bool HasSideEffects(vector<unique_ptr<Expression>> &expressions);
+
+	//! Execute the pipeline, calling sink(chunk, morsel_index, thread_index) for every chunk that is produced. The sink
+	//! is called concurrently from different threads, but never concurrently for the same thread_index. All chunks of a
+	//! morsel are passed to the sink by the same thread, in order; concatenating the output of the morsels in order of
+	//! their morsel_index yields the same result as serial execution.
+	void Execute(std::function<void(DataChunk &chunk, index_t morsel_index, index_t thread_index)> sink);
+	//! Execute the pipeline and append its output to the result, in the same order as serial execution
+	void Materialize(ChunkCollection &result);
+
+	//! The amount of threads that execute the pipeline
+	index_t thread_count;
+	//! The amount of morsels the input is split into
+	index_t morsel_count;
+
+private:
+	//! Execute the pipeline in the calling thread with the operator states the hash tables were built with, passing all
+	//! output to the sink as part of the first morsel. Used when a hash join in the pipeline has been spilled to disk.
+	void ExecuteSerial(PhysicalOperatorState &state,
+	                   std::function<void(DataChunk &chunk, index_t morsel_index, index_t thread_index)> sink);
+
+	ClientContext &context;
+	//! The top operator of the pipeline
+	PhysicalOperator &source;
+	//! The table scan at the bottom of the pipeline
+	PhysicalTableScan *scan;
+	//! The shared state of the parallel scan
+	ParallelTableScanState scan_state;
+};
+
+} // namespace duckdb
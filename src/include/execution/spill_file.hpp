@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/spill_file.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/common.hpp"
+#include "common/serializer/buffered_file_reader.hpp"
+#include "common/serializer/buffered_file_writer.hpp"
+#include "common/types/data_chunk.hpp"
+
+#include <mutex>
+
+namespace duckdb {
+class ClientContext;
+
+//! A SpillFile is a temporary file holding a sequence of chunks that do not fit in memory. Chunks are first appended
+//! to the file, after which they can be read back in the order in which they were written. The file is removed when
+//! the SpillFile is destroyed, and the temporary directory is removed when the database is closed if it was created
+//! for the spill files.
+class SpillFile {
+public:
+	SpillFile(FileSystem &fs, string path);
+	~SpillFile();
+
+	//! Returns true if operators are allowed to spill to disk, i.e. if a temporary directory has been configured
+	static bool CanSpill(ClientContext &context);
+	//! Creates a new (empty) SpillFile in the temporary directory of the database
+	static unique_ptr<SpillFile> Create(ClientContext &context);
+
+	//! Append a chunk to the file. Can only be called before the file is scanned. Can be called concurrently.
+	void Append(DataChunk &chunk);
+	//! Read the next chunk from the file into the result, returns false if all chunks have been read
+	bool Scan(DataChunk &result);
+
+	//! The amount of tuples in the file
+	index_t count;
+
+private:
+	FileSystem &fs;
+	//! The path of the file
+	string path;
+	//! The writer used while appending to the file
+	unique_ptr<BufferedFileWriter> writer;
+	//! The reader used while scanning the file
+	unique_ptr<BufferedFileReader> reader;
+	//! The amount of chunks in the file
+	index_t chunk_count;
+	//! The amount of chunks that have been scanned
+	index_t chunks_scanned;
+	//! Chunk used to remove the selection vector of appended chunks
+	DataChunk flat_chunk;
+	//! The lock held while appending to the file
+	std::mutex append_lock;
+};
+
+} // namespace duckdb
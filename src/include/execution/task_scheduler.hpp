@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/task_scheduler.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/common.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace duckdb {
+
+//! The TaskScheduler owns the pool of worker threads of a database instance. Operators hand it a task that is executed
+//! concurrently by a number of threads; the calling thread participates in the execution as thread 0.
+class TaskScheduler {
+public:
+	//! Create a scheduler that executes tasks using at most thread_count threads (including the calling thread)
+	TaskScheduler(index_t thread_count);
+	~TaskScheduler();
+
+	//! Execute task(thread_index) on up to task_count threads and wait until all of them have finished. If any of the
+	//! invocations throws an exception, the first exception is rethrown in the calling thread.
+	void ExecuteParallel(index_t task_count, std::function<void(index_t)> task);
+	//! Change the amount of threads used by the scheduler. Waits until the running calls to ExecuteParallel have
+	//! finished.
+	void SetThreads(index_t thread_count);
+	//! Returns the amount of threads (including the calling thread) that can execute a task
+	index_t NumberOfThreads() {
+		return thread_count;
+	}
+
+private:
+	void LaunchWorkers(index_t worker_count);
+	void StopWorkers();
+	void WorkerThread();
+
+	//! The worker threads
+	vector<std::thread> workers;
+	//! The queue of pending tasks
+	std::queue<std::function<void()>> tasks;
+	//! The lock protecting the task queue
+	std::mutex queue_lock;
+	//! Signaled whenever a task is added to the queue or the workers have to shut down
+	std::condition_variable queue_signal;
+	//! Whether or not the workers should shut down
+	bool shutdown;
+	//! The amount of calls to ExecuteParallel that have scheduled tasks and not finished yet (protected by queue_lock)
+	index_t active_calls;
+	//! Whether or not SetThreads is replacing the workers (protected by queue_lock)
+	bool resizing;
+	//! Signaled whenever a call to ExecuteParallel finishes or SetThreads is done replacing the workers
+	std::condition_variable resize_signal;
+	//! The lock serializing calls to SetThreads
+	std::mutex resize_lock;
+	//! The amount of threads (including the calling thread) that can execute a task
+	std::atomic<index_t> thread_count;
+};
+
+} // namespace duckdb
@@ -12,30 +12,55 @@
 #include "execution/physical_operator.hpp"
 
 namespace duckdb {
+class AggregateFunctionCatalogEntry;
 
+//! The WindowSegmentTree computes an aggregate over the frames of a window (see
+//! http://www.vldb.org/pvldb/vol8/p1058-leis.pdf). The internal nodes of the tree are aggregate states, which are
+//! combined with the states of the other nodes and the input rows that make up a frame.
 class WindowSegmentTree {
 public:
-	WindowSegmentTree(ExpressionType window_type, TypeId payload_type, ChunkCollection *input)
-	    : aggregate(Value()), n_aggregated(0), window_type(window_type), payload_type(payload_type), input_ref(input) {
-		ConstructTree();
-	}
-	Value Compute(index_t start, index_t end);
+	WindowSegmentTree(AggregateFunctionCatalogEntry &aggregate, TypeId result_type, ChunkCollection *input);
+
+	//! Computes the aggregate over the frames [begins[i], ends[i]) of the input, and writes the results to the result
+	//! vector
+	void Compute(Vector &result, index_t begins[], index_t ends[], index_t count);
 
 private:
 	void ConstructTree();
-	void WindowSegmentValue(index_t l_idx, index_t begin, index_t end);
-	void AggregateInit();
-	Value AggegateFinal();
-
-	Value aggregate;
-	index_t n_aggregated; // for sum
-	ExpressionType window_type;
-	TypeId payload_type;
+	//! Aggregates the input rows [begin, end) into the state of the row
+	void AddLeaves(index_t row_idx, index_t begin, index_t end);
+	//! Combines the nodes [begin, end) of the level into the state of the row
+	void AddNodes(index_t row_idx, index_t level, index_t begin, index_t end);
+	//! Updates the states with the gathered input rows
+	void FlushLeaves();
+	//! Combines the gathered node states into the target states
+	void FlushNodes();
+
+	//! The aggregate function
+	AggregateFunctionCatalogEntry &aggregate;
+	//! The result type of the aggregate
+	TypeId result_type;
+	//! The size of the aggregate state
+	index_t state_size;
+	//! The aggregate states of the internal nodes, level by level
 	unique_ptr<data_t[]> levels_flat_native;
+	//! The index of the first node of every level in levels_flat_native
 	vector<index_t> levels_flat_start;
 
+	//! The input rows, the leaves of the tree
 	ChunkCollection *input_ref;
 
+	//! The aggregate states of the rows that are being computed
+	unique_ptr<data_t[]> row_states;
+	//! The gathered input rows and the states they are aggregated into
+	DataChunk leaves;
+	data_ptr_t leaf_states[STANDARD_VECTOR_SIZE];
+	index_t leaf_count;
+	//! The gathered node states and the states they are combined into
+	data_ptr_t node_sources[STANDARD_VECTOR_SIZE];
+	data_ptr_t node_targets[STANDARD_VECTOR_SIZE];
+	index_t node_count;
+
 	static constexpr index_t TREE_FANOUT = 64; // this should cleanly divide STANDARD_VECTOR_SIZE
 };
 
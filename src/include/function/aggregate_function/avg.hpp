@@ -27,6 +27,7 @@ static void avg_initialize(data_ptr_t payload, TypeId return_type) {
 }
 
 void avg_update(Vector inputs[], index_t input_count, Vector &result);
+void avg_combine(Vector &state, Vector &combined, TypeId return_type);
 void avg_finalize(Vector &payloads, Vector &result);
 SQLType avg_get_return_type(vector<SQLType> &arguments);
 
@@ -48,6 +49,10 @@ public:
 		return avg_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return avg_combine;
+	}
+
 	static aggregate_finalize_t GetFinalizeFunction() {
 		return avg_finalize;
 	}
@@ -13,6 +13,7 @@
 namespace duckdb {
 
 void covar_update(Vector inputs[], index_t input_count, Vector &result);
+void covar_combine(Vector &state, Vector &combined, TypeId return_type);
 void covarpop_finalize(Vector &payloads, Vector &result);
 void covarsamp_finalize(Vector &payloads, Vector &result);
 SQLType covar_get_return_type(vector<SQLType> &arguments);
@@ -44,6 +45,10 @@ public:
 		return covar_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return covar_combine;
+	}
+
 	static aggregate_finalize_t GetFinalizeFunction() {
 		return covarsamp_finalize;
 	}
@@ -83,6 +88,10 @@ public:
 		return covar_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return covar_combine;
+	}
+
 	static aggregate_finalize_t GetFinalizeFunction() {
 		return covarpop_finalize;
 	}
@@ -14,6 +14,9 @@
 namespace duckdb {
 
 void gather_finalize(Vector &payloads, Vector &result);
+void add_combine(Vector &state, Vector &combined, TypeId return_type);
+void min_combine(Vector &state, Vector &combined, TypeId return_type);
+void max_combine(Vector &state, Vector &combined, TypeId return_type);
 
 class AggregateInPlaceFunction {
 public:
@@ -54,6 +57,10 @@ public:
 		return bigint_payload_initialize;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return add_combine;
+	}
+
 	static aggregate_simple_initialize_t GetSimpleInitializeFunction() {
 		return bigint_simple_initialize;
 	}
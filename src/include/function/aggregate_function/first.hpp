@@ -24,6 +24,10 @@ public:
 		return first_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return nullptr;
+	}
+
 	static aggregate_simple_update_t GetSimpleUpdateFunction() {
 		return nullptr;
 	}
@@ -25,6 +25,10 @@ public:
 		return max_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return max_combine;
+	}
+
 	static aggregate_simple_update_t GetSimpleUpdateFunction() {
 		return max_simple_update;
 	}
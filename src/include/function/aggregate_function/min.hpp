@@ -25,6 +25,10 @@ public:
 		return min_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return min_combine;
+	}
+
 	static aggregate_simple_update_t GetSimpleUpdateFunction() {
 		return min_simple_update;
 	}
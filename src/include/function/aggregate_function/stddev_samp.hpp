@@ -13,6 +13,7 @@
 namespace duckdb {
 
 void stddevsamp_update(Vector inputs[], index_t input_count, Vector &result);
+void stddevsamp_combine(Vector &state, Vector &combined, TypeId return_type);
 void stddevsamp_finalize(Vector &payloads, Vector &result);
 void stddevpop_finalize(Vector &payloads, Vector &result);
 void varsamp_finalize(Vector &payloads, Vector &result);
@@ -52,6 +53,10 @@ public:
 		return stddevsamp_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return stddevsamp_combine;
+	}
+
 	static aggregate_finalize_t GetFinalizeFunction() {
 		return stddevsamp_finalize;
 	}
@@ -91,6 +96,10 @@ public:
 		return stddevsamp_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return stddevsamp_combine;
+	}
+
 	static aggregate_finalize_t GetFinalizeFunction() {
 		return stddevpop_finalize;
 	}
@@ -129,6 +138,10 @@ public:
 		return stddevsamp_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return stddevsamp_combine;
+	}
+
 	static aggregate_finalize_t GetFinalizeFunction() {
 		return varsamp_finalize;
 	}
@@ -168,6 +181,10 @@ public:
 		return stddevsamp_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return stddevsamp_combine;
+	}
+
 	static aggregate_finalize_t GetFinalizeFunction() {
 		return varpop_finalize;
 	}
@@ -34,6 +34,10 @@ public:
 		return sum_update;
 	}
 
+	static aggregate_combine_t GetCombineFunction() {
+		return add_combine;
+	}
+
 	static aggregate_simple_initialize_t GetSimpleInitializeFunction() {
 		return null_simple_initialize;
 	}
@@ -52,6 +52,9 @@ typedef index_t (*aggregate_size_t)(TypeId return_type);
 typedef void (*aggregate_initialize_t)(data_ptr_t payload, TypeId return_type);
 //! The type used for updating hashed aggregate functions
 typedef void (*aggregate_update_t)(Vector inputs[], index_t input_count, Vector &result);
+//! The type used for combining hashed aggregate states: merges the states pointed to by state into the states
+//! pointed to by combined
+typedef void (*aggregate_combine_t)(Vector &state, Vector &combined, TypeId return_type);
 //! The type used for finalizing hashed aggregate function payloads
 typedef void (*aggregate_finalize_t)(Vector &payloads, Vector &result);
 
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// function/scalar_function/like.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/types/data_chunk.hpp"
+#include "function/function.hpp"
+
+namespace duckdb {
+
+void prefix_function(ExpressionExecutor &exec, Vector inputs[], index_t input_count, BoundFunctionExpression &expr,
+                     Vector &result);
+void suffix_function(ExpressionExecutor &exec, Vector inputs[], index_t input_count, BoundFunctionExpression &expr,
+                     Vector &result);
+void contains_function(ExpressionExecutor &exec, Vector inputs[], index_t input_count, BoundFunctionExpression &expr,
+                       Vector &result);
+bool string_match_matches_arguments(vector<SQLType> &arguments);
+SQLType string_match_get_return_type(vector<SQLType> &arguments);
+
+//! prefix(string, pattern) returns true if the string starts with the pattern (string LIKE 'pattern%')
+class PrefixFunction {
+public:
+	static const char *GetName() {
+		return "prefix";
+	}
+
+	static scalar_function_t GetFunction() {
+		return prefix_function;
+	}
+
+	static matches_argument_function_t GetMatchesArgumentFunction() {
+		return string_match_matches_arguments;
+	}
+
+	static get_return_type_function_t GetReturnTypeFunction() {
+		return string_match_get_return_type;
+	}
+
+	static bind_scalar_function_t GetBindFunction() {
+		return nullptr;
+	}
+
+	static dependency_function_t GetDependencyFunction() {
+		return nullptr;
+	}
+
+	static bool HasSideEffects() {
+		return false;
+	}
+};
+
+//! suffix(string, pattern) returns true if the string ends with the pattern (string LIKE '%pattern')
+class SuffixFunction {
+public:
+	static const char *GetName() {
+		return "suffix";
+	}
+
+	static scalar_function_t GetFunction() {
+		return suffix_function;
+	}
+
+	static matches_argument_function_t GetMatchesArgumentFunction() {
+		return string_match_matches_arguments;
+	}
+
+	static get_return_type_function_t GetReturnTypeFunction() {
+		return string_match_get_return_type;
+	}
+
+	static bind_scalar_function_t GetBindFunction() {
+		return nullptr;
+	}
+
+	static dependency_function_t GetDependencyFunction() {
+		return nullptr;
+	}
+
+	static bool HasSideEffects() {
+		return false;
+	}
+};
+
+//! contains(string, pattern) returns true if the pattern occurs in the string (string LIKE '%pattern%')
+class ContainsFunction {
+public:
+	static const char *GetName() {
+		return "contains";
+	}
+
+	static scalar_function_t GetFunction() {
+		return contains_function;
+	}
+
+	static matches_argument_function_t GetMatchesArgumentFunction() {
+		return string_match_matches_arguments;
+	}
+
+	static get_return_type_function_t GetReturnTypeFunction() {
+		return string_match_get_return_type;
+	}
+
+	static bind_scalar_function_t GetBindFunction() {
+		return nullptr;
+	}
+
+	static dependency_function_t GetDependencyFunction() {
+		return nullptr;
+	}
+
+	static bool HasSideEffects() {
+		return false;
+	}
+};
+
+} // namespace duckdb
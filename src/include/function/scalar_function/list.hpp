@@ -3,6 +3,7 @@
 #include "function/scalar_function/concat.hpp"
 #include "function/scalar_function/date_part.hpp"
 #include "function/scalar_function/length.hpp"
+#include "function/scalar_function/like.hpp"
 #include "function/scalar_function/math.hpp"
 #include "function/scalar_function/mod.hpp"
 #include "function/scalar_function/nextval.hpp"
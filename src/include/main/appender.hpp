@@ -25,6 +25,8 @@ class Appender {
 	ClientContext context;
 	//! The table entry to append to
 	TableCatalogEntry *table_entry;
+	//! The SQL types of the columns of the table
+	vector<SQLType> sql_types;
 	//! Internal chunk used for appends
 	DataChunk chunk;
 	//! The current column to append to
@@ -62,6 +64,19 @@ public:
 	//! that does conversion for you, but in exchange for lower efficiency.
 	void AppendValue(Value value);
 
+	// Bulk append functions
+	// These functions append many rows at once and can only be called in between rows. They do not perform type
+	// conversion either: the values have to be in the physical layout of the column types (e.g. int32_t for DATE
+	// columns and const char* for VARCHAR columns)
+
+	//! Append all rows of a chunk, the chunk must have the physical types of the columns of the table. Strings are
+	//! copied into the table.
+	void AppendChunk(DataChunk &chunk);
+	//! Append count rows that are given as one array of count values per column. nullmasks is either nullptr (no NULL
+	//! values), or holds per column either nullptr or an array of count entries that are true for NULL values. The
+	//! arrays are used directly and not copied, strings are copied into the table.
+	void AppendColumns(index_t count, data_ptr_t columns[], bool *nullmasks[] = nullptr);
+
 	//! Commit the changes made by the appender. The appender cannot be used after this point.
 	void Commit();
 	//! Rollback any changes made by the appender The appender cannot be used after this point.
@@ -70,6 +85,10 @@ public:
 	index_t CurrentColumn() {
 		return column;
 	}
+	//! Returns the SQL types of the columns of the table
+	vector<SQLType> &GetTypes() {
+		return sql_types;
+	}
 
 private:
 	void CheckAppend(TypeId type = TypeId::INVALID);
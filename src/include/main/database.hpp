@@ -11,36 +11,43 @@
 #include "common/common.hpp"
 #include "common/file_system.hpp"
 
+#include <atomic>
+#include <mutex>
+
 namespace duckdb {
 class StorageManager;
 class Catalog;
 class TransactionManager;
 class ConnectionManager;
 class FileSystem;
+class TaskScheduler;
 
 enum AccessMode { UNDEFINED, READ_ONLY, READ_WRITE }; // TODO AUTOMATIC
 
 // this is optional and only used in tests at the moment
 struct DBConfig {
-	friend class DuckDB;
-	friend class StorageManager;
-
-public:
 	~DBConfig();
 
 	//! Access mode of the database (READ_ONLY or READ_WRITE)
 	AccessMode access_mode = AccessMode::UNDEFINED;
 	// Checkpoint when WAL reaches this size
 	index_t checkpoint_wal_size = 1 << 20;
+	//! The maximum time (in microseconds) a committing transaction waits for concurrently committing transactions
+	//! before syncing the WAL, so their commits can be synced together (default: 0, i.e. only commits that arrive
+	//! during a sync are combined)
+	index_t commit_delay = 0;
+	//! The maximum amount of memory used by persistent blocks loaded by the buffer manager (default: unlimited)
+	index_t maximum_memory = (index_t)-1;
+	//! The maximum amount of threads used to execute a query (default: the amount of hardware threads)
+	index_t maximum_threads = (index_t)-1;
+	//! The directory in which operators can store temporary files when their data does not fit within the memory
+	//! limit (default: "<database path>.tmp" for persistent databases, none for in-memory databases)
+	string temporary_directory;
 	//! Whether or not to use Direct IO, bypassing operating system buffers
 	bool use_direct_io = false;
 	//! The FileSystem to use, can be overwritten to allow for injecting custom file systems for testing purposes (e.g.
 	//! RamFS or something similar)
 	unique_ptr<FileSystem> file_system;
-
-private:
-	// FIXME: don't set this as a user: used internally (only for now)
-	bool checkpoint_only = false;
 };
 
 //! The database object. This object holds the catalog and all the
@@ -58,14 +65,31 @@ public:
 	unique_ptr<Catalog> catalog;
 	unique_ptr<TransactionManager> transaction_manager;
 	unique_ptr<ConnectionManager> connection_manager;
+	unique_ptr<TaskScheduler> scheduler;
 
 	AccessMode access_mode;
 	bool use_direct_io;
-	bool checkpoint_only;
 	index_t checkpoint_wal_size;
+	//! Read by committing transactions while PRAGMA commit_delay can change it
+	std::atomic<index_t> commit_delay;
+	index_t maximum_memory;
+	index_t maximum_threads;
+	//! The temporary directories that were created to store spill files in, they are removed when the database is
+	//! closed
+	vector<string> created_temporary_directories;
+
+public:
+	//! Returns the directory in which spill files are stored, or an empty string if operators cannot spill to disk
+	string GetTemporaryDirectory();
+	//! Set the directory in which spill files are stored, while other connections can be spilling to the previous one
+	void SetTemporaryDirectory(string directory);
 
 private:
 	void Configure(DBConfig &config);
+
+	//! Read by queries that spill to disk while PRAGMA temp_directory can change it
+	string temporary_directory;
+	std::mutex temporary_directory_lock;
 };
 
 } // namespace duckdb
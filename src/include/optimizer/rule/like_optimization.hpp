@@ -0,0 +1,25 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// optimizer/rule/like_optimization.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "optimizer/rule.hpp"
+
+namespace duckdb {
+
+// The Like Optimization rule rewrites LIKE comparisons with a constant pattern that only has % wildcards at its start
+// and end into a cheaper test (i.e. [x LIKE 'abc'] => [x = 'abc'], [x LIKE 'abc%'] => [prefix(x, 'abc')],
+// [x LIKE '%abc'] => [suffix(x, 'abc')] and [x LIKE '%abc%'] => [contains(x, 'abc')])
+class LikeOptimizationRule : public Rule {
+public:
+	LikeOptimizationRule(ExpressionRewriter &rewriter);
+
+	unique_ptr<Expression> Apply(LogicalOperator &op, vector<Expression *> &bindings, bool &changes_made) override;
+};
+
+} // namespace duckdb
@@ -4,4 +4,5 @@
 #include "optimizer/rule/conjunction_simplification.hpp"
 #include "optimizer/rule/constant_folding.hpp"
 #include "optimizer/rule/distributivity.hpp"
+#include "optimizer/rule/like_optimization.hpp"
 #include "optimizer/rule/move_constants.hpp"
@@ -27,10 +27,14 @@ enum class WindowBoundary : uint8_t {
 //! they inherit from them.
 class WindowExpression : public ParsedExpression {
 public:
-	WindowExpression(ExpressionType type, unique_ptr<ParsedExpression> child);
+	WindowExpression(ExpressionType type, string schema_name, string function_name);
 
-	//! The child expression of the main window aggregate
-	unique_ptr<ParsedExpression> child;
+	//! Schema of the aggregate function (only for WINDOW_AGGREGATE)
+	string schema;
+	//! Name of the aggregate function (only for WINDOW_AGGREGATE)
+	string function_name;
+	//! The child expressions of the main window function
+	vector<unique_ptr<ParsedExpression>> children;
 	//! The set of expressions to partition by
 	vector<unique_ptr<ParsedExpression>> partitions;
 	//! The set of ordering clauses
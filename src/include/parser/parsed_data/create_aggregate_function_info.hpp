@@ -22,6 +22,8 @@ struct CreateAggregateFunctionInfo : public CreateFunctionInfo {
 	aggregate_initialize_t initialize;
 	//! The hashed aggregate update function
 	aggregate_update_t update;
+	//! The hashed aggregate combine function (may be null)
+	aggregate_combine_t combine;
 	//! The hashed aggregate finalization function
 	aggregate_finalize_t finalize;
 
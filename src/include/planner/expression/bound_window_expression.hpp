@@ -13,13 +13,16 @@
 #include "planner/expression.hpp"
 
 namespace duckdb {
+class AggregateFunctionCatalogEntry;
 
 class BoundWindowExpression : public Expression {
 public:
-	BoundWindowExpression(ExpressionType type, TypeId return_type);
+	BoundWindowExpression(ExpressionType type, TypeId return_type, AggregateFunctionCatalogEntry *aggregate);
 
-	//! The child expression of the main window aggregate
-	unique_ptr<Expression> child;
+	//! The bound aggregate function (only for WINDOW_AGGREGATE)
+	AggregateFunctionCatalogEntry *aggregate;
+	//! The child expressions of the main window function
+	vector<unique_ptr<Expression>> children;
 	//! The set of expressions to partition by
 	vector<unique_ptr<Expression>> partitions;
 	//! The set of ordering clauses
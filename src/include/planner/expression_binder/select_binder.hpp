@@ -41,6 +41,8 @@ protected:
 
 protected:
 	BindResult BindWindow(WindowExpression &expr, index_t depth);
+	//! Returns the result type of the aggregate for the given argument types, or throws if the types are not supported
+	static SQLType ResolveAggregateReturnType(vector<SQLType> &arguments, AggregateFunctionCatalogEntry *func);
 
 	index_t TryBindGroup(ParsedExpression &expr, index_t depth);
 	BindResult BindGroup(ParsedExpression &expr, index_t depth, index_t group_index);
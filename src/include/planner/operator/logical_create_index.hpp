@@ -19,7 +19,9 @@ public:
 	                   vector<unique_ptr<Expression>> expressions, unique_ptr<CreateIndexInfo> info)
 	    : LogicalOperator(LogicalOperatorType::CREATE_INDEX), table(table), column_ids(column_ids),
 	      info(std::move(info)) {
-		this->unbound_expressions.push_back(expressions[0]->Copy());
+		for (auto &expr : expressions) {
+			this->unbound_expressions.push_back(expr->Copy());
+		}
 		this->expressions = move(expressions);
 	}
 
@@ -34,9 +36,8 @@ public:
 
 protected:
 	void ResolveTypes() override {
-		for (auto &expr : expressions) {
-			types.push_back(expr->return_type);
-		}
+		// the statement returns a single count
+		types.push_back(TypeId::BIGINT);
 	}
 };
 } // namespace duckdb
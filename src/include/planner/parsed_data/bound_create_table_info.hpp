@@ -11,7 +11,7 @@
 #include "parser/parsed_data/create_table_info.hpp"
 #include "planner/bound_constraint.hpp"
 #include "planner/expression.hpp"
-#include "storage/table/persistent_segment.hpp"
+#include "storage/table/persistent_table_data.hpp"
 
 namespace duckdb {
 class CatalogEntry;
@@ -30,7 +30,7 @@ struct BoundCreateTableInfo {
 	//! Dependents of the table (in e.g. default values)
 	unordered_set<CatalogEntry *> dependencies;
 	//! The existing table data on disk (if any)
-	unique_ptr<vector<unique_ptr<PersistentSegment>>[]> data;
+	unique_ptr<PersistentTableData> data;
 	//! The base create table info
 	unique_ptr<CreateTableInfo> base;
 };
@@ -29,6 +29,15 @@ public:
 	virtual void Read(Block &block) = 0;
 	//! Writes the block to disk
 	virtual void Write(Block &block) = 0;
+	//! Mark a block as used by the checkpoint that is currently being written, e.g. because the checkpoint reuses it
+	//! from the previous checkpoint. Blocks returned by GetFreeBlockId are always used by the checkpoint.
+	virtual void MarkBlockAsUsed(block_id_t block_id) = 0;
+	//! Mark a block as referenced by the persistent segments of a table in memory: the block is not reused while the
+	//! database is running, even if a later checkpoint does not use it anymore
+	virtual void MarkBlockAsLoaded(block_id_t block_id) = 0;
+	//! Release a block that was marked as loaded and that is not used by the last written checkpoint: the persistent
+	//! segments in memory do not refer to it anymore, so it can be reused
+	virtual void ReleaseLoadedBlock(block_id_t block_id) = 0;
 	//! Write the header; should be the final step of a checkpoint
 	virtual void WriteHeader(DatabaseHeader header) = 0;
 };
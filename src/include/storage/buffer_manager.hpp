@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// storage/buffer_manager.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/common.hpp"
+#include "common/unordered_map.hpp"
+#include "storage/block.hpp"
+#include "storage/block_manager.hpp"
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+
+namespace duckdb {
+class BufferManager;
+
+//! A BufferHandle keeps a block pinned in memory; the block can be evicted again after the handle is destroyed
+class BufferHandle {
+public:
+	BufferHandle(BufferManager &manager, block_id_t block_id, Block *node);
+	~BufferHandle();
+
+	//! The buffer manager the block was pinned in
+	BufferManager &manager;
+	//! The id of the pinned block
+	block_id_t block_id;
+	//! The pinned block
+	Block *node;
+};
+
+//! The BufferManager sits in between the BlockManager and the persistent segments. Blocks are read from disk on
+//! demand when they are pinned, and unpinned blocks are evicted in least-recently-used order whenever the memory limit
+//! would otherwise be exceeded.
+class BufferManager {
+	friend class BufferHandle;
+
+public:
+	BufferManager(BlockManager &manager, index_t maximum_memory);
+
+	//! Pin the block with the given id, reading it from disk if it is not loaded yet
+	unique_ptr<BufferHandle> Pin(block_id_t block_id);
+	//! Set a new memory limit, evicting unpinned blocks if the current memory usage exceeds the new limit
+	void SetLimit(index_t limit);
+
+	index_t GetUsedMemory() {
+		return current_memory;
+	}
+	index_t GetMaxMemory() {
+		return maximum_memory;
+	}
+
+	//! The block manager the blocks are read from
+	BlockManager &manager;
+
+private:
+	struct BufferEntry {
+		//! The loaded block
+		unique_ptr<Block> block;
+		//! The amount of handles that currently pin the block
+		index_t readers;
+		//! Whether the block is still being read from disk (without holding the lock)
+		bool loading;
+		//! The position of the block in the LRU list, only valid if readers == 0
+		std::list<block_id_t>::iterator lru_position;
+	};
+
+	//! Unpin a block, making it a candidate for eviction if no other handles pin it
+	void Unpin(block_id_t block_id);
+	//! Evict unpinned blocks until extra_memory bytes can be loaded without exceeding the memory limit. Returns false
+	//! if not enough blocks could be evicted.
+	bool EvictBlocks(index_t extra_memory, index_t memory_limit);
+
+	//! The current amount of memory taken up by loaded blocks
+	index_t current_memory;
+	//! The maximum amount of memory that loaded blocks may take up
+	index_t maximum_memory;
+	//! The lock protecting the set of loaded blocks
+	std::mutex lock;
+	//! Signaled when a block has been read from disk
+	std::condition_variable block_loaded;
+	//! The set of loaded blocks
+	unordered_map<block_id_t, BufferEntry> blocks;
+	//! The unpinned blocks, ordered from least to most recently used
+	std::list<block_id_t> lru;
+};
+
+} // namespace duckdb
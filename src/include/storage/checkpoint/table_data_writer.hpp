@@ -10,6 +10,8 @@
 
 #include "storage/checkpoint_manager.hpp"
 #include "common/unordered_map.hpp"
+#include "storage/table/segment_compression.hpp"
+#include "storage/table/column_segment.hpp"
 
 namespace duckdb {
 
@@ -31,15 +33,24 @@ public:
 public:
 	TableDataWriter(CheckpointManager &manager, TableCatalogEntry &table);
 
-	void WriteTableData(Transaction &transaction);
+	//! Writes the data of the table that is visible to the transaction. The segments of the previous checkpoint of the
+	//! table that precede the first modified row are reused, only the remaining rows are written to new blocks. If
+	//! compact is true, the entire table is written without its deleted rows, which changes the row ids of the rows.
+	unique_ptr<PersistentTableData> WriteTableData(Transaction &transaction, bool compact = false);
 
-	void WriteColumnData(DataChunk &chunk, index_t column_index);
+	void WriteColumnData(DataChunk &chunk, index_t column_index, index_t offset = 0);
 	void WriteString(index_t index, const char *val);
 	void FlushBlock(index_t col);
 
-	void WriteDataPointers();
-
 private:
+	//! Writes the rows of the chunk, which starts at the given row, to the columns that are being rewritten
+	void WriteRows(DataChunk &chunk, row_t start);
+	//! Adds a range of rows that are not visible to the checkpoint to the deleted rows
+	void AddDeletedRows(row_t start, index_t count);
+	//! Adds a range of rows to the deleted rows, and writes NULL values for them
+	void WriteDeletedRows(row_t start, index_t count);
+	//! Writes the rows of a chunk that was scanned together with the row ids
+	void WriteScannedRows(DataChunk &scan_chunk);
 	//! Flush the block of the column if it cannot fit write_size more bytes
 	void FlushIfFull(index_t col, index_t write_size);
 	//! Writes the dictionary to the block buffer
@@ -54,8 +65,24 @@ private:
 	vector<index_t> row_numbers;
 	vector<index_t> indexes;
 	vector<StringDictionary> dictionaries;
+	//! The compressors of the constant size columns (nullptr for VARCHAR columns)
+	vector<unique_ptr<SegmentCompressor>> compressors;
+	//! The statistics of the segment that is currently being written for every column
+	vector<unique_ptr<SegmentStatistics>> segment_stats;
+	//! The blocks holding the big strings of the segment that is currently being written for every column
+	vector<vector<block_id_t>> overflow_blocks;
+	//! Whether or not the deleted rows are left out
+	bool compact;
+	//! The first row that is written for every column, the rows before it are stored in reused segments
+	vector<index_t> write_start;
+	//! The smallest write start of the columns
+	index_t min_write_start;
+	//! The next row of the table that is expected in the scan (or the next row that is written if compact is true)
+	row_t next_row;
+	//! Chunks holding the rows of a scanned vector at their positions, and the NULL values of deleted rows
+	DataChunk positioned_chunk, null_chunk;
 
-	vector<vector<DataPointer>> data_pointers;
+	unique_ptr<PersistentTableData> data;
 };
 
 } // namespace duckdb
@@ -14,52 +14,63 @@
 #include "storage/meta_block_writer.hpp"
 
 namespace duckdb {
+class BufferManager;
 class ClientContext;
 class MetaBlockReader;
 class SchemaCatalogEntry;
 class SequenceCatalogEntry;
 class TableCatalogEntry;
 class ViewCatalogEntry;
-
-struct DataPointer {
-	double min;
-	double max;
-	uint64_t row_start;
-	uint64_t tuple_count;
-	block_id_t block_id;
-	uint32_t offset;
-};
+class DataTable;
+struct PersistentTableData;
 
 //! CheckpointManager is responsible for checkpointing the database
 class CheckpointManager {
 public:
 	CheckpointManager(StorageManager &manager);
 
-	//! Checkpoint the current state of the WAL and flush it to the main storage. This should be called BEFORE any
-	//! connction is available because right now the checkpointing cannot be done online. (TODO)
-	void CreateCheckpoint();
+	//! Write a checkpoint of the committed state of the database to the main storage. Tables that have not been
+	//! modified since the last checkpoint reuse the blocks they were stored in. Commits have to be blocked while the
+	//! checkpoint is created (see StorageManager::CreateCheckpoint). If compact is true, the tables that contain many
+	//! deleted rows are rewritten without them and reloaded, which changes the row ids of their rows: this is only
+	//! allowed while no transaction or WAL entry can refer to the rows, i.e. when the database is opened.
+	void CreateCheckpoint(bool compact = false);
 	//! Load from a stored checkpoint
 	void LoadFromStorage();
 
 	//! The block manager to write the checkpoint to
 	BlockManager &block_manager;
+	//! The buffer manager used to load persistent blocks
+	BufferManager &buffer_manager;
 	//! The database this storagemanager belongs to
 	DuckDB &database;
 	//! The metadata writer is responsible for writing schema information
 	unique_ptr<MetaBlockWriter> metadata_writer;
 	//! The table data writer is responsible for writing the DataPointers used by the table chunks
 	unique_ptr<MetaBlockWriter> tabledata_writer;
+	//! Whether a loaded table contains so many deleted rows that it should be compacted
+	bool compact_tables = false;
 
 private:
 	void WriteSchema(Transaction &transaction, SchemaCatalogEntry &schema);
 	void WriteTable(Transaction &transaction, TableCatalogEntry &table);
 	void WriteView(Transaction &transaction, ViewCatalogEntry &table);
 	void WriteSequence(Transaction &transaction, SequenceCatalogEntry &table);
+	//! Write the indexes of the UNIQUE and PRIMARY KEY constraints of the table, if they only contain the committed
+	//! versions of the rows
+	void WriteIndexes(Transaction &transaction, TableCatalogEntry &table, PersistentTableData &data);
+	//! Write the data pointers, deleted rows and index positions of a table to the table data writer
+	void WriteTableData(PersistentTableData &data);
 
 	void ReadSchema(ClientContext &context, MetaBlockReader &reader);
 	void ReadTable(ClientContext &context, MetaBlockReader &reader);
 	void ReadView(ClientContext &context, MetaBlockReader &reader);
 	void ReadSequence(ClientContext &context, MetaBlockReader &reader);
+
+	//! Whether the checkpoint compacts tables
+	bool compact = false;
+	//! The tables that were compacted by the checkpoint, together with the data they were loaded from
+	vector<std::pair<DataTable *, unique_ptr<PersistentTableData>>> compacted_tables;
 };
 
 } // namespace duckdb
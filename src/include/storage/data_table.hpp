@@ -16,6 +16,8 @@
 #include "storage/block.hpp"
 #include "storage/table/column_segment.hpp"
 #include "storage/table/persistent_segment.hpp"
+#include "storage/table/persistent_table_data.hpp"
+#include "storage/table_filter.hpp"
 
 #include <atomic>
 #include <mutex>
@@ -40,6 +42,26 @@ struct TableScanState {
 	VersionInfo *version_chain;
 	VersionChunk *last_chunk;
 	index_t last_chunk_count;
+	//! The filters of the scan (if any). Parts of the table that cannot satisfy the filters according to the zone maps
+	//! of the column segments are skipped, and only rows that satisfy all filters are returned. Every filtered column
+	//! has to be part of the scanned columns.
+	vector<TableFilter> *table_filters = nullptr;
+};
+
+//! The shared state of a parallel scan. The table is handed out to the scanning threads in morsels of one VersionChunk.
+struct ParallelTableScanState {
+	//! The next chunk to hand out (nullptr if all chunks have been handed out)
+	VersionChunk *next_chunk;
+	//! The last chunk of the scan
+	VersionChunk *last_chunk;
+	//! The amount of tuples in the last chunk when the scan was initialized
+	index_t last_chunk_count;
+	//! The index of the next morsel
+	index_t next_morsel;
+	//! The total amount of morsels
+	index_t morsel_count;
+	//! The lock protecting the state
+	std::mutex lock;
 };
 
 struct IndexTableScanState : public TableScanState {
@@ -52,7 +74,7 @@ struct IndexTableScanState : public TableScanState {
 class DataTable {
 public:
 	DataTable(StorageManager &storage, string schema, string table, vector<TypeId> types,
-	          unique_ptr<vector<unique_ptr<PersistentSegment>>[]> data);
+	          unique_ptr<PersistentTableData> data);
 
 	//! The amount of elements in the table. Note that this number signifies the amount of COMMITTED entries in the
 	//! table. It can be inaccurate inside of transactions. More work is needed to properly support that.
@@ -72,6 +94,22 @@ public:
 	//! Indexes
 	vector<unique_ptr<Index>> indexes;
 
+	//! The data of the table in the last checkpoint (nullptr if the table has not been checkpointed yet). Only
+	//! accessed while commits are blocked by the checkpoint.
+	unique_ptr<PersistentTableData> persistent_data;
+	//! The amount of rows stored in the persistent segments that were loaded from disk. These rows never change: an
+	//! update of a persistent row appends a new version of the row to the table.
+	index_t persistent_rows;
+	//! The amount of rows stored in the last checkpoint of the table. These rows are loaded as persistent rows when the
+	//! database is opened, so they are updated like persistent rows in the running database as well: otherwise the row
+	//! ids of the WAL would not match the rows that replaying it produces.
+	std::atomic<index_t> checkpointed_rows;
+	//! Whether or not changes to the table have been committed since the last checkpoint
+	std::atomic<bool> dirty;
+	//! The lowest row that was inserted or updated by a transaction that committed since the last checkpoint. The
+	//! stored data of the rows before it is still valid.
+	std::atomic<row_t> first_modified_row;
+
 public:
 	void InitializeScan(TableScanState &state);
 	//! Scans up to STANDARD_VECTOR_SIZE elements from the table starting
@@ -79,11 +117,17 @@ public:
 	// elements were returned.
 	void Scan(Transaction &transaction, DataChunk &result, const vector<column_t> &column_ids,
 	          TableScanState &structure);
+	//! Initialize a parallel scan over the table
+	void InitializeParallelScan(ParallelTableScanState &state);
+	//! Assign the next morsel of a parallel scan to the (thread-local) scan state, so that subsequent calls to Scan only
+	//! return the tuples of that morsel. Returns false if all morsels have been handed out.
+	bool NextParallelScanMorsel(ParallelTableScanState &state, TableScanState &scan_state, index_t &morsel_index);
 	//! Fetch data from the specific row identifiers from the base table
 	void Fetch(Transaction &transaction, DataChunk &result, vector<column_t> &column_ids, Vector &row_ids);
 	//! Append a DataChunk to the table. Throws an exception if the columns
-	// don't match the tables' columns.
-	void Append(TableCatalogEntry &table, ClientContext &context, DataChunk &chunk);
+	// don't match the tables' columns. If replaced_rows is set, the appended rows replace the given rows, which are
+	// deleted afterwards, and may take their keys in the unique indexes.
+	void Append(TableCatalogEntry &table, ClientContext &context, DataChunk &chunk, Vector *replaced_rows = nullptr);
 	//! Delete the entries with the specified row identifier from the table
 	void Delete(TableCatalogEntry &table, ClientContext &context, Vector &row_ids);
 	//! Update the entries with the specified row identifier from the table
@@ -109,8 +153,14 @@ public:
 	//! Add an index to the DataTable
 	void AddIndex(unique_ptr<Index> index, vector<unique_ptr<Expression>> &expressions);
 
+	//! Replace the contents of the table with the data of a checkpoint, in which the rows can have different row ids.
+	//! Only allowed while no transaction, index or WAL entry can refer to the rows of the table.
+	void ReplaceTableData(unique_ptr<PersistentTableData> data);
+
 private:
-	index_t InitializeTable(unique_ptr<vector<unique_ptr<PersistentSegment>>[]> data);
+	//! Set up the storage of the table from the data of a checkpoint (if any)
+	void LoadTable(unique_ptr<PersistentTableData> data);
+	index_t InitializeTable(unique_ptr<PersistentTableData> data);
 	//! Append a storage chunk with the given start index to the data table. Returns a pointer to the newly created
 	//! storage chunk.
 	VersionChunk *AppendVersionChunk(index_t start);
@@ -122,10 +172,10 @@ private:
 	//! Verify constraints with a chunk from the Update containing only the specified column_ids
 	void VerifyUpdateConstraints(TableCatalogEntry &table, DataChunk &chunk, vector<column_t> &column_ids);
 
-	//! Append a DataChunk to the set of indexes
-	void AppendToIndexes(DataChunk &chunk, row_t row_start);
-	//! Issue the specified update to the set of indexes
-	void UpdateIndexes(TableCatalogEntry &table, vector<column_t> &column_ids, DataChunk &updates,
+	//! Append a DataChunk to the set of indexes, optionally replacing the entries of the rows in replaced_rows
+	void AppendToIndexes(DataChunk &chunk, row_t row_start, Vector *replaced_rows);
+	//! Issue the specified update of the rows of the (transient) chunk to the set of indexes
+	void UpdateIndexes(TableCatalogEntry &table, VersionChunk &chunk, vector<column_t> &column_ids, DataChunk &updates,
 	                   Vector &row_identifiers);
 
 private:
@@ -13,11 +13,14 @@
 #include "common/types/data_chunk.hpp"
 #include "parser/parsed_expression.hpp"
 #include "planner/expression.hpp"
+#include "storage/storage_info.hpp"
 
 namespace duckdb {
 
 class ClientContext;
 class DataTable;
+class MetaBlockWriter;
+class TaskScheduler;
 class Transaction;
 
 struct IndexScanState {
@@ -61,18 +64,51 @@ public:
 	                                                               vector<column_t> column_ids, Value low_value,
 	                                                               ExpressionType low_expression_type, Value high_value,
 	                                                               ExpressionType high_expression_type) = 0;
+	//! Initialize a scan on the index with the given column ids to fetch from the base table, for an equality
+	//! predicate on every expression of the index
+	virtual unique_ptr<IndexScanState> InitializeScanEqualityPredicates(Transaction &transaction,
+	                                                                    vector<column_t> column_ids,
+	                                                                    vector<Value> values) = 0;
 	//! Perform a lookup on the index
 	virtual void Scan(Transaction &transaction, IndexScanState *ss, DataChunk &result) = 0;
+	//! Look up the keys formed by the rows of the input chunk, which has a column for every expression of the index.
+	//! For every match the position of the row in the input is appended to result_rows, and the matching row id to
+	//! result_ids. Rows with a NULL value have no matches.
+	virtual void LookupKeys(DataChunk &input, vector<index_t> &result_rows, vector<row_t> &result_ids) = 0;
 
 	//! Called when data is appended to the index
 	virtual bool Append(DataChunk &entries, Vector &row_identifiers) = 0;
 
 	//! Called when data inside the index is Deleted
 	virtual void Delete(DataChunk &entries, Vector &row_identifiers) = 0;
+	//! Delete the entries of rows of which another version remains, e.g. the old versions of updated rows. The entry
+	//! of a row is only deleted if its key differs from the key of the remaining version, which shares the entry.
+	virtual void Delete(DataChunk &entries, DataChunk &remaining_entries, Vector &row_identifiers) = 0;
+
+	//! Called when rows are updated in place. Only the keys of the rows of which the update changes the key are
+	//! added, the old keys are deleted when the old versions are cleaned up. Returns false if the update violates the
+	//! UNIQUE constraint of the index, in which case no entries are added.
+	virtual bool Update(DataChunk &old_entries, DataChunk &new_entries, Vector &row_identifiers) = 0;
+	//! Called when rows are appended that replace other rows of the table, which are deleted by the same update. The
+	//! keys of the replaced rows do not violate the UNIQUE constraint, unless another appended row takes them.
+	virtual bool Replace(DataChunk &entries, Vector &row_identifiers, Vector &replaced_row_identifiers) = 0;
 
 	//! Insert data into the index. Does not lock the index.
 	virtual bool Insert(DataChunk &input, Vector &row_identifiers) = 0;
 
+	//! Called with the entries of the existing rows of the table when the index is created, before the index is used.
+	//! The entries only have to be in the index after FinalizeBuild. By default they are inserted directly.
+	virtual void BuildAppend(DataChunk &input, Vector &row_identifiers) {
+		Insert(input, row_identifiers);
+	}
+	//! Called after all the existing rows of the table have been passed to BuildAppend
+	virtual void FinalizeBuild(TaskScheduler &scheduler) {
+	}
+
+	//! Write the index to the writer, returns the position of the stored index. Only the entries of the committed
+	//! versions of the rows may be in the index (see TransactionManager::LockIfOnlyTransaction).
+	virtual BlockPointer Serialize(MetaBlockWriter &writer) = 0;
+
 	//! Returns true if the index is affected by updates on the specified column ids, and false otherwise
 	bool IndexIsUpdated(vector<column_t> &column_ids);
 
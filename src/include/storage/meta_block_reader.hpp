@@ -14,10 +14,17 @@
 #include "storage/block_manager.hpp"
 
 namespace duckdb {
+class BufferHandle;
+class BufferManager;
+
 //! This struct is responsible for reading meta data from disk
 class MetaBlockReader : public Deserializer {
 public:
 	MetaBlockReader(BlockManager &manager, block_id_t block);
+	//! Read from the given position, pinning the blocks in the buffer manager instead of reading them from disk. Used
+	//! for data that is read in many small parts, e.g. the nodes of a stored index.
+	MetaBlockReader(BufferManager &buffer_manager, BlockPointer pointer);
+	~MetaBlockReader();
 
 	BlockManager &manager;
 	unique_ptr<Block> block;
@@ -30,5 +37,12 @@ public:
 
 private:
 	void ReadNewBlock(block_id_t id);
+
+	//! The buffer manager the blocks are pinned in (if any)
+	BufferManager *buffer_manager;
+	//! The handle of the currently pinned block
+	unique_ptr<BufferHandle> handle;
+	//! The block that is currently read from: either block or the pinned block
+	Block *current_block;
 };
 } // namespace duckdb
@@ -24,8 +24,14 @@ public:
 	BlockManager &manager;
 	unique_ptr<Block> block;
 	index_t offset;
+	//! The ids of all the blocks the writer has written to
+	vector<block_id_t> written_blocks;
 
 public:
+	//! Returns the position at which the next data is written
+	BlockPointer GetBlockPointer() {
+		return BlockPointer{block->id, (uint32_t)offset};
+	}
 	void Flush();
 
 	void WriteData(const_data_ptr_t buffer, index_t write_size) override;
@@ -12,6 +12,7 @@
 #include "storage/block_manager.hpp"
 #include "storage/block.hpp"
 #include "common/file_system.hpp"
+#include "common/unordered_set.hpp"
 
 namespace duckdb {
 class FileBuffer;
@@ -34,7 +35,14 @@ public:
 	void Read(Block &block) override;
 	//! Write the given block to disk
 	void Write(Block &block) override;
-	//! Write the header to disk, this is the final step of the checkpointing process
+	//! Mark the block as used by the checkpoint that is currently being written
+	void MarkBlockAsUsed(block_id_t block_id) override;
+	//! Mark the block as referenced by the persistent segments of a table in memory
+	void MarkBlockAsLoaded(block_id_t block_id) override;
+	//! Release a loaded block that is not used by the last written checkpoint, so it can be reused
+	void ReleaseLoadedBlock(block_id_t block_id) override;
+	//! Write the header to disk, this is the final step of the checkpointing process. All blocks that are not used by
+	//! the new checkpoint are added to the free list.
 	void WriteHeader(DatabaseHeader header) override;
 
 private:
@@ -51,8 +59,12 @@ private:
 	FileBuffer header_buffer;
 	//! The list of free blocks that can be written to currently
 	vector<block_id_t> free_list;
-	//! The list of blocks that are used by the current block manager
-	vector<block_id_t> used_blocks;
+	//! The set of blocks that are used by the checkpoint that is currently being written
+	unordered_set<block_id_t> checkpoint_blocks;
+	//! The set of blocks that the persistent segments of the tables in memory can refer to, i.e. the blocks that the
+	//! tables were loaded from. These blocks are not reused while the segments exist, even if a later checkpoint does
+	//! not use them anymore.
+	unordered_set<block_id_t> loaded_blocks;
 	//! The current meta block id
 	block_id_t meta_block;
 	//! The current maximum block id, this id will be given away first after the free_list runs out
@@ -25,6 +25,12 @@ using block_id_t = int64_t;
 
 #define INVALID_BLOCK -1
 
+//! A position in a meta block (see MetaBlockWriter)
+struct BlockPointer {
+	block_id_t block_id;
+	uint32_t offset;
+};
+
 //! The MainHeader is the first header in the storage file. The MainHeader is typically written only once for a database
 //! file.
 struct MainHeader {
@@ -10,6 +10,7 @@
 
 #include "common/constants.hpp"
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 
 namespace duckdb {
@@ -39,8 +40,17 @@ public:
 	unique_ptr<StorageLockKey> GetSharedLock();
 
 private:
+	//! Set in the lock state while a writer holds or waits for the exclusive lock
+	static constexpr index_t EXCLUSIVE_FLAG = (index_t)1 << (sizeof(index_t) * 8 - 1);
+
+	//! Held for the duration of an exclusive lock, serializes the writers
 	std::mutex exclusive_lock;
-	std::atomic<index_t> read_count;
+	//! The number of shared lock holders, plus EXCLUSIVE_FLAG if there is a writer. Readers only touch this counter,
+	//! unless there is a writer.
+	std::atomic<index_t> lock_state;
+	//! Protects the waits for a change of the lock state
+	std::mutex wait_lock;
+	std::condition_variable state_changed;
 
 private:
 	//! Release an exclusive lock
@@ -10,10 +10,12 @@
 
 #include "common/helper.hpp"
 #include "storage/data_table.hpp"
+#include "storage/storage_lock.hpp"
 #include "storage/write_ahead_log.hpp"
 
 namespace duckdb {
 class BlockManager;
+class BufferManager;
 class Catalog;
 class DuckDB;
 class TransactionManager;
@@ -28,6 +30,11 @@ public:
 
 	//! Initialize a database or load an existing database from the given path
 	void Initialize();
+	//! Checkpoint the database: write the changes committed since the last checkpoint to the database file and
+	//! truncate the WAL. If force is false, the checkpoint is only created when the WAL exceeds the
+	//! checkpoint_wal_size. Does nothing for in-memory and read-only databases. See CheckpointManager::CreateCheckpoint
+	//! for compact.
+	void CreateCheckpoint(bool force = true, bool compact = false);
 	//! Get the WAL of the StorageManager, returns nullptr if in-memory
 	WriteAheadLog *GetWriteAheadLog() {
 		return wal.initialized ? &wal : nullptr;
@@ -38,14 +45,17 @@ public:
 	}
 	//! The BlockManager to read/store meta information and data in blocks
 	unique_ptr<BlockManager> block_manager;
+	//! The BufferManager that loads persistent blocks on demand and evicts them under memory pressure
+	unique_ptr<BufferManager> buffer_manager;
 	//! The database this storagemanager belongs to
 	DuckDB &database;
+	//! Committing transactions hold a shared lock and checkpoints an exclusive lock, so that a checkpoint contains
+	//! exactly the transactions that committed to the WAL before it
+	StorageLock checkpoint_lock;
 
 private:
 	//! Load the database from a directory
 	void LoadDatabase();
-	//! Create a checkpoint of the database
-	void Checkpoint(string wal_path);
 
 	//! The path of the database
 	string path;
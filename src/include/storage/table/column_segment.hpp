@@ -9,6 +9,7 @@
 #pragma once
 
 #include "storage/block.hpp"
+#include "storage/buffer_manager.hpp"
 #include "storage/table/segment_tree.hpp"
 #include "common/types.hpp"
 
@@ -16,6 +17,7 @@ namespace duckdb {
 class BlockManager;
 class ColumnSegment;
 class Vector;
+struct TableFilter;
 
 enum class ColumnSegmentType : uint8_t { TRANSIENT, PERSISTENT };
 
@@ -25,14 +27,16 @@ struct ColumnPointer {
 	ColumnSegment *segment;
 	//! The offset inside the column segment
 	index_t offset;
+	//! The blocks pinned by the last scan of the column, the scanned strings of persistent segments point into them
+	vector<unique_ptr<BufferHandle>> handles;
 };
 
 struct SegmentStatistics {
 	SegmentStatistics(TypeId type, index_t type_size);
 
-	//! The minimum value of the segment
+	//! The minimum (non-NULL) value of the segment, only kept for numeric types
 	unique_ptr<data_t[]> minimum;
-	//! The maximum value of the segment
+	//! The maximum (non-NULL) value of the segment, only kept for numeric types
 	unique_ptr<data_t[]> maximum;
 	//! Whether or not the segment has NULL values
 	bool has_null;
@@ -58,6 +62,10 @@ public:
 	virtual void Scan(ColumnPointer &pointer, Vector &result, index_t count, sel_t *sel_vector, index_t sel_count) = 0;
 	//! Fetch an individual value and append it to a vector, row_id must be >= start
 	virtual void Fetch(Vector &result, index_t row_id) = 0;
+
+	//! Checks the filter against the minimum and maximum of the segment (its zone map). Returns false if no value in
+	//! the segment can satisfy the filter.
+	bool CheckZonemap(TableFilter &filter);
 };
 
 } // namespace duckdb
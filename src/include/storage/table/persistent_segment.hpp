@@ -10,45 +10,54 @@
 
 #include "storage/table/column_segment.hpp"
 #include "storage/block.hpp"
-#include "storage/block_manager.hpp"
+#include "storage/buffer_manager.hpp"
 
+#include "common/types/string_heap.hpp"
 #include "common/unordered_map.hpp"
 
+#include <atomic>
+
 namespace duckdb {
 
 class PersistentSegment : public ColumnSegment {
 public:
-	PersistentSegment(BlockManager &manager, block_id_t id, index_t offset, TypeId type, index_t start, index_t count);
+	PersistentSegment(BufferManager &manager, block_id_t id, index_t offset, TypeId type, index_t start, index_t count);
 
-	//! The block manager
-	BlockManager &manager;
+	//! The buffer manager
+	BufferManager &manager;
 	//! The block id that this segment relates to
 	block_id_t block_id;
 	//! The offset into the block
 	index_t offset;
-	//! The block that holds the data for this segment (if loaded)
-	unique_ptr<Block> block;
-	//! The lock to load the block into memory (if not loaded yet)
+	//! The lock to load the string dictionary into memory (if not loaded yet)
 	std::mutex load_lock;
 
 public:
-	void LoadBlock();
+	//! Pin the block of the segment. Strings scanned from a VARCHAR segment point directly into the dictionary stored
+	//! in the block, so the scans keep the block pinned in the ColumnPointer until the next scan of the column.
+	unique_ptr<BufferHandle> PinBlock();
 
 	void Scan(ColumnPointer &pointer, Vector &result, index_t count) override;
 	void Scan(ColumnPointer &pointer, Vector &result, index_t count, sel_t *sel_vector, index_t sel_count) override;
 	void Fetch(Vector &result, index_t row_id) override;
 
 private:
-	//! Pointer to the dictionary, only used for string blocks
-	data_ptr_t dictionary;
+	//! The offset of the dictionary in the block, only used for string blocks
+	index_t dictionary_offset;
+	//! Whether or not the location of the dictionary has been read, only used for string blocks. The offsets of a string
+	//! segment are written before this flag is set, and may only be read by scans that have observed it set.
+	std::atomic<bool> dictionary_loaded;
 	//! Heap used for big strings
 	StringHeap heap;
 	//! Big string map
 	unordered_map<block_id_t, const char *> big_strings;
 
-	void AppendFromStorage(Vector &source, Vector &target, bool has_null);
+	//! Appends the strings with the dictionary offsets in source to the target
+	void AppendStrings(data_ptr_t dictionary, Vector &source, Vector &target, bool has_null);
+	//! Decompresses the values [start, start + count) of the (constant size) segment and appends them to the result
+	void Decompress(data_ptr_t segment, index_t start, index_t count, Vector &result);
 
-	template <bool HAS_NULL> void AppendStrings(Vector &source, Vector &target);
+	template <bool HAS_NULL> void AppendStrings(data_ptr_t dictionary, Vector &source, Vector &target);
 
 	const char *GetBigString(block_id_t block);
 };
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// storage/table/persistent_table_data.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/common.hpp"
+#include "storage/storage_info.hpp"
+
+namespace duckdb {
+
+struct DataPointer {
+	//! The minimum and maximum (non-NULL) value of the segment in the storage format of the column type, only kept
+	//! for numeric types
+	data_t min[8];
+	data_t max[8];
+	//! Whether or not the segment contains NULL values
+	bool has_null;
+	uint64_t row_start;
+	uint64_t tuple_count;
+	block_id_t block_id;
+	uint32_t offset;
+	//! The blocks that store the big strings of the segment (if any)
+	vector<block_id_t> overflow_blocks;
+};
+
+//! An index as it is stored in a checkpoint
+struct PersistentIndexData {
+	//! The location of the root node of the index, or INVALID_BLOCK if the index is empty
+	BlockPointer root;
+	//! The blocks that the nodes of the index are stored in
+	vector<block_id_t> blocks;
+};
+
+//! The data of a table as it is stored in a checkpoint
+struct PersistentTableData {
+	PersistentTableData(index_t column_count) : data_pointers(column_count) {
+	}
+
+	//! The data pointers to the segments of every column
+	vector<vector<DataPointer>> data_pointers;
+	//! The ranges of deleted rows, as (first row, row count). The rows of a table keep their row id in a checkpoint,
+	//! so deleted rows are stored as well and only marked as deleted when the table is loaded.
+	vector<std::pair<row_t, index_t>> deleted_rows;
+	//! The indexes of the UNIQUE and PRIMARY KEY constraints of the table, in the order of the constraints. Empty if
+	//! the indexes were not stored, in which case they are rebuilt when the table is loaded.
+	vector<PersistentIndexData> indexes;
+
+	//! The amount of stored rows, including the deleted rows
+	index_t RowCount() {
+		auto &pointers = data_pointers[0];
+		return pointers.size() > 0 ? pointers.back().row_start + pointers.back().tuple_count : 0;
+	}
+	//! Whether so many of the stored rows are deleted (at least a quarter) that the table should be compacted
+	bool ShouldCompact() {
+		index_t deleted_count = 0;
+		for (auto &range : deleted_rows) {
+			deleted_count += range.second;
+		}
+		return deleted_count > 0 && deleted_count * 4 >= RowCount();
+	}
+};
+
+} // namespace duckdb
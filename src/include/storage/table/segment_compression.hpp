@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// storage/table/segment_compression.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/common.hpp"
+
+namespace duckdb {
+
+//! The compression used for the values of a persistent segment of a constant size type
+enum class CompressionType : uint8_t {
+	//! The values are stored as-is
+	UNCOMPRESSED = 0,
+	//! All values in the segment are equal, the value is stored once
+	CONSTANT = 1,
+	//! Run-length encoding: the distinct value of every run is stored together with the end of the run
+	RLE = 2,
+	//! Frame-of-reference + bit-packing: values are stored as the difference to the minimum of the segment, using as
+	//! few bits as the range of the segment requires
+	BITPACKING = 3
+};
+
+//! The header at the start of a persistent segment of a constant size type
+struct CompressedSegmentHeader {
+	//! The compression of the segment
+	CompressionType compression;
+	//! Whether or not the segment contains NULL values
+	bool has_null;
+	//! The amount of bits per value (BITPACKING only)
+	uint8_t bit_width;
+	//! The amount of runs (RLE only)
+	uint32_t run_count;
+	//! The frame of reference, i.e. the minimum value of the segment (BITPACKING only)
+	int64_t base;
+};
+
+//! Statistics over the values of a segment, used to pick the compression with the smallest size
+struct CompressionStatistics {
+	//! The amount of values
+	index_t count = 0;
+	//! The amount of runs of equal values
+	index_t run_count = 0;
+	//! Whether or not there are NULL values
+	bool has_null = false;
+	//! Whether or not there are non-NULL values
+	bool has_value = false;
+	//! The minimum and maximum (non-NULL) value, only for integral types
+	int64_t min = 0;
+	int64_t max = 0;
+	//! The bits of the last value, used to detect runs
+	uint64_t last_value = 0;
+};
+
+//! The SegmentCompressor gathers the values of a column segment while a table is checkpointed. Values are appended
+//! until the segment does not fit in a block anymore with the best compression, at which point the segment is
+//! compressed and written to a block.
+class SegmentCompressor {
+public:
+	//! The maximum amount of values in a single segment
+	static constexpr index_t MAXIMUM_SEGMENT_COUNT = 256 * STANDARD_VECTOR_SIZE;
+
+	SegmentCompressor(TypeId type, index_t capacity);
+
+	//! The type of the values
+	TypeId type;
+	//! The size of the block the compressed segment has to fit in
+	index_t capacity;
+
+public:
+	//! The amount of values in the segment
+	index_t Count() {
+		return stats.count;
+	}
+	//! Appends count values in storage format (i.e. NULL values are stored as NullValue<T>). Returns false if the
+	//! segment would not fit in the block anymore, in which case nothing is appended.
+	bool Append(data_ptr_t values, index_t count);
+	//! Compresses the segment into the target buffer and resets the compressor. Returns the amount of bytes written.
+	index_t Flush(data_ptr_t target);
+
+	//! Decompresses the values [start, start + count) of the compressed segment at the given location into target,
+	//! in storage format
+	static void Decompress(data_ptr_t segment, TypeId type, index_t start, index_t count, data_ptr_t target);
+
+private:
+	//! The values of the segment
+	vector<data_t> data;
+	//! The statistics of the segment
+	CompressionStatistics stats;
+
+	//! Returns the best compression for a segment with the given statistics, and its compressed size
+	CompressionType ChooseCompression(CompressionStatistics &stats, index_t &size);
+};
+
+} // namespace duckdb
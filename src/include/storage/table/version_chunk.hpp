@@ -20,6 +20,7 @@ class ColumnDefinition;
 class DataTable;
 class StorageManager;
 
+struct TableFilter;
 struct TableScanState;
 struct IndexTableScanState;
 
@@ -63,6 +64,12 @@ public:
 	//! chunk.
 	bool Scan(TableScanState &state, Transaction &transaction, DataChunk &result, const vector<column_t> &column_ids,
 	          index_t version_index);
+	//! Returns true if the entire (unversioned) chunk can be skipped by the scan, because the zone maps show that none
+	//! of its rows can satisfy the filters of the scan
+	bool SkipScan(TableScanState &state);
+	//! Checks the filters against the zone maps of the column segments that hold the rows [offset, offset + count) of
+	//! the chunk. Returns false if none of the rows can satisfy all the filters.
+	bool CheckZonemap(vector<TableFilter> &filters, index_t offset, index_t count);
 
 	//! Scan used for creating an index, scans ALL tuples in the table (including all versions of a tuple). Returns true
 	//! if the chunk is exhausted
@@ -85,11 +92,17 @@ private:
 	//! are chosen by "sel_vector". The column pointer is advanced by "count" entries.
 	void RetrieveColumnData(ColumnPointer &pointer, Vector &result, index_t count, sel_t *sel_vector,
 	                        index_t sel_count);
+	//! Advance the column pointer by "count" entries without fetching any data
+	void SkipColumnData(ColumnPointer &pointer, index_t count);
 
 	void FetchColumnData(TableScanState &state, DataChunk &result, const vector<column_t> &column_ids,
 	                     index_t offset_in_chunk, index_t count);
 	void FetchColumnData(TableScanState &state, DataChunk &result, const vector<column_t> &column_ids,
 	                     index_t offset_in_chunk, index_t scan_count, sel_t sel_vector[], index_t count);
+	//! Fetch "count" entries that satisfy the filters of the scan. The filtered columns are fetched first, the other
+	//! columns are only fetched for the entries that satisfy the filters.
+	void FetchFilteredColumnData(TableScanState &state, DataChunk &result, const vector<column_t> &column_ids,
+	                             index_t offset_in_chunk, index_t count);
 };
 
 } // namespace duckdb
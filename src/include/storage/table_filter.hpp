@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// storage/table_filter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/types/value.hpp"
+#include "common/enums/expression_type.hpp"
+
+namespace duckdb {
+class Vector;
+
+//! A comparison between a column of a table and a constant (column <comparison_type> constant) that is pushed down
+//! into the scan of the table. The scan uses the filter to skip segments using their zone maps, and evaluates the
+//! filter before fetching the other columns of the scanned rows.
+struct TableFilter {
+	TableFilter(Value constant, ExpressionType comparison_type, column_t column_index)
+	    : constant(constant), comparison_type(comparison_type), column_index(column_index) {
+	}
+
+	//! The constant, of the same (physical) type as the column
+	Value constant;
+	//! The comparison, one of =, <, <=, > or >=
+	ExpressionType comparison_type;
+	//! The column of the table (i.e. not the index in the projected column list)
+	column_t column_index;
+
+	//! Evaluates the filter on the entries of the vector in the selection vector. The selection vector is overwritten
+	//! with the entries that satisfy the filter, and the amount of these entries is returned.
+	index_t Select(Vector &vector, sel_t sel_vector[], index_t count);
+};
+
+} // namespace duckdb
@@ -14,6 +14,10 @@
 #include "common/serializer/buffered_file_writer.hpp"
 #include "catalog/catalog_entry/sequence_catalog_entry.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 namespace duckdb {
 
 class BufferedSerializer;
@@ -38,11 +42,17 @@ public:
 	bool initialized;
 
 public:
-	//! Replay the WAL
-	static void Replay(DuckDB &database, string &path);
+	//! Replay the WAL. Returns true if the WAL was not replayed because its entries are already stored in the
+	//! checkpoint that was loaded, in which case the WAL should be truncated.
+	static bool Replay(DuckDB &database, string &path);
 
 	//! Initialize the WAL in the specified directory
 	void Initialize(string &path);
+	//! Returns the current size of the WAL file
+	index_t GetWALSize();
+	//! Removes all entries from the WAL, after they have been written to a checkpoint. No transaction can be
+	//! committing while the WAL is truncated.
+	void Truncate();
 
 	void WriteCreateTable(TableCatalogEntry *entry);
 	void WriteDropTable(TableCatalogEntry *entry);
@@ -65,12 +75,43 @@ public:
 	void WriteUpdate(DataChunk &chunk);
 
 	void WriteQuery(string &query);
-
-	void Flush();
+	//! Writes and syncs a marker for the checkpoint with the given meta block, before the header of the checkpoint is
+	//! written. If the database crashes before the WAL is truncated, the marker shows that the entries of the WAL are
+	//! already stored in the checkpoint.
+	void WriteCheckpoint(block_id_t meta_block);
+
+	//! Announces that a transaction is about to write its commit to the WAL, so a concurrent sync can wait for it. Must
+	//! be followed by either Flush or CancelCommit.
+	void BeginCommit();
+	//! Cancels a commit announced with BeginCommit that failed before it was flushed
+	void CancelCommit();
+	//! Writes a flush entry and hands all entries written so far to the file system, without syncing the file.
+	//! Returns the flush number to pass to Sync to make the entries durable.
+	index_t Flush();
+	//! Syncs the WAL file up to (at least) the given flush. Concurrently committing transactions are synced together
+	//! (group commit): one of them syncs the file for all entries flushed so far, the others wait for it to finish.
+	//! If other transactions are writing their commit, the syncing transaction waits for them for at most
+	//! commit_delay microseconds.
+	void Sync(index_t flush_number);
 
 private:
 	DuckDB &database;
+	//! The path of the WAL file
+	string wal_path;
 	unique_ptr<BufferedFileWriter> writer;
+	//! The amount of flushes that have been handed to the file system
+	std::atomic<index_t> flush_count;
+	//! The amount of flushes that have been synced to disk
+	index_t synced_count;
+	//! Whether or not one of the committers is currently syncing the file
+	bool sync_in_progress;
+	//! The amount of announced commits that have not been flushed yet (protected by sync_lock)
+	index_t pending_commits;
+	//! Lock and condition variable used to wait for the sync of another committer to finish
+	std::mutex sync_lock;
+	std::condition_variable sync_finished;
+	//! Signaled when the last pending commit has been flushed
+	std::condition_variable commits_flushed;
 };
 
 } // namespace duckdb
@@ -24,12 +24,14 @@ private:
 	// data for index cleanup
 	DataTable *current_table;
 	DataChunk chunk;
+	//! The data of the versions that follow the cleaned up versions: the entries they share are kept in the index
+	DataChunk successor_chunk;
 	data_ptr_t data[STANDARD_VECTOR_SIZE];
 	row_t row_numbers[STANDARD_VECTOR_SIZE];
 	index_t count;
 
 private:
-	void CleanupIndexInsert(VersionInfo *info);
+	void CleanupIndexInsert(VersionInfo *info, bool is_update);
 	void FlushIndexCleanup();
 };
 
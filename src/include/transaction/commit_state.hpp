@@ -15,6 +15,8 @@ class DataChunk;
 class DataTable;
 class WriteAheadLog;
 
+//! The CommitState iterates over the entries of an UndoBuffer. With HAS_LOG it writes the entries to the WAL,
+//! otherwise it commits the entries by setting their commit timestamp.
 template <bool HAS_LOG> class CommitState {
 public:
 	CommitState(transaction_t commit_id, WriteAheadLog *log = nullptr);
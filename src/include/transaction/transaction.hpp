@@ -60,8 +60,13 @@ public:
 	//! Push a query into the undo buffer
 	void PushQuery(string query);
 
+	//! Returns true if the transaction has changes that have to be written to the WAL
+	bool ChangesMade();
+	//! Write the changes of the transaction to the WAL. Returns the flush of the WAL that has to be synced for the
+	//! commit to be durable.
+	index_t WriteToWAL(WriteAheadLog *log);
 	//! Commit the current transaction with the given commit identifier
-	void Commit(WriteAheadLog *log, transaction_t commit_id);
+	void Commit(transaction_t commit_id);
 	//! Rollback
 	void Rollback() {
 		undo_buffer.Rollback();
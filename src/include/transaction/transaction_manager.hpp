@@ -39,6 +39,11 @@ public:
 	void CommitTransaction(Transaction *transaction);
 	//! Rollback the given transaction
 	void RollbackTransaction(Transaction *transaction);
+	//! Lock the transaction manager if the given transaction is the only active transaction and the changes of all
+	//! committed transactions have been cleaned up, i.e. if the storage contains no other versions of the data than
+	//! the committed one. No transaction can be started or finished while the returned lock is held. If this is not
+	//! the case the returned lock is not locked.
+	std::unique_lock<std::mutex> LockIfOnlyTransaction(Transaction *transaction);
 	//! Add the catalog set
 	void AddCatalogSet(ClientContext &context, unique_ptr<CatalogSet> catalog_set);
 
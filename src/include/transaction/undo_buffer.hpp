@@ -46,8 +46,11 @@ public:
 
 	//! Cleanup the undo buffer
 	void Cleanup();
-	//! Commit the changes made in the UndoBuffer: should be called on commit
-	void Commit(WriteAheadLog *log, transaction_t commit_id);
+	//! Write the changes made in the UndoBuffer to the WAL, without committing them
+	void WriteToWAL(WriteAheadLog *log);
+	//! Commit the changes made in the UndoBuffer, making them visible to transactions that start afterwards: should be
+	//! called on commit
+	void Commit(transaction_t commit_id);
 	//! Rollback the changes made in this UndoBuffer: should be called on
 	//! rollback
 	void Rollback();
@@ -25,6 +25,9 @@ Appender::Appender(DuckDB &database, string schema_name, string table_name)
 	// get the table entry
 	auto types = table_entry->GetTypes();
 	chunk.Initialize(types);
+	for (auto &col : table_entry->columns) {
+		sql_types.push_back(col.type);
+	}
 }
 
 Appender::~Appender() {
@@ -48,6 +51,7 @@ void Appender::EndRow() {
 		throw Exception("Call to Appender::EndRow() without all rows having been "
 		                "appended to!");
 	}
+	column = 0;
 	if (chunk.size() >= STANDARD_VECTOR_SIZE) {
 		Flush();
 	}
@@ -94,6 +98,59 @@ void Appender::AppendValue(Value value) {
 	column++;
 }
 
+void Appender::AppendChunk(DataChunk &append_chunk) {
+	if (!table_entry) {
+		throw Exception("Call to Appender::AppendChunk() after the appender has been closed!");
+	}
+	if (column != 0) {
+		throw Exception("Call to Appender::AppendChunk() while a row is being appended!");
+	}
+	if (append_chunk.column_count != chunk.column_count) {
+		throw Exception("Call to Appender::AppendChunk() with the wrong amount of columns!");
+	}
+	for (index_t i = 0; i < chunk.column_count; i++) {
+		if (append_chunk.data[i].type != chunk.data[i].type) {
+			throw Exception("Call to Appender::AppendChunk() with the wrong type for column " + to_string(i) + "!");
+		}
+	}
+	// the rows appended with the AppendX() functions go first
+	Flush();
+	table_entry->storage->Append(*table_entry, context, append_chunk);
+}
+
+void Appender::AppendColumns(index_t count, data_ptr_t columns[], bool *nullmasks[]) {
+	if (!table_entry) {
+		throw Exception("Call to Appender::AppendColumns() after the appender has been closed!");
+	}
+	if (column != 0) {
+		throw Exception("Call to Appender::AppendColumns() while a row is being appended!");
+	}
+	Flush();
+	// append the arrays one vector at a time: the vectors of the internal chunk point directly into the arrays
+	for (index_t offset = 0; offset < count; offset += STANDARD_VECTOR_SIZE) {
+		index_t vector_count = min((index_t)STANDARD_VECTOR_SIZE, count - offset);
+		for (index_t i = 0; i < chunk.column_count; i++) {
+			auto &vector = chunk.data[i];
+			vector.data = columns[i] + offset * GetTypeIdSize(vector.type);
+			vector.count = vector_count;
+			if (nullmasks && nullmasks[i]) {
+				auto nulls = nullmasks[i] + offset;
+				for (index_t k = 0; k < vector_count; k++) {
+					vector.nullmask[k] = nulls[k];
+				}
+			}
+		}
+		try {
+			table_entry->storage->Append(*table_entry, context, chunk);
+		} catch (...) {
+			chunk.Reset();
+			throw;
+		}
+		// point the chunk back to its own data
+		chunk.Reset();
+	}
+}
+
 void Appender::Flush() {
 	assert(table_entry);
 	table_entry->storage->Append(*table_entry, context, chunk);
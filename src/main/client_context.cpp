@@ -2,6 +2,7 @@
 
 #include "common/serializer/buffered_deserializer.hpp"
 #include "common/serializer/buffered_serializer.hpp"
+#include "execution/parallel_pipeline.hpp"
 #include "execution/physical_plan_generator.hpp"
 #include "main/database.hpp"
 #include "main/materialized_query_result.hpp"
@@ -189,6 +190,12 @@ unique_ptr<QueryResult> ClientContext::ExecuteStatementInternal(string query, un
 	}
 	// create a materialized result by continuously fetching
 	auto result = make_unique<MaterializedQueryResult>(statement_type, sql_types, types, names);
+	if (ParallelPipeline::CanParallelize(*this, *execution_context.physical_plan)) {
+		// the plan is a single pipeline: execute it using multiple threads
+		ParallelPipeline pipeline(*this, *execution_context.physical_plan);
+		pipeline.Materialize(result->collection);
+		return move(result);
+	}
 	while (true) {
 		auto chunk = FetchInternal();
 		if (chunk->size() == 0) {
@@ -2,6 +2,7 @@
 
 #include "catalog/catalog.hpp"
 #include "common/file_system.hpp"
+#include "execution/task_scheduler.hpp"
 #include "main/connection_manager.hpp"
 #include "storage/storage_manager.hpp"
 #include "transaction/transaction_manager.hpp"
@@ -22,10 +23,16 @@ DuckDB::DuckDB(const char *path, DBConfig *config) {
 		Configure(config);
 	}
 
-	storage = make_unique<StorageManager>(*this, path ? string(path) : string(), access_mode == AccessMode::READ_ONLY);
+	string database_path = path ? string(path) : string();
+	if (temporary_directory.empty() && !database_path.empty() && database_path != ":memory:") {
+		// by default temporary files are stored in a directory next to the database file
+		temporary_directory = database_path + ".tmp";
+	}
+	storage = make_unique<StorageManager>(*this, database_path, access_mode == AccessMode::READ_ONLY);
 	catalog = make_unique<Catalog>(*storage);
 	transaction_manager = make_unique<TransactionManager>(*storage);
 	connection_manager = make_unique<ConnectionManager>();
+	scheduler = make_unique<TaskScheduler>(maximum_threads);
 	// initialize the database
 	storage->Initialize();
 }
@@ -34,6 +41,22 @@ DuckDB::DuckDB(const string &path, DBConfig *config) : DuckDB(path.c_str(), conf
 }
 
 DuckDB::~DuckDB() {
+	// the spill files are removed by the queries that created them: clean up the directories we created for them
+	for (auto &directory : created_temporary_directories) {
+		if (file_system->DirectoryExists(directory)) {
+			file_system->RemoveDirectory(directory);
+		}
+	}
+}
+
+string DuckDB::GetTemporaryDirectory() {
+	lock_guard<mutex> lock(temporary_directory_lock);
+	return temporary_directory;
+}
+
+void DuckDB::SetTemporaryDirectory(string directory) {
+	lock_guard<mutex> lock(temporary_directory_lock);
+	temporary_directory = move(directory);
 }
 
 void DuckDB::Configure(DBConfig &config) {
@@ -47,7 +70,14 @@ void DuckDB::Configure(DBConfig &config) {
 	} else {
 		file_system = make_unique<FileSystem>();
 	}
-	checkpoint_only = config.checkpoint_only;
 	checkpoint_wal_size = config.checkpoint_wal_size;
+	commit_delay = config.commit_delay;
+	maximum_memory = config.maximum_memory;
+	if (config.maximum_threads == (index_t)-1) {
+		maximum_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	} else {
+		maximum_threads = config.maximum_threads;
+	}
 	use_direct_io = config.use_direct_io;
+	temporary_directory = config.temporary_directory;
 }
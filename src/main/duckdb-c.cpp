@@ -4,6 +4,7 @@
 #include "common/vector_operations/vector_operations.hpp"
 #include "duckdb.h"
 #include "duckdb.hpp"
+#include "main/appender.hpp"
 
 #include <cstring>
 
@@ -356,6 +357,109 @@ void duckdb_destroy_prepare(duckdb_prepared_statement *prepared_statement) {
 	*prepared_statement = nullptr;
 }
 
+duckdb_state duckdb_appender_create(duckdb_connection connection, const char *schema, const char *table,
+                                    duckdb_appender *out_appender) {
+	Connection *conn = (Connection *)connection;
+	if (!connection || !table || !out_appender) {
+		return DuckDBError;
+	}
+	if (!schema) {
+		schema = DEFAULT_SCHEMA;
+	}
+	try {
+		*out_appender = (duckdb_appender) new Appender(conn->db, schema, table);
+	} catch (...) {
+		*out_appender = nullptr;
+		return DuckDBError;
+	}
+	return DuckDBSuccess;
+}
+
+static bool IsNullEntry(bool **nullmasks, index_t col, index_t row) {
+	return nullmasks && nullmasks[col] && nullmasks[col][row];
+}
+
+duckdb_state duckdb_append_columns(duckdb_appender appender, index_t count, void **columns, bool **nullmasks) {
+	Appender *wrapper = (Appender *)appender;
+	if (!appender || !columns) {
+		return DuckDBError;
+	}
+	auto &sql_types = wrapper->GetTypes();
+	// dates and timestamps are converted from their C representation, the other arrays are appended directly
+	vector<unique_ptr<data_t[]>> converted_columns;
+	vector<data_ptr_t> column_data;
+	for (index_t col = 0; col < sql_types.size(); col++) {
+		if (!columns[col] || ConvertCPPTypeToC(sql_types[col]) == DUCKDB_TYPE_INVALID) {
+			return DuckDBError;
+		}
+		switch (sql_types[col].id) {
+		case SQLTypeId::DATE: {
+			auto source = (duckdb_date *)columns[col];
+			auto converted = unique_ptr<data_t[]>(new data_t[count * sizeof(date_t)]);
+			auto target = (date_t *)converted.get();
+			for (index_t row = 0; row < count; row++) {
+				if (!IsNullEntry(nullmasks, col, row)) {
+					target[row] = Date::FromDate(source[row].year, source[row].month, source[row].day);
+				}
+			}
+			column_data.push_back(converted.get());
+			converted_columns.push_back(move(converted));
+			break;
+		}
+		case SQLTypeId::TIMESTAMP: {
+			auto source = (duckdb_timestamp *)columns[col];
+			auto converted = unique_ptr<data_t[]>(new data_t[count * sizeof(timestamp_t)]);
+			auto target = (timestamp_t *)converted.get();
+			for (index_t row = 0; row < count; row++) {
+				if (!IsNullEntry(nullmasks, col, row)) {
+					auto &date = source[row].date;
+					auto &time = source[row].time;
+					target[row] = Timestamp::FromDatetime(Date::FromDate(date.year, date.month, date.day),
+					                                      Time::FromTime(time.hour, time.min, time.sec, time.msec));
+				}
+			}
+			column_data.push_back(converted.get());
+			converted_columns.push_back(move(converted));
+			break;
+		}
+		default:
+			column_data.push_back((data_ptr_t)columns[col]);
+			break;
+		}
+	}
+	try {
+		wrapper->AppendColumns(count, column_data.data(), nullmasks);
+	} catch (...) {
+		return DuckDBError;
+	}
+	return DuckDBSuccess;
+}
+
+duckdb_state duckdb_appender_commit(duckdb_appender appender) {
+	Appender *wrapper = (Appender *)appender;
+	if (!appender) {
+		return DuckDBError;
+	}
+	try {
+		wrapper->Commit();
+	} catch (...) {
+		return DuckDBError;
+	}
+	return DuckDBSuccess;
+}
+
+void duckdb_appender_destroy(duckdb_appender *appender) {
+	if (!appender || !*appender) {
+		return;
+	}
+	Appender *wrapper = (Appender *)*appender;
+	try {
+		delete wrapper;
+	} catch (...) {
+	}
+	*appender = nullptr;
+}
+
 duckdb_type ConvertCPPTypeToC(SQLType sql_type) {
 	switch (sql_type.id) {
 	case SQLTypeId::BOOLEAN:
@@ -65,35 +65,44 @@ unique_ptr<LogicalOperator> IndexScan::TransformFilterToIndexScan(unique_ptr<Log
 	for (size_t j = 0; j < storage.indexes.size(); j++) {
 		auto &index = storage.indexes[j];
 
-		assert(index->unbound_expressions.size() == 1);
-		// first rewrite the index expression so the ColumnBindings align with the column bindings of the current table
-		auto index_expression = index->unbound_expressions[0]->Copy();
+		// first rewrite the index expressions so the ColumnBindings align with the column bindings of the current table
+		vector<unique_ptr<Expression>> index_expressions;
 		bool rewrite_possible = true;
-		RewriteIndexExpression(*index, *get, *index_expression, rewrite_possible);
+		for (auto &unbound_expression : index->unbound_expressions) {
+			auto index_expression = unbound_expression->Copy();
+			RewriteIndexExpression(*index, *get, *index_expression, rewrite_possible);
+			index_expressions.push_back(move(index_expression));
+		}
 		if (!rewrite_possible) {
 			// could not rewrite!
 			continue;
 		}
 
-		Value low_value, high_value, equal_value;
+		// the equality predicates on each of the index expressions; range predicates can only be used if the index
+		// has a single expression
+		vector<Value> equal_values(index_expressions.size());
+		Value low_value, high_value;
 		// try to find a matching index for any of the filter expressions
 		auto expr = filter.expressions[0].get();
 		auto low_comparison_type = expr->type;
 		auto high_comparison_type = expr->type;
 		for (index_t i = 0; i < filter.expressions.size(); i++) {
 			expr = filter.expressions[i].get();
-			// create a matcher for a comparison with a constant
-			ComparisonExpressionMatcher matcher;
-			// match on a comparison type
-			matcher.expr_type = make_unique<ComparisonExpressionTypeMatcher>();
-			// match on a constant comparison with the indexed expression
-			matcher.matchers.push_back(make_unique<ExpressionEqualityMatcher>(index_expression.get()));
-			matcher.matchers.push_back(make_unique<ConstantExpressionMatcher>());
+			for (index_t k = 0; k < index_expressions.size(); k++) {
+				// create a matcher for a comparison with a constant
+				ComparisonExpressionMatcher matcher;
+				// match on a comparison type
+				matcher.expr_type = make_unique<ComparisonExpressionTypeMatcher>();
+				// match on a constant comparison with the indexed expression
+				matcher.matchers.push_back(make_unique<ExpressionEqualityMatcher>(index_expressions[k].get()));
+				matcher.matchers.push_back(make_unique<ConstantExpressionMatcher>());
 
-			matcher.policy = SetMatcher::Policy::UNORDERED;
+				matcher.policy = SetMatcher::Policy::UNORDERED;
 
-			vector<Expression *> bindings;
-			if (matcher.Match(expr, bindings)) {
+				vector<Expression *> bindings;
+				if (!matcher.Match(expr, bindings)) {
+					continue;
+				}
 				// range or equality comparison with constant value
 				// we can use our index here
 				// bindings[0] = the expression
@@ -111,9 +120,10 @@ unique_ptr<LogicalOperator> IndexScan::TransformFilterToIndexScan(unique_ptr<Log
 				}
 				if (comparison_type == ExpressionType::COMPARE_EQUAL) {
 					// equality value
-					// equality overrides any other bounds so we just break here
-					equal_value = constant_value;
-					break;
+					equal_values[k] = constant_value;
+				} else if (index_expressions.size() > 1) {
+					// range predicate on a part of a multi-column index
+					continue;
 				} else if (comparison_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO ||
 				           comparison_type == ExpressionType::COMPARE_GREATERTHAN) {
 					// greater than means this is a lower bound
@@ -126,22 +136,30 @@ unique_ptr<LogicalOperator> IndexScan::TransformFilterToIndexScan(unique_ptr<Log
 				}
 			}
 		}
-		if (!equal_value.is_null || !low_value.is_null || !high_value.is_null) {
+		bool equal_index = true;
+		for (auto &equal_value : equal_values) {
+			if (equal_value.is_null) {
+				equal_index = false;
+			}
+		}
+		if (equal_index || !low_value.is_null || !high_value.is_null) {
 			auto logical_index_scan = make_unique<LogicalIndexScan>(*get->table, *get->table->storage, *index,
 			                                                        get->column_ids, get->table_index);
-			if (!equal_value.is_null) {
-				logical_index_scan->equal_value = equal_value;
+			if (equal_index) {
+				// equality overrides any other bounds
+				logical_index_scan->equal_values = move(equal_values);
 				logical_index_scan->equal_index = true;
-			}
-			if (!low_value.is_null) {
-				logical_index_scan->low_value = low_value;
-				logical_index_scan->low_index = true;
-				logical_index_scan->low_expression_type = low_comparison_type;
-			}
-			if (!high_value.is_null) {
-				logical_index_scan->high_value = high_value;
-				logical_index_scan->high_index = true;
-				logical_index_scan->high_expression_type = high_comparison_type;
+			} else {
+				if (!low_value.is_null) {
+					logical_index_scan->low_value = low_value;
+					logical_index_scan->low_index = true;
+					logical_index_scan->low_expression_type = low_comparison_type;
+				}
+				if (!high_value.is_null) {
+					logical_index_scan->high_value = high_value;
+					logical_index_scan->high_index = true;
+					logical_index_scan->high_expression_type = high_comparison_type;
+				}
 			}
 			op->children[0] = move(logical_index_scan);
 			break;
@@ -0,0 +1,70 @@
+#include "optimizer/rule/like_optimization.hpp"
+
+#include "catalog/catalog_entry/scalar_function_catalog_entry.hpp"
+#include "main/client_context.hpp"
+#include "main/database.hpp"
+#include "optimizer/expression_rewriter.hpp"
+#include "planner/expression/bound_comparison_expression.hpp"
+#include "planner/expression/bound_constant_expression.hpp"
+#include "planner/expression/bound_function_expression.hpp"
+#include "planner/expression/bound_operator_expression.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+LikeOptimizationRule::LikeOptimizationRule(ExpressionRewriter &rewriter) : Rule(rewriter) {
+	// match on a (NOT) LIKE comparison that has a ConstantExpression as its pattern
+	auto op = make_unique<ComparisonExpressionMatcher>();
+	op->expr_type = make_unique<ManyExpressionTypeMatcher>(
+	    vector<ExpressionType>{ExpressionType::COMPARE_LIKE, ExpressionType::COMPARE_NOTLIKE});
+	op->matchers.push_back(make_unique<ExpressionMatcher>());
+	op->matchers.push_back(make_unique<ConstantExpressionMatcher>());
+	op->policy = SetMatcher::Policy::ORDERED;
+	root = move(op);
+}
+
+unique_ptr<Expression> LikeOptimizationRule::Apply(LogicalOperator &op, vector<Expression *> &bindings,
+                                                   bool &changes_made) {
+	auto root = (BoundComparisonExpression *)bindings[0];
+	auto constant_expr = (BoundConstantExpression *)bindings[2];
+	auto &value = constant_expr->value;
+	if (value.is_null || value.type != TypeId::VARCHAR || root->left->return_type != TypeId::VARCHAR) {
+		return nullptr;
+	}
+	// strip the % wildcards from the start and the end of the pattern
+	auto &pattern = value.str_value;
+	index_t start = 0, end = pattern.size();
+	while (start < end && pattern[start] == '%') {
+		start++;
+	}
+	while (end > start && pattern[end - 1] == '%') {
+		end--;
+	}
+	auto literal = pattern.substr(start, end - start);
+	if (literal.find_first_of("%_") != string::npos) {
+		// the remainder of the pattern contains wildcards: the pattern is matched by the LIKE operator
+		return nullptr;
+	}
+	bool invert = root->type == ExpressionType::COMPARE_NOTLIKE;
+	bool has_start_percentage = start > 0;
+	bool has_end_percentage = end < pattern.size();
+	if (!has_start_percentage && !has_end_percentage) {
+		// no wildcards: the string has to equal the pattern
+		return make_unique<BoundComparisonExpression>(invert ? ExpressionType::COMPARE_NOTEQUAL
+		                                                     : ExpressionType::COMPARE_EQUAL,
+		                                              move(root->left), move(root->right));
+	}
+	string function_name = has_start_percentage ? (has_end_percentage ? "contains" : "suffix") : "prefix";
+	auto &context = rewriter.context;
+	auto function = (ScalarFunctionCatalogEntry *)context.catalog.GetFunction(context.ActiveTransaction(),
+	                                                                          DEFAULT_SCHEMA, function_name);
+	auto result = make_unique<BoundFunctionExpression>(TypeId::BOOLEAN, function);
+	result->children.push_back(move(root->left));
+	result->children.push_back(make_unique<BoundConstantExpression>(Value(literal)));
+	if (invert) {
+		auto not_expr = make_unique<BoundOperatorExpression>(ExpressionType::OPERATOR_NOT, TypeId::BOOLEAN);
+		not_expr->children.push_back(move(result));
+		return move(not_expr);
+	}
+	return move(result);
+}
@@ -1,7 +1,11 @@
 #include "parser/parser.hpp"
 
 #include "main/client_context.hpp"
+#include "main/database.hpp"
+#include "execution/task_scheduler.hpp"
 #include "parser/transformer.hpp"
+#include "storage/buffer_manager.hpp"
+#include "storage/storage_manager.hpp"
 #include "postgres_parser.hpp"
 
 namespace postgres {
@@ -46,6 +50,39 @@ void Parser::ParseQuery(string query) {
 
 enum class PragmaType : uint8_t { NOTHING, ASSIGNMENT, CALL };
 
+//! Parse a memory limit of the form "<number>[KB|MB|GB|TB]"; returns (index_t)-1 for "-1" or "none" (no limit)
+static index_t ParseMemoryLimit(string arg) {
+	arg = StringUtil::Replace(StringUtil::Lower(arg), "'", "");
+	arg = StringUtil::Replace(arg, " ", "");
+	if (arg == "-1" || arg == "none") {
+		return (index_t)-1;
+	}
+	index_t idx = 0;
+	while (idx < arg.size() && isdigit(arg[idx])) {
+		idx++;
+	}
+	if (idx == 0) {
+		throw ParserException("Memory limit must be a number followed by an optional unit (e.g. 1GB)");
+	}
+	index_t limit = std::stoull(arg.substr(0, idx));
+	string unit = arg.substr(idx);
+	index_t multiplier;
+	if (unit == "" || unit == "b" || unit == "bytes") {
+		multiplier = 1;
+	} else if (unit == "kb" || unit == "k") {
+		multiplier = 1000LL;
+	} else if (unit == "mb" || unit == "m") {
+		multiplier = 1000LL * 1000LL;
+	} else if (unit == "gb" || unit == "g") {
+		multiplier = 1000LL * 1000LL * 1000LL;
+	} else if (unit == "tb" || unit == "t") {
+		multiplier = 1000LL * 1000LL * 1000LL * 1000LL;
+	} else {
+		throw ParserException("Unknown unit for memory limit: %s (expected: KB, MB, GB or TB)", unit.c_str());
+	}
+	return limit * multiplier;
+}
+
 bool Parser::ParsePragma(string &query) {
 	// check if there is a PRAGMA statement, this is done before calling the
 	// postgres parser
@@ -133,6 +170,66 @@ bool Parser::ParsePragma(string &query) {
 		}
 		string location = StringUtil::Replace(StringUtil::Lower(query.substr(pos + 1)), ";", "");
 		context.profiler.save_location = location;
+	} else if (keyword == "memory_limit") {
+		// set the maximum amount of memory used by the buffer manager
+		if (type != PragmaType::ASSIGNMENT) {
+			throw ParserException("Memory limit must be an assignment (e.g. PRAGMA memory_limit=1GB)");
+		}
+		index_t limit = ParseMemoryLimit(StringUtil::Replace(query.substr(pos + 1), ";", ""));
+		auto &storage = *context.db.storage;
+		if (storage.buffer_manager) {
+			storage.buffer_manager->SetLimit(limit);
+		}
+		context.db.maximum_memory = limit;
+	} else if (keyword == "threads") {
+		// set the amount of threads used to execute queries
+		if (type != PragmaType::ASSIGNMENT) {
+			throw ParserException("Threads must be an assignment (e.g. PRAGMA threads=4)");
+		}
+		string assignment = StringUtil::Replace(query.substr(pos + 1), ";", "");
+		StringUtil::Trim(assignment);
+		if (assignment.empty() || assignment.find_first_not_of("0123456789") != string::npos) {
+			throw ParserException("Threads must be a positive number");
+		}
+		index_t threads = std::stoull(assignment);
+		if (threads == 0) {
+			throw ParserException("Threads must be a positive number");
+		}
+		context.db.scheduler->SetThreads(threads);
+		context.db.maximum_threads = threads;
+	} else if (keyword == "commit_delay") {
+		// set the time (in microseconds) a commit waits for other commits before syncing the WAL
+		if (type != PragmaType::ASSIGNMENT) {
+			throw ParserException("Commit delay must be an assignment (e.g. PRAGMA commit_delay=1000)");
+		}
+		string assignment = StringUtil::Replace(query.substr(pos + 1), ";", "");
+		StringUtil::Trim(assignment);
+		if (assignment.empty() || assignment.find_first_not_of("0123456789") != string::npos) {
+			throw ParserException("Commit delay must be a number of microseconds");
+		}
+		try {
+			context.db.commit_delay = std::stoull(assignment);
+		} catch (std::exception &) {
+			// out of range
+			throw ParserException("Commit delay must be a number of microseconds");
+		}
+	} else if (keyword == "temp_directory") {
+		// set the directory in which operators can spill data that does not fit in memory
+		if (type != PragmaType::ASSIGNMENT) {
+			throw ParserException("Temporary directory must be an assignment (e.g. PRAGMA temp_directory='/tmp/duck')");
+		}
+		string directory = StringUtil::Replace(query.substr(pos + 1), ";", "");
+		StringUtil::Trim(directory);
+		if (directory.size() >= 2 && directory[0] == '\'' && directory[directory.size() - 1] == '\'') {
+			directory = directory.substr(1, directory.size() - 2);
+		}
+		context.db.SetTemporaryDirectory(directory);
+	} else if (keyword == "checkpoint") {
+		// write the committed state of the database to the database file and truncate the WAL
+		if (type != PragmaType::NOTHING) {
+			throw ParserException("Checkpoint does not take any arguments (e.g. PRAGMA checkpoint)");
+		}
+		context.db.storage->CreateCheckpoint();
 	} else {
 		throw ParserException("Unrecognized PRAGMA keyword: %s", keyword.c_str());
 	}
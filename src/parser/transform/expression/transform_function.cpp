@@ -12,17 +12,7 @@ using namespace postgres;
 using namespace std;
 
 static ExpressionType WindowToExpressionType(string &fun_name) {
-	if (fun_name == "sum") {
-		return ExpressionType::WINDOW_SUM;
-	} else if (fun_name == "count") {
-		return ExpressionType::WINDOW_COUNT_STAR;
-	} else if (fun_name == "min") {
-		return ExpressionType::WINDOW_MIN;
-	} else if (fun_name == "max") {
-		return ExpressionType::WINDOW_MAX;
-	} else if (fun_name == "avg") {
-		return ExpressionType::WINDOW_AVG;
-	} else if (fun_name == "rank") {
+	if (fun_name == "rank") {
 		return ExpressionType::WINDOW_RANK;
 	} else if (fun_name == "rank_dense" || fun_name == "dense_rank") {
 		return ExpressionType::WINDOW_RANK_DENSE;
@@ -43,8 +33,8 @@ static ExpressionType WindowToExpressionType(string &fun_name) {
 	} else if (fun_name == "ntile") {
 		return ExpressionType::WINDOW_NTILE;
 	}
-
-	return ExpressionType::INVALID;
+	// any other function is an aggregate function computed over the window frame
+	return ExpressionType::WINDOW_AGGREGATE;
 }
 
 void Transformer::TransformWindowDef(WindowDef *window_spec, WindowExpression *expr) {
@@ -118,13 +108,12 @@ unique_ptr<ParsedExpression> Transformer::TransformFuncCall(FuncCall *root) {
 	auto lowercase_name = StringUtil::Lower(function_name);
 
 	if (root->over) {
-
-		auto win_fun_type = WindowToExpressionType(lowercase_name);
-		if (win_fun_type == ExpressionType::INVALID) {
-			throw Exception("Unknown/unsupported window function");
+		if (root->agg_distinct) {
+			throw ParserException("DISTINCT is not implemented for window functions!");
 		}
 
-		auto expr = make_unique<WindowExpression>(win_fun_type, nullptr);
+		auto win_fun_type = WindowToExpressionType(lowercase_name);
+		auto expr = make_unique<WindowExpression>(win_fun_type, schema, lowercase_name);
 
 		if (root->args) {
 			vector<unique_ptr<ParsedExpression>> function_list;
@@ -132,18 +121,26 @@ unique_ptr<ParsedExpression> Transformer::TransformFuncCall(FuncCall *root) {
 			if (!res) {
 				throw Exception("Failed to transform window function children");
 			}
-			if (function_list.size() > 0) {
-				expr->child = move(function_list[0]);
-			}
-			if (function_list.size() > 1) {
-				assert(win_fun_type == ExpressionType::WINDOW_LEAD || win_fun_type == ExpressionType::WINDOW_LAG);
-				expr->offset_expr = move(function_list[1]);
-			}
-			if (function_list.size() > 2) {
-				assert(win_fun_type == ExpressionType::WINDOW_LEAD || win_fun_type == ExpressionType::WINDOW_LAG);
-				expr->default_expr = move(function_list[2]);
+			if (win_fun_type == ExpressionType::WINDOW_AGGREGATE) {
+				// all arguments are passed to the aggregate function
+				expr->children = move(function_list);
+			} else {
+				if (function_list.size() > 0) {
+					expr->children.push_back(move(function_list[0]));
+				}
+				if (function_list.size() > 1) {
+					if (win_fun_type != ExpressionType::WINDOW_LEAD && win_fun_type != ExpressionType::WINDOW_LAG) {
+						throw ParserException("Too many arguments for window function %s", lowercase_name.c_str());
+					}
+					expr->offset_expr = move(function_list[1]);
+				}
+				if (function_list.size() > 2) {
+					expr->default_expr = move(function_list[2]);
+				}
+				if (function_list.size() > 3) {
+					throw ParserException("Too many arguments for window function %s", lowercase_name.c_str());
+				}
 			}
-			assert(function_list.size() <= 3);
 		}
 		auto window_spec = reinterpret_cast<WindowDef *>(root->over);
 
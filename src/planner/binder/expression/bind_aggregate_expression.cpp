@@ -10,7 +10,7 @@
 using namespace duckdb;
 using namespace std;
 
-static SQLType ValidateReturnType(vector<SQLType> &arguments, AggregateFunctionCatalogEntry *func) {
+SQLType SelectBinder::ResolveAggregateReturnType(vector<SQLType> &arguments, AggregateFunctionCatalogEntry *func) {
 	auto result = func->return_type(arguments);
 	if (result == SQLTypeId::INVALID) {
 		// types do not match up, throw exception
@@ -64,7 +64,7 @@ BindResult SelectBinder::BindAggregate(FunctionExpression &aggr, AggregateFuncti
 	}
 
 	// types match up, get the result type
-	SQLType result_type = ValidateReturnType(types, func);
+	SQLType result_type = ResolveAggregateReturnType(types, func);
 	// add a cast to the child node (if needed)
 	if (func->cast_arguments(types)) {
 		for (index_t i = 0; i < children.size(); i++) {
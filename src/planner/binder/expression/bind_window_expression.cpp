@@ -1,3 +1,5 @@
+#include "catalog/catalog_entry/aggregate_function_catalog_entry.hpp"
+#include "main/client_context.hpp"
 #include "parser/expression/window_expression.hpp"
 #include "planner/expression/bound_columnref_expression.hpp"
 #include "planner/expression/bound_window_expression.hpp"
@@ -9,30 +11,14 @@ using namespace std;
 
 static SQLType ResolveWindowExpressionType(ExpressionType window_type, SQLType child_type) {
 	switch (window_type) {
-	case ExpressionType::WINDOW_SUM:
-		switch (child_type.id) {
-		case SQLTypeId::BOOLEAN:
-		case SQLTypeId::TINYINT:
-		case SQLTypeId::SMALLINT:
-		case SQLTypeId::INTEGER:
-		case SQLTypeId::BIGINT:
-			return SQLType(SQLTypeId::BIGINT);
-		default:
-			return child_type;
-		}
-		break;
-	case ExpressionType::WINDOW_AVG:
 	case ExpressionType::WINDOW_PERCENT_RANK:
 	case ExpressionType::WINDOW_CUME_DIST:
 		return SQLType(SQLTypeId::DECIMAL);
 	case ExpressionType::WINDOW_ROW_NUMBER:
-	case ExpressionType::WINDOW_COUNT_STAR:
 	case ExpressionType::WINDOW_RANK:
 	case ExpressionType::WINDOW_RANK_DENSE:
 	case ExpressionType::WINDOW_NTILE:
 		return SQLType(SQLTypeId::BIGINT);
-	case ExpressionType::WINDOW_MIN:
-	case ExpressionType::WINDOW_MAX:
 	case ExpressionType::WINDOW_FIRST_VALUE:
 	case ExpressionType::WINDOW_LAST_VALUE:
 		assert(child_type.id != SQLTypeId::INVALID); // "Window function needs an expression"
@@ -54,6 +40,16 @@ static unique_ptr<Expression> GetExpression(unique_ptr<ParsedExpression> &expr)
 	return move(((BoundExpression &)*expr).expr);
 }
 
+//! Casts the bound window expression to the given type
+static unique_ptr<Expression> CastWindowExpression(unique_ptr<ParsedExpression> &expr, SQLType type) {
+	if (!expr) {
+		return nullptr;
+	}
+	assert(expr->expression_class == ExpressionClass::BOUND_EXPRESSION);
+	auto &bound = (BoundExpression &)*expr;
+	return AddCastToType(move(bound.expr), bound.sql_type, type);
+}
+
 BindResult SelectBinder::BindWindow(WindowExpression &window, index_t depth) {
 	if (inside_window) {
 		return BindResult("window function calls cannot be nested");
@@ -65,7 +61,9 @@ BindResult SelectBinder::BindWindow(WindowExpression &window, index_t depth) {
 	// we set the inside_window flag to true to prevent binding nested window functions
 	this->inside_window = true;
 	string error;
-	BindChild(window.child, depth, error);
+	for (auto &child : window.children) {
+		BindChild(child, depth, error);
+	}
 	for (auto &child : window.partitions) {
 		BindChild(child, depth, error);
 	}
@@ -82,10 +80,42 @@ BindResult SelectBinder::BindWindow(WindowExpression &window, index_t depth) {
 		return BindResult(error);
 	}
 	// fetch the children
-	auto *child = (BoundExpression *)window.child.get();
-	SQLType sql_type = ResolveWindowExpressionType(window.type, window.child ? child->sql_type : SQLType());
-	auto result = make_unique<BoundWindowExpression>(window.type, GetInternalType(sql_type));
-	result->child = window.child ? move(child->expr) : nullptr;
+	vector<SQLType> types;
+	vector<unique_ptr<Expression>> children;
+	for (auto &child : window.children) {
+		auto &bound_child = (BoundExpression &)*child;
+		types.push_back(bound_child.sql_type);
+		children.push_back(move(bound_child.expr));
+	}
+	SQLType sql_type;
+	AggregateFunctionCatalogEntry *aggregate = nullptr;
+	if (window.type == ExpressionType::WINDOW_AGGREGATE) {
+		// look up the aggregate function in the catalog
+		auto func = context.catalog.GetFunction(context.ActiveTransaction(), window.schema, window.function_name);
+		if (func->type != CatalogType::AGGREGATE_FUNCTION) {
+			throw BinderException("Unknown window function \"%s\": only aggregate functions can be used as window "
+			                      "functions",
+			                      window.function_name.c_str());
+		}
+		aggregate = (AggregateFunctionCatalogEntry *)func;
+		sql_type = ResolveAggregateReturnType(types, aggregate);
+		// add a cast to the children (if needed)
+		if (aggregate->cast_arguments(types)) {
+			for (index_t i = 0; i < children.size(); i++) {
+				children[i] = AddCastToType(move(children[i]), types[i], sql_type);
+			}
+		}
+	} else {
+		sql_type = ResolveWindowExpressionType(window.type, types.size() > 0 ? types[0] : SQLType());
+		if (window.type == ExpressionType::WINDOW_NTILE) {
+			if (children.size() != 1) {
+				throw BinderException("NTILE needs a parameter");
+			}
+			children[0] = AddCastToType(move(children[0]), types[0], SQLType(SQLTypeId::BIGINT));
+		}
+	}
+	auto result = make_unique<BoundWindowExpression>(window.type, GetInternalType(sql_type), aggregate);
+	result->children = move(children);
 	for (auto &child : window.partitions) {
 		result->partitions.push_back(GetExpression(child));
 	}
@@ -95,10 +125,11 @@ BindResult SelectBinder::BindWindow(WindowExpression &window, index_t depth) {
 		bound_order.type = order.type;
 		result->orders.push_back(move(bound_order));
 	}
-	result->start_expr = GetExpression(window.start_expr);
-	result->end_expr = GetExpression(window.end_expr);
-	result->offset_expr = GetExpression(window.offset_expr);
-	result->default_expr = GetExpression(window.default_expr);
+	// the frame offsets and the LEAD/LAG offset are computed as BIGINT, the default has the type of the result
+	result->start_expr = CastWindowExpression(window.start_expr, SQLType(SQLTypeId::BIGINT));
+	result->end_expr = CastWindowExpression(window.end_expr, SQLType(SQLTypeId::BIGINT));
+	result->offset_expr = CastWindowExpression(window.offset_expr, SQLType(SQLTypeId::BIGINT));
+	result->default_expr = CastWindowExpression(window.default_expr, sql_type);
 	result->start = window.start;
 	result->end = window.end;
 
@@ -3,8 +3,9 @@
 using namespace duckdb;
 using namespace std;
 
-BoundWindowExpression::BoundWindowExpression(ExpressionType type, TypeId return_type)
-    : Expression(type, ExpressionClass::BOUND_WINDOW, return_type) {
+BoundWindowExpression::BoundWindowExpression(ExpressionType type, TypeId return_type,
+                                             AggregateFunctionCatalogEntry *aggregate)
+    : Expression(type, ExpressionClass::BOUND_WINDOW, return_type), aggregate(aggregate) {
 }
 
 string BoundWindowExpression::ToString() const {
@@ -17,12 +18,22 @@ bool BoundWindowExpression::Equals(const BaseExpression *other_) const {
 	}
 	auto other = (BoundWindowExpression *)other_;
 
+	if (aggregate != other->aggregate) {
+		return false;
+	}
 	if (start != other->start || end != other->end) {
 		return false;
 	}
 	// check if the child expressions are equivalent
-	if (!Expression::Equals(child.get(), other->child.get()) ||
-	    !Expression::Equals(start_expr.get(), other->start_expr.get()) ||
+	if (children.size() != other->children.size()) {
+		return false;
+	}
+	for (index_t i = 0; i < children.size(); i++) {
+		if (!Expression::Equals(children[i].get(), other->children[i].get())) {
+			return false;
+		}
+	}
+	if (!Expression::Equals(start_expr.get(), other->start_expr.get()) ||
 	    !Expression::Equals(end_expr.get(), other->end_expr.get()) ||
 	    !Expression::Equals(offset_expr.get(), other->offset_expr.get()) ||
 	    !Expression::Equals(default_expr.get(), other->default_expr.get())) {
@@ -55,10 +66,12 @@ bool BoundWindowExpression::Equals(const BaseExpression *other_) const {
 }
 
 unique_ptr<Expression> BoundWindowExpression::Copy() {
-	auto new_window = make_unique<BoundWindowExpression>(type, return_type);
+	auto new_window = make_unique<BoundWindowExpression>(type, return_type, aggregate);
 	new_window->CopyProperties(*this);
 
-	new_window->child = child ? child->Copy() : nullptr;
+	for (auto &child : children) {
+		new_window->children.push_back(child->Copy());
+	}
 	for (auto &e : partitions) {
 		new_window->partitions.push_back(e->Copy());
 	}
@@ -0,0 +1,113 @@
+#include "storage/buffer_manager.hpp"
+#include "common/exception.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+BufferHandle::BufferHandle(BufferManager &manager, block_id_t block_id, Block *node)
+    : manager(manager), block_id(block_id), node(node) {
+}
+
+BufferHandle::~BufferHandle() {
+	manager.Unpin(block_id);
+}
+
+BufferManager::BufferManager(BlockManager &manager, index_t maximum_memory)
+    : manager(manager), current_memory(0), maximum_memory(maximum_memory) {
+}
+
+unique_ptr<BufferHandle> BufferManager::Pin(block_id_t block_id) {
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		auto entry = blocks.find(block_id);
+		if (entry == blocks.end()) {
+			break;
+		}
+		auto &buffer = entry->second;
+		if (buffer.loading) {
+			// another thread is reading the block from disk: wait for it (or for its read to fail)
+			block_loaded.wait(guard);
+			continue;
+		}
+		// the block is already loaded
+		if (buffer.readers == 0) {
+			// the block was unpinned: it can no longer be evicted
+			lru.erase(buffer.lru_position);
+		}
+		buffer.readers++;
+		return make_unique<BufferHandle>(*this, block_id, buffer.block.get());
+	}
+	// the block is not loaded yet: first make room for it
+	if (!EvictBlocks(BLOCK_SIZE, maximum_memory)) {
+		throw OutOfRangeException("Not enough memory to load block %lld: memory limit of %lld bytes reached and all "
+		                          "loaded blocks are pinned",
+		                          block_id, maximum_memory);
+	}
+	// reserve the (pinned) entry, so other threads that pin the block wait for this read instead of reading it too
+	auto block = make_unique<Block>(block_id);
+	auto block_ptr = block.get();
+
+	BufferEntry buffer;
+	buffer.block = move(block);
+	buffer.readers = 1;
+	buffer.loading = true;
+	blocks[block_id] = move(buffer);
+	current_memory += BLOCK_SIZE;
+
+	// now read the block from disk without holding the lock, so loads of other blocks are not serialized
+	guard.unlock();
+	try {
+		manager.Read(*block_ptr);
+	} catch (...) {
+		guard.lock();
+		blocks.erase(block_id);
+		current_memory -= BLOCK_SIZE;
+		guard.unlock();
+		block_loaded.notify_all();
+		throw;
+	}
+	guard.lock();
+	blocks[block_id].loading = false;
+	guard.unlock();
+	block_loaded.notify_all();
+	return make_unique<BufferHandle>(*this, block_id, block_ptr);
+}
+
+void BufferManager::Unpin(block_id_t block_id) {
+	lock_guard<mutex> guard(lock);
+	auto entry = blocks.find(block_id);
+	assert(entry != blocks.end());
+	auto &buffer = entry->second;
+	assert(buffer.readers > 0);
+	buffer.readers--;
+	if (buffer.readers == 0) {
+		// the block is no longer pinned: add it to the back of the LRU list
+		buffer.lru_position = lru.insert(lru.end(), block_id);
+	}
+}
+
+void BufferManager::SetLimit(index_t limit) {
+	lock_guard<mutex> guard(lock);
+	if (!EvictBlocks(0, limit)) {
+		throw OutOfRangeException("Failed to change memory limit to %lld bytes: could not free up enough memory for "
+		                          "the pinned blocks",
+		                          limit);
+	}
+	maximum_memory = limit;
+}
+
+bool BufferManager::EvictBlocks(index_t extra_memory, index_t memory_limit) {
+	while (current_memory + extra_memory > memory_limit) {
+		if (lru.empty()) {
+			// all loaded blocks are pinned
+			return false;
+		}
+		// evict the least recently used block
+		auto block_id = lru.front();
+		lru.pop_front();
+		assert(blocks.find(block_id) != blocks.end() && blocks[block_id].readers == 0);
+		blocks.erase(block_id);
+		current_memory -= BLOCK_SIZE;
+	}
+	return true;
+}
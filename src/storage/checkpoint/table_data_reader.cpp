@@ -2,13 +2,6 @@
 #include "storage/checkpoint/table_data_writer.hpp"
 #include "storage/meta_block_reader.hpp"
 
-#include "storage/meta_block_reader.hpp"
-
-#include "common/vector_operations/vector_operations.hpp"
-#include "common/types/null_value.hpp"
-
-#include "catalog/catalog_entry/table_catalog_entry.hpp"
-
 #include "planner/parsed_data/bound_create_table_info.hpp"
 
 using namespace duckdb;
@@ -16,8 +9,7 @@ using namespace std;
 
 TableDataReader::TableDataReader(CheckpointManager &manager, MetaBlockReader &reader, BoundCreateTableInfo &info)
     : manager(manager), reader(reader), info(info) {
-	info.data = unique_ptr<vector<unique_ptr<PersistentSegment>>[]>(
-	    new vector<unique_ptr<PersistentSegment>>[info.base->columns.size()]);
+	info.data = make_unique<PersistentTableData>(info.base->columns.size());
 }
 
 void TableDataReader::ReadTableData() {
@@ -26,22 +18,41 @@ void TableDataReader::ReadTableData() {
 
 	// load the data pointers for the table
 	for (index_t col = 0; col < columns.size(); col++) {
-		auto &column = columns[col];
 		index_t data_pointer_count = reader.Read<index_t>();
 		for (index_t data_ptr = 0; data_ptr < data_pointer_count; data_ptr++) {
 			// read the data pointer
 			DataPointer data_pointer;
-			data_pointer.min = reader.Read<double>();
-			data_pointer.max = reader.Read<double>();
+			reader.ReadData(data_pointer.min, sizeof(data_pointer.min));
+			reader.ReadData(data_pointer.max, sizeof(data_pointer.max));
+			data_pointer.has_null = reader.Read<bool>();
 			data_pointer.row_start = reader.Read<index_t>();
 			data_pointer.tuple_count = reader.Read<index_t>();
 			data_pointer.block_id = reader.Read<block_id_t>();
 			data_pointer.offset = reader.Read<uint32_t>();
-			// create a persistent segment
-			auto segment = make_unique<PersistentSegment>(manager.block_manager, data_pointer.block_id,
-			                                              data_pointer.offset, GetInternalType(column.type),
-			                                              data_pointer.row_start, data_pointer.tuple_count);
-			info.data[col].push_back(move(segment));
+			index_t overflow_count = reader.Read<index_t>();
+			for (index_t i = 0; i < overflow_count; i++) {
+				data_pointer.overflow_blocks.push_back(reader.Read<block_id_t>());
+			}
+			info.data->data_pointers[col].push_back(move(data_pointer));
+		}
+	}
+	// load the deleted rows of the table
+	index_t deleted_count = reader.Read<index_t>();
+	for (index_t i = 0; i < deleted_count; i++) {
+		auto start = reader.Read<row_t>();
+		auto count = reader.Read<index_t>();
+		info.data->deleted_rows.push_back(make_pair(start, count));
+	}
+	// load the positions of the stored indexes
+	index_t index_count = reader.Read<index_t>();
+	for (index_t i = 0; i < index_count; i++) {
+		PersistentIndexData index;
+		index.root.block_id = reader.Read<block_id_t>();
+		index.root.offset = reader.Read<uint32_t>();
+		index_t block_count = reader.Read<index_t>();
+		for (index_t j = 0; j < block_count; j++) {
+			index.blocks.push_back(reader.Read<block_id_t>());
 		}
+		info.data->indexes.push_back(move(index));
 	}
 }
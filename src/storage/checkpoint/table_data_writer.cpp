@@ -5,6 +5,7 @@
 
 #include "catalog/catalog_entry/table_catalog_entry.hpp"
 #include "common/serializer/buffered_serializer.hpp"
+#include "storage/data_table.hpp"
 
 using namespace duckdb;
 using namespace std;
@@ -17,94 +18,301 @@ TableDataWriter::TableDataWriter(CheckpointManager &manager, TableCatalogEntry &
     : manager(manager), table(table) {
 }
 
-void TableDataWriter::WriteTableData(Transaction &transaction) {
+unique_ptr<PersistentTableData> TableDataWriter::WriteTableData(Transaction &transaction, bool compact) {
 	assert(blocks.size() == 0);
+	this->compact = compact;
+	auto &storage = *table.storage;
+	auto column_count = table.columns.size();
+	data = make_unique<PersistentTableData>(column_count);
+
+	// the rows before the first modified row are unchanged since the previous checkpoint: reuse the segments that
+	// only contain such rows
+	row_t first_modified = storage.first_modified_row.exchange(std::numeric_limits<row_t>::max());
+	min_write_start = std::numeric_limits<index_t>::max();
+	for (index_t i = 0; i < column_count; i++) {
+		auto &pointers = data->data_pointers[i];
+		if (storage.persistent_data && !compact) {
+			for (auto &pointer : storage.persistent_data->data_pointers[i]) {
+				if ((row_t)(pointer.row_start + pointer.tuple_count) > first_modified) {
+					break;
+				}
+				pointers.push_back(pointer);
+			}
+			// the last segment written by a checkpoint is usually not full: rewrite it together with the rows that
+			// follow it, unless it was loaded from disk (its block can only be reused after a restart)
+			if (pointers.size() > 0 && pointers.back().row_start >= storage.persistent_rows) {
+				pointers.pop_back();
+			}
+		}
+		write_start.push_back(pointers.size() > 0 ? pointers.back().row_start + pointers.back().tuple_count : 0);
+		min_write_start = std::min(min_write_start, write_start[i]);
+	}
 
 	// when writing table data we write columns to individual blocks
 	// we scan the underlying table structure and write to the blocks
 	// then flush the blocks to disk when they are full
+	dictionaries.resize(column_count);
+	overflow_blocks.resize(column_count);
+	for (index_t i = 0; i < column_count; i++) {
+		// for each column, create a block that serves as the buffer for that blocks data
+		blocks.push_back(make_unique<Block>(INVALID_BLOCK));
+		// constant size columns gather the values of a segment in a compressor
+		auto type = GetInternalType(table.columns[i].type);
+		compressors.push_back(TypeIsConstantSize(type) ? make_unique<SegmentCompressor>(type, blocks[i]->size)
+		                                               : nullptr);
+		segment_stats.push_back(make_unique<SegmentStatistics>(type, GetTypeIdSize(type)));
+		// initialize offsets, tuple counts and row number sizes
+		offsets.push_back(GetTypeHeaderSize(table.columns[i].type));
+		tuple_counts.push_back(0);
+		row_numbers.push_back(write_start[i]);
+	}
 
-	// initialize scan structures to prepare for the scan
-	TableScanState state;
-	table.storage->InitializeScan(state);
-	vector<column_t> column_ids;
+	// the rows keep their row ids in the checkpoint: we scan the row ids together with the data, and rows that are
+	// not visible to the checkpoint are stored as deleted rows. The chunks that only contain rows of reused segments
+	// are only scanned for their row ids.
+	vector<column_t> column_ids, row_id_column = {COLUMN_IDENTIFIER_ROW_ID};
 	for (auto &column : table.columns) {
 		column_ids.push_back(column.oid);
 	}
-	//! get all types of the table and initialize the chunk
+	column_ids.push_back(COLUMN_IDENTIFIER_ROW_ID);
 	auto types = table.GetTypes();
-	DataChunk chunk;
+	types.push_back(ROW_TYPE);
+	vector<TypeId> row_id_types = {ROW_TYPE};
+	DataChunk chunk, row_id_chunk;
 	chunk.Initialize(types);
+	row_id_chunk.Initialize(row_id_types);
+	types.pop_back();
+	positioned_chunk.Initialize(types);
+	null_chunk.Initialize(types);
 
-	// the pointers to the written column data for this table
-	dictionaries.resize(table.columns.size());
-	data_pointers.resize(table.columns.size());
-	// we want to fetch all the column ids from the scan
-	// so make a list of all column ids of the table
-	for (index_t i = 0; i < table.columns.size(); i++) {
-		// for each column, create a block that serves as the buffer for that blocks data
-		blocks.push_back(make_unique<Block>(INVALID_BLOCK));
-		// initialize offsets, tuple counts and row number sizes
-		offsets.push_back(GetTypeHeaderSize(table.columns[i].type));
-		tuple_counts.push_back(0);
-		row_numbers.push_back(0);
-	}
-	while (true) {
-		chunk.Reset();
-		// now scan the table to construct the blocks
-		table.storage->Scan(transaction, chunk, column_ids, state);
-		if (chunk.size() == 0) {
-			break;
+	// scan the table one storage chunk at a time
+	ParallelTableScanState chunk_state;
+	TableScanState state;
+	index_t chunk_index;
+	storage.InitializeParallelScan(chunk_state);
+	storage.InitializeScan(state);
+	next_row = 0;
+	while (storage.NextParallelScanMorsel(chunk_state, state, chunk_index)) {
+		index_t chunk_end = state.chunk->start + state.last_chunk_count;
+		bool write_data = chunk_end > min_write_start;
+		auto &scan_chunk = write_data ? chunk : row_id_chunk;
+		while (true) {
+			scan_chunk.Reset();
+			storage.Scan(transaction, scan_chunk, write_data ? column_ids : row_id_column, state);
+			if (scan_chunk.size() == 0) {
+				break;
+			}
+			WriteScannedRows(scan_chunk);
 		}
-		// for each column, we append whatever we can fit into the block
-		for (index_t i = 0; i < table.columns.size(); i++) {
-			assert(chunk.data[i].type == GetInternalType(table.columns[i].type));
-			WriteColumnData(chunk, i);
+		if (!compact) {
+			// the rows at the end of the chunk that were not returned by the scan are deleted
+			WriteDeletedRows(next_row, chunk_end - next_row);
 		}
 	}
+
 	// finally we write the blocks that were not completely filled to disk
-	// FIXME: pack together these unfilled blocks
+	for (index_t i = 0; i < column_count; i++) {
+		FlushBlock(i);
+	}
+	return move(data);
+}
+
+void TableDataWriter::WriteScannedRows(DataChunk &scan_chunk) {
+	// the row ids are the last column of the scanned chunk
+	auto &row_id_vector = scan_chunk.data[scan_chunk.column_count - 1];
+	auto row_ids = (row_t *)row_id_vector.data;
+	// the rows of a scanned chunk belong to a single vector of a storage chunk, but the scan returns the rows that
+	// have an older version first: find the range of the rows and check whether they are in order
+	row_t min_row = std::numeric_limits<row_t>::max(), max_row = 0;
+	bool ordered = !row_id_vector.sel_vector;
+	VectorOperations::Exec(row_id_vector, [&](index_t i, index_t k) {
+		ordered = ordered && (k == 0 || row_ids[i] == row_ids[i - 1] + 1);
+		min_row = std::min(min_row, row_ids[i]);
+		max_row = std::max(max_row, row_ids[i]);
+	});
+	assert(max_row - min_row < STANDARD_VECTOR_SIZE);
+	if (!compact) {
+		// the rows between the previously scanned row and this chunk are deleted
+		assert(min_row >= next_row);
+		WriteDeletedRows(next_row, min_row - next_row);
+	}
+	// the rows keep their row ids, unless the table is compacted
+	row_t start = compact ? next_row : min_row;
+
+	if (ordered) {
+		// the rows are consecutive: write the chunk as-is
+		assert((index_t)(max_row - min_row + 1) == scan_chunk.size());
+		if (start + scan_chunk.size() > min_write_start) {
+			WriteRows(scan_chunk, start);
+		}
+		next_row = start + scan_chunk.size();
+		return;
+	}
+	// place every row at its position, the gaps in between are either deleted rows (which are written as NULL values)
+	// or left out
+	bool present[STANDARD_VECTOR_SIZE] = {};
+	index_t positions[STANDARD_VECTOR_SIZE];
+	VectorOperations::Exec(row_id_vector, [&](index_t i, index_t k) { present[row_ids[i] - min_row] = true; });
+	index_t row_count = 0;
+	for (index_t i = 0; i <= (index_t)(max_row - min_row); i++) {
+		if (compact) {
+			positions[i] = row_count;
+			row_count += present[i];
+			continue;
+		}
+		positions[i] = row_count++;
+		if (!present[i]) {
+			index_t gap_end = i + 1;
+			while (!present[gap_end]) {
+				positions[gap_end] = row_count++;
+				gap_end++;
+			}
+			AddDeletedRows(min_row + i, gap_end - i);
+			i = gap_end - 1;
+		}
+	}
+	if (start + row_count > min_write_start) {
+		positioned_chunk.Reset();
+		for (index_t col = 0; col < table.columns.size(); col++) {
+			auto &source = scan_chunk.data[col];
+			auto &target = positioned_chunk.data[col];
+			auto type_size = GetTypeIdSize(target.type);
+			// deleted rows are written as NULL values
+			target.count = row_count;
+			target.nullmask.set();
+			VectorOperations::Exec(row_id_vector, [&](index_t i, index_t k) {
+				auto position = positions[row_ids[i] - min_row];
+				memcpy(target.data + position * type_size, source.data + i * type_size, type_size);
+				target.nullmask[position] = source.nullmask[i];
+			});
+		}
+		WriteRows(positioned_chunk, start);
+	}
+	next_row = start + row_count;
+}
+
+void TableDataWriter::AddDeletedRows(row_t start, index_t count) {
+	auto &deleted_rows = data->deleted_rows;
+	if (deleted_rows.size() > 0 && deleted_rows.back().first + (row_t)deleted_rows.back().second == start) {
+		deleted_rows.back().second += count;
+	} else {
+		deleted_rows.push_back(make_pair(start, count));
+	}
+}
+
+void TableDataWriter::WriteDeletedRows(row_t start, index_t count) {
+	if (count == 0) {
+		return;
+	}
+	AddDeletedRows(start, count);
+	next_row = start + count;
+	if (start + count <= min_write_start) {
+		// the rows are stored in the reused segments already
+		return;
+	}
+	// the deleted rows are stored as NULL values
+	for (index_t offset = 0; offset < count; offset += STANDARD_VECTOR_SIZE) {
+		index_t null_count = std::min((index_t)STANDARD_VECTOR_SIZE, count - offset);
+		for (index_t col = 0; col < null_chunk.column_count; col++) {
+			null_chunk.data[col].count = null_count;
+			null_chunk.data[col].nullmask.set();
+		}
+		WriteRows(null_chunk, start + offset);
+	}
+}
+
+void TableDataWriter::WriteRows(DataChunk &chunk, row_t start) {
 	for (index_t i = 0; i < table.columns.size(); i++) {
-		// we only write blocks that have data in them
-		if (offsets[i] > 0) {
-			FlushBlock(i);
+		assert(chunk.data[i].type == GetInternalType(table.columns[i].type));
+		if (start + chunk.size() <= write_start[i]) {
+			// the rows are stored in a reused segment of this column
+			continue;
 		}
+		assert(row_numbers[i] + tuple_counts[i] == std::max((index_t)start, write_start[i]));
+		WriteColumnData(chunk, i, write_start[i] > (index_t)start ? write_start[i] - start : 0);
 	}
-	// finally write the table storage information
-	WriteDataPointers();
 }
 
 //===--------------------------------------------------------------------===//
 // Write Column Data to Block
 //===--------------------------------------------------------------------===//
-void TableDataWriter::WriteColumnData(DataChunk &chunk, index_t column_index) {
+template <class T> static void TemplatedUpdateStatistics(SegmentStatistics &stats, T *values, index_t count) {
+	auto min = (T *)stats.minimum.get();
+	auto max = (T *)stats.maximum.get();
+	for (index_t i = 0; i < count; i++) {
+		if (IsNullValue<T>(values[i])) {
+			stats.has_null = true;
+			continue;
+		}
+		if (values[i] < *min) {
+			*min = values[i];
+		}
+		if (values[i] > *max) {
+			*max = values[i];
+		}
+	}
+}
+
+//! Updates the statistics of a segment with count values in storage format
+static void UpdateStatistics(TypeId type, SegmentStatistics &stats, data_ptr_t values, index_t count) {
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		TemplatedUpdateStatistics<int8_t>(stats, (int8_t *)values, count);
+		break;
+	case TypeId::SMALLINT:
+		TemplatedUpdateStatistics<int16_t>(stats, (int16_t *)values, count);
+		break;
+	case TypeId::INTEGER:
+		TemplatedUpdateStatistics<int32_t>(stats, (int32_t *)values, count);
+		break;
+	case TypeId::BIGINT:
+		TemplatedUpdateStatistics<int64_t>(stats, (int64_t *)values, count);
+		break;
+	case TypeId::FLOAT:
+		TemplatedUpdateStatistics<float>(stats, (float *)values, count);
+		break;
+	case TypeId::DOUBLE:
+		TemplatedUpdateStatistics<double>(stats, (double *)values, count);
+		break;
+	default:
+		throw NotImplementedException("Unimplemented type for statistics");
+	}
+}
+
+void TableDataWriter::WriteColumnData(DataChunk &chunk, index_t column_index, index_t offset) {
 	TypeId type = chunk.data[column_index].type;
 	if (TypeIsConstantSize(type)) {
-		// constant size type: simple memcpy
-		// first check if we can fit the chunk into the block
-		index_t size = GetTypeIdSize(type) * chunk.size();
-		// check if we need to flush
-		// FIXME: append part of data that still fits into block if it does not fit entirely
-		FlushIfFull(column_index, size);
-		// data fits into block, write it and update the offset
-		auto ptr = blocks[column_index]->buffer + offsets[column_index];
-		VectorOperations::CopyToStorage(chunk.data[column_index], ptr);
-		offsets[column_index] += size;
-		tuple_counts[column_index] += chunk.size();
+		// constant size type: append the values in storage format to the compressor of the column
+		int64_t values[STANDARD_VECTOR_SIZE];
+		index_t count = chunk.size() - offset;
+		VectorOperations::CopyToStorage(chunk.data[column_index], values, offset, count);
+		if (!compressors[column_index]->Append((data_ptr_t)values, count)) {
+			// the segment does not fit in the block anymore: write it to disk and start a new segment
+			// an empty segment always accepts a chunk
+			FlushBlock(column_index);
+			compressors[column_index]->Append((data_ptr_t)values, count);
+		}
+		UpdateStatistics(type, *segment_stats[column_index], (data_ptr_t)values, count);
+		tuple_counts[column_index] += count;
 	} else {
 		assert(type == TypeId::VARCHAR);
 		// we inline strings into the block
 		VectorOperations::ExecType<const char *>(chunk.data[column_index], [&](const char *val, size_t i, size_t k) {
-			if (chunk.data[column_index].nullmask[i]) {
+			bool is_null = chunk.data[column_index].nullmask[i];
+			if (is_null) {
 				// NULL value
 				val = NullValue<const char *>();
 			}
+			// writing the string can flush the block, so the statistics are only updated afterwards
 			WriteString(column_index, val);
-		});
+			segment_stats[column_index]->has_null |= is_null;
+		}, offset);
 	}
 }
 
 void TableDataWriter::FlushBlock(index_t col) {
+	// we only write blocks that have data in them
 	if (tuple_counts[col] == 0) {
 		return;
 	}
@@ -114,20 +322,34 @@ void TableDataWriter::FlushBlock(index_t col) {
 	if (table.columns[col].type.id == SQLTypeId::VARCHAR) {
 		// for varchar columns, write the dictionary to the buffer
 		FlushDictionary(col);
+	} else {
+		// for constant size columns, compress the segment into the buffer
+		assert(compressors[col]->Count() == tuple_counts[col]);
+		compressors[col]->Flush(blocks[col]->buffer);
 	}
-	// construct the data pointer, FIXME: add statistics as well
+	// construct the data pointer
+	auto type = GetInternalType(table.columns[col].type);
+	auto &stats = *segment_stats[col];
 	DataPointer data_pointer;
+	memset(data_pointer.min, 0, sizeof(data_pointer.min));
+	memset(data_pointer.max, 0, sizeof(data_pointer.max));
+	memcpy(data_pointer.min, stats.minimum.get(), GetTypeIdSize(type));
+	memcpy(data_pointer.max, stats.maximum.get(), GetTypeIdSize(type));
+	data_pointer.has_null = stats.has_null;
 	data_pointer.block_id = blocks[col]->id;
 	data_pointer.offset = 0;
 	data_pointer.row_start = row_numbers[col];
 	data_pointer.tuple_count = tuple_counts[col];
-	data_pointers[col].push_back(data_pointer);
+	data_pointer.overflow_blocks = move(overflow_blocks[col]);
+	overflow_blocks[col].clear();
+	data->data_pointers[col].push_back(move(data_pointer));
 	// write the block
 	manager.block_manager.Write(*blocks[col]);
 
 	offsets[col] = GetTypeHeaderSize(table.columns[col].type);
 	row_numbers[col] += tuple_counts[col];
 	tuple_counts[col] = 0;
+	segment_stats[col] = make_unique<SegmentStatistics>(type, GetTypeIdSize(type));
 }
 
 void TableDataWriter::FlushIfFull(index_t col, index_t write_size) {
@@ -173,6 +395,7 @@ void TableDataWriter::WriteString(index_t col, const char *val) {
 	FlushIfFull(col, sizeof(int32_t));
 	// create the string value
 	string str_value(val);
+	vector<block_id_t> big_string_blocks;
 	if (str_value.size() + 1 > blocks[col]->size - BLOCK_HEADER_STRING - sizeof(int32_t)) {
 		// string can never fit in a single block, insert a special marker followed by the block id and offset where it
 		// is stored create the special marker indicating it is a big string
@@ -180,6 +403,7 @@ void TableDataWriter::WriteString(index_t col, const char *val) {
 		string marker = BigStringMarker(writer.block->id);
 		// write the string to the overflow blocks
 		writer.WriteString(str_value);
+		big_string_blocks = writer.written_blocks;
 		// now write the marker in the dictionary
 		str_value = marker;
 	}
@@ -194,6 +418,8 @@ void TableDataWriter::WriteString(index_t col, const char *val) {
 		offset = dictionaries[col].size;
 		dictionaries[col].offsets[str_value] = offset;
 		dictionaries[col].size += str_value.size() + 1;
+		// the big string belongs to the segment only now that the block cannot be flushed anymore
+		overflow_blocks[col].insert(overflow_blocks[col].end(), big_string_blocks.begin(), big_string_blocks.end());
 	} else {
 		// in the dictionary, only need to write the offset
 		// check if we have room to write the offset
@@ -204,21 +430,3 @@ void TableDataWriter::WriteString(index_t col, const char *val) {
 	offsets[col] += sizeof(int32_t);
 	tuple_counts[col]++;
 }
-
-void TableDataWriter::WriteDataPointers() {
-	for (index_t i = 0; i < data_pointers.size(); i++) {
-		// get a reference to the data column
-		auto &data_pointer_list = data_pointers[i];
-		manager.tabledata_writer->Write<index_t>(data_pointer_list.size());
-		// then write the data pointers themselves
-		for (index_t k = 0; k < data_pointer_list.size(); k++) {
-			auto &data_pointer = data_pointer_list[k];
-			manager.tabledata_writer->Write<double>(data_pointer.min);
-			manager.tabledata_writer->Write<double>(data_pointer.max);
-			manager.tabledata_writer->Write<index_t>(data_pointer.row_start);
-			manager.tabledata_writer->Write<index_t>(data_pointer.tuple_count);
-			manager.tabledata_writer->Write<block_id_t>(data_pointer.block_id);
-			manager.tabledata_writer->Write<uint32_t>(data_pointer.offset);
-		}
-	}
-}
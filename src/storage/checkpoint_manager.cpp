@@ -11,6 +11,7 @@
 #include "catalog/catalog_entry/sequence_catalog_entry.hpp"
 #include "catalog/catalog_entry/table_catalog_entry.hpp"
 #include "catalog/catalog_entry/view_catalog_entry.hpp"
+#include "planner/bound_constraint.hpp"
 
 #include "parser/parsed_data/create_schema_info.hpp"
 #include "parser/parsed_data/create_table_info.hpp"
@@ -26,19 +27,39 @@
 
 #include "storage/checkpoint/table_data_writer.hpp"
 #include "storage/checkpoint/table_data_reader.hpp"
+#include "storage/data_table.hpp"
+#include "storage/index.hpp"
 
 using namespace duckdb;
 using namespace std;
 
 // constexpr uint64_t CheckpointManager::DATA_BLOCK_HEADER_SIZE;
 
+//! Calls the callback for every block that the segments and the indexes of the table data are stored in
+template <class T> static void MarkTableBlocks(PersistentTableData &data, T &&callback) {
+	for (auto &data_pointer_list : data.data_pointers) {
+		for (auto &data_pointer : data_pointer_list) {
+			callback(data_pointer.block_id);
+			for (auto &block_id : data_pointer.overflow_blocks) {
+				callback(block_id);
+			}
+		}
+	}
+	for (auto &index : data.indexes) {
+		for (auto &block_id : index.blocks) {
+			callback(block_id);
+		}
+	}
+}
+
 CheckpointManager::CheckpointManager(StorageManager &manager)
-    : block_manager(*manager.block_manager), database(manager.database) {
+    : block_manager(*manager.block_manager), buffer_manager(*manager.buffer_manager), database(manager.database) {
 }
 
-void CheckpointManager::CreateCheckpoint() {
+void CheckpointManager::CreateCheckpoint(bool compact) {
 	// assert that the checkpoint manager hasn't been used before
 	assert(!metadata_writer);
+	this->compact = compact;
 
 	auto transaction = database.transaction_manager->StartTransaction();
 
@@ -63,10 +84,29 @@ void CheckpointManager::CreateCheckpoint() {
 	metadata_writer->Flush();
 	tabledata_writer->Flush();
 
+	// mark the WAL as stored in this checkpoint, in case the database crashes before the WAL is truncated
+	auto wal = database.storage->GetWriteAheadLog();
+	if (wal) {
+		wal->WriteCheckpoint(meta_block);
+	}
+
 	// finally write the updated header
 	DatabaseHeader header;
 	header.meta_block = meta_block;
 	block_manager.WriteHeader(header);
+
+	// the transaction only served as a snapshot of the database
+	database.transaction_manager->RollbackTransaction(transaction);
+
+	// the rows of the compacted tables have new row ids: reload the tables from the checkpoint, after which the blocks
+	// they were loaded from can be reused
+	for (auto &entry : compacted_tables) {
+		auto &storage = *entry.first;
+		MarkTableBlocks(*storage.persistent_data,
+		                [&](block_id_t block_id) { block_manager.MarkBlockAsLoaded(block_id); });
+		storage.ReplaceTableData(move(storage.persistent_data));
+		MarkTableBlocks(*entry.second, [&](block_id_t block_id) { block_manager.ReleaseLoadedBlock(block_id); });
+	}
 }
 
 void CheckpointManager::LoadFromStorage() {
@@ -124,7 +164,6 @@ void CheckpointManager::WriteSchema(Transaction &transaction, SchemaCatalogEntry
 	for (auto &view : views) {
 		WriteView(transaction, *view);
 	}
-	// FIXME: free list?
 }
 
 void CheckpointManager::ReadSchema(ClientContext &context, MetaBlockReader &reader) {
@@ -187,9 +226,93 @@ void CheckpointManager::WriteTable(Transaction &transaction, TableCatalogEntry &
 	metadata_writer->Write<block_id_t>(tabledata_writer->block->id);
 	//! and the offset to where the info starts
 	metadata_writer->Write<uint64_t>(tabledata_writer->offset);
-	// now we need to write the table data
-	TableDataWriter writer(*this, table);
-	writer.WriteTableData(transaction);
+	// now we need to write the table data, unless the data of the previous checkpoint is still up to date
+	auto &storage = *table.storage;
+	if (compact && storage.indexes.size() == 0 && storage.persistent_data && storage.persistent_data->ShouldCompact()) {
+		// rewrite the table without its deleted rows
+		TableDataWriter writer(*this, table);
+		auto data = writer.WriteTableData(transaction, true);
+		compacted_tables.push_back(make_pair(&storage, move(storage.persistent_data)));
+		storage.persistent_data = move(data);
+	} else if (storage.dirty.exchange(false) || !storage.persistent_data) {
+		TableDataWriter writer(*this, table);
+		storage.persistent_data = writer.WriteTableData(transaction);
+		// the stored rows are loaded as persistent rows after a restart
+		storage.checkpointed_rows = storage.persistent_data->RowCount();
+	}
+	if (storage.persistent_data->indexes.size() == 0) {
+		// the data was rewritten, or the indexes could not be stored by the previous checkpoint
+		WriteIndexes(transaction, table, *storage.persistent_data);
+	}
+	WriteTableData(*storage.persistent_data);
+}
+
+void CheckpointManager::WriteIndexes(Transaction &transaction, TableCatalogEntry &table, PersistentTableData &data) {
+	// the first indexes of a table are the indexes of its UNIQUE and PRIMARY KEY constraints
+	index_t index_count = 0;
+	for (auto &constraint : table.bound_constraints) {
+		if (constraint->type == ConstraintType::UNIQUE) {
+			index_count++;
+		}
+	}
+	if (index_count == 0) {
+		return;
+	}
+	// an index also contains the entries of the versions of the rows that are not visible to the checkpoint. The
+	// indexes can only be stored if there are no such versions, otherwise they are rebuilt when the table is loaded.
+	auto lock = database.transaction_manager->LockIfOnlyTransaction(&transaction);
+	if (!lock.owns_lock()) {
+		return;
+	}
+	auto &storage = *table.storage;
+	assert(storage.indexes.size() >= index_count);
+	for (index_t i = 0; i < index_count; i++) {
+		// every index is written to its own blocks, so they can be reused by a later checkpoint
+		MetaBlockWriter writer(block_manager);
+		PersistentIndexData index;
+		index.root = storage.indexes[i]->Serialize(writer);
+		writer.Flush();
+		index.blocks = writer.written_blocks;
+		data.indexes.push_back(move(index));
+	}
+}
+
+void CheckpointManager::WriteTableData(PersistentTableData &data) {
+	for (auto &data_pointer_list : data.data_pointers) {
+		tabledata_writer->Write<index_t>(data_pointer_list.size());
+		// then write the data pointers themselves
+		for (auto &data_pointer : data_pointer_list) {
+			tabledata_writer->WriteData(data_pointer.min, sizeof(data_pointer.min));
+			tabledata_writer->WriteData(data_pointer.max, sizeof(data_pointer.max));
+			tabledata_writer->Write<bool>(data_pointer.has_null);
+			tabledata_writer->Write<index_t>(data_pointer.row_start);
+			tabledata_writer->Write<index_t>(data_pointer.tuple_count);
+			tabledata_writer->Write<block_id_t>(data_pointer.block_id);
+			tabledata_writer->Write<uint32_t>(data_pointer.offset);
+			tabledata_writer->Write<index_t>(data_pointer.overflow_blocks.size());
+			for (auto &block_id : data_pointer.overflow_blocks) {
+				tabledata_writer->Write<block_id_t>(block_id);
+			}
+		}
+	}
+	// the blocks of the segments are part of this checkpoint, even if they were written by an earlier one
+	MarkTableBlocks(data, [&](block_id_t block_id) { block_manager.MarkBlockAsUsed(block_id); });
+	// finally write the ranges of deleted rows
+	tabledata_writer->Write<index_t>(data.deleted_rows.size());
+	for (auto &range : data.deleted_rows) {
+		tabledata_writer->Write<row_t>(range.first);
+		tabledata_writer->Write<index_t>(range.second);
+	}
+	// and the positions of the stored indexes
+	tabledata_writer->Write<index_t>(data.indexes.size());
+	for (auto &index : data.indexes) {
+		tabledata_writer->Write<block_id_t>(index.root.block_id);
+		tabledata_writer->Write<uint32_t>(index.root.offset);
+		tabledata_writer->Write<index_t>(index.blocks.size());
+		for (auto &block_id : index.blocks) {
+			tabledata_writer->Write<block_id_t>(block_id);
+		}
+	}
 }
 
 void CheckpointManager::ReadTable(ClientContext &context, MetaBlockReader &reader) {
@@ -206,6 +329,10 @@ void CheckpointManager::ReadTable(ClientContext &context, MetaBlockReader &reade
 	table_data_reader.offset = offset;
 	TableDataReader data_reader(*this, table_data_reader, *bound_info);
 	data_reader.ReadTableData();
+	// the persistent segments and the stored indexes of the table refer to its blocks: they cannot be reused while the
+	// table is loaded
+	MarkTableBlocks(*bound_info->data, [&](block_id_t block_id) { block_manager.MarkBlockAsLoaded(block_id); });
+	compact_tables = compact_tables || bound_info->data->ShouldCompact();
 
 	// finally create the table in the catalog
 	database.catalog->CreateTable(context.ActiveTransaction(), bound_info.get());
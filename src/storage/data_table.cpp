@@ -6,8 +6,11 @@
 #include "common/vector_operations/vector_operations.hpp"
 #include "common/types/static_vector.hpp"
 #include "execution/expression_executor.hpp"
+#include "execution/task_scheduler.hpp"
 #include "main/client_context.hpp"
+#include "main/database.hpp"
 #include "planner/constraints/list.hpp"
+#include "storage/storage_manager.hpp"
 #include "transaction/transaction.hpp"
 #include "transaction/transaction_manager.hpp"
 #include "storage/table/transient_segment.hpp"
@@ -18,8 +21,9 @@ using namespace duckdb;
 using namespace std;
 
 DataTable::DataTable(StorageManager &storage, string schema, string table, vector<TypeId> types_,
-                     unique_ptr<vector<unique_ptr<PersistentSegment>>[]> data)
-    : cardinality(0), schema(schema), table(table), types(types_), storage(storage) {
+                     unique_ptr<PersistentTableData> data)
+    : cardinality(0), schema(schema), table(table), types(types_), storage(storage), persistent_rows(0), checkpointed_rows(0), dirty(true),
+      first_modified_row(std::numeric_limits<row_t>::max()) {
 	index_t accumulative_size = 0;
 	for (index_t i = 0; i < types.size(); i++) {
 		accumulative_tuple_size.push_back(accumulative_size);
@@ -30,8 +34,14 @@ DataTable::DataTable(StorageManager &storage, string schema, string table, vecto
 	// set up the segment trees for the column segments
 	columns = unique_ptr<SegmentTree[]>(new SegmentTree[types.size()]);
 
+	LoadTable(move(data));
+}
+
+void DataTable::LoadTable(unique_ptr<PersistentTableData> data) {
 	// initialize the table with the existing data from disk
 	index_t current_row = InitializeTable(move(data));
+	persistent_rows = current_row;
+	checkpointed_rows = current_row;
 
 	// now initialize the transient segments and the transient version chunk
 	for (index_t i = 0; i < types.size(); i++) {
@@ -41,17 +51,36 @@ DataTable::DataTable(StorageManager &storage, string schema, string table, vecto
 	AppendVersionChunk(current_row);
 }
 
-index_t DataTable::InitializeTable(unique_ptr<vector<unique_ptr<PersistentSegment>>[]> data) {
-	if (!data || data[0].size() == 0) {
+void DataTable::ReplaceTableData(unique_ptr<PersistentTableData> data) {
+	assert(indexes.size() == 0);
+	// drop the current storage of the table
+	storage_tree.nodes.clear();
+	storage_tree.root_node.reset();
+	for (index_t i = 0; i < types.size(); i++) {
+		columns[i].nodes.clear();
+		columns[i].root_node.reset();
+	}
+	LoadTable(move(data));
+}
+
+index_t DataTable::InitializeTable(unique_ptr<PersistentTableData> data) {
+	if (!data || data->data_pointers[0].size() == 0) {
 		// no data: nothing to set up
 		return 0;
 	}
 
 	index_t current_row = 0;
 
-	// first append all the segments to the set of column segments
+	// first create the persistent segments of the columns
 	for (index_t i = 0; i < types.size(); i++) {
-		for (auto &segment : data[i]) {
+		for (auto &data_pointer : data->data_pointers[i]) {
+			auto segment = make_unique<PersistentSegment>(*storage.buffer_manager, data_pointer.block_id,
+			                                              data_pointer.offset, types[i], data_pointer.row_start,
+			                                              data_pointer.tuple_count);
+			// set the statistics of the segment
+			memcpy(segment->stats.minimum.get(), data_pointer.min, segment->type_size);
+			memcpy(segment->stats.maximum.get(), data_pointer.max, segment->type_size);
+			segment->stats.has_null = data_pointer.has_null;
 			columns[i].AppendSegment(move(segment));
 		}
 	}
@@ -99,6 +128,20 @@ index_t DataTable::InitializeTable(unique_ptr<vector<unique_ptr<PersistentSegmen
 		current_row += chunk->count;
 		storage_tree.AppendSegment(move(chunk));
 	}
+
+	// mark the deleted rows as deleted again
+	index_t deleted_count = 0;
+	for (auto &range : data->deleted_rows) {
+		for (row_t row = range.first; row < range.first + (row_t)range.second; row++) {
+			auto chunk = GetChunk(row);
+			chunk->SetDeleted(row - chunk->start);
+		}
+		deleted_count += range.second;
+	}
+	cardinality = current_row - deleted_count;
+	// the table is not modified until changes to it are committed: the next checkpoint can reuse the stored data
+	persistent_data = move(data);
+	dirty = false;
 	return current_row;
 }
 
@@ -167,8 +210,11 @@ static void VerifyCheckConstraint(TableCatalogEntry &table, Expression &expr, Da
 }
 
 static void VerifyUniqueConstraint(TableCatalogEntry &table, unordered_set<index_t> &keys, DataChunk &chunk) {
-	// not implemented for multiple keys
-	assert(keys.size() == 1);
+	if (keys.size() > 1) {
+		// the combination of the columns can be unique while the individual columns are not: the unique index checks
+		// the combined keys
+		return;
+	}
 	// check if the columns are unique
 	for (auto &key : keys) {
 		if (!VectorOperations::Unique(chunk.data[key])) {
@@ -203,7 +249,7 @@ void DataTable::VerifyAppendConstraints(TableCatalogEntry &table, DataChunk &chu
 	}
 }
 
-void DataTable::AppendToIndexes(DataChunk &chunk, row_t row_start) {
+void DataTable::AppendToIndexes(DataChunk &chunk, row_t row_start, Vector *replaced_rows) {
 	if (indexes.size() == 0) {
 		return;
 	}
@@ -216,7 +262,9 @@ void DataTable::AppendToIndexes(DataChunk &chunk, row_t row_start) {
 	index_t failed_index = INVALID_INDEX;
 	// now append the entries to the indices
 	for (index_t i = 0; i < indexes.size(); i++) {
-		if (!indexes[i]->Append(chunk, row_identifiers)) {
+		bool success = replaced_rows ? indexes[i]->Replace(chunk, row_identifiers, *replaced_rows)
+		                             : indexes[i]->Append(chunk, row_identifiers);
+		if (!success) {
 			failed_index = i;
 			break;
 		}
@@ -231,7 +279,7 @@ void DataTable::AppendToIndexes(DataChunk &chunk, row_t row_start) {
 	}
 }
 
-void DataTable::Append(TableCatalogEntry &table, ClientContext &context, DataChunk &chunk) {
+void DataTable::Append(TableCatalogEntry &table, ClientContext &context, DataChunk &chunk, Vector *replaced_rows) {
 	if (chunk.size() == 0) {
 		return;
 	}
@@ -259,7 +307,7 @@ void DataTable::Append(TableCatalogEntry &table, ClientContext &context, DataChu
 		row_start = last_chunk->start + last_chunk->count;
 
 		// Append the entries to the indexes, we do this first because this might fail in case of unique index conflicts
-		AppendToIndexes(chunk, row_start);
+		AppendToIndexes(chunk, row_start, replaced_rows);
 
 		Transaction &transaction = context.ActiveTransaction();
 		index_t remainder = chunk.size();
@@ -409,13 +457,32 @@ void DataTable::VerifyUpdateConstraints(TableCatalogEntry &table, DataChunk &chu
 	}
 }
 
-void DataTable::UpdateIndexes(TableCatalogEntry &table, vector<column_t> &column_ids, DataChunk &updates,
-                              Vector &row_identifiers) {
-	if (indexes.size() == 0) {
+void DataTable::UpdateIndexes(TableCatalogEntry &table, VersionChunk &chunk, vector<column_t> &column_ids,
+                              DataChunk &updates, Vector &row_identifiers) {
+	bool index_is_updated = false;
+	for (auto &index : indexes) {
+		index_is_updated = index_is_updated || index->IndexIsUpdated(column_ids);
+	}
+	if (!index_is_updated) {
 		return;
 	}
-	// first create a mock chunk to be used in the index appends
-	DataChunk mock_chunk;
+	// fetch the current values of the updated columns: the index only gets the keys that the update changes
+	vector<TypeId> update_types;
+	for (auto &column_id : column_ids) {
+		update_types.push_back(types[column_id]);
+	}
+	DataChunk current_values;
+	current_values.Initialize(update_types);
+	auto ids = (row_t *)row_identifiers.data;
+	VectorOperations::Exec(row_identifiers, [&](index_t i, index_t k) {
+		for (index_t col_idx = 0; col_idx < column_ids.size(); col_idx++) {
+			chunk.columns[column_ids[col_idx]].segment->Fetch(current_values.data[col_idx], ids[i]);
+		}
+	});
+
+	// now create mock chunks to be used in the index updates
+	DataChunk current_chunk, mock_chunk;
+	CreateMockChunk(table, column_ids, current_values, current_chunk);
 	CreateMockChunk(table, column_ids, updates, mock_chunk);
 
 	index_t failed_index = INVALID_INDEX;
@@ -425,8 +492,8 @@ void DataTable::UpdateIndexes(TableCatalogEntry &table, vector<column_t> &column
 		if (!indexes[i]->IndexIsUpdated(column_ids)) {
 			continue;
 		}
-		// if it is, we append the data to the index
-		if (!indexes[i]->Append(mock_chunk, row_identifiers)) {
+		// if it is, we update the index
+		if (!indexes[i]->Update(current_chunk, mock_chunk, row_identifiers)) {
 			failed_index = i;
 			break;
 		}
@@ -436,7 +503,7 @@ void DataTable::UpdateIndexes(TableCatalogEntry &table, vector<column_t> &column
 		// remove any appended entries from previous indexes (if any)
 		for (index_t i = 0; i < failed_index; i++) {
 			if (indexes[i]->IndexIsUpdated(column_ids)) {
-				indexes[i]->Delete(mock_chunk, row_identifiers);
+				indexes[i]->Delete(mock_chunk, current_chunk, row_identifiers);
 			}
 		}
 		throw ConstraintException("PRIMARY KEY or UNIQUE constraint violated: duplicated key");
@@ -463,8 +530,59 @@ void DataTable::Update(TableCatalogEntry &table, ClientContext &context, Vector
 	// first find the chunk the row ids belong to
 	auto chunk = GetChunk(first_id);
 
-	if (chunk->type == VersionChunkType::PERSISTENT) {
-		// persistent chunk, we can't do an in-place update here
+	// the rows of the last checkpoint are updated like persistent rows, even if they are still stored in a transient
+	// chunk: the update is then replayed from the WAL in the same way
+	row_t checkpointed_end = checkpointed_rows;
+	index_t checkpointed_count = 0;
+	VectorOperations::Exec(row_identifiers, [&](index_t i, index_t k) {
+		if (ids[i] < checkpointed_end) {
+			checkpointed_count++;
+		}
+	});
+	assert(chunk->type != VersionChunkType::PERSISTENT || checkpointed_count == row_identifiers.count);
+	if (checkpointed_count > 0 && checkpointed_count < row_identifiers.count) {
+		// the vector contains both checkpointed and newer rows: update them separately
+		updates.Flatten();
+		row_identifiers.Flatten();
+		ids = (row_t *)row_identifiers.data;
+		auto update_count = row_identifiers.count;
+		sel_t checkpointed_sel[STANDARD_VECTOR_SIZE], transient_sel[STANDARD_VECTOR_SIZE];
+		index_t transient_count = 0;
+		checkpointed_count = 0;
+		for (index_t i = 0; i < update_count; i++) {
+			if (ids[i] < checkpointed_end) {
+				checkpointed_sel[checkpointed_count++] = i;
+			} else {
+				transient_sel[transient_count++] = i;
+			}
+		}
+		// every part references the flattened vectors, as the update of a part can flatten its vectors again
+		vector<TypeId> update_types;
+		for (index_t i = 0; i < updates.column_count; i++) {
+			update_types.push_back(updates.data[i].type);
+		}
+		auto update_rows = [&](sel_t *sel, index_t count) {
+			Vector part_ids;
+			part_ids.Reference(row_identifiers);
+			part_ids.sel_vector = sel;
+			part_ids.count = count;
+			DataChunk part_updates;
+			part_updates.InitializeEmpty(update_types);
+			for (index_t i = 0; i < updates.column_count; i++) {
+				part_updates.data[i].Reference(updates.data[i]);
+				part_updates.data[i].sel_vector = sel;
+				part_updates.data[i].count = count;
+			}
+			part_updates.sel_vector = sel;
+			Update(table, context, part_ids, column_ids, part_updates);
+		};
+		update_rows(checkpointed_sel, checkpointed_count);
+		update_rows(transient_sel, transient_count);
+		return;
+	}
+
+	if (checkpointed_count > 0) {
+		// persistent rows, we can't do an in-place update here
 		// first fetch the existing columns for any non-updated columns
 		updates.Flatten();
 		row_identifiers.Flatten();
@@ -504,8 +622,8 @@ void DataTable::Update(TableCatalogEntry &table, ClientContext &context, Vector
 			}
 		}
 
-		// append the new set of rows
-		Append(table, context, append_chunk);
+		// append the new set of rows, which replace the current set of rows in the indexes
+		Append(table, context, append_chunk, &row_identifiers);
 
 		// finally delete the current set of rows
 		Delete(table, context, row_identifiers);
@@ -539,7 +657,7 @@ void DataTable::Update(TableCatalogEntry &table, ClientContext &context, Vector
 	});
 
 	// now we update any indexes, we do this before inserting anything into the undo buffer
-	UpdateIndexes(table, column_ids, updates, row_identifiers);
+	UpdateIndexes(table, *chunk, column_ids, updates, row_identifiers);
 
 	// now we know there are no conflicts, move the tuples into the undo buffer and mark the chunk as dirty
 	VectorOperations::Exec(row_identifiers, [&](index_t i, index_t k) {
@@ -579,6 +697,19 @@ void DataTable::Scan(Transaction &transaction, DataChunk &result, const vector<c
 	// scan the base table
 	while (state.chunk) {
 		auto current_chunk = state.chunk;
+		if (state.offset == 0 && state.table_filters && current_chunk->SkipScan(state)) {
+			// none of the rows of the chunk can satisfy the filters: skip the entire chunk
+			if (state.chunk == state.last_chunk) {
+				state.chunk = nullptr;
+				break;
+			}
+			state.chunk = (VersionChunk *)current_chunk->next.get();
+			for (index_t i = 0; i < types.size(); i++) {
+				state.columns[i].segment = state.chunk->columns[i].segment;
+				state.columns[i].offset = state.chunk->columns[i].offset;
+			}
+			continue;
+		}
 
 		// scan the current chunk
 		bool is_last_segment = current_chunk->Scan(state, transaction, result, column_ids, state.offset);
@@ -602,6 +733,43 @@ void DataTable::Scan(Transaction &transaction, DataChunk &result, const vector<c
 	}
 }
 
+void DataTable::InitializeParallelScan(ParallelTableScanState &state) {
+	state.next_chunk = (VersionChunk *)storage_tree.GetRootSegment();
+	state.last_chunk = (VersionChunk *)storage_tree.GetLastSegment();
+	state.last_chunk_count = state.last_chunk->count;
+	state.next_morsel = 0;
+	state.morsel_count = 1;
+	for (auto chunk = state.next_chunk; chunk != state.last_chunk; chunk = (VersionChunk *)chunk->next.get()) {
+		state.morsel_count++;
+	}
+}
+
+bool DataTable::NextParallelScanMorsel(ParallelTableScanState &state, TableScanState &scan_state,
+                                       index_t &morsel_index) {
+	VersionChunk *chunk;
+	{
+		lock_guard<mutex> parallel_lock(state.lock);
+		if (!state.next_chunk) {
+			// all morsels have been handed out
+			return false;
+		}
+		chunk = state.next_chunk;
+		morsel_index = state.next_morsel++;
+		state.next_chunk = chunk == state.last_chunk ? nullptr : (VersionChunk *)chunk->next.get();
+	}
+	// set up the scan state to only scan this chunk
+	scan_state.chunk = chunk;
+	scan_state.last_chunk = chunk;
+	scan_state.last_chunk_count = chunk == state.last_chunk ? state.last_chunk_count : chunk->count;
+	for (index_t i = 0; i < types.size(); i++) {
+		scan_state.columns[i].segment = chunk->columns[i].segment;
+		scan_state.columns[i].offset = chunk->columns[i].offset;
+	}
+	scan_state.offset = 0;
+	scan_state.version_chain = nullptr;
+	return true;
+}
+
 void DataTable::Fetch(Transaction &transaction, DataChunk &result, vector<column_t> &column_ids,
                       Vector &row_identifiers) {
 	assert(row_identifiers.type == ROW_TYPE);
@@ -712,8 +880,10 @@ void DataTable::AddIndex(unique_ptr<Index> index, vector<unique_ptr<Expression>>
 		// resolve the expressions for this chunk
 		ExpressionExecutor executor(intermediate);
 		executor.Execute(expressions, result);
-		// insert into the index
-		index->Insert(result, intermediate.data[intermediate.column_count - 1]);
+		// pass the entries to the index
+		index->BuildAppend(result, intermediate.data[intermediate.column_count - 1]);
 	}
+	// the locks on the table are held until the index is complete
+	index->FinalizeBuild(*storage.GetDatabase().scheduler);
 	indexes.push_back(move(index));
 }
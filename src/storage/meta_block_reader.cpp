@@ -1,20 +1,32 @@
 #include "storage/meta_block_reader.hpp"
+#include "storage/buffer_manager.hpp"
 
 using namespace duckdb;
 using namespace std;
 
 MetaBlockReader::MetaBlockReader(BlockManager &manager, block_id_t block_id)
-    : manager(manager), block(make_unique<Block>(-1)), offset(0), next_block(-1) {
+    : manager(manager), block(make_unique<Block>(-1)), offset(0), next_block(-1), buffer_manager(nullptr),
+      current_block(nullptr) {
 	ReadNewBlock(block_id);
 }
 
+MetaBlockReader::MetaBlockReader(BufferManager &buffer_manager, BlockPointer pointer)
+    : manager(buffer_manager.manager), offset(0), next_block(-1), buffer_manager(&buffer_manager),
+      current_block(nullptr) {
+	ReadNewBlock(pointer.block_id);
+	offset = pointer.offset;
+}
+
+MetaBlockReader::~MetaBlockReader() {
+}
+
 void MetaBlockReader::ReadData(data_ptr_t buffer, index_t read_size) {
-	while (offset + read_size > block->size) {
+	while (offset + read_size > current_block->size) {
 		// cannot read entire entry from block
 		// first read what we can from this block
-		index_t to_read = block->size - offset;
+		index_t to_read = current_block->size - offset;
 		if (to_read > 0) {
-			memcpy(buffer, block->buffer + offset, to_read);
+			memcpy(buffer, current_block->buffer + offset, to_read);
 			read_size -= to_read;
 			buffer += to_read;
 		}
@@ -22,13 +34,19 @@ void MetaBlockReader::ReadData(data_ptr_t buffer, index_t read_size) {
 		ReadNewBlock(next_block);
 	}
 	// we have enough left in this block to read from the buffer
-	memcpy(buffer, block->buffer + offset, read_size);
+	memcpy(buffer, current_block->buffer + offset, read_size);
 	offset += read_size;
 }
 
 void MetaBlockReader::ReadNewBlock(block_id_t id) {
-	block->id = id;
-	manager.Read(*block);
-	next_block = *((block_id_t *)block->buffer);
+	if (buffer_manager) {
+		handle = buffer_manager->Pin(id);
+		current_block = handle->node;
+	} else {
+		block->id = id;
+		manager.Read(*block);
+		current_block = block.get();
+	}
+	next_block = *((block_id_t *)current_block->buffer);
 	offset = sizeof(block_id_t);
 }
@@ -6,6 +6,7 @@ using namespace std;
 MetaBlockWriter::MetaBlockWriter(BlockManager &manager) : manager(manager) {
 	block = manager.CreateBlock();
 	offset = sizeof(block_id_t);
+	written_blocks.push_back(block->id);
 }
 
 MetaBlockWriter::~MetaBlockWriter() {
@@ -33,6 +34,7 @@ void MetaBlockWriter::WriteData(const_data_ptr_t buffer, index_t write_size) {
 		}
 		// now we need to get a new block id
 		block_id_t new_block_id = manager.GetFreeBlockId();
+		written_blocks.push_back(new_block_id);
 		// write the block id of the new block to the start of the current block
 		*((block_id_t *)block->buffer) = new_block_id;
 		// first flush the old block
@@ -101,15 +101,18 @@ void SingleFileBlockManager::Initialize(DatabaseHeader &header) {
 }
 
 block_id_t SingleFileBlockManager::GetFreeBlockId() {
+	block_id_t block;
 	if (free_list.size() > 0) {
 		// free list is non empty
 		// take an entry from the free list
-		block_id_t block = free_list.back();
+		block = free_list.back();
 		// erase the entry from the free list again
 		free_list.pop_back();
-		return block;
+	} else {
+		block = max_block++;
 	}
-	return max_block++;
+	checkpoint_blocks.insert(block);
+	return block;
 }
 
 block_id_t SingleFileBlockManager::GetMetaBlock() {
@@ -122,7 +125,6 @@ unique_ptr<Block> SingleFileBlockManager::CreateBlock() {
 
 void SingleFileBlockManager::Read(Block &block) {
 	assert(block.id >= 0);
-	used_blocks.push_back(block.id);
 	block.Read(*handle, BLOCK_START + block.id * BLOCK_SIZE);
 }
 
@@ -131,29 +133,62 @@ void SingleFileBlockManager::Write(Block &block) {
 	block.Write(*handle, BLOCK_START + block.id * BLOCK_SIZE);
 }
 
-void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
-	if (!use_direct_io) {
-		// if we are not using Direct IO we need to fsync BEFORE we write the header to ensure that all the previous
-		// blocks are written as well
-		handle->Sync();
+void SingleFileBlockManager::MarkBlockAsUsed(block_id_t block_id) {
+	assert(block_id >= 0 && block_id < max_block);
+	checkpoint_blocks.insert(block_id);
+}
+
+void SingleFileBlockManager::MarkBlockAsLoaded(block_id_t block_id) {
+	assert(block_id >= 0 && block_id < max_block);
+	loaded_blocks.insert(block_id);
+}
+
+void SingleFileBlockManager::ReleaseLoadedBlock(block_id_t block_id) {
+	assert(checkpoint_blocks.find(block_id) == checkpoint_blocks.end());
+	if (loaded_blocks.erase(block_id) > 0) {
+		// the block was added to the free list of the last checkpoint, but could not be reused until now
+		free_list.push_back(block_id);
 	}
+}
+
+void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 	// set the iteration count
 	header.iteration = ++iteration_count;
+	// reserve the blocks to write the free list to, which can contain (almost) every block of the file
+	index_t free_list_size = sizeof(uint64_t) + max_block * sizeof(block_id_t);
+	index_t free_list_block_count = free_list_size / (BLOCK_SIZE - 2 * sizeof(block_id_t)) + 1;
+	vector<block_id_t> reserved_blocks;
+	for (index_t i = 0; i < free_list_block_count; i++) {
+		reserved_blocks.push_back(GetFreeBlockId());
+	}
+	// every block that is not used by the new checkpoint is free after the header is written
+	vector<block_id_t> free_blocks;
+	for (block_id_t block = 0; block < max_block; block++) {
+		if (checkpoint_blocks.find(block) == checkpoint_blocks.end()) {
+			free_blocks.push_back(block);
+		}
+	}
 	header.block_count = max_block;
-	// now handle the free list
-	if (used_blocks.size() > 0) {
-		// there are blocks in the free list
-		// write them to the file
+	if (free_blocks.size() > 0) {
+		// write the free list to the reserved blocks
+		free_list.assign(reserved_blocks.rbegin(), reserved_blocks.rend());
 		MetaBlockWriter writer(*this);
 		header.free_list = writer.block->id;
-		writer.Write<uint64_t>(used_blocks.size());
-		for (auto &block_id : used_blocks) {
+		writer.Write<uint64_t>(free_blocks.size());
+		for (auto &block_id : free_blocks) {
 			writer.Write<block_id_t>(block_id);
 		}
 		writer.Flush();
+		assert(max_block == (block_id_t)header.block_count);
 	} else {
 		// no blocks in the free list
 		header.free_list = INVALID_BLOCK;
+		free_list = reserved_blocks;
+	}
+	if (!use_direct_io) {
+		// if we are not using Direct IO we need to fsync BEFORE we write the header to ensure that all the previous
+		// blocks are written as well
+		handle->Sync();
 	}
 	// set the header inside the buffer
 	header_buffer.Clear();
@@ -166,6 +201,12 @@ void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 	//! Ensure the header write ends up on disk
 	handle->Sync();
 
-	// the free list is now equal to the blocks that were used by the previous iteration
-	free_list = used_blocks;
+	// the free blocks can now be reused, as long as the loaded persistent segments do not refer to them
+	// the reserved blocks that were not needed for the free list are not used by the checkpoint either
+	for (auto &block_id : free_blocks) {
+		if (loaded_blocks.find(block_id) == loaded_blocks.end()) {
+			free_list.push_back(block_id);
+		}
+	}
+	checkpoint_blocks.clear();
 }
@@ -5,6 +5,6 @@ using namespace std;
 
 namespace duckdb {
 
-const uint64_t VERSION_NUMBER = 1;
+const uint64_t VERSION_NUMBER = 6;
 
 } // namespace duckdb
@@ -15,27 +15,49 @@ StorageLockKey::~StorageLockKey() {
 	}
 }
 
-StorageLock::StorageLock() : read_count(0) {
+constexpr index_t StorageLock::EXCLUSIVE_FLAG;
+
+StorageLock::StorageLock() : lock_state(0) {
 }
 
 unique_ptr<StorageLockKey> StorageLock::GetExclusiveLock() {
 	exclusive_lock.lock();
-	while (read_count != 0) {
-	}
+	// new readers wait from here on, wait for the current ones to leave
+	lock_state.fetch_or(EXCLUSIVE_FLAG);
+	unique_lock<mutex> lock(wait_lock);
+	state_changed.wait(lock, [&]() { return lock_state.load() == EXCLUSIVE_FLAG; });
 	return make_unique<StorageLockKey>(*this, StorageLockType::EXCLUSIVE);
 }
 
 unique_ptr<StorageLockKey> StorageLock::GetSharedLock() {
-	exclusive_lock.lock();
-	read_count++;
-	exclusive_lock.unlock();
-	return make_unique<StorageLockKey>(*this, StorageLockType::SHARED);
+	auto state = lock_state.load();
+	while (true) {
+		if (state & EXCLUSIVE_FLAG) {
+			// there is a writer: wait until it releases the lock
+			unique_lock<mutex> lock(wait_lock);
+			state_changed.wait(lock, [&]() { return !(lock_state.load() & EXCLUSIVE_FLAG); });
+			state = lock_state.load();
+			continue;
+		}
+		if (lock_state.compare_exchange_weak(state, state + 1)) {
+			return make_unique<StorageLockKey>(*this, StorageLockType::SHARED);
+		}
+	}
 }
 
 void StorageLock::ReleaseExclusiveLock() {
+	{
+		lock_guard<mutex> lock(wait_lock);
+		lock_state.fetch_and(~EXCLUSIVE_FLAG);
+	}
+	state_changed.notify_all();
 	exclusive_lock.unlock();
 }
 
 void StorageLock::ReleaseSharedLock() {
-	read_count--;
+	if (lock_state.fetch_sub(1) == EXCLUSIVE_FLAG + 1) {
+		// the last reader left while a writer is waiting: wake it up
+		lock_guard<mutex> lock(wait_lock);
+		state_changed.notify_all();
+	}
 }
@@ -1,6 +1,7 @@
 #include "storage/storage_manager.hpp"
 #include "storage/checkpoint_manager.hpp"
 #include "storage/single_file_block_manager.hpp"
+#include "storage/buffer_manager.hpp"
 
 #include "catalog/catalog.hpp"
 #include "common/file_system.hpp"
@@ -10,7 +11,6 @@
 #include "parser/parsed_data/create_schema_info.hpp"
 #include "transaction/transaction_manager.hpp"
 #include "planner/binder.hpp"
-#include "common/serializer/buffered_file_reader.hpp"
 
 using namespace duckdb;
 using namespace std;
@@ -50,35 +50,9 @@ void StorageManager::Initialize() {
 	}
 }
 
-void StorageManager::Checkpoint(string wal_path) {
-	if (!database.file_system->FileExists(wal_path)) {
-		// no WAL to checkpoint
-		return;
-	}
-	if (read_only) {
-		// cannot checkpoint in read-only system
-		return;
-	}
-	// check the size of the WAL
-	{
-		BufferedFileReader reader(*database.file_system, wal_path.c_str());
-		if (reader.FileSize() <= database.checkpoint_wal_size) {
-			// WAL is too small
-			return;
-		}
-	}
-
-	// checkpoint the database
-	// FIXME: we do this now by creating a new database and forcing a checkpoint in that database
-	// then reloading the file again
-	// this should be fixed and turned into an incremental checkpoint
-	DBConfig config;
-	config.checkpoint_only = true;
-	DuckDB db(path, &config);
-}
-
 void StorageManager::LoadDatabase() {
 	string wal_path = path + ".wal";
+	bool compact_tables = false;
 	// first check if the database exists
 	if (!database.file_system->FileExists(path)) {
 		if (read_only) {
@@ -94,31 +68,51 @@ void StorageManager::LoadDatabase() {
 		// initialize the block manager while creating a new db file
 		block_manager =
 		    make_unique<SingleFileBlockManager>(*database.file_system, path, read_only, true, database.use_direct_io);
+		buffer_manager = make_unique<BufferManager>(*block_manager, database.maximum_memory);
 	} else {
-		if (!database.checkpoint_only) {
-			Checkpoint(wal_path);
-		}
 		// initialize the block manager while loading the current db file
 		block_manager =
 		    make_unique<SingleFileBlockManager>(*database.file_system, path, read_only, false, database.use_direct_io);
+		buffer_manager = make_unique<BufferManager>(*block_manager, database.maximum_memory);
 		//! Load from storage
 		CheckpointManager checkpointer(*this);
 		checkpointer.LoadFromStorage();
+		compact_tables = checkpointer.compact_tables;
 		// check if the WAL file exists
 		if (database.file_system->FileExists(wal_path)) {
 			// replay the WAL
-			WriteAheadLog::Replay(database, wal_path);
-			if (database.checkpoint_only) {
-				assert(!read_only);
-				// checkpoint the database
-				checkpointer.CreateCheckpoint();
-				// remove the WAL
+			bool truncate_wal = WriteAheadLog::Replay(database, wal_path);
+			if (truncate_wal && !read_only) {
+				// the WAL was already stored in the checkpoint but not truncated yet: remove it
 				database.file_system->RemoveFile(wal_path);
 			}
 		}
 	}
 	// initialize the WAL file
-	if (!database.checkpoint_only && !read_only) {
+	if (!read_only) {
 		wal.Initialize(wal_path);
+		// checkpoint the replayed WAL if it is too large
+		CreateCheckpoint(false);
+		if (compact_tables && wal.GetWALSize() == 0) {
+			// nothing refers to the row ids of the tables yet: compact the tables that contain many deleted rows
+			CreateCheckpoint(true, true);
+		}
+	}
+}
+
+void StorageManager::CreateCheckpoint(bool force, bool compact) {
+	if (!wal.initialized) {
+		// in-memory or read-only database: nothing to checkpoint
+		return;
+	}
+	// block any commits while the checkpoint is created
+	auto lock = checkpoint_lock.GetExclusiveLock();
+	if (!force && wal.GetWALSize() <= database.checkpoint_wal_size) {
+		// WAL is too small
+		return;
 	}
+	CheckpointManager checkpointer(*this);
+	checkpointer.CreateCheckpoint(compact);
+	// the WAL entries are now stored in the checkpoint
+	wal.Truncate();
 }
@@ -1,5 +1,10 @@
 #include "storage/table/column_segment.hpp"
 
+#include "common/exception.hpp"
+#include "storage/table_filter.hpp"
+
+#include <cstring>
+
 using namespace duckdb;
 using namespace std;
 
@@ -8,8 +13,85 @@ ColumnSegment::ColumnSegment(TypeId type, ColumnSegmentType segment_type, index_
       stats(type, type_size) {
 }
 
+template <class T> static void InitializeStatistics(data_ptr_t minimum, data_ptr_t maximum) {
+	// the statistics of an empty segment: the minimum is bigger than the maximum, so no value is in the range
+	*((T *)minimum) = numeric_limits<T>::max();
+	*((T *)maximum) = numeric_limits<T>::lowest();
+}
+
 SegmentStatistics::SegmentStatistics(TypeId type, index_t type_size) {
 	minimum = unique_ptr<data_t[]>(new data_t[type_size]);
 	maximum = unique_ptr<data_t[]>(new data_t[type_size]);
 	has_null = false;
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		InitializeStatistics<int8_t>(minimum.get(), maximum.get());
+		break;
+	case TypeId::SMALLINT:
+		InitializeStatistics<int16_t>(minimum.get(), maximum.get());
+		break;
+	case TypeId::INTEGER:
+		InitializeStatistics<int32_t>(minimum.get(), maximum.get());
+		break;
+	case TypeId::BIGINT:
+		InitializeStatistics<int64_t>(minimum.get(), maximum.get());
+		break;
+	case TypeId::FLOAT:
+		InitializeStatistics<float>(minimum.get(), maximum.get());
+		break;
+	case TypeId::DOUBLE:
+		InitializeStatistics<double>(minimum.get(), maximum.get());
+		break;
+	default:
+		// no statistics are kept for other types
+		memset(minimum.get(), 0, type_size);
+		memset(maximum.get(), 0, type_size);
+		break;
+	}
+}
+
+template <class T> static bool TemplatedCheckZonemap(SegmentStatistics &stats, TableFilter &filter) {
+	// the value union of the constant starts with the value of the constant for every type
+	T constant = *((T *)&filter.constant.value_);
+	T min = *((T *)stats.minimum.get());
+	T max = *((T *)stats.maximum.get());
+	switch (filter.comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+		return constant >= min && constant <= max;
+	case ExpressionType::COMPARE_LESSTHAN:
+		return min < constant;
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return min <= constant;
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return max > constant;
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return max >= constant;
+	default:
+		return true;
+	}
+}
+
+bool ColumnSegment::CheckZonemap(TableFilter &filter) {
+	if (filter.constant.type != type || filter.constant.is_null) {
+		return true;
+	}
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		return TemplatedCheckZonemap<int8_t>(stats, filter);
+	case TypeId::SMALLINT:
+		return TemplatedCheckZonemap<int16_t>(stats, filter);
+	case TypeId::INTEGER:
+		return TemplatedCheckZonemap<int32_t>(stats, filter);
+	case TypeId::BIGINT:
+		return TemplatedCheckZonemap<int64_t>(stats, filter);
+	case TypeId::FLOAT:
+		return TemplatedCheckZonemap<float>(stats, filter);
+	case TypeId::DOUBLE:
+		return TemplatedCheckZonemap<double>(stats, filter);
+	default:
+		// no statistics: the segment can always contain matching values
+		return true;
+	}
 }
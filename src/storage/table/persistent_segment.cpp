@@ -5,63 +5,118 @@
 #include "common/types/null_value.hpp"
 #include "storage/checkpoint/table_data_writer.hpp"
 #include "storage/meta_block_reader.hpp"
+#include "storage/table/segment_compression.hpp"
 
 using namespace duckdb;
 using namespace std;
 
-PersistentSegment::PersistentSegment(BlockManager &manager, block_id_t id, index_t offset, TypeId type, index_t start,
+PersistentSegment::PersistentSegment(BufferManager &manager, block_id_t id, index_t offset, TypeId type, index_t start,
                                      index_t count)
-    : ColumnSegment(type, ColumnSegmentType::PERSISTENT, start, count), manager(manager), block_id(id), offset(offset) {
-	// FIXME
+    : ColumnSegment(type, ColumnSegmentType::PERSISTENT, start, count), manager(manager), block_id(id), offset(offset),
+      dictionary_offset(0), dictionary_loaded(false) {
+	// the statistics are loaded together with the segment: until then we have to assume there are NULL values
 	stats.has_null = true;
 }
 
-void PersistentSegment::LoadBlock() {
-	if (block) {
-		// already loaded
-		return;
+unique_ptr<BufferHandle> PersistentSegment::PinBlock() {
+	auto handle = manager.Pin(block_id);
+	// scans of the segment from other threads only read the offsets after they observe the release store of the flag
+	if (type == TypeId::VARCHAR && !dictionary_loaded.load(memory_order_acquire)) {
+		lock_guard<mutex> lock(load_lock);
+		if (!dictionary_loaded.load(memory_order_relaxed)) {
+			// read the location of the string dictionary, the values of the segment are offsets into it
+			dictionary_offset = offset + *((int32_t *)(handle->node->buffer + offset));
+			offset += sizeof(int32_t);
+			type_size = sizeof(int32_t);
+			dictionary_loaded.store(true, memory_order_release);
+		}
 	}
-	// load the block
-	lock_guard<mutex> lock(load_lock);
-	if (block) {
-		// loaded in the meantime
-		return;
+	return handle;
+}
+
+template <class T> static void MarkNullValues(T *values, index_t count, nullmask_t &nullmask, index_t offset) {
+	for (index_t i = 0; i < count; i++) {
+		if (IsNullValue<T>(values[i])) {
+			nullmask[offset + i] = true;
+		}
 	}
-	block = make_unique<Block>(block_id);
-	manager.Read(*block);
-	if (type == TypeId::VARCHAR) {
-		int32_t dictionary_offset = *((int32_t *)(block->buffer + offset));
-		dictionary = block->buffer + offset + dictionary_offset;
-		offset += sizeof(int32_t);
-		type_size = sizeof(int32_t);
+}
+
+void PersistentSegment::Decompress(data_ptr_t segment, index_t start, index_t count, Vector &result) {
+	assert(result.count + count <= STANDARD_VECTOR_SIZE);
+	auto target = result.data + result.count * type_size;
+	SegmentCompressor::Decompress(segment, type, start, count, target);
+	if (((CompressedSegmentHeader *)segment)->has_null) {
+		switch (type) {
+		case TypeId::BOOLEAN:
+		case TypeId::TINYINT:
+			MarkNullValues<int8_t>((int8_t *)target, count, result.nullmask, result.count);
+			break;
+		case TypeId::SMALLINT:
+			MarkNullValues<int16_t>((int16_t *)target, count, result.nullmask, result.count);
+			break;
+		case TypeId::INTEGER:
+			MarkNullValues<int32_t>((int32_t *)target, count, result.nullmask, result.count);
+			break;
+		case TypeId::BIGINT:
+			MarkNullValues<int64_t>((int64_t *)target, count, result.nullmask, result.count);
+			break;
+		case TypeId::FLOAT:
+			MarkNullValues<float>((float *)target, count, result.nullmask, result.count);
+			break;
+		case TypeId::DOUBLE:
+			MarkNullValues<double>((double *)target, count, result.nullmask, result.count);
+			break;
+		default:
+			throw NotImplementedException("Unimplemented type for compression");
+		}
 	}
+	result.count += count;
 }
 
 void PersistentSegment::Scan(ColumnPointer &pointer, Vector &result, index_t count) {
-	LoadBlock();
+	auto handle = PinBlock();
 
-	data_ptr_t dataptr = block->buffer + offset + pointer.offset * type_size;
-	Vector source(type, dataptr);
-	source.count = count;
-	AppendFromStorage(source, result, stats.has_null);
+	if (type == TypeId::VARCHAR) {
+		data_ptr_t dataptr = handle->node->buffer + offset + pointer.offset * type_size;
+		Vector source(type, dataptr);
+		source.count = count;
+		AppendStrings(handle->node->buffer + dictionary_offset, source, result, stats.has_null);
+		// the scanned strings point into the block: keep it pinned until the next scan of the column
+		pointer.handles.push_back(move(handle));
+	} else {
+		// decompress the values directly into the result vector
+		Decompress(handle->node->buffer + offset, pointer.offset, count, result);
+	}
 	pointer.offset += count;
 }
 
 void PersistentSegment::Scan(ColumnPointer &pointer, Vector &result, index_t count, sel_t *sel_vector,
                              index_t sel_count) {
-	LoadBlock();
+	auto handle = PinBlock();
 
-	data_ptr_t dataptr = block->buffer + offset + pointer.offset * type_size;
-	Vector source(type, dataptr);
-	source.count = sel_count;
-	source.sel_vector = sel_vector;
-	AppendFromStorage(source, result, stats.has_null);
+	if (type == TypeId::VARCHAR) {
+		data_ptr_t dataptr = handle->node->buffer + offset + pointer.offset * type_size;
+		Vector source(type, dataptr);
+		source.count = sel_count;
+		source.sel_vector = sel_vector;
+		AppendStrings(handle->node->buffer + dictionary_offset, source, result, stats.has_null);
+		// the scanned strings point into the block: keep it pinned until the next scan of the column
+		pointer.handles.push_back(move(handle));
+	} else {
+		// decompress the values of the range, then append the selected values to the result
+		auto segment = handle->node->buffer + offset;
+		int64_t values[STANDARD_VECTOR_SIZE];
+		SegmentCompressor::Decompress(segment, type, pointer.offset, count, (data_ptr_t)values);
+		Vector source(type, (data_ptr_t)values);
+		source.count = sel_count;
+		source.sel_vector = sel_vector;
+		VectorOperations::AppendFromStorage(source, result, ((CompressedSegmentHeader *)segment)->has_null);
+	}
 	pointer.offset += count;
 }
 
 void PersistentSegment::Fetch(Vector &result, index_t row_id) {
-	LoadBlock();
-
 	assert(row_id >= start);
 	if (row_id >= start + count) {
 		assert(next);
@@ -69,10 +124,21 @@ void PersistentSegment::Fetch(Vector &result, index_t row_id) {
 		next_segment.Fetch(result, row_id);
 		return;
 	}
-	data_ptr_t dataptr = block->buffer + (row_id - start) * type_size;
-	Vector source(type, dataptr);
-	source.count = 1;
-	AppendFromStorage(source, result, stats.has_null);
+	auto handle = PinBlock();
+
+	if (type == TypeId::VARCHAR) {
+		data_ptr_t dataptr = handle->node->buffer + offset + (row_id - start) * type_size;
+		Vector source(type, dataptr);
+		source.count = 1;
+		AppendStrings(handle->node->buffer + dictionary_offset, source, result, stats.has_null);
+		// the block is unpinned after the fetch: copy the fetched string into the result vector
+		auto &str = ((const char **)result.data)[result.count - 1];
+		if (!result.nullmask[result.count - 1]) {
+			str = result.string_heap.AddString(str);
+		}
+	} else {
+		Decompress(handle->node->buffer + offset, row_id - start, 1, result);
+	}
 }
 
 template <class T, bool HAS_NULL>
@@ -87,7 +153,8 @@ static void append_function(T *__restrict source, T *__restrict target, index_t
 	});
 }
 
-template <bool HAS_NULL> void PersistentSegment::AppendStrings(Vector &source, Vector &target) {
+template <bool HAS_NULL>
+void PersistentSegment::AppendStrings(data_ptr_t dictionary, Vector &source, Vector &target) {
 	auto offsets = (int32_t *)source.data;
 	auto target_strings = (const char **)target.data;
 	VectorOperations::Exec(source, [&](index_t i, index_t k) {
@@ -105,16 +172,12 @@ template <bool HAS_NULL> void PersistentSegment::AppendStrings(Vector &source, V
 	target.count += source.count;
 }
 
-void PersistentSegment::AppendFromStorage(Vector &source, Vector &target, bool has_null) {
-	if (source.type == TypeId::VARCHAR) {
-		// varchar vector: load data from dictionary
-		if (has_null) {
-			AppendStrings<true>(source, target);
-		} else {
-			AppendStrings<false>(source, target);
-		}
+void PersistentSegment::AppendStrings(data_ptr_t dictionary, Vector &source, Vector &target, bool has_null) {
+	// varchar vector: load data from dictionary
+	if (has_null) {
+		AppendStrings<true>(dictionary, source, target);
 	} else {
-		VectorOperations::AppendFromStorage(source, target, has_null);
+		AppendStrings<false>(dictionary, source, target);
 	}
 }
 
@@ -126,8 +189,11 @@ const char *PersistentSegment::GetBigString(block_id_t block_id) {
 	if (entry != big_strings.end()) {
 		return entry->second;
 	}
-	// the big string was not read yet: read it from disk
-	MetaBlockReader reader(manager, block_id);
+	// the big string was not read yet: read it through the buffer manager
+	BlockPointer pointer;
+	pointer.block_id = block_id;
+	pointer.offset = sizeof(block_id_t);
+	MetaBlockReader reader(manager, pointer);
 	auto read_string = reader.Read<string>();
 	// add it to the string heap
 	auto big_string = heap.AddString(read_string);
@@ -0,0 +1,326 @@
+#include "storage/table/segment_compression.hpp"
+
+#include "common/exception.hpp"
+#include "common/types/null_value.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+using namespace duckdb;
+using namespace std;
+
+constexpr index_t SegmentCompressor::MAXIMUM_SEGMENT_COUNT;
+
+SegmentCompressor::SegmentCompressor(TypeId type, index_t capacity) : type(type), capacity(capacity) {
+	assert(TypeIsConstantSize(type));
+}
+
+//===--------------------------------------------------------------------===//
+// Helpers
+//===--------------------------------------------------------------------===//
+static bool SupportsBitpacking(TypeId type) {
+	return type == TypeId::BOOLEAN || TypeIsInteger(type);
+}
+
+//! The amount of bits required to store the difference of every value with the minimum, plus a code for NULL values
+static index_t BitWidth(CompressionStatistics &stats) {
+	uint64_t range = (uint64_t)stats.max - (uint64_t)stats.min;
+	if (stats.has_null) {
+		if (range == numeric_limits<uint64_t>::max()) {
+			return 64;
+		}
+		// reserve a code for NULL values
+		range++;
+	}
+	index_t bit_width = 0;
+	while (bit_width < 64 && (range >> bit_width) != 0) {
+		bit_width++;
+	}
+	return bit_width;
+}
+
+static index_t BitpackedSize(index_t count, index_t bit_width) {
+	return (count * bit_width + 63) / 64 * sizeof(uint64_t);
+}
+
+//! The size of the run ends of an RLE segment, padded so the run values that follow it are aligned
+static index_t RunEndsSize(index_t run_count) {
+	return (run_count * sizeof(uint32_t) + 7) / 8 * 8;
+}
+
+//===--------------------------------------------------------------------===//
+// Statistics
+//===--------------------------------------------------------------------===//
+template <class T> static void TemplatedUpdateStatistics(CompressionStatistics &stats, T *values, index_t count) {
+	T last;
+	memcpy(&last, &stats.last_value, sizeof(T));
+	for (index_t i = 0; i < count; i++) {
+		// runs are detected on the bits of the values, so e.g. NaN values form a run as well
+		if (stats.count + i == 0 || memcmp(&values[i], &last, sizeof(T)) != 0) {
+			stats.run_count++;
+			last = values[i];
+		}
+		if (IsNullValue<T>(values[i])) {
+			stats.has_null = true;
+			continue;
+		}
+		if (std::is_integral<T>::value) {
+			auto value = (int64_t)values[i];
+			if (!stats.has_value) {
+				stats.min = value;
+				stats.max = value;
+			} else {
+				stats.min = std::min(stats.min, value);
+				stats.max = std::max(stats.max, value);
+			}
+		}
+		stats.has_value = true;
+	}
+	stats.count += count;
+	memcpy(&stats.last_value, &last, sizeof(T));
+}
+
+static void UpdateStatistics(TypeId type, CompressionStatistics &stats, data_ptr_t values, index_t count) {
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		TemplatedUpdateStatistics<int8_t>(stats, (int8_t *)values, count);
+		break;
+	case TypeId::SMALLINT:
+		TemplatedUpdateStatistics<int16_t>(stats, (int16_t *)values, count);
+		break;
+	case TypeId::INTEGER:
+		TemplatedUpdateStatistics<int32_t>(stats, (int32_t *)values, count);
+		break;
+	case TypeId::BIGINT:
+		TemplatedUpdateStatistics<int64_t>(stats, (int64_t *)values, count);
+		break;
+	case TypeId::FLOAT:
+		TemplatedUpdateStatistics<float>(stats, (float *)values, count);
+		break;
+	case TypeId::DOUBLE:
+		TemplatedUpdateStatistics<double>(stats, (double *)values, count);
+		break;
+	default:
+		throw NotImplementedException("Unimplemented type for compression");
+	}
+}
+
+CompressionType SegmentCompressor::ChooseCompression(CompressionStatistics &stats, index_t &size) {
+	index_t type_size = GetTypeIdSize(type);
+	if (stats.run_count <= 1) {
+		size = type_size;
+		return CompressionType::CONSTANT;
+	}
+	auto compression = CompressionType::UNCOMPRESSED;
+	size = stats.count * type_size;
+	index_t rle_size = RunEndsSize(stats.run_count) + stats.run_count * type_size;
+	if (rle_size < size) {
+		compression = CompressionType::RLE;
+		size = rle_size;
+	}
+	if (SupportsBitpacking(type) && stats.has_value) {
+		index_t bit_width = BitWidth(stats);
+		index_t bitpacked_size = BitpackedSize(stats.count, bit_width);
+		if (bit_width < type_size * 8 && bitpacked_size < size) {
+			compression = CompressionType::BITPACKING;
+			size = bitpacked_size;
+		}
+	}
+	return compression;
+}
+
+//===--------------------------------------------------------------------===//
+// Append & Flush
+//===--------------------------------------------------------------------===//
+bool SegmentCompressor::Append(data_ptr_t values, index_t count) {
+	if (stats.count > 0 && stats.count + count > MAXIMUM_SEGMENT_COUNT) {
+		return false;
+	}
+	// check if the segment still fits in the block after appending the values
+	auto new_stats = stats;
+	UpdateStatistics(type, new_stats, values, count);
+	index_t size;
+	ChooseCompression(new_stats, size);
+	if (stats.count > 0 && sizeof(CompressedSegmentHeader) + size > capacity) {
+		return false;
+	}
+	stats = new_stats;
+	data.insert(data.end(), values, values + count * GetTypeIdSize(type));
+	return true;
+}
+
+template <class T>
+static void TemplatedCompress(CompressedSegmentHeader &header, CompressionStatistics &stats, T *values,
+                              data_ptr_t target) {
+	switch (header.compression) {
+	case CompressionType::UNCOMPRESSED:
+		memcpy(target, values, stats.count * sizeof(T));
+		break;
+	case CompressionType::CONSTANT:
+		memcpy(target, values, sizeof(T));
+		break;
+	case CompressionType::RLE: {
+		auto run_ends = (uint32_t *)target;
+		auto run_values = (T *)(target + RunEndsSize(stats.run_count));
+		index_t run = 0;
+		for (index_t i = 0; i < stats.count; i++) {
+			if (i > 0 && memcmp(&values[i], &values[i - 1], sizeof(T)) != 0) {
+				run++;
+			}
+			run_values[run] = values[i];
+			run_ends[run] = i + 1;
+		}
+		assert(run + 1 == stats.run_count);
+		header.run_count = stats.run_count;
+		break;
+	}
+	case CompressionType::BITPACKING: {
+		header.bit_width = BitWidth(stats);
+		header.base = stats.min;
+		auto words = (uint64_t *)target;
+		memset(words, 0, BitpackedSize(stats.count, header.bit_width));
+		// NULL values are stored as the highest code, which is never the code of a value
+		uint64_t null_code = ((uint64_t)1 << header.bit_width) - 1;
+		for (index_t i = 0; i < stats.count; i++) {
+			uint64_t code = IsNullValue<T>(values[i]) ? null_code : (uint64_t)(int64_t)values[i] - (uint64_t)stats.min;
+			index_t bit_position = i * header.bit_width;
+			index_t word = bit_position / 64, shift = bit_position % 64;
+			words[word] |= code << shift;
+			if (shift + header.bit_width > 64) {
+				// the value straddles two words
+				words[word + 1] |= code >> (64 - shift);
+			}
+		}
+		break;
+	}
+	}
+}
+
+index_t SegmentCompressor::Flush(data_ptr_t target) {
+	assert(stats.count > 0);
+	CompressedSegmentHeader header;
+	index_t size;
+	header.compression = ChooseCompression(stats, size);
+	header.has_null = stats.has_null;
+	header.bit_width = 0;
+	header.run_count = 0;
+	header.base = 0;
+
+	auto segment_data = target + sizeof(CompressedSegmentHeader);
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		TemplatedCompress<int8_t>(header, stats, (int8_t *)data.data(), segment_data);
+		break;
+	case TypeId::SMALLINT:
+		TemplatedCompress<int16_t>(header, stats, (int16_t *)data.data(), segment_data);
+		break;
+	case TypeId::INTEGER:
+		TemplatedCompress<int32_t>(header, stats, (int32_t *)data.data(), segment_data);
+		break;
+	case TypeId::BIGINT:
+		TemplatedCompress<int64_t>(header, stats, (int64_t *)data.data(), segment_data);
+		break;
+	case TypeId::FLOAT:
+		TemplatedCompress<float>(header, stats, (float *)data.data(), segment_data);
+		break;
+	case TypeId::DOUBLE:
+		TemplatedCompress<double>(header, stats, (double *)data.data(), segment_data);
+		break;
+	default:
+		throw NotImplementedException("Unimplemented type for compression");
+	}
+	memcpy(target, &header, sizeof(CompressedSegmentHeader));
+	assert(sizeof(CompressedSegmentHeader) + size <= capacity);
+	// reset the compressor for the next segment
+	data.clear();
+	stats = CompressionStatistics();
+	return sizeof(CompressedSegmentHeader) + size;
+}
+
+//===--------------------------------------------------------------------===//
+// Decompress
+//===--------------------------------------------------------------------===//
+template <class T>
+static void TemplatedDecompress(CompressedSegmentHeader &header, data_ptr_t data, index_t start, index_t count,
+                                T *target) {
+	switch (header.compression) {
+	case CompressionType::UNCOMPRESSED:
+		memcpy(target, ((T *)data) + start, count * sizeof(T));
+		break;
+	case CompressionType::CONSTANT: {
+		T value = *((T *)data);
+		for (index_t i = 0; i < count; i++) {
+			target[i] = value;
+		}
+		break;
+	}
+	case CompressionType::RLE: {
+		auto run_ends = (uint32_t *)data;
+		auto run_values = (T *)(data + RunEndsSize(header.run_count));
+		// find the run that contains the first value
+		index_t run = std::upper_bound(run_ends, run_ends + header.run_count, (uint32_t)start) - run_ends;
+		for (index_t i = 0; i < count; i++) {
+			if (start + i >= run_ends[run]) {
+				run++;
+			}
+			target[i] = run_values[run];
+		}
+		break;
+	}
+	case CompressionType::BITPACKING: {
+		auto words = (uint64_t *)data;
+		index_t bit_width = header.bit_width;
+		uint64_t mask = bit_width == 64 ? numeric_limits<uint64_t>::max() : ((uint64_t)1 << bit_width) - 1;
+		uint64_t null_code = mask;
+		for (index_t i = 0; i < count; i++) {
+			index_t bit_position = (start + i) * bit_width;
+			index_t word = bit_position / 64, shift = bit_position % 64;
+			uint64_t code = words[word] >> shift;
+			if (shift + bit_width > 64) {
+				code |= words[word + 1] << (64 - shift);
+			}
+			code &= mask;
+			if (header.has_null && code == null_code) {
+				target[i] = NullValue<T>();
+			} else {
+				target[i] = (T)((uint64_t)header.base + code);
+			}
+		}
+		break;
+	}
+	default:
+		throw IOException("Unknown compression type in segment");
+	}
+}
+
+void SegmentCompressor::Decompress(data_ptr_t segment, TypeId type, index_t start, index_t count, data_ptr_t target) {
+	CompressedSegmentHeader header;
+	memcpy(&header, segment, sizeof(CompressedSegmentHeader));
+	auto data = segment + sizeof(CompressedSegmentHeader);
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		TemplatedDecompress<int8_t>(header, data, start, count, (int8_t *)target);
+		break;
+	case TypeId::SMALLINT:
+		TemplatedDecompress<int16_t>(header, data, start, count, (int16_t *)target);
+		break;
+	case TypeId::INTEGER:
+		TemplatedDecompress<int32_t>(header, data, start, count, (int32_t *)target);
+		break;
+	case TypeId::BIGINT:
+		TemplatedDecompress<int64_t>(header, data, start, count, (int64_t *)target);
+		break;
+	case TypeId::FLOAT:
+		TemplatedDecompress<float>(header, data, start, count, (float *)target);
+		break;
+	case TypeId::DOUBLE:
+		TemplatedDecompress<double>(header, data, start, count, (double *)target);
+		break;
+	default:
+		throw NotImplementedException("Unimplemented type for compression");
+	}
+}
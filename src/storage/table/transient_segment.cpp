@@ -165,8 +165,9 @@ template <class T> static void update_value(SegmentStatistics &stats, data_ptr_t
 	auto max = (T *)stats.maximum.get();
 	if (IsNullValue<T>(*source)) {
 		stats.has_null = true;
+	} else {
+		update_min_max(*source, min, max);
 	}
-	update_min_max(*source, min, max);
 
 	*target = *source;
 }
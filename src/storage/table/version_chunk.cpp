@@ -3,6 +3,7 @@
 #include "common/helper.hpp"
 #include "common/vector_operations/vector_operations.hpp"
 #include "storage/data_table.hpp"
+#include "storage/table_filter.hpp"
 #include "transaction/transaction.hpp"
 #include "transaction/version_info.hpp"
 #include "storage/table/transient_segment.hpp"
@@ -111,8 +112,12 @@ void VersionChunk::PushTuple(Transaction &transaction, UndoFlags flag, index_t o
 	Vector target(TypeId::POINTER, (data_ptr_t)target_locations);
 	target.count = 1;
 	for (index_t i = 0; i < chunk.column_count; i++) {
+		// strings fetched from persistent segments are copied into the heap of the vector: keep them alive
+		string_heap.MergeHeap(chunk.data[i].string_heap);
 		VectorOperations::Scatter::SetAll(chunk.data[i], target);
-		target_locations[0] += columns[i].segment->type_size;
+		// the size of the stored values of persistent segments can differ from the size of the type (e.g. the
+		// dictionary offsets of strings): the tuple is laid out according to the types
+		target_locations[0] += GetTypeIdSize(table.types[i]);
 	}
 }
 
@@ -209,6 +214,8 @@ void VersionChunk::RetrieveTupleData(Transaction &transaction, DataChunk &result
 }
 
 void VersionChunk::RetrieveColumnData(ColumnPointer &pointer, Vector &result, index_t count) {
+	// the vector of the previous scan of this column has been consumed: release the blocks it pinned
+	pointer.handles.clear();
 	// copy data from the column storage
 	while (count > 0) {
 		// check how much we can copy from this column segment
@@ -230,13 +237,34 @@ void VersionChunk::RetrieveColumnData(ColumnPointer &pointer, Vector &result, in
 
 void VersionChunk::RetrieveColumnData(ColumnPointer &pointer, Vector &result, index_t count, sel_t *sel_vector,
                                       index_t sel_count) {
-	// copy data from the column storage
+	// the vector of the previous scan of this column has been consumed: release the blocks it pinned
+	pointer.handles.clear();
+	// copy data from the column storage, the selection vector is sorted
+	index_t scan_offset = 0, sel_index = 0;
 	while (count > 0) {
 		// check how much we can copy from this column segment
 		index_t to_copy = std::min(count, pointer.segment->count - pointer.offset);
 		if (to_copy > 0) {
-			// we can copy everything from this column segment, copy with the sel vector
-			pointer.segment->Scan(pointer, result, to_copy, sel_vector, sel_count);
+			// find the entries of the selection vector that are stored in this column segment
+			index_t segment_start = sel_index;
+			while (sel_index < sel_count && sel_vector[sel_index] < scan_offset + to_copy) {
+				sel_index++;
+			}
+			if (scan_offset == 0 && sel_index == sel_count) {
+				// we can copy everything from this column segment, copy with the sel vector
+				pointer.segment->Scan(pointer, result, to_copy, sel_vector, sel_count);
+			} else if (sel_index > segment_start) {
+				// copy the entries of this segment with a selection vector relative to the segment
+				sel_t segment_sel[STANDARD_VECTOR_SIZE];
+				for (index_t i = segment_start; i < sel_index; i++) {
+					segment_sel[i - segment_start] = sel_vector[i] - scan_offset;
+				}
+				pointer.segment->Scan(pointer, result, to_copy, segment_sel, sel_index - segment_start);
+			} else {
+				// none of the entries are stored in this segment
+				pointer.offset += to_copy;
+			}
+			scan_offset += to_copy;
 			count -= to_copy;
 		}
 		if (count > 0) {
@@ -248,6 +276,165 @@ void VersionChunk::RetrieveColumnData(ColumnPointer &pointer, Vector &result, in
 	}
 }
 
+//! Returns the index of the column in the scanned columns
+static index_t GetScanColumnIndex(const vector<column_t> &column_ids, column_t column_index) {
+	auto entry = std::find(column_ids.begin(), column_ids.end(), column_index);
+	assert(entry != column_ids.end());
+	return entry - column_ids.begin();
+}
+
+//! Moves the entries of the selection vector to the front of the vector
+static void CompactVector(Vector &vector, sel_t sel_vector[], index_t count) {
+	assert(!vector.sel_vector);
+	auto type_size = GetTypeIdSize(vector.type);
+	nullmask_t nullmask;
+	for (index_t i = 0; i < count; i++) {
+		// the selection vector is sorted, so an entry never overwrites an entry that still has to be moved
+		assert(sel_vector[i] >= i);
+		memmove(vector.data + i * type_size, vector.data + sel_vector[i] * type_size, type_size);
+		nullmask[i] = vector.nullmask[sel_vector[i]];
+	}
+	vector.nullmask = nullmask;
+	vector.count = count;
+}
+
+//! Removes the rows of the chunk that do not satisfy the filters
+static void FilterChunk(vector<TableFilter> &filters, DataChunk &result, const vector<column_t> &column_ids) {
+	index_t count = result.size();
+	sel_t sel_vector[STANDARD_VECTOR_SIZE];
+	for (index_t i = 0; i < count; i++) {
+		sel_vector[i] = i;
+	}
+	index_t sel_count = count;
+	for (auto &filter : filters) {
+		auto &vector = result.data[GetScanColumnIndex(column_ids, filter.column_index)];
+		sel_count = filter.Select(vector, sel_vector, sel_count);
+	}
+	if (sel_count < count) {
+		for (index_t col_idx = 0; col_idx < result.column_count; col_idx++) {
+			CompactVector(result.data[col_idx], sel_vector, sel_count);
+		}
+	}
+}
+
+void VersionChunk::FetchFilteredColumnData(TableScanState &state, DataChunk &result, const vector<column_t> &column_ids,
+                                           index_t offset_in_chunk, index_t count) {
+	assert(result.size() == 0);
+	sel_t sel_vector[STANDARD_VECTOR_SIZE];
+	for (index_t i = 0; i < count; i++) {
+		sel_vector[i] = i;
+	}
+	index_t sel_count = count;
+	// first fetch the filtered columns and evaluate the filters on them
+	vector<bool> fetched(column_ids.size(), false);
+	for (auto &filter : *state.table_filters) {
+		auto col_idx = GetScanColumnIndex(column_ids, filter.column_index);
+		if (!fetched[col_idx]) {
+			RetrieveColumnData(state.columns[filter.column_index], result.data[col_idx], count);
+			fetched[col_idx] = true;
+		}
+		sel_count = filter.Select(result.data[col_idx], sel_vector, sel_count);
+		if (sel_count == 0) {
+			break;
+		}
+	}
+	if (sel_count == count) {
+		// every row satisfies the filters: fetch the remaining columns as-is
+		for (index_t col_idx = 0; col_idx < column_ids.size(); col_idx++) {
+			if (fetched[col_idx]) {
+				continue;
+			}
+			if (column_ids[col_idx] == COLUMN_IDENTIFIER_ROW_ID) {
+				result.data[col_idx].count = count;
+				VectorOperations::GenerateSequence(result.data[col_idx], this->start + offset_in_chunk, 1);
+			} else {
+				RetrieveColumnData(state.columns[column_ids[col_idx]], result.data[col_idx], count);
+			}
+		}
+		return;
+	}
+	// only fetch the rows that satisfy the filters for the remaining columns
+	for (index_t col_idx = 0; col_idx < column_ids.size(); col_idx++) {
+		if (fetched[col_idx]) {
+			CompactVector(result.data[col_idx], sel_vector, sel_count);
+		} else if (column_ids[col_idx] == COLUMN_IDENTIFIER_ROW_ID) {
+			auto row_ids = (int64_t *)result.data[col_idx].data;
+			for (index_t i = 0; i < sel_count; i++) {
+				row_ids[i] = this->start + offset_in_chunk + sel_vector[i];
+			}
+			result.data[col_idx].count = sel_count;
+		} else if (sel_count == 0) {
+			SkipColumnData(state.columns[column_ids[col_idx]], count);
+		} else {
+			RetrieveColumnData(state.columns[column_ids[col_idx]], result.data[col_idx], count, sel_vector, sel_count);
+		}
+	}
+}
+
+void VersionChunk::SkipColumnData(ColumnPointer &pointer, index_t count) {
+	while (true) {
+		index_t to_skip = std::min(count, pointer.segment->count - pointer.offset);
+		pointer.offset += to_skip;
+		count -= to_skip;
+		if (count == 0) {
+			break;
+		}
+		// move to the next segment
+		assert(pointer.segment->next);
+		pointer.segment = (ColumnSegment *)pointer.segment->next.get();
+		pointer.offset = 0;
+	}
+}
+
+bool VersionChunk::CheckZonemap(vector<TableFilter> &filters, index_t offset, index_t count) {
+	for (auto &filter : filters) {
+		// find the segment that holds the first row
+		auto segment = columns[filter.column_index].segment;
+		index_t segment_offset = columns[filter.column_index].offset + offset;
+		while (segment_offset >= segment->count) {
+			segment_offset -= segment->count;
+			segment = (ColumnSegment *)segment->next.get();
+		}
+		// now check the zone maps of all segments that overlap with the rows
+		bool can_match = false;
+		index_t remaining = count;
+		while (true) {
+			if (segment->CheckZonemap(filter)) {
+				can_match = true;
+				break;
+			}
+			index_t segment_count = std::min(remaining, segment->count - segment_offset);
+			remaining -= segment_count;
+			if (remaining == 0) {
+				break;
+			}
+			segment = (ColumnSegment *)segment->next.get();
+			segment_offset = 0;
+		}
+		if (!can_match) {
+			// none of the rows satisfies this filter
+			return false;
+		}
+	}
+	return true;
+}
+
+bool VersionChunk::SkipScan(TableScanState &state) {
+	assert(state.table_filters);
+	auto shared_lock = lock.GetSharedLock();
+	index_t end = this == state.last_chunk ? state.last_chunk_count : this->count;
+	if (end == 0) {
+		return false;
+	}
+	// rows with version information might have a different value for this transaction than the one in the segments
+	for (index_t version_index = 0; version_index <= GetVersionIndex(end - 1); version_index++) {
+		if (version_data[version_index]) {
+			return false;
+		}
+	}
+	return !CheckZonemap(*state.table_filters, 0, end);
+}
+
 bool VersionChunk::Scan(TableScanState &state, Transaction &transaction, DataChunk &result,
                         const vector<column_t> &column_ids, index_t version_index) {
 	// obtain a shared lock on this chunk
@@ -279,6 +466,15 @@ bool VersionChunk::Scan(TableScanState &state, Transaction &transaction, DataChu
 			version_data[version_index] = nullptr;
 		}
 	} else {
+		if (state.table_filters && !CheckZonemap(*state.table_filters, scan_start, scan_count)) {
+			// no row of this vector can satisfy the filters: skip it
+			for (auto &column_id : column_ids) {
+				if (column_id != COLUMN_IDENTIFIER_ROW_ID) {
+					SkipColumnData(state.columns[column_id], scan_count);
+				}
+			}
+			return scan_start + scan_count == end;
+		}
 		// no deleted entries or version information: just scan everything
 		regular_count = scan_count;
 	}
@@ -303,11 +499,13 @@ bool VersionChunk::Scan(TableScanState &state, Transaction &transaction, DataChu
 				// version info available: use the version info
 				if (version_info->tuple_data) {
 					alternate_version_pointers[alternate_version_count] = version_info->tuple_data;
-					alternate_version_index[alternate_version_count] = scan_start + version_entries[i];
+					alternate_version_index[alternate_version_count] = this->start + scan_start + version_entries[i];
 					alternate_version_count++;
 				}
 			}
 		}
+		// the base table entries of versioned rows were added at the end: sort the entries again
+		std::sort(regular_entries, regular_entries + regular_count);
 		if (alternate_version_count > 0) {
 			// retrieve alternate versions, if any
 			table.RetrieveVersionedData(result, column_ids, alternate_version_pointers, alternate_version_index,
@@ -315,6 +513,13 @@ bool VersionChunk::Scan(TableScanState &state, Transaction &transaction, DataChu
 		}
 		// retrieve entries from the base table with the selection vector
 		FetchColumnData(state, result, column_ids, scan_start, scan_count, regular_entries, regular_count);
+		if (state.table_filters) {
+			// apply the filters to the fetched rows
+			FilterChunk(*state.table_filters, result, column_ids);
+		}
+	} else if (state.table_filters) {
+		// no versions or deleted tuples, but we only fetch the rows that satisfy the filters
+		FetchFilteredColumnData(state, result, column_ids, scan_start, regular_count);
 	} else {
 		// no versions or deleted tuples, simply scan the column segments
 		FetchColumnData(state, result, column_ids, scan_start, regular_count);
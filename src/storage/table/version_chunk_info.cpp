@@ -20,15 +20,19 @@ void VersionChunkInfo::Undo(VersionInfo *info) {
 	if (!info->tuple_data) {
 		deleted[entry] = true;
 	} else {
-		// move data back to the original chunk
 		deleted[entry] = false;
-		auto tuple_data = info->tuple_data;
-		auto row_id = info->GetRowId();
-		for (index_t i = 0; i < chunk.table.types.size(); i++) {
-			assert(chunk.columns[i].segment->segment_type == ColumnSegmentType::TRANSIENT);
-			auto &transient = (TransientSegment &)*chunk.columns[i].segment;
-			transient.Update(row_id, tuple_data);
-			tuple_data += transient.type_size;
+		// persistent chunks are never updated in place (an update deletes the rows and appends new ones): undoing a
+		// delete leaves their data untouched
+		if (chunk.type == VersionChunkType::TRANSIENT) {
+			// move data back to the original chunk
+			auto tuple_data = info->tuple_data;
+			auto row_id = info->GetRowId();
+			for (index_t i = 0; i < chunk.table.types.size(); i++) {
+				assert(chunk.columns[i].segment->segment_type == ColumnSegmentType::TRANSIENT);
+				auto &transient = (TransientSegment &)*chunk.columns[i].segment;
+				transient.Update(row_id, tuple_data);
+				tuple_data += transient.type_size;
+			}
 		}
 	}
 	version_pointers[entry] = info->next;
@@ -0,0 +1,62 @@
+#include "storage/table_filter.hpp"
+
+#include "common/exception.hpp"
+#include "common/operator/comparison_operators.hpp"
+#include "common/types/vector.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+template <class T, class OP>
+static index_t TemplatedSelect(Vector &vector, T constant, sel_t sel_vector[], index_t count) {
+	auto data = (T *)vector.data;
+	index_t result_count = 0;
+	for (index_t i = 0; i < count; i++) {
+		auto index = sel_vector[i];
+		// comparisons with NULL values never hold
+		if (!vector.nullmask[index] && OP::Operation(data[index], constant)) {
+			sel_vector[result_count++] = index;
+		}
+	}
+	return result_count;
+}
+
+template <class OP> static index_t SelectSwitch(Vector &vector, Value &constant, sel_t sel_vector[], index_t count) {
+	switch (vector.type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		return TemplatedSelect<int8_t, OP>(vector, constant.value_.tinyint, sel_vector, count);
+	case TypeId::SMALLINT:
+		return TemplatedSelect<int16_t, OP>(vector, constant.value_.smallint, sel_vector, count);
+	case TypeId::INTEGER:
+		return TemplatedSelect<int32_t, OP>(vector, constant.value_.integer, sel_vector, count);
+	case TypeId::BIGINT:
+		return TemplatedSelect<int64_t, OP>(vector, constant.value_.bigint, sel_vector, count);
+	case TypeId::FLOAT:
+		return TemplatedSelect<float, OP>(vector, constant.value_.float_, sel_vector, count);
+	case TypeId::DOUBLE:
+		return TemplatedSelect<double, OP>(vector, constant.value_.double_, sel_vector, count);
+	case TypeId::VARCHAR:
+		return TemplatedSelect<const char *, OP>(vector, constant.str_value.c_str(), sel_vector, count);
+	default:
+		throw NotImplementedException("Unimplemented type for table filter");
+	}
+}
+
+index_t TableFilter::Select(Vector &vector, sel_t sel_vector[], index_t count) {
+	assert(vector.type == constant.type && !vector.sel_vector);
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+		return SelectSwitch<Equals>(vector, constant, sel_vector, count);
+	case ExpressionType::COMPARE_LESSTHAN:
+		return SelectSwitch<LessThan>(vector, constant, sel_vector, count);
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return SelectSwitch<LessThanEquals>(vector, constant, sel_vector, count);
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return SelectSwitch<GreaterThan>(vector, constant, sel_vector, count);
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return SelectSwitch<GreaterThanEquals>(vector, constant, sel_vector, count);
+	default:
+		throw NotImplementedException("Unimplemented comparison type for table filter");
+	}
+}
@@ -1,21 +1,29 @@
 #include "storage/write_ahead_log.hpp"
 #include "common/serializer/buffered_file_reader.hpp"
 
+#include "main/database.hpp"
 #include "parser/parsed_data/drop_info.hpp"
+#include "storage/block_manager.hpp"
+#include "storage/storage_manager.hpp"
 
 using namespace duckdb;
 using namespace std;
 
 class ReplayState {
 public:
-	ReplayState(DuckDB &db, ClientContext &context, Deserializer &source)
-	    : db(db), context(context), source(source), current_table(nullptr) {
+	ReplayState(DuckDB &db, ClientContext &context, Deserializer &source, bool deserialize_only = false)
+	    : db(db), context(context), source(source), current_table(nullptr), deserialize_only(deserialize_only),
+	      checkpoint_id(INVALID_BLOCK) {
 	}
 
 	DuckDB &db;
 	ClientContext &context;
 	Deserializer &source;
 	TableCatalogEntry *current_table;
+	//! Whether the entries are only read, without replaying them
+	bool deserialize_only;
+	//! The meta block of the checkpoint of the last checkpoint marker in the WAL (if any)
+	block_id_t checkpoint_id;
 
 public:
 	void ReplayEntry(WALType entry_type);
@@ -40,18 +48,45 @@ private:
 	void ReplayUpdate();
 
 	void ReplayQuery();
-};
 
-void WriteAheadLog::Replay(DuckDB &database, string &path) {
-	BufferedFileReader reader(*database.file_system, path.c_str());
+	void ReplayCheckpoint();
+};
 
-	if (reader.Finished()) {
+bool WriteAheadLog::Replay(DuckDB &database, string &path) {
+	auto initial_reader = make_unique<BufferedFileReader>(*database.file_system, path.c_str());
+	if (initial_reader->Finished()) {
 		// WAL is empty
-		return;
+		return false;
 	}
 
 	ClientContext context(database);
 	context.transaction.SetAutoCommit(false);
+
+	// first deserialize the WAL without replaying it to find the checkpoint marker (if any)
+	ReplayState checkpoint_state(database, context, *initial_reader, true);
+	try {
+		while (true) {
+			WALType entry_type = initial_reader->Read<WALType>();
+			if (entry_type == WALType::WAL_FLUSH) {
+				if (initial_reader->Finished()) {
+					break;
+				}
+			} else {
+				checkpoint_state.ReplayEntry(entry_type);
+			}
+		}
+	} catch (std::exception &ex) {
+		// the WAL is corrupt, this is reported when the WAL is replayed
+	}
+	initial_reader.reset();
+	if (checkpoint_state.checkpoint_id != INVALID_BLOCK &&
+	    checkpoint_state.checkpoint_id == database.storage->block_manager->GetMetaBlock()) {
+		// the database crashed after the checkpoint that was loaded was written, but before the WAL was truncated:
+		// the entries of the WAL are already stored in the checkpoint, so they must not be replayed again
+		return true;
+	}
+
+	BufferedFileReader reader(*database.file_system, path.c_str());
 	context.transaction.BeginTransaction();
 
 	ReplayState state(database, context, reader);
@@ -85,6 +120,7 @@ void WriteAheadLog::Replay(DuckDB &database, string &path) {
 		// exception thrown in WAL replay: rollback
 		context.transaction.Rollback();
 	}
+	return false;
 }
 
 //===--------------------------------------------------------------------===//
@@ -134,6 +170,9 @@ void ReplayState::ReplayEntry(WALType entry_type) {
 	case WALType::QUERY:
 		ReplayQuery();
 		break;
+	case WALType::CHECKPOINT:
+		ReplayCheckpoint();
+		break;
 	default:
 		throw Exception("Invalid WAL entry type!");
 	}
@@ -144,6 +183,9 @@ void ReplayState::ReplayEntry(WALType entry_type) {
 //===--------------------------------------------------------------------===//
 void ReplayState::ReplayCreateTable() {
 	auto info = TableCatalogEntry::Deserialize(source);
+	if (deserialize_only) {
+		return;
+	}
 
 	// bind the constraints to the table again
 	Binder binder(context);
@@ -158,6 +200,9 @@ void ReplayState::ReplayDropTable() {
 	info.type = CatalogType::TABLE;
 	info.schema = source.Read<string>();
 	info.name = source.Read<string>();
+	if (deserialize_only) {
+		return;
+	}
 
 	db.catalog->DropTable(context.ActiveTransaction(), &info);
 }
@@ -167,6 +212,9 @@ void ReplayState::ReplayDropTable() {
 //===--------------------------------------------------------------------===//
 void ReplayState::ReplayCreateView() {
 	auto entry = ViewCatalogEntry::Deserialize(source);
+	if (deserialize_only) {
+		return;
+	}
 
 	db.catalog->CreateView(context.ActiveTransaction(), entry.get());
 }
@@ -176,6 +224,9 @@ void ReplayState::ReplayDropView() {
 	info.type = CatalogType::VIEW;
 	info.schema = source.Read<string>();
 	info.name = source.Read<string>();
+	if (deserialize_only) {
+		return;
+	}
 	db.catalog->DropView(context.ActiveTransaction(), &info);
 }
 
@@ -185,6 +236,9 @@ void ReplayState::ReplayDropView() {
 void ReplayState::ReplayCreateSchema() {
 	CreateSchemaInfo info;
 	info.schema = source.Read<string>();
+	if (deserialize_only) {
+		return;
+	}
 
 	db.catalog->CreateSchema(context.ActiveTransaction(), &info);
 }
@@ -194,6 +248,9 @@ void ReplayState::ReplayDropSchema() {
 
 	info.type = CatalogType::SCHEMA;
 	info.name = source.Read<string>();
+	if (deserialize_only) {
+		return;
+	}
 
 	db.catalog->DropSchema(context.ActiveTransaction(), &info);
 }
@@ -203,6 +260,9 @@ void ReplayState::ReplayDropSchema() {
 //===--------------------------------------------------------------------===//
 void ReplayState::ReplayCreateSequence() {
 	auto entry = SequenceCatalogEntry::Deserialize(source);
+	if (deserialize_only) {
+		return;
+	}
 
 	db.catalog->CreateSequence(context.ActiveTransaction(), entry.get());
 }
@@ -212,6 +272,9 @@ void ReplayState::ReplayDropSequence() {
 	info.type = CatalogType::SEQUENCE;
 	info.schema = source.Read<string>();
 	info.name = source.Read<string>();
+	if (deserialize_only) {
+		return;
+	}
 
 	db.catalog->DropSequence(context.ActiveTransaction(), &info);
 }
@@ -221,6 +284,9 @@ void ReplayState::ReplaySequenceValue() {
 	auto name = source.Read<string>();
 	auto usage_count = source.Read<uint64_t>();
 	auto counter = source.Read<int64_t>();
+	if (deserialize_only) {
+		return;
+	}
 
 	// fetch the sequence from the catalog
 	auto seq = db.catalog->GetSequence(context.ActiveTransaction(), schema, name);
@@ -236,26 +302,35 @@ void ReplayState::ReplaySequenceValue() {
 void ReplayState::ReplayUseTable() {
 	auto schema_name = source.Read<string>();
 	auto table_name = source.Read<string>();
+	if (deserialize_only) {
+		return;
+	}
 	current_table = db.catalog->GetTable(context.ActiveTransaction(), schema_name, table_name);
 }
 
 void ReplayState::ReplayInsert() {
+	DataChunk chunk;
+	chunk.Deserialize(source);
+	if (deserialize_only) {
+		return;
+	}
 	if (!current_table) {
 		throw Exception("Corrupt WAL: insert without table");
 	}
-	DataChunk chunk;
-	chunk.Deserialize(source);
 
 	// append to the current table
 	current_table->storage->Append(*current_table, context, chunk);
 }
 
 void ReplayState::ReplayDelete() {
+	DataChunk chunk;
+	chunk.Deserialize(source);
+	if (deserialize_only) {
+		return;
+	}
 	if (!current_table) {
 		throw Exception("Corrupt WAL: delete without table");
 	}
-	DataChunk chunk;
-	chunk.Deserialize(source);
 
 	assert(chunk.column_count == 1 && chunk.data[0].type == ROW_TYPE);
 	row_t row_ids[1];
@@ -271,11 +346,14 @@ void ReplayState::ReplayDelete() {
 }
 
 void ReplayState::ReplayUpdate() {
+	DataChunk chunk;
+	chunk.Deserialize(source);
+	if (deserialize_only) {
+		return;
+	}
 	if (!current_table) {
 		throw Exception("Corrupt WAL: update without table");
 	}
-	DataChunk chunk;
-	chunk.Deserialize(source);
 
 	vector<column_t> column_ids;
 	for (index_t i = 0; i < chunk.column_count - 1; i++) {
@@ -304,6 +382,17 @@ void ReplayState::ReplayUpdate() {
 void ReplayState::ReplayQuery() {
 	// read the query
 	auto query = source.Read<string>();
+	if (deserialize_only) {
+		return;
+	}
 
 	context.Query(query, false);
 }
+
+//===--------------------------------------------------------------------===//
+// Checkpoint
+//===--------------------------------------------------------------------===//
+void ReplayState::ReplayCheckpoint() {
+	// the marker of a checkpoint: if the header of the checkpoint was not written, the marker is ignored
+	checkpoint_id = source.Read<block_id_t>();
+}
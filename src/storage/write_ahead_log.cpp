@@ -1,18 +1,43 @@
 #include "storage/write_ahead_log.hpp"
 
+#include "main/database.hpp"
+
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 
 using namespace duckdb;
 using namespace std;
 
-WriteAheadLog::WriteAheadLog(DuckDB &database) : initialized(false), database(database) {
+WriteAheadLog::WriteAheadLog(DuckDB &database)
+    : initialized(false), database(database), flush_count(0), synced_count(0), sync_in_progress(false),
+      pending_commits(0) {
 }
 
 void WriteAheadLog::Initialize(string &path) {
+	wal_path = path;
 	writer = make_unique<BufferedFileWriter>(*database.file_system, path.c_str(), true);
 	initialized = true;
 }
 
+index_t WriteAheadLog::GetWALSize() {
+	return (index_t)database.file_system->GetFileSize(*writer->handle);
+}
+
+void WriteAheadLog::Truncate() {
+	assert(writer->offset == 0);
+	{
+		// every entry that was flushed is now stored in the checkpoint: there is nothing left to sync
+		lock_guard<mutex> lock(sync_lock);
+		assert(!sync_in_progress);
+		synced_count = flush_count;
+	}
+	// remove the WAL file and start a new, empty one
+	writer.reset();
+	database.file_system->RemoveFile(wal_path);
+	writer = make_unique<BufferedFileWriter>(*database.file_system, wal_path.c_str(), true);
+}
+
 //===--------------------------------------------------------------------===//
 // Write Entries
 //===--------------------------------------------------------------------===//
@@ -130,12 +155,75 @@ void WriteAheadLog::WriteQuery(string &query) {
 	writer->WriteString(query);
 }
 
+//===--------------------------------------------------------------------===//
+// CHECKPOINT
+//===--------------------------------------------------------------------===//
+void WriteAheadLog::WriteCheckpoint(block_id_t meta_block) {
+	writer->Write<WALType>(WALType::CHECKPOINT);
+	writer->Write<block_id_t>(meta_block);
+	writer->Write<WALType>(WALType::WAL_FLUSH);
+	// the marker has to be on disk before the header of the checkpoint is written
+	writer->Sync();
+}
+
 //===--------------------------------------------------------------------===//
 // FLUSH
 //===--------------------------------------------------------------------===//
-void WriteAheadLog::Flush() {
+void WriteAheadLog::BeginCommit() {
+	lock_guard<mutex> lock(sync_lock);
+	pending_commits++;
+}
+
+void WriteAheadLog::CancelCommit() {
+	lock_guard<mutex> lock(sync_lock);
+	assert(pending_commits > 0);
+	if (--pending_commits == 0) {
+		commits_flushed.notify_all();
+	}
+}
+
+index_t WriteAheadLog::Flush() {
 	// write an empty entry
 	writer->Write<WALType>(WALType::WAL_FLUSH);
-	// flushes all changes made to the WAL to disk
-	writer->Sync();
+	// write the buffered entries to the file; they are synced to disk later
+	writer->Flush();
+	lock_guard<mutex> lock(sync_lock);
+	assert(pending_commits > 0);
+	if (--pending_commits == 0) {
+		commits_flushed.notify_all();
+	}
+	return ++flush_count;
+}
+
+void WriteAheadLog::Sync(index_t flush_number) {
+	unique_lock<mutex> lock(sync_lock);
+	while (synced_count < flush_number) {
+		if (sync_in_progress) {
+			// another committer is syncing the file, wait for it: its sync might include our entries
+			sync_finished.wait(lock);
+			continue;
+		}
+		// we sync the file for all entries that have been flushed so far
+		sync_in_progress = true;
+		index_t commit_delay = database.commit_delay;
+		if (commit_delay > 0 && pending_commits > 0) {
+			// other transactions are writing their commit: give them the chance to finish so their entries are
+			// included in this sync, but wait at most commit_delay
+			commits_flushed.wait_for(lock, chrono::microseconds(commit_delay), [&] { return pending_commits == 0; });
+		}
+		lock.unlock();
+		index_t sync_target = flush_count;
+		try {
+			writer->handle->Sync();
+		} catch (...) {
+			lock.lock();
+			sync_in_progress = false;
+			sync_finished.notify_all();
+			throw;
+		}
+		lock.lock();
+		synced_count = std::max(synced_count, sync_target);
+		sync_in_progress = false;
+		sync_finished.notify_all();
+	}
 }
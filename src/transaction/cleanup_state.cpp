@@ -31,7 +31,7 @@ void CleanupState::CleanupEntry(UndoFlags type, data_ptr_t data) {
 		// undo this entry
 		auto info = (VersionInfo *)data;
 		if (type == UndoFlags::DELETE_TUPLE || type == UndoFlags::UPDATE_TUPLE) {
-			CleanupIndexInsert(info);
+			CleanupIndexInsert(info, type == UndoFlags::UPDATE_TUPLE);
 		}
 		if (!info->prev) {
 			// parent refers to a storage chunk
@@ -55,7 +55,7 @@ void CleanupState::CleanupEntry(UndoFlags type, data_ptr_t data) {
 	}
 }
 
-void CleanupState::CleanupIndexInsert(VersionInfo *info) {
+void CleanupState::CleanupIndexInsert(VersionInfo *info, bool is_update) {
 	assert(info->tuple_data);
 	auto version_table = &info->GetTable();
 	if (version_table->indexes.size() == 0) {
@@ -67,12 +67,31 @@ void CleanupState::CleanupIndexInsert(VersionInfo *info) {
 		FlushIndexCleanup();
 		current_table = version_table;
 		chunk.Initialize(current_table->types);
+		successor_chunk.Initialize(current_table->types);
 	}
 	if (count == STANDARD_VECTOR_SIZE) {
 		// current vector is filled up: flush
 		FlushIndexCleanup();
 	}
 
+	// store the data of the successor version, which is gone by the time the batch is flushed
+	if (!is_update) {
+		// a deleted row has no successor
+		for (index_t i = 0; i < successor_chunk.column_count; i++) {
+			successor_chunk.data[i].nullmask[count] = true;
+			successor_chunk.data[i].count++;
+		}
+	} else {
+		// the lock keeps concurrent updates of the row from replacing the successor while it is read
+		auto &version_chunk = info->vinfo->chunk;
+		auto lock = version_chunk.lock.GetSharedLock();
+		if (info->prev) {
+			current_table->RetrieveVersionedData(successor_chunk, &info->prev->tuple_data, 1);
+		} else {
+			version_chunk.AppendToChunk(successor_chunk, info);
+		}
+	}
+
 	// store the row identifiers and tuple data
 	data[count] = info->tuple_data;
 	row_numbers[count] = info->GetRowId();
@@ -91,10 +110,11 @@ void CleanupState::FlushIndexCleanup() {
 	// now retrieve data from the version info
 	current_table->RetrieveVersionedData(chunk, data, count);
 	for (auto &index : current_table->indexes) {
-		index->Delete(chunk, row_identifiers);
+		index->Delete(chunk, successor_chunk, row_identifiers);
 	}
 
 	chunk.Reset();
+	successor_chunk.Reset();
 
 	count = 0;
 }
@@ -190,14 +190,14 @@ template <bool HAS_LOG> void CommitState<HAS_LOG>::CommitEntry(UndoFlags type, d
 	}
 	switch (type) {
 	case UndoFlags::CATALOG_ENTRY: {
-		// set the commit timestamp of the catalog entry to the given id
 		CatalogEntry *catalog_entry = *((CatalogEntry **)data);
 		assert(catalog_entry->parent);
-		catalog_entry->parent->timestamp = commit_id;
-
 		if (HAS_LOG) {
 			// push the catalog update to the WAL
 			WriteCatalogEntry(catalog_entry);
+		} else {
+			// set the commit timestamp of the catalog entry to the given id
+			catalog_entry->parent->timestamp = commit_id;
 		}
 		break;
 	}
@@ -205,31 +205,41 @@ template <bool HAS_LOG> void CommitState<HAS_LOG>::CommitEntry(UndoFlags type, d
 	case UndoFlags::UPDATE_TUPLE:
 	case UndoFlags::INSERT_TUPLE: {
 		auto info = (VersionInfo *)data;
-		// Before we set the commit timestamp we write the entry to the WAL. When we set the commit timestamp it enables
-		// other transactions to overwrite the data, but BEFORE we set the commit timestamp the other transactions will
-		// get a concurrency conflict error if they attempt ot modify these tuples. Hence BEFORE we set the commit
-		// timestamp we can safely access the data in the base table without needing any locks.
-		switch (type) {
-		case UndoFlags::UPDATE_TUPLE:
-			if (HAS_LOG) {
+		// The entries are written to the WAL before we set the commit timestamp. When we set the commit timestamp it
+		// enables other transactions to overwrite the data, but BEFORE we set the commit timestamp the other
+		// transactions will get a concurrency conflict error if they attempt ot modify these tuples. Hence BEFORE we
+		// set the commit timestamp we can safely access the data in the base table without needing any locks.
+		if (HAS_LOG) {
+			switch (type) {
+			case UndoFlags::UPDATE_TUPLE:
 				WriteUpdate(info);
-			}
-			break;
-		case UndoFlags::DELETE_TUPLE:
-			info->GetTable().cardinality--;
-			if (HAS_LOG) {
+				break;
+			case UndoFlags::DELETE_TUPLE:
 				WriteDelete(info);
-			}
-			break;
-		default: // UndoFlags::INSERT_TUPLE
-			assert(type == UndoFlags::INSERT_TUPLE);
-			info->GetTable().cardinality++;
-			if (HAS_LOG) {
+				break;
+			default: // UndoFlags::INSERT_TUPLE
+				assert(type == UndoFlags::INSERT_TUPLE);
 				// push the tuple insert to the WAL
 				WriteInsert(info);
+				break;
 			}
 			break;
 		}
+		auto &table = info->GetTable();
+		// the next checkpoint has to store the changes made to the table; inserts and updates change the stored data
+		// of the row itself as well
+		table.dirty = true;
+		if (type != UndoFlags::DELETE_TUPLE) {
+			auto row_id = (row_t)info->GetRowId();
+			if (row_id < table.first_modified_row) {
+				table.first_modified_row = row_id;
+			}
+		}
+		if (type == UndoFlags::DELETE_TUPLE) {
+			table.cardinality--;
+		} else if (type == UndoFlags::INSERT_TUPLE) {
+			table.cardinality++;
+		}
 		// set the commit timestamp of the entry
 		info->version_number = commit_id;
 		break;
@@ -4,6 +4,7 @@ using namespace duckdb;
 using namespace std;
 
 static void RollbackIndexInsert(VersionInfo *info);
+static void RollbackIndexUpdate(VersionInfo *info);
 
 void RollbackState::RollbackEntry(UndoFlags type, data_ptr_t data) {
 	switch (type) {
@@ -24,7 +25,11 @@ void RollbackState::RollbackEntry(UndoFlags type, data_ptr_t data) {
 			// delete base table entry from index
 			assert(!info->prev);
 			if (info->GetTable().indexes.size() > 0) {
-				RollbackIndexInsert(info);
+				if (type == UndoFlags::UPDATE_TUPLE) {
+					RollbackIndexUpdate(info);
+				} else {
+					RollbackIndexInsert(info);
+				}
 			}
 		}
 		// parent needs to refer to a storage chunk because of our transactional model
@@ -52,3 +57,20 @@ static void RollbackIndexInsert(VersionInfo *info) {
 		index->Delete(result, row_identifiers);
 	}
 }
+
+static void RollbackIndexUpdate(VersionInfo *info) {
+	row_t row_id = info->GetRowId();
+	Value ptr = Value::BIGINT(row_id);
+	Vector row_identifiers(ptr);
+
+	auto &table = info->GetTable();
+	DataChunk result, previous;
+	result.Initialize(table.types);
+	previous.Initialize(table.types);
+	info->vinfo->chunk.AppendToChunk(result, info);
+	table.RetrieveVersionedData(previous, &info->tuple_data, 1);
+	// the entry of the updated row is only deleted if the update changed its key
+	for (auto &index : table.indexes) {
+		index->Delete(result, previous, row_identifiers);
+	}
+}
@@ -27,19 +27,23 @@ void Transaction::PushQuery(string query) {
 	strcpy(blob, query.c_str());
 }
 
-void Transaction::Commit(WriteAheadLog *log, transaction_t commit_id) {
+bool Transaction::ChangesMade() {
+	return undo_buffer.ChangesMade() || sequence_usage.size() > 0;
+}
+
+index_t Transaction::WriteToWAL(WriteAheadLog *log) {
+	assert(ChangesMade());
+	undo_buffer.WriteToWAL(log);
+	// commit any sequences that were used to the WAL
+	for (auto &entry : sequence_usage) {
+		log->WriteSequenceValue(entry.first, entry.second);
+	}
+	// flush the WAL
+	return log->Flush();
+}
+
+void Transaction::Commit(transaction_t commit_id) {
 	this->commit_id = commit_id;
 	// commit the undo buffer
-	bool changes_made = undo_buffer.ChangesMade();
-	undo_buffer.Commit(log, commit_id);
-	if (log) {
-		// commit any sequences that were used to the WAL
-		for (auto &entry : sequence_usage) {
-			log->WriteSequenceValue(entry.first, entry.second);
-		}
-		// flush the WAL
-		if (changes_made || sequence_usage.size() > 0) {
-			log->Flush();
-		}
-	}
+	undo_buffer.Commit(commit_id);
 }
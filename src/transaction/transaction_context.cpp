@@ -30,8 +30,10 @@ void TransactionContext::Commit() {
 	if (!current_transaction) {
 		throw TransactionException("No transaction is currently active - cannot commit!");
 	}
-	transaction_manager.CommitTransaction(current_transaction);
+	auto transaction = current_transaction;
+	// a failed commit is rolled back, so the transaction is finished either way
 	current_transaction = nullptr;
+	transaction_manager.CommitTransaction(transaction);
 }
 
 void TransactionContext::Rollback() {
@@ -53,18 +53,53 @@ Transaction *TransactionManager::StartTransaction() {
 }
 
 void TransactionManager::CommitTransaction(Transaction *transaction) {
-	// obtain the transaction lock during this function
-	lock_guard<mutex> lock(transaction_lock);
+	auto log = storage.GetWriteAheadLog();
+	bool checkpoint = false;
+	{
+		// a checkpoint cannot be created while the transaction is being committed to the WAL
+		unique_ptr<StorageLockKey> checkpoint_lock;
+		if (log) {
+			checkpoint_lock = storage.checkpoint_lock.GetSharedLock();
+		}
+		try {
+			if (log && transaction->ChangesMade()) {
+				// announce the commit, so a concurrent sync can wait for it to be included
+				log->BeginCommit();
+				index_t wal_flush;
+				try {
+					// write the changes of the transaction to the WAL while holding the transaction lock
+					lock_guard<mutex> lock(transaction_lock);
+					wal_flush = transaction->WriteToWAL(log);
+				} catch (...) {
+					log->CancelCommit();
+					throw;
+				}
+				// sync the WAL after releasing the transaction lock, so the syncs of concurrent commits can be combined
+				log->Sync(wal_flush);
+				checkpoint = log->GetWALSize() > storage.database.checkpoint_wal_size;
+			}
+		} catch (...) {
+			// the commit could not be made durable: roll back the transaction
+			RollbackTransaction(transaction);
+			throw;
+		}
+		// the commit is durable: make its changes visible to transactions that start from now on
+		lock_guard<mutex> lock(transaction_lock);
 
-	// obtain a commit id for the transaction
-	transaction_t commit_id = current_start_timestamp++;
+		// obtain a commit id for the transaction
+		transaction_t commit_id = current_start_timestamp++;
 
-	// commit the UndoBuffer of the transaction
-	transaction->Commit(storage.GetWriteAheadLog(), commit_id);
+		// commit the UndoBuffer of the transaction
+		transaction->Commit(commit_id);
 
-	// remove the transaction id from the list of active transactions
-	// potentially resulting in garbage collection
-	RemoveTransaction(transaction);
+		// remove the transaction id from the list of active transactions
+		// potentially resulting in garbage collection
+		RemoveTransaction(transaction);
+	}
+	if (checkpoint) {
+		// the WAL has grown too large: checkpoint the database
+		storage.CreateCheckpoint(false);
+	}
 }
 
 void TransactionManager::RollbackTransaction(Transaction *transaction) {
@@ -79,6 +114,15 @@ void TransactionManager::RollbackTransaction(Transaction *transaction) {
 	RemoveTransaction(transaction);
 }
 
+unique_lock<mutex> TransactionManager::LockIfOnlyTransaction(Transaction *transaction) {
+	unique_lock<mutex> lock(transaction_lock);
+	if (active_transactions.size() != 1 || active_transactions[0].get() != transaction ||
+	    recently_committed_transactions.size() > 0) {
+		lock.unlock();
+	}
+	return lock;
+}
+
 void TransactionManager::RemoveTransaction(Transaction *transaction) {
 	// remove the transaction from the list of active transactions
 	index_t t_index = active_transactions.size();
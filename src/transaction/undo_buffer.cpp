@@ -122,18 +122,16 @@ void UndoBuffer::Cleanup() {
 	IterateEntries([&](UndoFlags type, data_ptr_t data) { state.CleanupEntry(type, data); });
 }
 
-void UndoBuffer::Commit(WriteAheadLog *log, transaction_t commit_id) {
-	if (log) {
-		CommitState<true> state(commit_id, log);
-		// commit WITH write ahead log
-		IterateEntries([&](UndoFlags type, data_ptr_t data) { state.CommitEntry(type, data); });
-		// final flush after writing
-		state.Flush(UndoFlags::EMPTY_ENTRY);
-	} else {
-		CommitState<false> state(commit_id);
-		// comit WITHOUT write ahead log
-		IterateEntries([&](UndoFlags type, data_ptr_t data) { state.CommitEntry(type, data); });
-	}
+void UndoBuffer::WriteToWAL(WriteAheadLog *log) {
+	CommitState<true> state(0, log);
+	IterateEntries([&](UndoFlags type, data_ptr_t data) { state.CommitEntry(type, data); });
+	// final flush after writing
+	state.Flush(UndoFlags::EMPTY_ENTRY);
+}
+
+void UndoBuffer::Commit(transaction_t commit_id) {
+	CommitState<false> state(commit_id);
+	IterateEntries([&](UndoFlags type, data_ptr_t data) { state.CommitEntry(type, data); });
 }
 
 void UndoBuffer::Rollback() {
@@ -86,3 +86,76 @@ TEST_CASE("Basic appender tests", "[appender]") {
 		appender.Rollback();
 	}
 }
+
+TEST_CASE("Test bulk appends of chunks and columns", "[appender]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE vals(i INTEGER, j BIGINT, s VARCHAR)"));
+
+	index_t count = 5000;
+	vector<int32_t> integers;
+	vector<int64_t> bigints;
+	vector<const char *> strings;
+	unique_ptr<bool[]> bigint_nulls(new bool[count]);
+	for (index_t i = 0; i < count; i++) {
+		integers.push_back(i);
+		bigints.push_back(i * 2);
+		strings.push_back(i % 2 == 0 ? "hello" : "world");
+		bigint_nulls[i] = i % 4 == 0;
+	}
+	data_ptr_t columns[] = {(data_ptr_t)integers.data(), (data_ptr_t)bigints.data(), (data_ptr_t)strings.data()};
+	bool *nullmasks[] = {nullptr, bigint_nulls.get(), nullptr};
+	{
+		Appender appender(db, DEFAULT_SCHEMA, "vals");
+		// a row appended before the bulk append goes first
+		appender.BeginRow();
+		appender.AppendInteger(-1);
+		appender.AppendBigInt(-1);
+		appender.AppendString("first");
+		appender.EndRow();
+		appender.AppendColumns(count, columns, nullmasks);
+
+		// append a chunk
+		vector<TypeId> types = {TypeId::INTEGER, TypeId::BIGINT, TypeId::VARCHAR};
+		DataChunk chunk;
+		chunk.Initialize(types);
+		for (index_t i = 0; i < 100; i++) {
+			chunk.data[0].SetValue(chunk.data[0].count++, Value::INTEGER(count + i));
+			chunk.data[1].SetValue(chunk.data[1].count++, Value());
+			chunk.data[2].SetValue(chunk.data[2].count++, Value("chunk"));
+		}
+		appender.AppendChunk(chunk);
+
+		// bulk appends cannot happen in the middle of a row, or with the wrong types
+		appender.BeginRow();
+		appender.AppendInteger(1);
+		REQUIRE_THROWS(appender.AppendColumns(count, columns));
+		REQUIRE_THROWS(appender.AppendChunk(chunk));
+		appender.AppendBigInt(1);
+		appender.AppendString("last");
+		appender.EndRow();
+		vector<TypeId> wrong_types = {TypeId::INTEGER, TypeId::INTEGER, TypeId::VARCHAR};
+		DataChunk wrong_chunk;
+		wrong_chunk.Initialize(wrong_types);
+		REQUIRE_THROWS(appender.AppendChunk(wrong_chunk));
+		appender.Commit();
+		// the appender cannot be used after it is committed
+		REQUIRE_THROWS(appender.AppendColumns(count, columns));
+	}
+
+	result = con.Query("SELECT COUNT(*), SUM(i), COUNT(j), SUM(j), COUNT(s) FROM vals");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(count + 102)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(count * (count - 1) / 2 + 100 * count + 4950)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(count - count / 4 + 2)}));
+	REQUIRE(CHECK_COLUMN(result, 3, {Value::BIGINT(count * (count - 1) - 4 * (count / 4) * (count / 4 - 1))}));
+	REQUIRE(CHECK_COLUMN(result, 4, {Value::BIGINT(count + 102)}));
+	result = con.Query("SELECT s, COUNT(*) FROM vals GROUP BY s ORDER BY s");
+	REQUIRE(CHECK_COLUMN(result, 0, {"chunk", "first", "hello", "last", "world"}));
+	REQUIRE(CHECK_COLUMN(result, 1, {100, 1, 2500, 1, 2500}));
+	// the rows are appended in order
+	result = con.Query("SELECT i, s FROM vals WHERE rowid IN (0, 1, 5001, 5101)");
+	REQUIRE(CHECK_COLUMN(result, 0, {-1, 0, 5000, 1}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"first", "hello", "chunk", "last"}));
+}
@@ -1,6 +1,7 @@
 #include "catch.hpp"
 #include "expression_helper.hpp"
 #include "optimizer/ca_optimizer.hpp"
+#include "planner/expression/bound_cast_expression.hpp"
 #include "planner/expression/bound_comparison_expression.hpp"
 #include "planner/expression/bound_operator_expression.hpp"
 #include "planner/expression/bound_window_expression.hpp"
@@ -127,7 +128,9 @@ TEST_CASE("Test common aggregate optimizer", "[aggregations]") {
 
 	// sum expression corresponding to the partition in the over clause.
 	auto &window_expression = (BoundWindowExpression &)*window->expressions[0];
-	auto &bound_op = (BoundOperatorExpression &)*window_expression.child;
+	// the argument of AVG is cast to DECIMAL
+	auto &bound_cast = (BoundCastExpression &)*window_expression.children[0];
+	auto &bound_op = (BoundOperatorExpression &)*bound_cast.child;
 	auto &sum_expression_left = (BoundColumnRefExpression &)*bound_op.children[0];
 	auto &sum_expression_right = (BoundColumnRefExpression &)*bound_op.children[1];
 	REQUIRE(sum_expression_left.binding.column_index == 0);
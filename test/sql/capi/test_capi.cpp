@@ -431,3 +431,89 @@ TEST_CASE("Test prepared statements in C API", "[capi]") {
 	duckdb_destroy_result(&res);
 	duckdb_destroy_prepare(&stmt);
 }
+
+TEST_CASE("Test appender in C API", "[capi]") {
+	CAPITester tester;
+	unique_ptr<CAPIResult> result;
+	duckdb_appender appender = nullptr;
+	duckdb_state status;
+
+	// open the database in in-memory mode
+	REQUIRE(tester.OpenDatabase(nullptr));
+	REQUIRE_NO_FAIL(tester.Query("CREATE TABLE test (i INTEGER, d DOUBLE, s VARCHAR, dt DATE, ts TIMESTAMP)"));
+
+	status = duckdb_appender_create(tester.connection, nullptr, "test", &appender);
+	REQUIRE(status == DuckDBSuccess);
+	REQUIRE(appender != nullptr);
+
+	// append the rows in columnar arrays, with NULL values in the first and the third column
+	const index_t count = 3000;
+	vector<int32_t> integers(count);
+	vector<double> doubles(count);
+	vector<const char *> strings(count);
+	vector<duckdb_date> dates(count);
+	vector<duckdb_timestamp> timestamps(count);
+	unique_ptr<bool[]> integer_nulls(new bool[count]);
+	unique_ptr<bool[]> string_nulls(new bool[count]);
+	for (index_t i = 0; i < count; i++) {
+		integers[i] = i;
+		doubles[i] = i / 2.0;
+		strings[i] = i % 2 == 0 ? "even" : "odd";
+		dates[i] = {1992, 1, 1};
+		timestamps[i] = {{1992, 1, 1}, {12, 30, 15, 0}};
+		integer_nulls[i] = i % 10 == 0;
+		string_nulls[i] = i % 3 == 0;
+	}
+	void *columns[] = {integers.data(), doubles.data(), strings.data(), dates.data(), timestamps.data()};
+	bool *nullmasks[] = {integer_nulls.get(), nullptr, string_nulls.get(), nullptr, nullptr};
+	status = duckdb_append_columns(appender, count, columns, nullmasks);
+	REQUIRE(status == DuckDBSuccess);
+	// append the same rows again without NULL values
+	status = duckdb_append_columns(appender, count, columns, nullptr);
+	REQUIRE(status == DuckDBSuccess);
+
+	// the rows are only visible after committing
+	result = tester.Query("SELECT COUNT(*) FROM test");
+	REQUIRE(NO_FAIL(*result));
+	REQUIRE(result->Fetch<int64_t>(0, 0) == 0);
+	status = duckdb_appender_commit(appender);
+	REQUIRE(status == DuckDBSuccess);
+	// the appender cannot be used after committing
+	status = duckdb_append_columns(appender, count, columns, nullptr);
+	REQUIRE(status == DuckDBError);
+	duckdb_appender_destroy(&appender);
+	REQUIRE(appender == nullptr);
+
+	result = tester.Query("SELECT COUNT(*), COUNT(i), SUM(i), SUM(d), COUNT(s), MIN(dt), MAX(ts) FROM test");
+	REQUIRE(NO_FAIL(*result));
+	REQUIRE(result->Fetch<int64_t>(0, 0) == 2 * count);
+	REQUIRE(result->Fetch<int64_t>(1, 0) == 2 * count - count / 10);
+	REQUIRE(result->Fetch<int64_t>(2, 0) == 2 * (count * (count - 1) / 2) - 10 * (count / 10) * (count / 10 - 1) / 2);
+	REQUIRE(result->Fetch<double>(3, 0) == count * (count - 1) / 2.0);
+	REQUIRE(result->Fetch<int64_t>(4, 0) == 2 * count - count / 3);
+	REQUIRE(result->Fetch<string>(5, 0) == "1992-01-01");
+	REQUIRE(result->Fetch<string>(6, 0) == "1992-01-01 12:30:15");
+	result = tester.Query("SELECT s, COUNT(*) FROM test GROUP BY s ORDER BY s");
+	REQUIRE(NO_FAIL(*result));
+	REQUIRE(result->IsNull(0, 0));
+	REQUIRE(result->Fetch<string>(0, 1) == "even");
+	REQUIRE(result->Fetch<string>(0, 2) == "odd");
+	REQUIRE(result->Fetch<int64_t>(1, 1) == 2500);
+
+	// a destroyed appender that was not committed rolls back its rows
+	status = duckdb_appender_create(tester.connection, DEFAULT_SCHEMA, "test", &appender);
+	REQUIRE(status == DuckDBSuccess);
+	status = duckdb_append_columns(appender, count, columns, nullptr);
+	REQUIRE(status == DuckDBSuccess);
+	duckdb_appender_destroy(&appender);
+	result = tester.Query("SELECT COUNT(*) FROM test");
+	REQUIRE(NO_FAIL(*result));
+	REQUIRE(result->Fetch<int64_t>(0, 0) == 2 * count);
+
+	// appending to a table that does not exist fails
+	status = duckdb_appender_create(tester.connection, nullptr, "nonexistent", &appender);
+	REQUIRE(status == DuckDBError);
+	REQUIRE(appender == nullptr);
+	// appending NULL arrays fails
+	REQUIRE(duckdb_append_columns(nullptr, count, columns, nullptr) == DuckDBError);
+}
@@ -59,27 +59,24 @@ TEST_CASE("Multiple PRIMARY KEY constraint", "[constraints]") {
 	DuckDB db(nullptr);
 	Connection con(db);
 
-	// FIXME: not supported by ART yet
-	REQUIRE_FAIL(con.Query("CREATE TABLE integers(i INTEGER, j VARCHAR, PRIMARY KEY(i, j))"));
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER, j VARCHAR, PRIMARY KEY(i, j))"));
 
-	// REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER, j VARCHAR, PRIMARY KEY(i, j))"));
-
-	// // insert unique values
-	// REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (3, 'hello'), (3, 'world')"));
+	// insert unique values
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (3, 'hello'), (3, 'world')"));
 
-	// result = con.Query("SELECT * FROM integers");
-	// REQUIRE(CHECK_COLUMN(result, 0, {3, 3}));
-	// REQUIRE(CHECK_COLUMN(result, 1, {"hello", "world"}));
+	result = con.Query("SELECT * FROM integers");
+	REQUIRE(CHECK_COLUMN(result, 0, {3, 3}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"hello", "world"}));
 
-	// // insert a duplicate value as part of a chain of values
-	// REQUIRE_FAIL(con.Query("INSERT INTO integers VALUES (6, 'bla'), (3, 'hello');"));
+	// insert a duplicate value as part of a chain of values
+	REQUIRE_FAIL(con.Query("INSERT INTO integers VALUES (6, 'bla'), (3, 'hello');"));
 
-	// // now insert just the first value
-	// REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (6, 'bla');"));
+	// now insert just the first value
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (6, 'bla');"));
 
-	// result = con.Query("SELECT * FROM integers");
-	// REQUIRE(CHECK_COLUMN(result, 0, {3, 3, 6}));
-	// REQUIRE(CHECK_COLUMN(result, 1, {"hello", "world", "bla"}));
+	result = con.Query("SELECT * FROM integers");
+	REQUIRE(CHECK_COLUMN(result, 0, {3, 3, 6}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"hello", "world", "bla"}));
 }
 
 TEST_CASE("PRIMARY KEY and transactions", "[constraints]") {
@@ -136,6 +133,17 @@ TEST_CASE("PRIMARY KEY and update/delete", "[constraints]") {
 	// set a column to NULL should fail
 	REQUIRE_FAIL(con.Query("UPDATE test SET a=NULL WHERE b=1;"));
 	REQUIRE_FAIL(con.Query("UPDATE test SET a=NULL;"));
+
+	// update the keys of a few rows scattered over a chunk
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE numbers (a INTEGER PRIMARY KEY);"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO numbers VALUES (0);"));
+	for (index_t i = 0; i < 6; i++) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO numbers SELECT a + (SELECT COUNT(*) FROM numbers) FROM numbers;"));
+	}
+	REQUIRE_NO_FAIL(con.Query("UPDATE numbers SET a=a+100 WHERE a%10=2 AND a>30;"));
+	result = con.Query("SELECT a FROM numbers WHERE a>40 ORDER BY a;");
+	REQUIRE(CHECK_COLUMN(result, 0, {41, 43, 44, 45, 46, 47, 48, 49, 50, 51, 53, 54, 55, 56, 57, 58, 59, 60, 61, 63,
+	                                 132, 142, 152, 162}));
 }
 
 TEST_CASE("PRIMARY KEY and update/delete on multiple columns", "[constraints]") {
@@ -143,43 +151,77 @@ TEST_CASE("PRIMARY KEY and update/delete on multiple columns", "[constraints]")
 	DuckDB db(nullptr);
 	Connection con(db);
 
-	// FIXME: not supported by ART yet
-	REQUIRE_FAIL(con.Query("CREATE TABLE test (a INTEGER, b VARCHAR, PRIMARY KEY(a, b));"));
-
-	// // create a table
-	// REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b VARCHAR, PRIMARY KEY(a, b));"));
-	// REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (11, 'hello'), (12, "
-	//                           "'world'), (13, 'blablabla')"));
-	// // update one of the columns, should work as it does not introduce duplicates
-	// REQUIRE_NO_FAIL(con.Query("UPDATE test SET b='hello';"));
-	// //! Set every key one higher, should also work without conflicts
-	// REQUIRE_NO_FAIL(con.Query("UPDATE test SET a=a+1;"));
-	// //! Set only the first key higher, should not work as this introduces a
-	// //! duplicate key!
-	// REQUIRE_FAIL(con.Query("UPDATE test SET a=a+1 WHERE a<=12;"));
-	// //! Set all keys to 4, results in a conflict!
-	// REQUIRE_FAIL(con.Query("UPDATE test SET a=4;"));
-
-	// result = con.Query("SELECT * FROM test;");
-	// REQUIRE(CHECK_COLUMN(result, 0, {12, 13, 14}));
-	// REQUIRE(CHECK_COLUMN(result, 1, {Value("hello"), Value("hello"), Value("hello")}));
-
-	// // delete and insert the same value should just work
-	// REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=12"));
-	// REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (12, 'hello');"));
-
-	// // insert a duplicate should fail
-	// REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (12, 'hello');"));
-
-	// // update one key
-	// REQUIRE_NO_FAIL(con.Query("UPDATE test SET a=4 WHERE a=12;"));
-
-	// result = con.Query("SELECT * FROM test ORDER BY a;");
-	// REQUIRE(CHECK_COLUMN(result, 0, {4, 13, 14}));
-	// REQUIRE(CHECK_COLUMN(result, 1, {Value("hello"), Value("hello"), Value("hello")}));
-
-	// // set a column to NULL should fail
-	// REQUIRE_FAIL(con.Query("UPDATE test SET b=NULL WHERE a=13;"));
+	// create a table
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b VARCHAR, PRIMARY KEY(a, b));"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (11, 'hello'), (12, "
+	                          "'world'), (13, 'blablabla')"));
+	// update one of the columns, should work as it does not introduce duplicates
+	REQUIRE_NO_FAIL(con.Query("UPDATE test SET b='hello';"));
+	//! Set every key one higher, should also work without conflicts
+	REQUIRE_NO_FAIL(con.Query("UPDATE test SET a=a+1;"));
+	//! Set only the first key higher, should not work as this introduces a
+	//! duplicate key!
+	REQUIRE_FAIL(con.Query("UPDATE test SET a=a+1 WHERE a<=12;"));
+	//! Set all keys to 4, results in a conflict!
+	REQUIRE_FAIL(con.Query("UPDATE test SET a=4;"));
+
+	result = con.Query("SELECT * FROM test;");
+	REQUIRE(CHECK_COLUMN(result, 0, {12, 13, 14}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value("hello"), Value("hello"), Value("hello")}));
+
+	// delete and insert the same value should just work
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=12"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (12, 'hello');"));
+
+	// insert a duplicate should fail
+	REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (12, 'hello');"));
+
+	// update one key
+	REQUIRE_NO_FAIL(con.Query("UPDATE test SET a=4 WHERE a=12;"));
+
+	result = con.Query("SELECT * FROM test ORDER BY a;");
+	REQUIRE(CHECK_COLUMN(result, 0, {4, 13, 14}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value("hello"), Value("hello"), Value("hello")}));
+
+	// set a column to NULL should fail
+	REQUIRE_FAIL(con.Query("UPDATE test SET b=NULL WHERE a=13;"));
+}
+
+TEST_CASE("PRIMARY KEY and updates that keep or swap keys", "[constraints]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER PRIMARY KEY, j INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1, 1), (2, 2), (3, 3)"));
+
+	// updating a column that is not part of the key keeps the key in the index
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET j=j+10"));
+	REQUIRE_FAIL(con.Query("INSERT INTO integers VALUES (1, 1)"));
+	REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET j=j+10"));
+	REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
+	REQUIRE_FAIL(con.Query("INSERT INTO integers VALUES (2, 2)"));
+
+	// rows can swap their keys
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET i=4-i"));
+	result = con.Query("SELECT i, j FROM integers ORDER BY i");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 3}));
+	REQUIRE(CHECK_COLUMN(result, 1, {13, 12, 11}));
+	REQUIRE_FAIL(con.Query("INSERT INTO integers VALUES (3, 3)"));
+
+	// a key that is changed and changed back within a transaction stays in the index
+	REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET i=10 WHERE i=1"));
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET i=1 WHERE i=10"));
+	REQUIRE_NO_FAIL(con.Query("COMMIT"));
+	REQUIRE_FAIL(con.Query("INSERT INTO integers VALUES (1, 1)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (10, 10)"));
+
+	result = con.Query("SELECT i FROM integers WHERE i=1");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	result = con.Query("SELECT j FROM integers WHERE i=10");
+	REQUIRE(CHECK_COLUMN(result, 0, {10}));
 }
 
 TEST_CASE("PRIMARY KEY and update/delete in the same transaction", "[constraints]") {
@@ -645,6 +645,49 @@ TEST_CASE("Test date copy", "[copy]") {
 	REQUIRE(CHECK_COLUMN(result, 0, {"2019-06-05"}));
 }
 
+TEST_CASE("Test copy into typed columns", "[copy]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE typed(b BOOLEAN, t TINYINT, s SMALLINT, i INTEGER, l BIGINT, f REAL, "
+	                          "d DOUBLE, dt DATE, ts TIMESTAMP, v VARCHAR)"));
+
+	auto csv_path = GetCSVPath();
+	auto typed_csv = fs.JoinPath(csv_path, "typed.csv");
+	WriteCSV(typed_csv, "true,1,1000,100000,10000000000,0.5,1e3,2019-06-05,2019-06-05 12:30:00,\"a,b\"\n"
+	                    "false, -2 ,-1000,\"42\",-10000000000,-1.25, 2.5 ,1992-01-01,2000-01-01,hello\n"
+	                    ",,,,,,,,,\n");
+	result = con.Query("COPY typed FROM '" + typed_csv + "'");
+	REQUIRE(CHECK_COLUMN(result, 0, {3}));
+
+	result = con.Query("SELECT b, t, s, i, l, CAST(f AS DOUBLE), d, CAST(dt AS VARCHAR), CAST(ts AS VARCHAR), v FROM "
+	                   "typed ORDER BY t");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value(), false, true}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value(), -2, 1}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value(), -1000, 1000}));
+	REQUIRE(CHECK_COLUMN(result, 3, {Value(), 42, 100000}));
+	REQUIRE(CHECK_COLUMN(result, 4, {Value(), Value::BIGINT(-10000000000), Value::BIGINT(10000000000)}));
+	REQUIRE(CHECK_COLUMN(result, 5, {Value(), -1.25, 0.5}));
+	REQUIRE(CHECK_COLUMN(result, 6, {Value(), 2.5, 1000}));
+	REQUIRE(CHECK_COLUMN(result, 7, {Value(), "1992-01-01", "2019-06-05"}));
+	REQUIRE(CHECK_COLUMN(result, 8, {Value(), "2000-01-01 00:00:00", "2019-06-05 12:30:00"}));
+	REQUIRE(CHECK_COLUMN(result, 9, {Value(), "hello", "a,b"}));
+
+	// values that cannot be converted to the type of the column result in an error
+	WriteCSV(typed_csv, "true,1,1000,1000000000000,1,0.5,1,2019-06-05,2019-06-05 12:30:00,a\n");
+	REQUIRE_FAIL(con.Query("COPY typed FROM '" + typed_csv + "'"));
+	WriteCSV(typed_csv, "true,1,1000,1,1,0.5,one,2019-06-05,2019-06-05 12:30:00,a\n");
+	REQUIRE_FAIL(con.Query("COPY typed FROM '" + typed_csv + "'"));
+	WriteCSV(typed_csv, "true,1,1000,1,1,0.5,1,2019-13-05,2019-06-05 12:30:00,a\n");
+	REQUIRE_FAIL(con.Query("COPY typed FROM '" + typed_csv + "'"));
+	WriteCSV(typed_csv, "maybe,1,1000,1,1,0.5,1,2019-06-05,2019-06-05 12:30:00,a\n");
+	REQUIRE_FAIL(con.Query("COPY typed FROM '" + typed_csv + "'"));
+
+	result = con.Query("SELECT COUNT(*) FROM typed");
+	REQUIRE(CHECK_COLUMN(result, 0, {3}));
+}
+
 TEST_CASE("Test cranlogs broken gzip copy", "[copy]") {
 	unique_ptr<QueryResult> result;
 	DuckDB db(nullptr);
@@ -660,3 +703,78 @@ TEST_CASE("Test cranlogs broken gzip copy", "[copy]") {
 	result = con.Query("COPY cranlogs FROM '" + cranlogs_csv + "' DELIMITER ',' HEADER");
 	REQUIRE(CHECK_COLUMN(result, 0, {37459}));
 }
+
+TEST_CASE("Test parallel copy from a csv file", "[copy]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	auto csv_path = GetCSVPath();
+	auto csv_file = fs.JoinPath(csv_path, "parallel.csv");
+	// generate a CSV file that is split into multiple batches of multiple ranges, with quoted values that contain
+	// delimiters and newlines, and with a mix of \n and \r\n newlines
+	index_t line_count = 400000;
+	ofstream from_csv_file(csv_file, ios::binary);
+	from_csv_file << "i,s,d\n";
+	for (index_t i = 0; i < line_count; i++) {
+		from_csv_file << i << "," << (i % 7 == 0 ? "\"a,b\nc\"" : "a row of the csv file") << "," << i / 2
+		              << (i % 2 == 0 ? "" : ".5") << (i % 11 == 0 ? "\r\n" : "\n");
+	}
+	from_csv_file.close();
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE serial (i INTEGER, s VARCHAR, d DOUBLE)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE parallel (i INTEGER, s VARCHAR, d DOUBLE)"));
+	result = con.Query("COPY serial FROM '" + csv_file + "' HEADER");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(line_count)}));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=2"));
+	result = con.Query("COPY parallel FROM '" + csv_file + "' HEADER");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(line_count)}));
+
+	result = con.Query("SELECT COUNT(*), SUM(i), SUM(d), COUNT(DISTINCT s) FROM parallel");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(line_count)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(79999800000)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::DOUBLE(39999900000)}));
+	REQUIRE(CHECK_COLUMN(result, 3, {2}));
+	result = con.Query("SELECT COUNT(*) FROM parallel WHERE s = 'a,b\nc'");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(57143)}));
+	// the rows are appended in the order of the file
+	result = con.Query("SELECT COUNT(*) FROM serial, parallel WHERE serial.rowid = parallel.rowid AND serial.i = "
+	                   "parallel.i AND serial.s = parallel.s AND serial.d = parallel.d");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(line_count)}));
+
+	// characters after the end quote of a field are read as quoted again, also across delimiters and newlines
+	from_csv_file.open(csv_file, ios::binary);
+	for (index_t i = 0; i < line_count; i++) {
+		from_csv_file << i << "," << (i % 5 == 0 ? "\"a\"b,c\nd\"e\"" : "row") << ",1.5\n";
+	}
+	from_csv_file.close();
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM serial"));
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM parallel"));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=1"));
+	result = con.Query("COPY serial FROM '" + csv_file + "'");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(line_count)}));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=2"));
+	result = con.Query("COPY parallel FROM '" + csv_file + "'");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(line_count)}));
+	result = con.Query("SELECT COUNT(*) FROM parallel WHERE s = 'a\"b,c\nd\"e'");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(80000)}));
+	result = con.Query("SELECT COUNT(*) FROM serial, parallel WHERE serial.rowid = parallel.rowid AND "
+	                   "serial.i = parallel.i AND serial.s = parallel.s");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(line_count)}));
+
+	// errors are reported from the range that contains them
+	from_csv_file.open(csv_file, ios::binary);
+	for (index_t i = 0; i < line_count; i++) {
+		from_csv_file << i << ",row," << (i == 300000 ? "hello" : "1.5") << "\n";
+	}
+	from_csv_file.close();
+	REQUIRE_FAIL(con.Query("COPY parallel FROM '" + csv_file + "'"));
+	// an unterminated quote at the end of the file
+	from_csv_file.open(csv_file, ios::binary);
+	for (index_t i = 0; i < line_count; i++) {
+		from_csv_file << i << ",row,1.5\n";
+	}
+	from_csv_file << "1,\"row,1.5\n";
+	from_csv_file.close();
+	REQUIRE_FAIL(con.Query("COPY parallel FROM '" + csv_file + "'"));
+}
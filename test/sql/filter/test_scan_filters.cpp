@@ -0,0 +1,83 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test filters that are evaluated in the table scan", "[filter]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db), con2(db);
+	con.EnableQueryVerification();
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER, j INTEGER, s VARCHAR, d DOUBLE)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1, 10, 'hello', 0.5), (2, NULL, 'world', 1.5), (NULL, 30, "
+	                          "NULL, NULL), (4, 40, 'hello', 3.5)"));
+
+	// simple filters on a single column
+	result = con.Query("SELECT i, j FROM integers WHERE i > 1 ORDER BY i");
+	REQUIRE(CHECK_COLUMN(result, 0, {2, 4}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value(), 40}));
+	result = con.Query("SELECT j FROM integers WHERE 2 >= i ORDER BY j");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value(), 10}));
+	result = con.Query("SELECT i FROM integers WHERE j = 30");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value()}));
+	result = con.Query("SELECT i FROM integers WHERE i < 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	// multiple filters, on the same and on different columns
+	result = con.Query("SELECT i FROM integers WHERE i >= 1 AND i < 4 AND j > 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	result = con.Query("SELECT i, d FROM integers WHERE s = 'hello' AND d > 1 ORDER BY i");
+	REQUIRE(CHECK_COLUMN(result, 0, {4}));
+	REQUIRE(CHECK_COLUMN(result, 1, {3.5}));
+	// string filters
+	result = con.Query("SELECT i FROM integers WHERE s > 'hello'");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE s <= 'hello'");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+	// filters together with the row id and with filters that cannot be evaluated in the scan
+	result = con.Query("SELECT rowid, i FROM integers WHERE i > 1 AND i + j > 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {3}));
+	REQUIRE(CHECK_COLUMN(result, 1, {4}));
+	result = con.Query("SELECT rowid FROM integers WHERE d < 2 ORDER BY 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {0, 1}));
+
+	// the filters are also applied to rows that have version information
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM integers WHERE i = 1"));
+	REQUIRE_NO_FAIL(con2.Query("BEGIN TRANSACTION"));
+	REQUIRE_NO_FAIL(con2.Query("UPDATE integers SET i = 100 WHERE i = 2"));
+	result = con.Query("SELECT i FROM integers WHERE i > 1 ORDER BY i");
+	REQUIRE(CHECK_COLUMN(result, 0, {2, 4}));
+	result = con2.Query("SELECT i, s FROM integers WHERE i > 1 ORDER BY i");
+	REQUIRE(CHECK_COLUMN(result, 0, {4, 100}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"hello", "world"}));
+	result = con2.Query("SELECT i FROM integers WHERE i < 10");
+	REQUIRE(CHECK_COLUMN(result, 0, {4}));
+	REQUIRE_NO_FAIL(con2.Query("ROLLBACK"));
+}
+
+TEST_CASE("Test scan filters on multiple vectors", "[filter]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE test(a INTEGER, b INTEGER, c VARCHAR)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (0, 0, '0')"));
+	for (index_t i = 0; i < 14; i++) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT a + (SELECT COUNT(*) FROM test), (a + (SELECT COUNT(*) FROM "
+		                          "test)) % 7, CAST(a + (SELECT COUNT(*) FROM test) AS VARCHAR) FROM test"));
+	}
+	// filters that select no rows, some rows and all rows of a vector
+	result = con.Query("SELECT COUNT(*), SUM(a) FROM test WHERE a >= 1000 AND a < 3000 AND b = 3");
+	REQUIRE(CHECK_COLUMN(result, 0, {286}));
+	REQUIRE(CHECK_COLUMN(result, 1, {572429}));
+	result = con.Query("SELECT COUNT(*), SUM(b) FROM test WHERE a >= 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {16384}));
+	REQUIRE(CHECK_COLUMN(result, 1, {49146}));
+	result = con.Query("SELECT a, c FROM test WHERE b > 5 AND a > 16370 ORDER BY a");
+	REQUIRE(CHECK_COLUMN(result, 0, {16372, 16379}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"16372", "16379"}));
+	// a filter on the row id is not evaluated in the scan
+	result = con.Query("SELECT COUNT(*) FROM test WHERE rowid >= 16000 AND b = 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {55}));
+}
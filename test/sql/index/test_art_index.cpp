@@ -1106,9 +1106,190 @@ TEST_CASE("Index Exceptions", "[art]") {
 
 	REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON integers using blabla(i)"));
 
-	REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON integers(i,j)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX i_index ON integers(i,j)"));
 
-	REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON integers(k)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX k_index ON integers(k)"));
 
-	REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON integers(f)"));
+	REQUIRE_FAIL(con.Query("CREATE INDEX f_index ON integers(f)"));
+}
+
+TEST_CASE("Test ART index on VARCHAR columns", "[art]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE strings(s VARCHAR, i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX s_index ON strings(s)"));
+	// strings that share long prefixes, and strings that are prefixes of other strings
+	vector<string> values = {"hello", "hell", "hello world", "", "hello worlds", "help", "a", "zzzzzzzzzzzzzzzzzzzz",
+	                         "zzzzzzzzzzzzzzzzzzzy", "hello"};
+	for (index_t i = 0; i < values.size(); i++) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES ($1, $2)", values[i], (int32_t)i));
+	}
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES (NULL, 100)"));
+
+	result = con.Query("SELECT i FROM strings WHERE s='hello' ORDER BY i");
+	REQUIRE(CHECK_COLUMN(result, 0, {0, 9}));
+	result = con.Query("SELECT i FROM strings WHERE s='hell'");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	result = con.Query("SELECT i FROM strings WHERE s=''");
+	REQUIRE(CHECK_COLUMN(result, 0, {3}));
+	result = con.Query("SELECT i FROM strings WHERE s='hello worl'");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	result = con.Query("SELECT s FROM strings WHERE s>'hello' ORDER BY s");
+	REQUIRE(CHECK_COLUMN(result, 0, {"hello world", "hello worlds", "help", "zzzzzzzzzzzzzzzzzzzy",
+	                                 "zzzzzzzzzzzzzzzzzzzz"}));
+	result = con.Query("SELECT s FROM strings WHERE s>='hello' AND s<'z' ORDER BY s");
+	REQUIRE(CHECK_COLUMN(result, 0, {"hello", "hello", "hello world", "hello worlds", "help"}));
+	result = con.Query("SELECT s FROM strings WHERE s<'hello' ORDER BY s");
+	REQUIRE(CHECK_COLUMN(result, 0, {"", "a", "hell"}));
+	result = con.Query("SELECT s FROM strings WHERE s>'hellp' AND s<='zzzzzzzzzzzzzzzzzzzy' ORDER BY s");
+	REQUIRE(CHECK_COLUMN(result, 0, {"help", "zzzzzzzzzzzzzzzzzzzy"}));
+
+	// delete and update entries
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM strings WHERE i=0"));
+	REQUIRE_NO_FAIL(con.Query("UPDATE strings SET s='hello worlds' WHERE s='hello world'"));
+	result = con.Query("SELECT i FROM strings WHERE s='hello'");
+	REQUIRE(CHECK_COLUMN(result, 0, {9}));
+	result = con.Query("SELECT i FROM strings WHERE s='hello world'");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	result = con.Query("SELECT i FROM strings WHERE s='hello worlds' ORDER BY i");
+	REQUIRE(CHECK_COLUMN(result, 0, {2, 4}));
+	result = con.Query("SELECT COUNT(*) FROM strings WHERE s>=''");
+	REQUIRE(CHECK_COLUMN(result, 0, {9}));
+}
+
+TEST_CASE("Test ART index on floating point columns", "[art]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE doubles(d DOUBLE, f REAL)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX d_index ON doubles(d)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX f_index ON doubles(f)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO doubles VALUES (-1e100, -1e30), (-2.5, -2.5), (-0.0, -0.0), (0.0, 0.0), "
+	                          "(1e-300, 0.25), (0.5, 0.5), (2.5, 2.5), (1e100, 1e30)"));
+
+	result = con.Query("SELECT COUNT(*) FROM doubles WHERE d=0");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+	result = con.Query("SELECT COUNT(*) FROM doubles WHERE f=0");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+	result = con.Query("SELECT d FROM doubles WHERE d<0 ORDER BY d");
+	REQUIRE(CHECK_COLUMN(result, 0, {-1e100, -2.5}));
+	result = con.Query("SELECT d FROM doubles WHERE d>0 AND d<=2.5 ORDER BY d");
+	REQUIRE(CHECK_COLUMN(result, 0, {1e-300, 0.5, 2.5}));
+	result = con.Query("SELECT CAST(f AS DOUBLE) FROM doubles WHERE f>=-2.5 AND f<1 ORDER BY f");
+	REQUIRE(CHECK_COLUMN(result, 0, {-2.5, 0, 0, 0.25, 0.5}));
+	result = con.Query("SELECT COUNT(*) FROM doubles WHERE f>0.5");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+}
+
+TEST_CASE("Test ART index on multiple columns", "[art]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(
+	    con.Query("CREATE TABLE accounts(tenant_id INTEGER, external_id VARCHAR, created DATE, v INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX account_index ON accounts(tenant_id, external_id)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX date_index ON accounts(created, tenant_id)"));
+	for (index_t tenant = 0; tenant < 10; tenant++) {
+		for (index_t i = 0; i < 20; i++) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO accounts VALUES ($1, $2, CAST($3 AS DATE), $4)", (int32_t)tenant,
+			                          "account-" + to_string(i), "2019-01-0" + to_string(1 + i % 5),
+			                          (int32_t)(tenant * 100 + i)));
+		}
+	}
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO accounts VALUES (1, NULL, NULL, -1), (NULL, 'account-1', NULL, -2)"));
+
+	// equality on all the columns of the index
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=3 AND external_id='account-12'");
+	REQUIRE(CHECK_COLUMN(result, 0, {312}));
+	result = con.Query("SELECT v FROM accounts WHERE external_id='account-1' AND tenant_id=0");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=3 AND external_id='account-20'");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=10 AND external_id='account-1'");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=3 AND external_id='account-12' AND v > 400");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	result = con.Query("SELECT v FROM accounts WHERE created=DATE '2019-01-03' AND tenant_id=4 ORDER BY v");
+	REQUIRE(CHECK_COLUMN(result, 0, {402, 407, 412, 417}));
+	// predicates on a part of the index
+	result = con.Query("SELECT COUNT(*) FROM accounts WHERE tenant_id=3");
+	REQUIRE(CHECK_COLUMN(result, 0, {20}));
+	result = con.Query("SELECT COUNT(*) FROM accounts WHERE external_id='account-1'");
+	REQUIRE(CHECK_COLUMN(result, 0, {11}));
+	result = con.Query("SELECT COUNT(*) FROM accounts WHERE tenant_id=3 AND external_id>'account-5'");
+	REQUIRE(CHECK_COLUMN(result, 0, {4}));
+
+	// updates and deletes
+	REQUIRE_NO_FAIL(
+	    con.Query("UPDATE accounts SET external_id='moved' WHERE tenant_id=3 AND external_id='account-12'"));
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=3 AND external_id='account-12'");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=3 AND external_id='moved'");
+	REQUIRE(CHECK_COLUMN(result, 0, {312}));
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM accounts WHERE tenant_id=5"));
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=5 AND external_id='account-5'");
+	REQUIRE(CHECK_COLUMN(result, 0, {}));
+	result = con.Query("SELECT v FROM accounts WHERE tenant_id=6 AND external_id='account-5'");
+	REQUIRE(CHECK_COLUMN(result, 0, {605}));
+	result = con.Query("SELECT COUNT(*) FROM accounts WHERE created=DATE '2019-01-01' AND tenant_id=5");
+	REQUIRE(CHECK_COLUMN(result, 0, {0}));
+
+	// a UNIQUE constraint on multiple columns
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE pairs(i INTEGER, s VARCHAR, d DOUBLE, UNIQUE(s, d, i))"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO pairs VALUES (1, 'a', 0.5), (1, 'a', 1.5), (2, 'a', 0.5), (1, 'ab', 0.5)"));
+	REQUIRE_FAIL(con.Query("INSERT INTO pairs VALUES (1, 'a', 1.5)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO pairs VALUES (1, NULL, 1.5), (1, NULL, 1.5)"));
+	result = con.Query("SELECT COUNT(*) FROM pairs");
+	REQUIRE(CHECK_COLUMN(result, 0, {6}));
+}
+
+TEST_CASE("Test ART index creation on a table with existing rows", "[art]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// the existing rows are sorted in parallel when the index is created
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE t(i INTEGER, s VARCHAR)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO t VALUES (0, 's0')"));
+	for (index_t count = 1; count < 131072; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO t SELECT i + (SELECT COUNT(*) FROM t), 's' || CAST((i + (SELECT "
+		                          "COUNT(*) FROM t)) % 1000 AS VARCHAR) FROM t"));
+	}
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO t VALUES (NULL, NULL)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX i_index ON t(i)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX s_index ON t(s)"));
+
+	result = con.Query("SELECT s FROM t WHERE i = 77777");
+	REQUIRE(CHECK_COLUMN(result, 0, {"s777"}));
+	result = con.Query("SELECT COUNT(*), SUM(i) FROM t WHERE i >= 1000 AND i < 2000");
+	REQUIRE(CHECK_COLUMN(result, 0, {1000}));
+	REQUIRE(CHECK_COLUMN(result, 1, {1499500}));
+	// every value of s occurs in many rows
+	result = con.Query("SELECT COUNT(*), SUM(i) FROM t WHERE s = 's123'");
+	REQUIRE(CHECK_COLUMN(result, 0, {131}));
+	REQUIRE(CHECK_COLUMN(result, 1, {8531113}));
+	result = con.Query("SELECT s, COUNT(*) FROM t WHERE s > 's998' GROUP BY s");
+	REQUIRE(CHECK_COLUMN(result, 0, {"s999"}));
+	REQUIRE(CHECK_COLUMN(result, 1, {131}));
+
+	// the index can be modified after it was created
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO t VALUES (131072, 's123')"));
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM t WHERE i = 77777 OR i = 123"));
+	result = con.Query("SELECT COUNT(*) FROM t WHERE i = 77777");
+	REQUIRE(CHECK_COLUMN(result, 0, {0}));
+	result = con.Query("SELECT COUNT(*), SUM(i) FROM t WHERE s = 's123'");
+	REQUIRE(CHECK_COLUMN(result, 0, {131}));
+	REQUIRE(CHECK_COLUMN(result, 1, {8531113 + 131072 - 123}));
+
+	// an index on an empty table
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE empty(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX empty_index ON empty(i)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO empty VALUES (1)"));
+	result = con.Query("SELECT COUNT(*) FROM empty WHERE i = 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
 }
@@ -147,4 +147,39 @@ TEST_CASE("Test correct functioning of art keys", "[art]") {
 	TestKeys(keys);
 
 	keys.clear();
+
+	// Test floating point numbers
+	keys.push_back(Key::CreateKey<double>(-1e300, is_little_endian));
+	keys.push_back(Key::CreateKey<double>(-2.5, is_little_endian));
+	keys.push_back(Key::CreateKey<double>(-1e-300, is_little_endian));
+	keys.push_back(Key::CreateKey<double>(0, is_little_endian));
+	keys.push_back(Key::CreateKey<double>(1e-300, is_little_endian));
+	keys.push_back(Key::CreateKey<double>(0.5, is_little_endian));
+	keys.push_back(Key::CreateKey<double>(2.5, is_little_endian));
+	keys.push_back(Key::CreateKey<double>(1e300, is_little_endian));
+	TestKeys(keys);
+	TestKeyEqual(*Key::CreateKey<double>(-0.0, is_little_endian), *Key::CreateKey<double>(0.0, is_little_endian));
+	TestKeyEqual(*Key::CreateKey<float>(-0.0f, is_little_endian), *Key::CreateKey<float>(0.0f, is_little_endian));
+
+	keys.clear();
+
+	keys.push_back(Key::CreateKey<float>(-1e30f, is_little_endian));
+	keys.push_back(Key::CreateKey<float>(-0.5f, is_little_endian));
+	keys.push_back(Key::CreateKey<float>(0, is_little_endian));
+	keys.push_back(Key::CreateKey<float>(1e-30f, is_little_endian));
+	keys.push_back(Key::CreateKey<float>(1e30f, is_little_endian));
+	TestKeys(keys);
+
+	keys.clear();
+
+	// test compound keys created from values
+	keys.push_back(Key::CreateKey({Value::INTEGER(-1), Value("b"), Value::BOOLEAN(true)}, is_little_endian));
+	keys.push_back(Key::CreateKey({Value::INTEGER(1), Value(""), Value::BOOLEAN(true)}, is_little_endian));
+	keys.push_back(Key::CreateKey({Value::INTEGER(1), Value("a"), Value::BOOLEAN(false)}, is_little_endian));
+	keys.push_back(Key::CreateKey({Value::INTEGER(1), Value("a"), Value::BOOLEAN(true)}, is_little_endian));
+	keys.push_back(Key::CreateKey({Value::INTEGER(1), Value("ab"), Value::BOOLEAN(false)}, is_little_endian));
+	keys.push_back(Key::CreateKey({Value::INTEGER(2), Value("a"), Value::BOOLEAN(false)}, is_little_endian));
+	TestKeys(keys);
+
+	keys.clear();
 }
@@ -297,3 +297,56 @@ TEST_CASE("Parallel appends to table with index with transactions", "[index][.]"
 	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(THREAD_COUNT * 500)}));
 	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(THREAD_COUNT * 500)}));
 }
+
+static void lookup_stored_keys(DuckDB *db, bool *correct, index_t threadnr) {
+	Connection con(*db);
+	correct[threadnr] = true;
+	for (index_t i = 0; i < 200; i++) {
+		auto key = to_string((threadnr * 977 + i * 31) % 8192);
+		auto result = con.Query("SELECT k, v FROM test WHERE k = " + key);
+		if (!CHECK_COLUMN(result, 0, {Value::INTEGER(stoi(key))}) || !CHECK_COLUMN(result, 1, {"v" + key})) {
+			correct[threadnr] = false;
+		}
+	}
+}
+
+TEST_CASE("Concurrent lookups and inserts in a stored index", "[index]") {
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("concurrent_index_storage");
+	auto config = GetTestConfig();
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test(k INTEGER PRIMARY KEY, v VARCHAR)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (0, 'v0')"));
+		for (index_t count = 1; count < 8192; count *= 2) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT k + (SELECT COUNT(*) FROM test), 'v' || CAST(k + "
+			                          "(SELECT COUNT(*) FROM test) AS VARCHAR) FROM test"));
+		}
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	{
+		// the nodes of the stored index are loaded while the readers share the index with each other and with the
+		// inserts
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		bool correct[THREAD_COUNT];
+		thread threads[THREAD_COUNT];
+		for (index_t i = 0; i < THREAD_COUNT; i++) {
+			threads[i] = thread(lookup_stored_keys, &db, correct, i);
+		}
+		for (index_t i = 0; i < 100; i++) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (" + to_string(10000 + i) + ", 'x')"));
+		}
+		for (index_t i = 0; i < THREAD_COUNT; i++) {
+			threads[i].join();
+			REQUIRE(correct[i]);
+		}
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (10050, 'y')"));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE k >= 10000");
+		REQUIRE(CHECK_COLUMN(result, 0, {100}));
+	}
+	DeleteDatabase(storage_database);
+}
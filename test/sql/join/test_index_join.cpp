@@ -0,0 +1,74 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test joins that look up the keys in an index", "[join]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db), con2(db);
+
+	// a large table with a primary key, and a small table whose keys are looked up in the index
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE big(k INTEGER PRIMARY KEY, v VARCHAR, g INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO big VALUES (0, 'v0', 0)"));
+	for (index_t count = 1; count < 8192; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO big SELECT k + (SELECT COUNT(*) FROM big), 'v' || CAST(k + (SELECT "
+		                          "COUNT(*) FROM big) AS VARCHAR), (k + (SELECT COUNT(*) FROM big)) % 10 FROM big"));
+	}
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE small(k INTEGER, w INTEGER)"));
+	REQUIRE_NO_FAIL(
+	    con.Query("INSERT INTO small VALUES (1, 10), (5000, 20), (NULL, 30), (20000, 40), (5000, 50), (8191, 60)"));
+
+	// keys that are missing or NULL have no matches, duplicate keys match the same row
+	result = con.Query("SELECT small.k, w, v FROM small JOIN big ON small.k=big.k ORDER BY w");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 5000, 5000, 8191}));
+	REQUIRE(CHECK_COLUMN(result, 1, {10, 20, 50, 60}));
+	REQUIRE(CHECK_COLUMN(result, 2, {"v1", "v5000", "v5000", "v8191"}));
+	// the indexed table can be on either side of the join, with additional conditions
+	result =
+	    con.Query("SELECT big.k, v, w FROM big, small WHERE big.k=small.k AND w > 10 AND g <> w - 59 ORDER BY w");
+	REQUIRE(CHECK_COLUMN(result, 0, {5000, 5000}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"v5000", "v5000"}));
+	REQUIRE(CHECK_COLUMN(result, 2, {20, 50}));
+	result = con.Query("SELECT COUNT(*), SUM(w) FROM small JOIN big ON small.k=big.k AND small.w < big.k");
+	REQUIRE(CHECK_COLUMN(result, 0, {3}));
+	REQUIRE(CHECK_COLUMN(result, 1, {130}));
+	// keys computed from expressions on the probe side
+	result = con.Query("SELECT w, v FROM small JOIN big ON small.k + 1=big.k ORDER BY w");
+	REQUIRE(CHECK_COLUMN(result, 0, {10, 20, 50}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"v2", "v5001", "v5001"}));
+
+	// the join only sees the rows that are visible to the transaction
+	REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM big WHERE k=1"));
+	REQUIRE_NO_FAIL(con.Query("UPDATE big SET v='updated' WHERE k=5000"));
+	REQUIRE_NO_FAIL(con.Query("UPDATE big SET k=20000 WHERE k=8191"));
+	result = con.Query("SELECT small.k, w, v FROM small JOIN big ON small.k=big.k ORDER BY w");
+	REQUIRE(CHECK_COLUMN(result, 0, {5000, 20000, 5000}));
+	REQUIRE(CHECK_COLUMN(result, 1, {20, 40, 50}));
+	REQUIRE(CHECK_COLUMN(result, 2, {"updated", "v8191", "updated"}));
+	result = con2.Query("SELECT small.k, w, v FROM small JOIN big ON small.k=big.k ORDER BY w");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 5000, 5000, 8191}));
+	REQUIRE(CHECK_COLUMN(result, 1, {10, 20, 50, 60}));
+	REQUIRE(CHECK_COLUMN(result, 2, {"v1", "v5000", "v5000", "v8191"}));
+	REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
+
+	// an index that is not unique, on a VARCHAR column
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE names(name VARCHAR, id INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO names VALUES ('v7', 1), ('v3', 2), ('x', 3), ('v7', 4)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE tags(tag VARCHAR, k INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO tags SELECT v, k FROM big"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO tags SELECT v, k + 10000 FROM big WHERE k < 5"));
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX tag_index ON tags(tag)"));
+	result = con.Query("SELECT id, k FROM names JOIN tags ON name=tag ORDER BY id, k");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 2, 4}));
+	REQUIRE(CHECK_COLUMN(result, 1, {7, 3, 10003, 7}));
+
+	// an index on multiple columns is used if all of its columns are compared
+	REQUIRE_NO_FAIL(con.Query("CREATE INDEX group_index ON big(g, v)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE pairs(g INTEGER, v VARCHAR)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO pairs VALUES (3, 'v13'), (4, 'v13'), (NULL, 'v1'), (1, 'v1')"));
+	result = con.Query("SELECT big.k FROM pairs JOIN big ON pairs.g=big.g AND pairs.v=big.v ORDER BY 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 13}));
+}
@@ -0,0 +1,158 @@
+#include "catch.hpp"
+#include "common/file_system.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test hash joins that spill to disk", "[join]") {
+	unique_ptr<QueryResult> result;
+	FileSystem fs;
+	auto temp_directory = TestCreatePath("spilling_join");
+	TestDeleteDirectory(temp_directory);
+
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table with the values [1, 65536]
+	index_t table_size = 65536;
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER, s VARCHAR)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1, '1')"));
+	for (index_t count = 1; count < table_size; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers), CAST(i + (SELECT "
+		                          "COUNT(*) FROM integers) AS VARCHAR) FROM integers"));
+	}
+	// the hash tables of these joins do not fit in the memory limit
+	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=500KB"));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA temp_directory='" + temp_directory + "'"));
+
+	// inner joins
+	result = con.Query("SELECT COUNT(*), SUM(a.i), SUM(CAST(b.s AS INTEGER)) FROM integers a JOIN integers b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	REQUIRE(fs.DirectoryExists(temp_directory));
+	result = con.Query("SELECT COUNT(*) FROM integers a JOIN integers b ON a.s = b.s AND a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	result = con.Query("SELECT a.i, b.s FROM integers a JOIN integers b ON a.i = b.i * 2 WHERE b.i <= 3 ORDER BY 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {2, 4, 6}));
+	REQUIRE(CHECK_COLUMN(result, 1, {"1", "2", "3"}));
+
+	// outer, semi, anti and mark joins
+	result = con.Query("SELECT COUNT(*), COUNT(b.i) FROM integers a LEFT JOIN (SELECT i FROM integers WHERE i % 2 = 0) b "
+	                   "ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size / 2)}));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE i IN (SELECT i FROM integers WHERE i % 4 = 0)");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size / 4)}));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE i NOT IN (SELECT i FROM integers WHERE i % 4 = 0)");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(3 * table_size / 4)}));
+	// a NULL value anywhere in the build side makes every non-matching NOT IN NULL
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE (i NOT IN (SELECT CASE WHEN i = 1 THEN NULL ELSE i + 65536 "
+	                   "END FROM integers)) IS NULL");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	// mark joins where most partitions of the build side are empty: a NULL probe key is NULL, and a probe key without a
+	// match is NULL if the build side has a NULL value
+	result = con.Query("SELECT COUNT(*), COUNT(r), SUM(CASE WHEN r THEN 1 ELSE 0 END) FROM (SELECT (CASE WHEN i % 2 = 0 "
+	                   "THEN NULL ELSE i END) IN (SELECT 1 FROM integers) AS r FROM integers) t");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size / 2)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(1)}));
+	result = con.Query("SELECT COUNT(*), COUNT(r), SUM(CASE WHEN r THEN 1 ELSE 0 END) FROM (SELECT (CASE WHEN i % 2 = 0 "
+	                   "THEN NULL ELSE i END) IN (SELECT CASE WHEN i = 1 THEN NULL ELSE 1 END FROM integers) AS r FROM "
+	                   "integers) t");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(1)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(1)}));
+
+	// a prepared statement with a spilling join can be executed more than once
+	REQUIRE_NO_FAIL(con.Query("PREPARE s1 AS SELECT COUNT(*) FROM integers a JOIN integers b ON a.i = b.i WHERE a.i > $1"));
+	result = con.Query("EXECUTE s1(0)");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	result = con.Query("EXECUTE s1(0)");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE_NO_FAIL(con.Query("DEALLOCATE s1"));
+
+	// the spill files are cleaned up after the queries
+	index_t file_count = 0;
+	fs.ListFiles(temp_directory, [&](string path) { file_count++; });
+	REQUIRE(file_count == 0);
+
+	// partitions that still exceed the memory limit are split again
+	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=20KB"));
+	result = con.Query("SELECT COUNT(*), SUM(a.i), SUM(CAST(b.s AS INTEGER)) FROM integers a JOIN integers b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	// a partition with a single key cannot be split, it is built in memory
+	result = con.Query("SELECT COUNT(*) FROM integers a JOIN (SELECT i % 2 AS k FROM integers) b ON a.i % 2 = b.k "
+	                   "WHERE a.i <= 2");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+
+	// joins with a parallel build and probe side spill as well
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+	result = con.Query("SELECT COUNT(*), SUM(a.i), SUM(CAST(b.s AS INTEGER)) FROM integers a JOIN integers b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE (i NOT IN (SELECT CASE WHEN i = 1 THEN NULL ELSE i + 65536 "
+	                   "END FROM integers)) IS NULL");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	// joins that fit in memory are still built and probed in parallel
+	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=100MB"));
+	result = con.Query("SELECT COUNT(*), SUM(a.i) FROM integers a JOIN integers b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=1"));
+
+	file_count = 0;
+	fs.ListFiles(temp_directory, [&](string path) { file_count++; });
+	REQUIRE(file_count == 0);
+
+	// without a memory limit nothing is spilled
+	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=-1"));
+	result = con.Query("SELECT COUNT(*) FROM integers a JOIN integers b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE_FAIL(con.Query("PRAGMA temp_directory"));
+	TestDeleteDirectory(temp_directory);
+}
+
+TEST_CASE("Test that the temporary directory is removed when the database is closed", "[join]") {
+	unique_ptr<QueryResult> result;
+	FileSystem fs;
+	auto temp_directory = TestCreatePath("spilling_join_directory");
+	TestDeleteDirectory(temp_directory);
+	{
+		DuckDB db(nullptr);
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+		for (index_t count = 1; count < 16384; count *= 2) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+		}
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=100KB"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA temp_directory='" + temp_directory + "'"));
+		result = con.Query("SELECT COUNT(*) FROM integers a JOIN integers b ON a.i = b.i");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(16384)}));
+		REQUIRE(fs.DirectoryExists(temp_directory));
+	}
+	REQUIRE(!fs.DirectoryExists(temp_directory));
+
+	// a directory that already existed is kept
+	fs.CreateDirectory(temp_directory);
+	{
+		DuckDB db(nullptr);
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+		for (index_t count = 1; count < 16384; count *= 2) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+		}
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=100KB"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA temp_directory='" + temp_directory + "'"));
+		result = con.Query("SELECT COUNT(*) FROM integers a JOIN integers b ON a.i = b.i");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(16384)}));
+	}
+	REQUIRE(fs.DirectoryExists(temp_directory));
+	TestDeleteDirectory(temp_directory);
+}
@@ -0,0 +1,64 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test parallel hash aggregation", "[parallelism]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table that spans multiple storage chunks (morsels) with the values [1, 65536]
+	index_t table_size = 65536;
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+	for (index_t count = 1; count < table_size; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+
+	// grouped aggregates
+	result =
+	    con.Query("SELECT i % 4 AS g, COUNT(*), SUM(i), MIN(i), MAX(i), AVG(i) FROM integers GROUP BY g ORDER BY g");
+	REQUIRE(CHECK_COLUMN(result, 0, {0, 1, 2, 3}));
+	REQUIRE(CHECK_COLUMN(result, 1, {16384, 16384, 16384, 16384}));
+	REQUIRE(CHECK_COLUMN(result, 2, {536903680, 536854528, 536870912, 536887296}));
+	REQUIRE(CHECK_COLUMN(result, 3, {4, 1, 2, 3}));
+	REQUIRE(CHECK_COLUMN(result, 4, {65536, 65533, 65534, 65535}));
+	REQUIRE(CHECK_COLUMN(result, 5, {32770, 32767, 32768, 32769}));
+
+	// many groups that are spread over all the partitions
+	result = con.Query("SELECT COUNT(*), MIN(c), MAX(c), SUM(c) FROM (SELECT i % 1000 AS k, COUNT(*) AS c FROM "
+	                   "integers GROUP BY k) sq");
+	REQUIRE(CHECK_COLUMN(result, 0, {1000}));
+	REQUIRE(CHECK_COLUMN(result, 1, {65}));
+	REQUIRE(CHECK_COLUMN(result, 2, {66}));
+	REQUIRE(CHECK_COLUMN(result, 3, {Value::BIGINT(table_size)}));
+	// string groups
+	result = con.Query("SELECT COUNT(*), SUM(c) FROM (SELECT CAST(i % 100 AS VARCHAR) AS k, COUNT(*) AS c FROM integers "
+	                   "GROUP BY k) sq");
+	REQUIRE(CHECK_COLUMN(result, 0, {100}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size)}));
+	result = con.Query("SELECT k, c FROM (SELECT CAST(i % 100 AS VARCHAR) AS k, COUNT(*) AS c FROM integers GROUP BY k) "
+	                   "sq WHERE k = '7' OR k = '42' ORDER BY k");
+	REQUIRE(CHECK_COLUMN(result, 0, {"42", "7"}));
+	REQUIRE(CHECK_COLUMN(result, 1, {655, 656}));
+
+	// aggregates without groups, including the merging of algebraic aggregates
+	result = con.Query("SELECT COUNT(*), MIN(i), MAX(i), VAR_POP(i), COVAR_POP(i, i) FROM integers");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {1}));
+	REQUIRE(CHECK_COLUMN(result, 2, {65536}));
+	REQUIRE(CHECK_COLUMN(result, 3, {357913941.25}));
+	REQUIRE(CHECK_COLUMN(result, 4, {357913941.25}));
+	// aggregate over an empty filter result
+	result = con.Query("SELECT COUNT(*), SUM(i) FROM integers WHERE i < 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {0}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value()}));
+
+	// distinct aggregates are computed serially
+	result = con.Query("SELECT COUNT(DISTINCT i % 7), SUM(DISTINCT i % 7) FROM integers");
+	REQUIRE(CHECK_COLUMN(result, 0, {7}));
+	REQUIRE(CHECK_COLUMN(result, 1, {21}));
+}
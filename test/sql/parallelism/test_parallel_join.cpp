@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test parallel hash join build and probe", "[parallelism]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table that spans multiple storage chunks (morsels) with the values [1, 65536]
+	index_t table_size = 65536;
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+	for (index_t count = 1; count < table_size; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+
+	// inner joins with a parallel build and probe
+	result = con.Query("SELECT COUNT(*), SUM(a.i) FROM integers a JOIN integers b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+	result = con.Query("SELECT COUNT(*) FROM integers a JOIN (SELECT i FROM integers WHERE i % 2 = 0) b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size / 2)}));
+	result = con.Query("SELECT COUNT(*) FROM integers a JOIN integers b ON CAST(a.i AS VARCHAR)=CAST(b.i AS VARCHAR)");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	result = con.Query("SELECT a.i FROM integers a JOIN integers b ON a.i = b.i WHERE a.i <= 3 ORDER BY 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 3}));
+
+	// materialize the output of a parallel probe
+	auto materialized = con.Query("SELECT a.i, b.i FROM integers a JOIN integers b ON a.i = b.i * 2 ORDER BY 1");
+	REQUIRE(materialized->success);
+	REQUIRE(materialized->collection.count == table_size / 2);
+	bool correct_result = true;
+	for (index_t i = 0; i < materialized->collection.count; i++) {
+		if (materialized->collection.GetValue(0, i) != Value::INTEGER(2 * (i + 1)) ||
+		    materialized->collection.GetValue(1, i) != Value::INTEGER(i + 1)) {
+			correct_result = false;
+			break;
+		}
+	}
+	REQUIRE(correct_result);
+
+	// outer, semi and anti joins
+	result = con.Query("SELECT COUNT(*), COUNT(b.i) FROM integers a LEFT JOIN (SELECT i FROM integers WHERE i % 2 = 0) b "
+	                   "ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size / 2)}));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE i IN (SELECT i FROM integers WHERE i % 4 = 0)");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size / 4)}));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE i NOT IN (SELECT i FROM integers WHERE i % 4 = 0)");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(3 * table_size / 4)}));
+	// empty build side
+	result = con.Query("SELECT COUNT(*) FROM integers a JOIN (SELECT i FROM integers WHERE i < 0) b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {0}));
+}
+
+TEST_CASE("Test hash joins with NULL values in the build keys", "[parallelism]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// a small build side is built serially
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE t(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO t VALUES (1), (2), (NULL)"));
+	result = con.Query("SELECT a.i, b.i FROM t a JOIN t b ON a.i = b.i ORDER BY 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2}));
+	REQUIRE(CHECK_COLUMN(result, 1, {1, 2}));
+	result = con.Query("SELECT i FROM t WHERE i IN (SELECT i FROM t) ORDER BY 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2}));
+
+	// a big build side is built in parallel
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+	for (index_t count = 1; count < 65536; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET i = NULL WHERE i % 3 = 0"));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+	result = con.Query("SELECT COUNT(*), SUM(a.i) FROM integers a JOIN integers b ON a.i = b.i");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(43691)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(1431677611)}));
+}
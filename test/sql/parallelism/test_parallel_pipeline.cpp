@@ -0,0 +1,91 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test parallel execution of scan pipelines", "[parallelism]") {
+	unique_ptr<MaterializedQueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table that spans multiple storage chunks (morsels) with the values [1, 65536]
+	index_t table_size = 65536;
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER, s VARCHAR)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1, 'hello')"));
+	for (index_t count = 1; count < table_size; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers), s FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+
+	// projection + filter pipeline: the output order is preserved
+	result = con.Query("SELECT i * 2, s FROM integers WHERE i % 2 = 1");
+	REQUIRE(result->success);
+	REQUIRE(result->collection.count == table_size / 2);
+	bool order_preserved = true;
+	for (index_t i = 0; i < result->collection.count; i++) {
+		if (result->collection.GetValue(0, i) != Value::INTEGER(2 * (2 * i + 1)) ||
+		    result->collection.GetValue(1, i) != Value("hello")) {
+			order_preserved = false;
+			break;
+		}
+	}
+	REQUIRE(order_preserved);
+
+	// order by with a parallel input pipeline
+	result = con.Query("SELECT i FROM integers WHERE i > 1000 ORDER BY i DESC LIMIT 3");
+	REQUIRE(CHECK_COLUMN(result, 0, {65536, 65535, 65534}));
+	// aggregate over a parallel materialized subquery
+	result = con.Query("SELECT COUNT(*), SUM(i) FROM (SELECT i FROM integers ORDER BY i) sq");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+
+	// errors in worker threads are propagated to the client
+	REQUIRE_FAIL(con.Query("SELECT CAST(s AS INTEGER) FROM integers"));
+
+	// we can go back to single-threaded execution
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=1"));
+	result = con.Query("SELECT i FROM integers WHERE i > 1000 ORDER BY i DESC LIMIT 3");
+	REQUIRE(CHECK_COLUMN(result, 0, {65536, 65535, 65534}));
+	REQUIRE_FAIL(con.Query("PRAGMA threads=0"));
+	REQUIRE_FAIL(con.Query("PRAGMA threads=abc"));
+}
+
+static void ParallelSumLoop(DuckDB *db, std::atomic<bool> *finished, std::atomic<bool> *correct) {
+	Connection con(*db);
+	while (!*finished) {
+		auto result = con.Query("SELECT SUM(i) FROM integers WHERE i % 2 = 0");
+		if (!CHECK_COLUMN(result, 0, {Value::BIGINT(32768LL * 32769LL)})) {
+			*correct = false;
+		}
+	}
+}
+
+TEST_CASE("Change the amount of threads while other connections execute parallel queries", "[parallelism]") {
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+	for (index_t count = 1; count < 65536; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+
+	std::atomic<bool> finished(false), correct(true);
+	thread readers[2];
+	for (index_t i = 0; i < 2; i++) {
+		readers[i] = thread(ParallelSumLoop, &db, &finished, &correct);
+	}
+	for (index_t i = 0; i < 20; i++) {
+		REQUIRE_NO_FAIL(con.Query("PRAGMA threads=" + to_string(1 + i % 4)));
+	}
+	finished = true;
+	for (index_t i = 0; i < 2; i++) {
+		readers[i].join();
+	}
+	REQUIRE(correct);
+}
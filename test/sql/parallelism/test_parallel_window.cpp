@@ -0,0 +1,62 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test parallel window functions", "[parallelism]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table with the values [1, 8192]
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+	for (index_t count = 1; count < 8192; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+
+	// the results are returned in the order of the input rows
+	result = con.Query("SELECT i, ROW_NUMBER() OVER (PARTITION BY i % 10 ORDER BY i DESC) FROM integers LIMIT 3");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 3}));
+	REQUIRE(CHECK_COLUMN(result, 1, {820, 820, 819}));
+	result = con.Query("SELECT COUNT(*) FROM (SELECT i, ROW_NUMBER() OVER (PARTITION BY i % 10 ORDER BY i) AS rn FROM "
+	                   "integers) sq WHERE rn <> (i - 1) / 10 + 1");
+	REQUIRE(CHECK_COLUMN(result, 0, {0}));
+
+	// framed aggregates and string results
+	result = con.Query("SELECT * FROM (SELECT i, SUM(i) OVER (PARTITION BY i % 10 ORDER BY i) AS s, LAG(CAST(i AS "
+	                   "VARCHAR)) OVER (PARTITION BY i % 10 ORDER BY i) AS l FROM integers) sq WHERE i IN (1, 21, 8192)");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 21, 8192}));
+	REQUIRE(CHECK_COLUMN(result, 1, {1, 33, 3359540}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value(), "11", "8182"}));
+	result = con.Query("SELECT COUNT(*), COUNT(l), SUM(CASE WHEN l = CAST(i - 10 AS VARCHAR) THEN 1 ELSE 0 END) FROM "
+	                   "(SELECT i, LAG(CAST(i AS VARCHAR)) OVER (PARTITION BY i % 10 ORDER BY i) AS l FROM integers) sq");
+	REQUIRE(CHECK_COLUMN(result, 0, {8192}));
+	REQUIRE(CHECK_COLUMN(result, 1, {8182}));
+	REQUIRE(CHECK_COLUMN(result, 2, {8182}));
+
+	// NULL partition keys form a single partition
+	result = con.Query("SELECT p, MAX(rn), COUNT(*) FROM (SELECT CASE WHEN i % 2 = 0 THEN NULL ELSE i % 3 END AS p, "
+	                   "ROW_NUMBER() OVER (PARTITION BY CASE WHEN i % 2 = 0 THEN NULL ELSE i % 3 END) AS rn FROM "
+	                   "integers) sq GROUP BY p ORDER BY p");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value(), 0, 1, 2}));
+	REQUIRE(CHECK_COLUMN(result, 1, {4096, 1365, 1366, 1365}));
+	REQUIRE(CHECK_COLUMN(result, 2, {4096, 1365, 1366, 1365}));
+
+	// the parallel and the serial evaluation of multiple window expressions give the same result
+	string query = "SELECT i, RANK() OVER (PARTITION BY i % 7 ORDER BY i % 13), AVG(i) OVER (PARTITION BY i % 3 ORDER BY "
+	               "i ROWS BETWEEN 5 PRECEDING AND 2 FOLLOWING), NTILE(4) OVER (PARTITION BY i % 5 ORDER BY i), "
+	               "FIRST_VALUE(i) OVER (ORDER BY i % 100 DESC, i) FROM integers";
+	auto parallel_result = con.Query(query);
+	REQUIRE_NO_FAIL(*parallel_result);
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=1"));
+	auto serial_result = con.Query(query);
+	REQUIRE_NO_FAIL(*serial_result);
+	REQUIRE(parallel_result->Equals(*serial_result));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA threads=4"));
+
+	// errors in the evaluation of a partition are propagated
+	REQUIRE_FAIL(con.Query("SELECT NTILE(0) OVER (PARTITION BY i % 10) FROM integers"));
+}
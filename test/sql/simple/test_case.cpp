@@ -82,3 +82,24 @@ TEST_CASE("NULL IF with strings", "[case]") {
 	result = con.Query("SELECT NULLIF(CAST(a AS VARCHAR), 11) FROM test;");
 	REQUIRE(CHECK_COLUMN(result, 0, {Value(), Value("13"), Value("12")}));
 }
+
+TEST_CASE("Test CASE only evaluating the required branch", "[case]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE strings(s VARCHAR);"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES ('1'), ('hello'), (NULL), ('42'), ('world')"));
+
+	// the cast is only evaluated for the rows for which the check is true
+	result = con.Query("SELECT CASE WHEN s SIMILAR TO '[0-9]+' THEN CAST(s AS INTEGER) + 1 ELSE LENGTH(s) END FROM "
+	                   "strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {2, 5, Value(), 43, 5}));
+	result = con.Query("SELECT CASE WHEN s SIMILAR TO '[0-9]+' THEN s ELSE CONCAT(s, '!') END FROM strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {"1", "hello!", Value(), "42", "world!"}));
+	REQUIRE_FAIL(con.Query("SELECT CASE WHEN s IS NOT NULL THEN CAST(s AS INTEGER) ELSE 0 END FROM strings"));
+
+	// the same for a subexpression that is shared by the check and a branch
+	result = con.Query("SELECT CASE WHEN LENGTH(s) < 3 THEN LENGTH(s) * 10 ELSE LENGTH(s) END FROM strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {10, 5, Value(), 20, 5}));
+}
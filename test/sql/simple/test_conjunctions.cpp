@@ -114,3 +114,37 @@ TEST_CASE("Test conjunction statements that can be simplified", "[conjunction]")
 	    con.Query("SELECT (i IS NULL AND (i+1) IS NULL) OR (i IS NULL AND (i+2) IS NULL) FROM integers ORDER BY i");
 	REQUIRE(CHECK_COLUMN(result, 0, {true, false, false, false}));
 }
+
+TEST_CASE("Test short-circuit evaluation of conjunctions", "[conjunction]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE strings(s VARCHAR);"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES ('1'), ('hello'), (NULL), ('42'), ('world')"));
+
+	// the right side is only evaluated for the rows for which the left side does not determine the result
+	result = con.Query("SELECT s SIMILAR TO '[0-9]+' AND CAST(s AS INTEGER) > 10 FROM strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {false, false, Value(), true, false}));
+	result = con.Query("SELECT NOT s SIMILAR TO '[0-9]+' OR CAST(s AS INTEGER) > 10 FROM strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {false, true, Value(), true, true}));
+	REQUIRE_FAIL(con.Query("SELECT s IS NOT NULL AND CAST(s AS INTEGER) > 10 FROM strings"));
+
+	// three-valued logic over multiple chunks
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+	for (index_t count = 1; count < 4096; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET i = NULL WHERE i % 7 = 0"));
+	result = con.Query("SELECT COUNT(*), COUNT(b), SUM(CASE WHEN b THEN 1 ELSE 0 END) FROM (SELECT i % 2 = 0 AND "
+	                   "NULLIF(i % 3, 1) = 0 AS b FROM integers) t");
+	REQUIRE(CHECK_COLUMN(result, 0, {4096}));
+	REQUIRE(CHECK_COLUMN(result, 1, {2925}));
+	REQUIRE(CHECK_COLUMN(result, 2, {585}));
+	result = con.Query("SELECT COUNT(*), COUNT(b), SUM(CASE WHEN b THEN 1 ELSE 0 END) FROM (SELECT i % 2 = 0 OR "
+	                   "NULLIF(i % 3, 1) = 0 AS b FROM integers) t");
+	REQUIRE(CHECK_COLUMN(result, 0, {4096}));
+	REQUIRE(CHECK_COLUMN(result, 1, {2926}));
+	REQUIRE(CHECK_COLUMN(result, 2, {2341}));
+}
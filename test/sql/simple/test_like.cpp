@@ -68,3 +68,54 @@ TEST_CASE("Test LIKE statement", "[like]") {
 	result = con.Query("SELECT s FROM strings WHERE s LIKE pat");
 	REQUIRE(CHECK_COLUMN(result, 0, {"abab", "aaa"}));
 }
+
+TEST_CASE("Test LIKE with constant patterns", "[like]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE strings(s STRING);"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES ('hello world'), ('world hello'), ('hello'), (''), (NULL), "
+	                          "('abcabcabd'), ('aaa')"));
+
+	// exact, prefix, suffix and contains patterns
+	result = con.Query("SELECT s LIKE 'hello', s LIKE 'hello%', s LIKE '%hello', s LIKE '%hello%' FROM strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {false, false, true, false, Value(), false, false}));
+	REQUIRE(CHECK_COLUMN(result, 1, {true, false, true, false, Value(), false, false}));
+	REQUIRE(CHECK_COLUMN(result, 2, {false, true, true, false, Value(), false, false}));
+	REQUIRE(CHECK_COLUMN(result, 3, {true, true, true, false, Value(), false, false}));
+	result = con.Query("SELECT s NOT LIKE 'hello', s NOT LIKE 'hello%', s NOT LIKE '%hello', s NOT LIKE '%lo w%' FROM "
+	                   "strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {true, true, false, true, Value(), true, true}));
+	REQUIRE(CHECK_COLUMN(result, 1, {false, true, false, true, Value(), true, true}));
+	REQUIRE(CHECK_COLUMN(result, 2, {true, false, false, true, Value(), true, true}));
+	REQUIRE(CHECK_COLUMN(result, 3, {false, true, true, true, Value(), true, true}));
+	result = con.Query("SELECT s LIKE '', s LIKE '%', s LIKE '%%' FROM strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {false, false, false, true, Value(), false, false}));
+	REQUIRE(CHECK_COLUMN(result, 1, {true, true, true, true, Value(), true, true}));
+	REQUIRE(CHECK_COLUMN(result, 2, {true, true, true, true, Value(), true, true}));
+
+	// patterns with wildcards in between
+	result = con.Query("SELECT s LIKE 'h%o', s LIKE '%abc%abd', s LIKE 'a%a%a', s LIKE '_a%', s NOT LIKE '%o_w%' FROM "
+	                   "strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {false, false, true, false, Value(), false, false}));
+	REQUIRE(CHECK_COLUMN(result, 1, {false, false, false, false, Value(), true, false}));
+	REQUIRE(CHECK_COLUMN(result, 2, {false, false, false, false, Value(), false, true}));
+	REQUIRE(CHECK_COLUMN(result, 3, {false, false, false, false, Value(), false, true}));
+	REQUIRE(CHECK_COLUMN(result, 4, {false, true, true, true, Value(), true, true}));
+
+	// a pattern that is only known at execution time
+	REQUIRE_NO_FAIL(con.Query("PREPARE s1 AS SELECT COUNT(*) FROM strings WHERE s LIKE $1"));
+	result = con.Query("EXECUTE s1('%o%o%')");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+	result = con.Query("EXECUTE s1('%llo')");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+
+	// the prefix, suffix and contains functions
+	result = con.Query("SELECT prefix(s, 'hel'), suffix(s, 'abd'), contains(s, 'bca'), contains('hello', s) FROM "
+	                   "strings");
+	REQUIRE(CHECK_COLUMN(result, 0, {true, false, true, false, Value(), false, false}));
+	REQUIRE(CHECK_COLUMN(result, 1, {false, false, false, false, Value(), true, false}));
+	REQUIRE(CHECK_COLUMN(result, 2, {false, false, false, false, Value(), true, false}));
+	REQUIRE(CHECK_COLUMN(result, 3, {false, false, true, true, Value(), false, false}));
+}
@@ -1,4 +1,5 @@
 #include "catch.hpp"
+#include "common/file_system.hpp"
 #include "test_helpers.hpp"
 
 using namespace duckdb;
@@ -169,3 +170,237 @@ TEST_CASE("Test ORDER BY with large table", "[order]") {
 		REQUIRE(result->GetValue<int32_t>(0, i) == i + 1);
 	}
 }
+
+TEST_CASE("Test ORDER BY on multiple columns of different types", "[order]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b DOUBLE, c VARCHAR, d BIGINT);"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1, -0.5, 'hello', -3), (-1, 2.5, NULL, 7), (NULL, 0, 'a', 0), "
+	                          "(1, -10, 'hello world, this is a long string', 2), (-1, NULL, 'b', -9223372036854775807), "
+	                          "(1, -0.5, 'hello world, this is a long string too', 1), (-2147483647, 1e300, '', 5)"));
+	// ascending and descending order on numeric keys, NULL values are smaller than all other values
+	result = con.Query("SELECT a, b FROM test ORDER BY a DESC, b");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 1, 1, -1, -1, -2147483647, Value()}));
+	REQUIRE(CHECK_COLUMN(result, 1, {-10, -0.5, -0.5, Value(), 2.5, 1e300, 0}));
+	result = con.Query("SELECT d FROM test ORDER BY d");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(-9223372036854775807LL), -3, 0, 1, 2, 5, 7}));
+	result = con.Query("SELECT b FROM test ORDER BY b DESC");
+	REQUIRE(CHECK_COLUMN(result, 0, {1e300, 2.5, 0, -0.5, -0.5, -10, Value()}));
+	// strings that are longer than the key prefix are ordered on the next columns after comparing the full strings
+	result = con.Query("SELECT c, d FROM test ORDER BY c, d DESC");
+	REQUIRE(CHECK_COLUMN(result, 0,
+	                     {Value(), "", "a", "b", "hello", "hello world, this is a long string",
+	                      "hello world, this is a long string too"}));
+	REQUIRE(CHECK_COLUMN(result, 1, {7, 5, 0, Value::BIGINT(-9223372036854775807LL), -3, 2, 1}));
+	result = con.Query("SELECT c FROM test ORDER BY c DESC");
+	REQUIRE(CHECK_COLUMN(result, 0,
+	                     {"hello world, this is a long string too", "hello world, this is a long string", "hello", "b",
+	                      "a", "", Value()}));
+	result = con.Query("SELECT a, b, d FROM test ORDER BY a, b DESC, d");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value(), -2147483647, -1, -1, 1, 1, 1}));
+	REQUIRE(CHECK_COLUMN(result, 1, {0, 1e300, 2.5, Value(), -0.5, -0.5, -10}));
+	REQUIRE(CHECK_COLUMN(result, 2, {0, 5, 7, Value::BIGINT(-9223372036854775807LL), -3, 1, 2}));
+}
+
+TEST_CASE("Test ORDER BY that spills to disk", "[order]") {
+	unique_ptr<MaterializedQueryResult> result;
+	FileSystem fs;
+	auto temp_directory = TestCreatePath("external_sort");
+	TestDeleteDirectory(temp_directory);
+
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table with the values [1, 65536]
+	index_t table_size = 65536;
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER, s VARCHAR)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1, '1')"));
+	for (index_t count = 1; count < table_size; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers), CAST(i + (SELECT "
+		                          "COUNT(*) FROM integers) AS VARCHAR) FROM integers"));
+	}
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET s = NULL WHERE i % 100 = 0"));
+	// the data does not fit in the memory limit, so sorted runs are written to disk and merged
+	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=200KB"));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA temp_directory='" + temp_directory + "'"));
+
+	// sort on a key that scrambles the input order
+	result = con.Query("SELECT i FROM integers ORDER BY (i * 7919) % 65536, i");
+	REQUIRE(result->success);
+	REQUIRE(result->collection.count == table_size);
+	REQUIRE(fs.DirectoryExists(temp_directory));
+	bool correct_order = true;
+	for (index_t i = 1; i < table_size; i++) {
+		auto previous = result->GetValue<int32_t>(0, i - 1);
+		auto current = result->GetValue<int32_t>(0, i);
+		auto previous_key = ((int64_t)previous * 7919) % 65536;
+		auto current_key = ((int64_t)current * 7919) % 65536;
+		if (previous_key > current_key || (previous_key == current_key && previous > current)) {
+			correct_order = false;
+			break;
+		}
+	}
+	REQUIRE(correct_order);
+
+	// descending order on strings with NULL values
+	result = con.Query("SELECT s FROM integers ORDER BY s DESC LIMIT 3");
+	REQUIRE(CHECK_COLUMN(result, 0, {"9999", "9998", "9997"}));
+	result = con.Query("SELECT s FROM integers ORDER BY s LIMIT 2");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value(), Value()}));
+	result = con.Query("SELECT COUNT(*), COUNT(s) FROM (SELECT * FROM integers ORDER BY s, i) sq");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size - table_size / 100)}));
+
+	// with a smaller limit there are more runs than can be merged at once: they are merged in several passes
+	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=20KB"));
+	result = con.Query("SELECT i, s FROM integers ORDER BY (i * 7919) % 65536 DESC, i");
+	REQUIRE(result->success);
+	REQUIRE(result->collection.count == table_size);
+	correct_order = true;
+	for (index_t i = 0; i < table_size; i++) {
+		auto current = result->GetValue<int32_t>(0, i);
+		auto current_string = result->GetValue(1, i);
+		if (current % 100 == 0 ? !current_string.is_null : current_string.str_value != to_string(current)) {
+			correct_order = false;
+			break;
+		}
+		if (i == 0) {
+			continue;
+		}
+		auto previous = result->GetValue<int32_t>(0, i - 1);
+		auto previous_key = ((int64_t)previous * 7919) % 65536;
+		auto current_key = ((int64_t)current * 7919) % 65536;
+		if (previous_key < current_key || (previous_key == current_key && previous > current)) {
+			correct_order = false;
+			break;
+		}
+	}
+	REQUIRE(correct_order);
+
+	// the sorted runs are cleaned up after the query
+	index_t file_count = 0;
+	fs.ListFiles(temp_directory, [&](string path) { file_count++; });
+	REQUIRE(file_count == 0);
+	TestDeleteDirectory(temp_directory);
+}
+
+TEST_CASE("Test ORDER BY on long strings that spills to disk", "[order]") {
+	unique_ptr<MaterializedQueryResult> result;
+	FileSystem fs;
+	auto temp_directory = TestCreatePath("external_sort_strings");
+	TestDeleteDirectory(temp_directory);
+
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// the tuples are small, but their strings do not fit in the memory limit
+	index_t table_size = 4096;
+	string padding(500, 'x');
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE strings(i INTEGER, s VARCHAR)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES (1, '" + padding + "')"));
+	for (index_t count = 1; count < table_size; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO strings SELECT i + (SELECT COUNT(*) FROM strings), s FROM strings"));
+	}
+	REQUIRE_NO_FAIL(con.Query("UPDATE strings SET s = CAST((i * 7919) % 4096 AS VARCHAR) || s"));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=500KB"));
+	REQUIRE_NO_FAIL(con.Query("PRAGMA temp_directory='" + temp_directory + "'"));
+
+	result = con.Query("SELECT s FROM strings ORDER BY s");
+	REQUIRE(result->success);
+	REQUIRE(result->collection.count == table_size);
+	REQUIRE(fs.DirectoryExists(temp_directory));
+	bool correct_order = true;
+	for (index_t i = 1; i < table_size; i++) {
+		if (result->GetValue(0, i - 1).str_value > result->GetValue(0, i).str_value) {
+			correct_order = false;
+			break;
+		}
+	}
+	REQUIRE(correct_order);
+	TestDeleteDirectory(temp_directory);
+}
+
+TEST_CASE("Test ORDER BY with LIMIT and OFFSET", "[order]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table with the values [1, 8192]
+	index_t table_size = 8192;
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+	for (index_t count = 1; count < table_size; count *= 2) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i + (SELECT COUNT(*) FROM integers) FROM integers"));
+	}
+
+	for (index_t threads = 1; threads <= 4; threads *= 4) {
+		REQUIRE_NO_FAIL(con.Query("PRAGMA threads=" + to_string(threads)));
+
+		result = con.Query("SELECT i FROM integers ORDER BY i DESC LIMIT 3");
+		REQUIRE(CHECK_COLUMN(result, 0, {8192, 8191, 8190}));
+		// multiple sort keys with an offset
+		result = con.Query("SELECT i % 7 AS j, i FROM integers ORDER BY j DESC, i LIMIT 3 OFFSET 2");
+		REQUIRE(CHECK_COLUMN(result, 0, {6, 6, 6}));
+		REQUIRE(CHECK_COLUMN(result, 1, {20, 27, 34}));
+		// rows with equal sort keys are returned in the order of the input
+		result = con.Query("SELECT i FROM integers ORDER BY i % 10 LIMIT 3");
+		REQUIRE(CHECK_COLUMN(result, 0, {10, 20, 30}));
+		// NULL values and strings
+		result = con.Query("SELECT CASE WHEN i % 2 = 0 THEN NULL ELSE i END AS k FROM integers ORDER BY k LIMIT 2");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value(), Value()}));
+		result = con.Query("SELECT CASE WHEN i % 2 = 0 THEN NULL ELSE i END AS k FROM integers ORDER BY k DESC LIMIT 2");
+		REQUIRE(CHECK_COLUMN(result, 0, {8191, 8189}));
+		result = con.Query("SELECT CAST(i AS VARCHAR) AS s FROM integers ORDER BY s DESC LIMIT 3");
+		REQUIRE(CHECK_COLUMN(result, 0, {"999", "998", "997"}));
+		// an offset at the end of the input, and an empty limit
+		result = con.Query("SELECT i FROM integers ORDER BY i LIMIT 5 OFFSET 8190");
+		REQUIRE(CHECK_COLUMN(result, 0, {8191, 8192}));
+		result = con.Query("SELECT i FROM integers ORDER BY i LIMIT 0");
+		REQUIRE(CHECK_COLUMN(result, 0, {}));
+
+		// a sort key that scrambles the input order, with a limit that spans multiple chunks
+		index_t limit = 3000;
+		auto materialized =
+		    con.Query("SELECT i FROM integers ORDER BY (i * 7919) % 1000, i DESC LIMIT " + to_string(limit));
+		REQUIRE(materialized->success);
+		REQUIRE(materialized->collection.count == limit);
+		vector<int32_t> expected;
+		for (int32_t i = 1; i <= (int32_t)table_size; i++) {
+			expected.push_back(i);
+		}
+		sort(expected.begin(), expected.end(), [](int32_t a, int32_t b) {
+			auto a_key = ((int64_t)a * 7919) % 1000, b_key = ((int64_t)b * 7919) % 1000;
+			return a_key == b_key ? a > b : a_key < b_key;
+		});
+		bool correct_result = true;
+		for (index_t i = 0; i < limit; i++) {
+			if (materialized->GetValue<int32_t>(0, i) != expected[i]) {
+				correct_result = false;
+				break;
+			}
+		}
+		REQUIRE(correct_result);
+	}
+
+	// a limit beyond the maximum heap size uses a full sort, which can spill to disk
+	auto physical_plan = [&](string limit) {
+		auto explain = con.Query("EXPLAIN SELECT i FROM integers ORDER BY i DESC LIMIT " + limit);
+		return explain->GetValue(1, 2).str_value;
+	};
+	REQUIRE(physical_plan("10").find("TOP_N") != string::npos);
+	REQUIRE(physical_plan("10").find("ORDER_BY") == string::npos);
+	REQUIRE(physical_plan("1000000").find("TOP_N") == string::npos);
+	REQUIRE(physical_plan("1000000").find("ORDER_BY") != string::npos);
+	REQUIRE(physical_plan("10 OFFSET 1000000").find("TOP_N") == string::npos);
+	result = con.Query("SELECT i FROM integers ORDER BY i DESC LIMIT 1000000 OFFSET 8190");
+	REQUIRE(CHECK_COLUMN(result, 0, {2, 1}));
+	// an offset in the middle of a chunk, with NULL values
+	auto offset_result = con.Query(
+	    "SELECT CASE WHEN i % 2 = 0 THEN NULL ELSE i END AS k FROM integers ORDER BY i LIMIT 1000000 OFFSET 5000");
+	REQUIRE(offset_result->collection.count == 3192);
+	REQUIRE(offset_result->GetValue<int32_t>(0, 0) == 5001);
+	REQUIRE(offset_result->GetValue(0, 1).is_null);
+	REQUIRE(offset_result->GetValue<int32_t>(0, 2) == 5003);
+}
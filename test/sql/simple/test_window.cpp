@@ -41,9 +41,9 @@ TEST_CASE("Most basic window function", "[window]") {
 
 	// first_value
 	result = con.Query("SELECT empno, first_value(empno) OVER (PARTITION BY depname ORDER BY empno) fv FROM empsalary "
-	                   "ORDER BY depname, fv");
+	                   "ORDER BY depname, fv, empno");
 	REQUIRE(result->types.size() == 2);
-	REQUIRE(CHECK_COLUMN(result, 0, {11, 8, 7, 9, 10, 5, 2, 4, 3, 1}));
+	REQUIRE(CHECK_COLUMN(result, 0, {7, 8, 9, 10, 11, 2, 5, 1, 3, 4}));
 	REQUIRE(CHECK_COLUMN(result, 1, {7, 7, 7, 7, 7, 2, 2, 1, 1, 1}));
 
 	// rank_dense
@@ -458,3 +458,102 @@ TEST_CASE("TPC-DS Q49 bug fix for multi-sort window functions", "[window]") {
 
 	REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
 }
+
+TEST_CASE("Window functions with arbitrary aggregates", "[window]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+	con.EnableQueryVerification();
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE empsalary (depname varchar, empno bigint, salary int, enroll_date date)"));
+	REQUIRE_NO_FAIL(
+	    con.Query("INSERT INTO empsalary VALUES ('develop', 10, 5200, '2007-08-01'), ('sales', 1, 5000, '2006-10-01'), "
+	              "('personnel', 5, 3500, '2007-12-10'), ('sales', 4, 4800, '2007-08-08'), ('personnel', 2, 3900, "
+	              "'2006-12-23'), ('develop', 7, 4200, '2008-01-01'), ('develop', 9, 4500, '2008-01-01'), ('sales', 3, "
+	              "4800, '2007-08-01'), ('develop', 8, 6000, '2006-10-01'), ('develop', 11, 5200, '2007-08-15')"));
+
+	// min/max over a moving frame
+	result = con.Query("SELECT empno, min(salary) OVER w, max(salary) OVER w FROM empsalary WINDOW w AS (ORDER BY "
+	                   "empno ROWS BETWEEN 1 PRECEDING AND 1 FOLLOWING) ORDER BY empno");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 3, 4, 5, 7, 8, 9, 10, 11}));
+	REQUIRE(CHECK_COLUMN(result, 1, {3900, 3900, 3900, 3500, 3500, 3500, 4200, 4500, 4500, 5200}));
+	REQUIRE(CHECK_COLUMN(result, 2, {5000, 5000, 4800, 4800, 4800, 6000, 6000, 6000, 5200, 5200}));
+
+	// stddev over a partition
+	result = con.Query("SELECT DISTINCT depname, CAST(stddev_samp(salary) OVER (PARTITION BY depname) AS INTEGER) "
+	                   "FROM empsalary WHERE depname <> 'personnel' ORDER BY depname");
+	REQUIRE(CHECK_COLUMN(result, 0, {"develop", "sales"}));
+	REQUIRE(CHECK_COLUMN(result, 1, {701, 115}));
+
+	// the aggregate of an empty frame is the aggregate of the empty set
+	result = con.Query("SELECT empno, COUNT(*) OVER w, COUNT(salary) OVER w, SUM(salary) OVER w FROM empsalary "
+	                   "WINDOW w AS (ORDER BY empno ROWS BETWEEN 1 FOLLOWING AND 2 FOLLOWING) ORDER BY empno");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 3, 4, 5, 7, 8, 9, 10, 11}));
+	REQUIRE(CHECK_COLUMN(result, 1, {2, 2, 2, 2, 2, 2, 2, 2, 1, 0}));
+	REQUIRE(CHECK_COLUMN(result, 2, {2, 2, 2, 2, 2, 2, 2, 2, 1, 0}));
+	REQUIRE(CHECK_COLUMN(result, 3, {8700, 9600, 8300, 7700, 10200, 10500, 9700, 10400, 5200, Value()}));
+
+	// lead with an offset, ntile within partitions
+	result = con.Query("SELECT empno, lead(empno, 2) OVER (ORDER BY empno), ntile(4) OVER (PARTITION BY depname "
+	                   "ORDER BY empno) FROM empsalary ORDER BY depname, empno");
+	REQUIRE(CHECK_COLUMN(result, 0, {7, 8, 9, 10, 11, 2, 5, 1, 3, 4}));
+	REQUIRE(CHECK_COLUMN(result, 1, {9, 10, 11, Value(), Value(), 4, 8, 3, 5, 7}));
+	REQUIRE(CHECK_COLUMN(result, 2, {1, 1, 2, 3, 4, 1, 2, 1, 2, 3}));
+
+	// DISTINCT and scalar functions are not supported as window functions
+	REQUIRE_FAIL(con.Query("SELECT COUNT(DISTINCT salary) OVER () FROM empsalary"));
+	REQUIRE_FAIL(con.Query("SELECT abs(salary) OVER () FROM empsalary"));
+}
+
+TEST_CASE("Window aggregates over many rows", "[window]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE a(i INTEGER)"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO a VALUES (0)"));
+	for (index_t k = 0; k < 12; k++) {
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO a SELECT i + (SELECT COUNT(*) FROM a) FROM a"));
+	}
+	int64_t row_count = 4096;
+
+	// moving sum over the last 100 rows
+	int64_t expected_sum = 0, expected_max = 0;
+	for (int64_t i = 0; i < row_count; i++) {
+		int64_t moving_sum = 0;
+		for (int64_t j = max((int64_t)0, i - 99); j <= i; j++) {
+			moving_sum += j;
+		}
+		expected_sum += moving_sum;
+		expected_max = max(expected_max, moving_sum);
+	}
+	result = con.Query("SELECT SUM(s), MAX(s) FROM (SELECT SUM(i) OVER (ORDER BY i ROWS BETWEEN 99 PRECEDING AND "
+	                   "CURRENT ROW) s FROM a) t");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(expected_sum)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(expected_max)}));
+
+	// frames within partitions, with aggregates that skip NULL values
+	int64_t expected_count = 0;
+	expected_max = 0;
+	for (int64_t i = 0; i < row_count; i++) {
+		// the partition of i contains the values i % 8 + 8 * k
+		int64_t k = i / 8, partition_size = row_count / 8;
+		for (int64_t j = max((int64_t)0, k - 10); j <= min(partition_size - 1, k + 5); j++) {
+			int64_t value = i % 8 + 8 * j;
+			expected_count += value % 3 != 0;
+		}
+		expected_max += i % 8 + 8 * min(partition_size - 1, k + 5);
+	}
+	result = con.Query("SELECT SUM(c), SUM(m) FROM (SELECT COUNT(CASE WHEN i % 3 = 0 THEN NULL ELSE i END) OVER "
+	                   "(PARTITION BY i % 8 ORDER BY i ROWS BETWEEN 10 PRECEDING AND 5 FOLLOWING) c, MAX(i) OVER "
+	                   "(PARTITION BY i % 8 ORDER BY i ROWS BETWEEN 10 PRECEDING AND 5 FOLLOWING) m FROM a) t");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(expected_count)}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(expected_max)}));
+
+	// peer groups span multiple vectors
+	result = con.Query("SELECT MIN(c), MAX(c), SUM(r) FROM (SELECT COUNT(*) OVER (ORDER BY i / 1000) c, rank() OVER "
+	                   "(ORDER BY i / 1000) r FROM a) t");
+	REQUIRE(CHECK_COLUMN(result, 0, {1000}));
+	REQUIRE(CHECK_COLUMN(result, 1, {4096}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(1000 * 1 + 1000 * 1001 + 1000 * 2001 + 1000 * 3001 + 96 * 4001)}));
+}
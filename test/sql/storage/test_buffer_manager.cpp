@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include "common/file_system.hpp"
+#include "test_helpers.hpp"
+#include "storage/buffer_manager.hpp"
+#include "storage/storage_info.hpp"
+#include "storage/storage_manager.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test scanning a table that is larger than the memory limit", "[storage]") {
+	unique_ptr<MaterializedQueryResult> result;
+	auto storage_database = TestCreatePath("buffer_manager_test");
+	auto config = GetTestConfig();
+
+	uint64_t integer_count = 3 * (BLOCK_SIZE / sizeof(int32_t));
+	uint64_t table_size = 4;
+	uint64_t expected_sum = 11 + 12 + 13;
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		// create a database and insert values
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER);"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (11), (13), (12), (NULL)"));
+		// grow the table until it exceeds integer_count
+		while (table_size < integer_count) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT * FROM test"));
+			table_size *= 2;
+			expected_sum *= 2;
+		}
+	}
+	// reload the database with a memory limit of a single block
+	config->maximum_memory = BLOCK_SIZE;
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		// scan the table twice: every block has to be read from disk again after being evicted
+		for (index_t k = 0; k < 2; k++) {
+			result = con.Query("SELECT SUM(a), COUNT(*) FROM test");
+			REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(expected_sum)}));
+			REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size)}));
+			REQUIRE(db.storage->buffer_manager->GetUsedMemory() <= BLOCK_SIZE);
+		}
+		// we can change the memory limit with a PRAGMA
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=1GB"));
+		REQUIRE(db.storage->buffer_manager->GetMaxMemory() == 1000000000LL);
+		result = con.Query("SELECT SUM(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(expected_sum)}));
+		// invalid memory limits are rejected
+		REQUIRE_FAIL(con.Query("PRAGMA memory_limit"));
+		REQUIRE_FAIL(con.Query("PRAGMA memory_limit=1ZB"));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test scanning strings of a table that is larger than the memory limit", "[storage]") {
+	unique_ptr<MaterializedQueryResult> result;
+	auto storage_database = TestCreatePath("buffer_manager_test");
+	auto config = GetTestConfig();
+
+	uint64_t string_count = 64 * BLOCK_SIZE / 16;
+	uint64_t table_size = 1;
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		// create a database and insert distinct strings, so the dictionaries span many blocks
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, s VARCHAR);"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (0, '0-abcdefghij')"));
+		while (table_size < string_count) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT a + " + to_string(table_size) + ", CAST(a + " +
+			                          to_string(table_size) + " AS VARCHAR) || '-abcdefghij' FROM test"));
+			table_size *= 2;
+		}
+	}
+	// reload the database with a memory limit of a few blocks: the blocks of the strings can only stay pinned while
+	// their strings are being scanned
+	config->maximum_memory = 4 * BLOCK_SIZE;
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db), con2(db);
+		for (index_t k = 0; k < 2; k++) {
+			result = con.Query("SELECT COUNT(*), COUNT(DISTINCT s) FROM test WHERE s LIKE '%-abcdefghij'");
+			REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+			REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size)}));
+			REQUIRE(db.storage->buffer_manager->GetUsedMemory() <= 4 * BLOCK_SIZE);
+		}
+		// the old version of a deleted row keeps its string after its block has been evicted
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=12345"));
+		result = con2.Query("SELECT COUNT(*) FROM test WHERE s LIKE '%-abcdefghij'");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+		result = con2.Query("SELECT s FROM test WHERE a=12345");
+		REQUIRE(CHECK_COLUMN(result, 0, {"12345-abcdefghij"}));
+		// rolling back the delete restores the row
+		REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
+		result = con.Query("SELECT s FROM test WHERE a=12345");
+		REQUIRE(CHECK_COLUMN(result, 0, {"12345-abcdefghij"}));
+	}
+	DeleteDatabase(storage_database);
+}
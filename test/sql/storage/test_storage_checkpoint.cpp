@@ -0,0 +1,274 @@
+#include "catch.hpp"
+#include "common/file_system.hpp"
+#include "common/string_util.hpp"
+#include "storage/storage_info.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+namespace duckdb {
+//! File system that fails at a point of a checkpoint, as if the database crashed there
+class CheckpointCrashFileSystem : public FileSystem {
+public:
+	CheckpointCrashFileSystem(bool crash_on_header) : crash_on_header(crash_on_header) {
+	}
+
+	void Write(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) override {
+		if (crash_on_header && (location == HEADER_SIZE || location == HEADER_SIZE * 2)) {
+			throw IOException("crash before writing the database header");
+		}
+		FileSystem::Write(handle, buffer, nr_bytes, location);
+	}
+	void RemoveFile(const string &filename) override {
+		if (!crash_on_header && StringUtil::EndsWith(filename, ".wal")) {
+			throw IOException("crash before truncating the WAL");
+		}
+		FileSystem::RemoveFile(filename);
+	}
+
+private:
+	bool crash_on_header;
+};
+} // namespace duckdb
+
+TEST_CASE("Test checkpointing a running database", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	// only checkpoint when requested
+	config->checkpoint_wal_size = 1 << 30;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("checkpoint_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b VARCHAR)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1, 'hello'), (2, 'world'), (3, NULL)"));
+		for (index_t i = 0; i < 12; i++) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT a + (SELECT MAX(a) FROM test), b FROM test"));
+		}
+		// 12288 rows: delete and update some of them
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a % 5 = 0"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET b = 'updated' WHERE a % 7 = 0"));
+		result = con.Query("SELECT rowid FROM test WHERE a = 9999");
+		REQUIRE(CHECK_COLUMN(result, 0, {9998}));
+
+		// checkpoint the database: the WAL is truncated
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+		auto wal_path = storage_database + ".wal";
+		REQUIRE(fs.FileExists(wal_path));
+		{
+			auto handle = fs.OpenFile(wal_path, FileFlags::READ);
+			REQUIRE(fs.GetFileSize(*handle) == 0);
+		}
+		REQUIRE_FAIL(con.Query("PRAGMA checkpoint=1"));
+		// the changes after the checkpoint refer to the rows in the checkpoint
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a % 11 = 0 OR a % 13 = 0"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET a = -a WHERE a = 9998"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (100000, 'new')"));
+	}
+	auto verify_data = [&](Connection &con) {
+		result = con.Query("SELECT COUNT(*), SUM(a), COUNT(b), SUM(CASE WHEN b = 'updated' THEN 1 ELSE 0 END) FROM "
+		                   "test");
+		REQUIRE(CHECK_COLUMN(result, 0, {8250}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(50760142)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {5893}));
+		REQUIRE(CHECK_COLUMN(result, 3, {1178}));
+		result = con.Query("SELECT a, b FROM test WHERE a IN (-9998, 1, 14, 9994, 100000) ORDER BY a");
+		REQUIRE(CHECK_COLUMN(result, 0, {-9998, 1, 14, 9994, 100000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {"world", "hello", "updated", "hello", "new"}));
+	};
+	{
+		// reload the database: the checkpoint is loaded and the WAL is replayed on top of it
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		verify_data(con);
+		result = con.Query("SELECT rowid FROM test WHERE a = 9994");
+		REQUIRE(CHECK_COLUMN(result, 0, {9993}));
+		// checkpoint the replayed changes, and checkpoint again without any changes
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+		verify_data(con);
+	}
+	{
+		// the table is compacted when the database is opened
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		verify_data(con);
+		result = con.Query("SELECT MAX(rowid) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {8249}));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET b = 'compacted' WHERE a = 1"));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT b FROM test WHERE a = 1");
+		REQUIRE(CHECK_COLUMN(result, 0, {"compacted"}));
+		result = con.Query("SELECT COUNT(*) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {8250}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test changes that refer to updated rows after a checkpoint", "[storage]") {
+	auto config = GetTestConfig();
+	// only checkpoint when requested
+	config->checkpoint_wal_size = 1 << 30;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("checkpoint_update_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE t (i INTEGER, j INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO t VALUES (1, 0), (2, 0), (3, 0)"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+		// the updated row is deleted again, by a statement that refers to its row id in the WAL
+		REQUIRE_NO_FAIL(con.Query("UPDATE t SET i = 100 WHERE i = 3"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM t WHERE i >= 100"));
+		// a row that is inserted after the update is deleted again
+		REQUIRE_NO_FAIL(con.Query("UPDATE t SET j = 1 WHERE i = 2"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO t VALUES (4, 0)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM t WHERE i = 4"));
+		// an update of both checkpointed rows and rows that were inserted after the checkpoint
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO t VALUES (5, 0), (6, 0)"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE t SET j = j + 10 WHERE i <> 6"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM t WHERE j = 10"));
+		result = con.Query("SELECT i, j FROM t ORDER BY i");
+		REQUIRE(CHECK_COLUMN(result, 0, {2, 6}));
+		REQUIRE(CHECK_COLUMN(result, 1, {11, 0}));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		// the WAL is replayed on top of the checkpoint, and then checkpointed itself
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT i, j FROM t ORDER BY i");
+		REQUIRE(CHECK_COLUMN(result, 0, {2, 6}));
+		REQUIRE(CHECK_COLUMN(result, 1, {11, 0}));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test that checkpoints only rewrite modified data", "[storage]") {
+	FileSystem fs;
+	// every commit checkpoints the database
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("incremental_checkpoint_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE big (i INTEGER, d DOUBLE)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO big VALUES (1, 0.5)"));
+		for (index_t i = 0; i < 17; i++) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO big SELECT i + (SELECT COUNT(*) FROM big), d FROM big"));
+		}
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE strings (s VARCHAR)"));
+		// create a string that is stored in overflow blocks
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES ('" + string(64, 'x') + "')"));
+		for (index_t i = 0; i < 4; i++) {
+			REQUIRE_NO_FAIL(con.Query("UPDATE strings SET s = s || s || s || s || s || s || s || s"));
+		}
+		int64_t size;
+		{
+			auto handle = fs.OpenFile(storage_database, FileFlags::READ);
+			size = fs.GetFileSize(*handle);
+		}
+		// small changes to the tables only rewrite the blocks they touch, and reuse the freed blocks
+		for (index_t i = 0; i < 50; i++) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO strings VALUES ('small" + to_string(i) + "')"));
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO big VALUES (" + to_string(i) + ", 1)"));
+		}
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM strings WHERE s = 'small7'"));
+		{
+			auto handle = fs.OpenFile(storage_database, FileFlags::READ);
+			REQUIRE(fs.GetFileSize(*handle) <= size + 20 * BLOCK_SIZE);
+		}
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(i), SUM(d) FROM big");
+		REQUIRE(CHECK_COLUMN(result, 0, {131122}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(8590001353)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value::DOUBLE(65586)}));
+		result = con.Query("SELECT COUNT(*), MAX(LENGTH(s)) FROM strings");
+		REQUIRE(CHECK_COLUMN(result, 0, {50}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(BLOCK_SIZE)}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test a crash while a checkpoint is written", "[storage]") {
+	FileSystem fs;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("checkpoint_crash_test");
+	auto wal_path = storage_database + ".wal";
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		auto config = GetTestConfig();
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1), (2), (3)"));
+	}
+	{
+		// crash after the checkpoint marker is written to the WAL, but before the header is written
+		auto config = GetTestConfig();
+		config->file_system = make_unique_base<FileSystem, CheckpointCrashFileSystem>(true);
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	{
+		// the previous checkpoint is loaded, so the WAL is replayed
+		auto config = GetTestConfig();
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {3}));
+		REQUIRE(CHECK_COLUMN(result, 1, {6}));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (4)"));
+	}
+	{
+		// crash after the header is written, but before the WAL is truncated
+		auto config = GetTestConfig();
+		config->file_system = make_unique_base<FileSystem, CheckpointCrashFileSystem>(false);
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	REQUIRE(fs.FileExists(wal_path));
+	{
+		// the new checkpoint already contains the entries of the WAL: they are not replayed again
+		auto config = GetTestConfig();
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {4}));
+		REQUIRE(CHECK_COLUMN(result, 1, {10}));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (5)"));
+	}
+	{
+		// the WAL was truncated when the database was opened, the new entries are replayed
+		auto config = GetTestConfig();
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {5}));
+		REQUIRE(CHECK_COLUMN(result, 1, {15}));
+	}
+	DeleteDatabase(storage_database);
+}
@@ -0,0 +1,97 @@
+#include "catch.hpp"
+#include "common/file_system.hpp"
+#include "storage/storage_info.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test compression of checkpointed column segments", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("compression_test");
+	index_t table_size = 131072;
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		// create a table with columns that are suited for the different compression methods
+		// the data is only checkpointed when the database is reloaded
+		auto load_config = GetTestConfig();
+		load_config->checkpoint_wal_size = 1 << 30;
+		DuckDB db(storage_database, load_config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (i INTEGER, c INTEGER, n INTEGER, r BIGINT, s SMALLINT, d DOUBLE, "
+		                          "b BIGINT, e BIGINT)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1, 42, NULL, 0, NULL, 0.5, 1000000000000, "
+		                          "-9223372036854775807)"));
+		for (index_t count = 1; count < table_size; count *= 2) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT i + (SELECT COUNT(*) FROM test), 42, NULL, "
+			                          "(i + (SELECT COUNT(*) FROM test)) / 1000, NULL, 0.5, 0, 0 FROM test"));
+		}
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET s = CASE WHEN i % 7 = 0 THEN NULL ELSE i % 5 END, d = i / 100 * "
+		                          "0.25, b = 1000000000000 + i % 1000, e = CASE WHEN i % 2 = 0 THEN "
+		                          "-9223372036854775807 ELSE 9223372036854775807 END"));
+	}
+	auto verify_data = [&](Connection &con) {
+		result = con.Query("SELECT COUNT(*), SUM(i), MIN(c), MAX(c), COUNT(n), SUM(r), MAX(r), COUNT(s), SUM(s), "
+		                   "SUM(d), MIN(b), MAX(b), COUNT(e), MIN(e), MAX(e) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(table_size)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(table_size * (table_size + 1) / 2)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {42}));
+		REQUIRE(CHECK_COLUMN(result, 3, {42}));
+		REQUIRE(CHECK_COLUMN(result, 4, {0}));
+		REQUIRE(CHECK_COLUMN(result, 5, {Value::BIGINT(8524563)}));
+		REQUIRE(CHECK_COLUMN(result, 6, {Value::BIGINT(131)}));
+		REQUIRE(CHECK_COLUMN(result, 7, {Value::BIGINT(112348)}));
+		REQUIRE(CHECK_COLUMN(result, 8, {Value::BIGINT(224693)}));
+		REQUIRE(CHECK_COLUMN(result, 9, {Value::DOUBLE(21458782.5)}));
+		REQUIRE(CHECK_COLUMN(result, 10, {Value::BIGINT(1000000000000)}));
+		REQUIRE(CHECK_COLUMN(result, 11, {Value::BIGINT(1000000000999)}));
+		REQUIRE(CHECK_COLUMN(result, 12, {Value::BIGINT(table_size)}));
+		REQUIRE(CHECK_COLUMN(result, 13, {Value::BIGINT(-9223372036854775807LL)}));
+		REQUIRE(CHECK_COLUMN(result, 14, {Value::BIGINT(9223372036854775807LL)}));
+		// individual rows
+		result = con.Query("SELECT i, c, n, r, s, d, b, e FROM test WHERE i IN (7, 1002, 131072) ORDER BY i");
+		REQUIRE(CHECK_COLUMN(result, 0, {7, 1002, 131072}));
+		REQUIRE(CHECK_COLUMN(result, 1, {42, 42, 42}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value(), Value(), Value()}));
+		REQUIRE(CHECK_COLUMN(result, 3, {0, 1, 131}));
+		REQUIRE(CHECK_COLUMN(result, 4, {Value(), 2, 2}));
+		REQUIRE(CHECK_COLUMN(result, 5, {0, 2.5, 327.5}));
+		REQUIRE(CHECK_COLUMN(result, 6, {Value::BIGINT(1000000000007), Value::BIGINT(1000000000002),
+		                                 Value::BIGINT(1000000000072)}));
+		REQUIRE(CHECK_COLUMN(result, 7, {Value::BIGINT(9223372036854775807LL), Value::BIGINT(-9223372036854775807LL),
+		                                 Value::BIGINT(-9223372036854775807LL)}));
+	};
+	{
+		// reload the database: the table is checkpointed and compressed
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		verify_data(con);
+	}
+	{
+		// uncompressed the columns take up more than 24 blocks, compressed only i and e need more than one block each
+		auto handle = fs.OpenFile(storage_database, FileFlags::READ);
+		REQUIRE(fs.GetFileSize(*handle) < 20 * BLOCK_SIZE);
+	}
+	{
+		// verify the compressed data after reloading, and modify the compressed segments
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		verify_data(con);
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE i % 3 = 0"));
+		result = con.Query("SELECT COUNT(*), SUM(s), SUM(b - 1000000000000), COUNT(n) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(87382)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(149794)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(43624443)}));
+		REQUIRE(CHECK_COLUMN(result, 3, {0}));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET s = 10 WHERE i = 1004"));
+		result = con.Query("SELECT s, r, b FROM test WHERE i = 1004");
+		REQUIRE(CHECK_COLUMN(result, 0, {10}));
+		REQUIRE(CHECK_COLUMN(result, 1, {1}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(1000000000004)}));
+	}
+	DeleteDatabase(storage_database);
+}
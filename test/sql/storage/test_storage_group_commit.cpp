@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace duckdb;
+using namespace std;
+
+#define GROUP_COMMIT_THREADS 8
+#define GROUP_COMMIT_INSERTS 50
+
+static void insert_rows(DuckDB *db, bool *success, index_t thread_nr) {
+	Connection con(*db);
+	success[thread_nr] = true;
+	for (index_t i = 0; i < GROUP_COMMIT_INSERTS; i++) {
+		// every insert is committed (and synced to the WAL) separately
+		auto value = to_string(thread_nr * GROUP_COMMIT_INSERTS + i);
+		if (!con.Query("INSERT INTO test VALUES (" + value + ", " + to_string(thread_nr) + ")")->success) {
+			success[thread_nr] = false;
+		}
+	}
+}
+
+static void run_concurrent_commits(DuckDB &db) {
+	bool success[GROUP_COMMIT_THREADS];
+	thread threads[GROUP_COMMIT_THREADS];
+	for (index_t i = 0; i < GROUP_COMMIT_THREADS; i++) {
+		threads[i] = thread(insert_rows, &db, success, i);
+	}
+	for (index_t i = 0; i < GROUP_COMMIT_THREADS; i++) {
+		threads[i].join();
+		REQUIRE(success[i]);
+	}
+}
+
+TEST_CASE("Test concurrent commits to the WAL", "[storage]") {
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("group_commit_test");
+	auto config = GetTestConfig();
+	index_t total_rows = GROUP_COMMIT_THREADS * GROUP_COMMIT_INSERTS;
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b INTEGER)"));
+		// commit without a delay: only the commits that arrive during a sync are synced together
+		run_concurrent_commits(db);
+		result = con.Query("SELECT COUNT(*), SUM(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(total_rows)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(total_rows * (total_rows - 1) / 2)}));
+	}
+	{
+		// all commits are in the WAL and are replayed after a restart
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a), COUNT(DISTINCT b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(total_rows)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(total_rows * (total_rows - 1) / 2)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {GROUP_COMMIT_THREADS}));
+
+		// now wait for other commits before syncing
+		REQUIRE_FAIL(con.Query("PRAGMA commit_delay"));
+		REQUIRE_FAIL(con.Query("PRAGMA commit_delay=-1"));
+		REQUIRE_FAIL(con.Query("PRAGMA commit_delay=99999999999999999999999"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA commit_delay=500"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test"));
+		run_concurrent_commits(db);
+		// a transaction with an explicit commit and one that is rolled back
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (-1, -1)"));
+		REQUIRE_NO_FAIL(con.Query("COMMIT"));
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (-2, -2)"));
+		REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
+
+		// the delay is a maximum: a commit does not wait if no other transaction is committing
+		REQUIRE_NO_FAIL(con.Query("PRAGMA commit_delay=60000000"));
+		auto start = chrono::steady_clock::now();
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (-3, -3)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=-3"));
+		REQUIRE(chrono::steady_clock::now() - start < chrono::seconds(30));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a), MIN(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(total_rows + 1)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(total_rows * (total_rows - 1) / 2 - 1)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {-1}));
+	}
+	DeleteDatabase(storage_database);
+}
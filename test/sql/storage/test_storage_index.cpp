@@ -0,0 +1,80 @@
+#include "catch.hpp"
+#include "common/file_system.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test storing the indexes of constraints in the database file", "[storage]") {
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("storage_test");
+	auto config = GetTestConfig();
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		// create a table with a primary key and a unique constraint, and modify it before checkpointing it
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test(k INTEGER PRIMARY KEY, v VARCHAR UNIQUE, w INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (0, 'v0', 0)"));
+		for (index_t count = 1; count < 8192; count *= 2) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT k + (SELECT COUNT(*) FROM test), 'v' || CAST(k + (SELECT "
+			                          "COUNT(*) FROM test) AS VARCHAR), k + (SELECT COUNT(*) FROM test) FROM test"));
+		}
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE k % 10 = 1"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET k = k + 100000, v = 'u' || v WHERE k % 10 = 2"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		// reload the database: the first time the indexes are loaded from disk, the second time the checkpoint of
+		// the previous iteration reused them
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(k) FROM test WHERE k > 8000");
+		REQUIRE(CHECK_COLUMN(result, 0, {971}));
+		REQUIRE(CHECK_COLUMN(result, 1, {86482016}));
+		result = con.Query("SELECT k, v, w FROM test WHERE v = 'u' || 'v102'");
+		REQUIRE(CHECK_COLUMN(result, 0, {100102}));
+		REQUIRE(CHECK_COLUMN(result, 1, {"uv102"}));
+		REQUIRE(CHECK_COLUMN(result, 2, {102}));
+		// the deleted and updated keys are not in the indexes anymore
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (3, 'x', 0)"));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (-1, 'v3', 0)"));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (100012, 'x', 0)"));
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1, 'v1', 0), (2, 'v2', 0), (8192, 'v8192', 0)"));
+		REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
+		// a checkpoint without changes to the table reuses the stored indexes
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	{
+		// modify the table after loading it: the checkpoint writes the partially loaded indexes
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1, 'v1', 1)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE k = 4"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	{
+		// the indexes are not stored while other transactions can have modified them: they are rebuilt instead
+		DuckDB db(storage_database, config.get());
+		Connection con(db), con2(db);
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (1, 'x', 0)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (4, 'v4', 4)"));
+		REQUIRE_NO_FAIL(con2.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con2.Query("INSERT INTO test VALUES (11, 'v11', 11)"));
+		REQUIRE_NO_FAIL(con2.Query("UPDATE test SET k = -4 WHERE k = 4"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA checkpoint"));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (4, 'x', 0)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (11, 'v11', 11), (-4, 'x', 0)"));
+		result = con.Query("SELECT k, w FROM test WHERE k < 12 ORDER BY k");
+		REQUIRE(CHECK_COLUMN(result, 0, {-4, 0, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+		REQUIRE(CHECK_COLUMN(result, 1, {0, 0, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+	}
+	DeleteDatabase(storage_database);
+}
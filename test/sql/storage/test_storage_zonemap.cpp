@@ -0,0 +1,103 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test zone map segment skipping in table scans", "[storage]") {
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("zonemap_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	auto verify_ranges = [&](Connection &con) {
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 77777");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		result = con.Query("SELECT COUNT(*), SUM(ts) FROM test WHERE 131000 < ts AND 200000 >= ts");
+		REQUIRE(CHECK_COLUMN(result, 0, {71}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(9303556)}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts > 2000000 OR ts < -10");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts > 2000000");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE d >= 65000.0");
+		REQUIRE(CHECK_COLUMN(result, 0, {1072}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE n > 130000");
+		REQUIRE(CHECK_COLUMN(result, 0, {1070}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE n IS NULL AND ts > 130000");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	};
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db), con2(db);
+		// create a table with an ascending column, so every chunk covers a distinct range of values
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (ts INTEGER, d DOUBLE, n INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (0, 0, 0)"));
+		for (index_t count = 1; count < 131072; count *= 2) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test SELECT ts + (SELECT COUNT(*) FROM test), (ts + (SELECT "
+			                          "COUNT(*) FROM test)) * 0.5, CASE WHEN (ts + (SELECT COUNT(*) FROM test)) % 1000 "
+			                          "= 999 THEN NULL ELSE ts + (SELECT COUNT(*) FROM test) END FROM test"));
+		}
+		verify_ranges(con);
+		result = con.Query("SELECT COUNT(*), SUM(ts) FROM test WHERE ts >= 50000 AND ts < 50100");
+		REQUIRE(CHECK_COLUMN(result, 0, {100}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(5004950)}));
+
+		// uncommitted updates are only visible to the transaction that made them
+		REQUIRE_NO_FAIL(con2.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con2.Query("UPDATE test SET ts = 500000 WHERE ts = 5"));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 5");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 500000");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		result = con2.Query("SELECT COUNT(*) FROM test WHERE ts = 5");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		result = con2.Query("SELECT COUNT(*) FROM test WHERE ts = 500000");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		REQUIRE_NO_FAIL(con2.Query("ROLLBACK"));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 5");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 500000");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+
+		// deletes and committed updates
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE ts >= 50000 AND ts < 50050"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET ts = 1000000 WHERE ts = 70000"));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts > 999999");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 70000");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+	}
+	auto verify_modifications = [&](Connection &con) {
+		result = con.Query("SELECT COUNT(*), SUM(ts) FROM test WHERE ts >= 50000 AND ts < 50100");
+		REQUIRE(CHECK_COLUMN(result, 0, {50}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(2503725)}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts > 999999");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 70000");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+	};
+	{
+		// reload the database: the zone maps of the persistent segments are loaded from the data pointers
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		verify_ranges(con);
+		verify_modifications(con);
+		// updating a persistent segment moves the row to the end of the table
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET ts = -5 WHERE ts = 12345"));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts < 0");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts = 12345");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		verify_ranges(con);
+		verify_modifications(con);
+		result = con.Query("SELECT COUNT(*) FROM test WHERE ts < 0");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	}
+	DeleteDatabase(storage_database);
+}
@@ -666,7 +666,8 @@ TEST_CASE("SQL Server functions tests", "[sqlserver]") {
 	    con.Query(" SELECT p.FirstName, p.LastName ,NTILE(4) OVER(ORDER BY SalesYTD DESC) AS Quartile "
 	              ",s.SalesYTD AS SalesYTD , a.PostalCode FROM Sales.SalesPerson AS s INNER "
 	              "JOIN Person.Person AS p ON s.BusinessEntityID = p.BusinessEntityID INNER JOIN Person.Address AS a "
-	              "ON a.AddressID = p.BusinessEntityID WHERE TerritoryID IS NOT NULL AND SalesYTD <> 0; ");
+	              "ON a.AddressID = p.BusinessEntityID WHERE TerritoryID IS NOT NULL AND SalesYTD <> 0 ORDER BY "
+	              "SalesYTD DESC; ");
 	REQUIRE(result->success);
 	REQUIRE(result->types.size() == 5);
 	REQUIRE(CHECK_COLUMN(result, 0,
@@ -687,7 +688,7 @@ TEST_CASE("SQL Server functions tests", "[sqlserver]") {
 	    " SELECT p.FirstName, p.LastName ,NTILE(4) OVER(PARTITION BY PostalCode ORDER BY SalesYTD DESC) AS "
 	    "Quartile ,s.SalesYTD AS SalesYTD ,a.PostalCode FROM Sales.SalesPerson AS s INNER JOIN "
 	    "Person.Person AS p ON s.BusinessEntityID = p.BusinessEntityID INNER JOIN Person.Address AS a ON a.AddressID = "
-	    "p.BusinessEntityID WHERE TerritoryID IS NOT NULL AND SalesYTD <> 0; ");
+	    "p.BusinessEntityID WHERE TerritoryID IS NOT NULL AND SalesYTD <> 0 ORDER BY PostalCode, SalesYTD DESC; ");
 	REQUIRE(result->success);
 	REQUIRE(result->types.size() == 5);
 	REQUIRE(CHECK_COLUMN(result, 0,
@@ -737,7 +738,7 @@ TEST_CASE("SQL Server functions tests", "[sqlserver]") {
 	// FROM https://docs.microsoft.com/en-us/sql/t-sql/functions/row-number-transact-sql?view=sql-server-2017
 
 	result = con.Query(" SELECT ROW_NUMBER() OVER(ORDER BY SalesYTD DESC) AS Row, FirstName, LastName, SalesYTD FROM "
-	                   "Sales.vSalesPerson WHERE TerritoryName IS NOT NULL AND SalesYTD <> 0;");
+	                   "Sales.vSalesPerson WHERE TerritoryName IS NOT NULL AND SalesYTD <> 0 ORDER BY SalesYTD DESC;");
 	REQUIRE(result->success);
 	REQUIRE(result->types.size() == 4);
 	REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14}));